@@ -210,6 +210,7 @@ namespace cli
             bool DoPredict();
             bool DoProductionFind(const ProductionFindBitset& options, const std::string& pattern);
             bool DoPWatch(bool query = true, const std::string* pProduction = 0, bool setting = false);
+            bool DoReorder(bool chunksOnly, const std::string* pProduction = 0);
             bool DoRemoveWME(uint64_t timetag);
             bool DoReplayInput(eReplayInputMode mode, std::string* pathname);
             bool DoReteNet(bool save, std::string filename);
@@ -231,6 +232,7 @@ namespace cli
             bool ParsePBreak(std::vector< std::string >& argv);
             bool ParsePFind(std::vector< std::string >& argv);
             bool ParsePWatch(std::vector< std::string >& argv);
+            bool ParseReorder(std::vector< std::string >& argv);
             bool ParseReplayInput(std::vector< std::string >& argv);
             bool ParseSource(std::vector< std::string >& argv);
             bool ParseReteLoad(std::vector< std::string >& argv);
@@ -127,7 +127,7 @@ namespace cli
             }
             [[nodiscard]] const char* GetSyntax() const override
             {
-                return "Syntax: debug [ allocate | internal-symbols | port | time | ? ] [arguments*]";
+                return "Syntax: debug [ allocate | internal-symbols | port | symbol-refcounts | time | ? ] [arguments*]";
             }
 
             bool Parse(std::vector< std::string >& argv) override
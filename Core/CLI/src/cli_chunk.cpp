@@ -121,6 +121,34 @@ bool CommandLineInterface::DoChunk(const std::string* pArg1, const std::string*
     {
         thisAgent->explanationBasedChunker->print_chunking_settings();
     }
+    else if ((my_param == thisAgent->explanationBasedChunker->ebc_params->timers) && !pArg2)
+    {
+        struct foo: public soar_module::accumulator< soar_module::timer* >
+        {
+            private:
+                cli::CommandLineInterface* this_cli;
+
+                foo& operator=(const foo&)
+                {
+                    return *this;
+                }
+
+            public:
+                foo(cli::CommandLineInterface* new_cli): this_cli(new_cli) {};
+
+                void operator()(soar_module::timer* t)
+                {
+                    std::string output(t->get_name());
+                    output += ":";
+                    this_cli->PrintCLIMessage_Item(output.c_str(), t, 40);
+                }
+        } bar(this);
+
+        tempStringStream << my_param->get_name() << " is" ;
+        PrintCLIMessage_Item(tempStringStream.str().c_str(), my_param, 0);
+        PrintCLIMessage_Header("Chunking Timers", 40);
+        thisAgent->explanationBasedChunker->ebc_timers->for_each(bar);
+    }
     else {
         if (!pArg2)
         {
@@ -152,6 +152,18 @@ bool CommandLineInterface::DoDebug(std::vector< std::string >* argv)
             thisAgent->symbolManager->print_internal_symbols();
             return true;
         }
+        else if (sub_command[0] == 's')
+        {
+#ifdef DEBUG_SYMBOL_REFCOUNTS
+            if (!thisAgent->symbolManager->check_symbol_refcounts())
+            {
+                return SetError("Symbol refcounts are out of balance.");
+            }
+#else
+            PrintCLIMessage("Symbol refcounts are only tracked when Soar is built with DEBUG_SYMBOL_REFCOUNTS.");
+#endif
+            return true;
+        }
         else if (sub_command[0] == 'p')
         {
 
@@ -173,6 +185,7 @@ bool CommandLineInterface::DoDebug(std::vector< std::string >* argv)
             PrintCLIMessage_Justify("allocate [pool blocks]", "Allocates extra memory to a memory pool", 70);
             PrintCLIMessage_Justify("internal-symbols", "Prints symbol table", 70);
             PrintCLIMessage_Justify("port", "Prints listening port", 70);
+            PrintCLIMessage_Justify("symbol-refcounts", "Checks that symbol refcounts balance", 70);
             PrintCLIMessage_Justify("time <command> [args]", "Executes command and prints time spent", 70);
         }
         else
@@ -163,6 +163,7 @@ namespace cli
     enum eSourceOptions
     {
         SOURCE_ALL,
+        SOURCE_BATCH,
         SOURCE_DISABLE,
         SOURCE_VERBOSE,
         SOURCE_NUM_OPTIONS,    // must be last
@@ -153,7 +153,7 @@ bool CommandLineInterface::DoExplain(const std::string* pArg1, const std::string
         }
         else if (my_param == thisAgent->explanationMemory->settings->explain_instantiation)
         {
-            if (!thisAgent->explanationMemory->current_discussed_chunk_exists())
+            if (!thisAgent->explanationMemory->any_discussed_chunk_exists())
             {
                 return SetError("Please first specify the chunk you want to discuss with the command 'explain chunk [chunk-name | chunk ID]'.");
             }
@@ -173,7 +173,7 @@ bool CommandLineInterface::DoExplain(const std::string* pArg1, const std::string
         }
         else if (my_param == thisAgent->explanationMemory->settings->explanation_trace)
         {
-            if (!thisAgent->explanationMemory->current_discussed_chunk_exists())
+            if (!thisAgent->explanationMemory->any_discussed_chunk_exists())
             {
                 return SetError("Please first specify the chunk you want to discuss with the command 'explain chunk [chunk-name | chunk ID]'.");
             }
@@ -182,7 +182,7 @@ bool CommandLineInterface::DoExplain(const std::string* pArg1, const std::string
         }
         else if (my_param == thisAgent->explanationMemory->settings->wm_trace)
         {
-            if (!thisAgent->explanationMemory->current_discussed_chunk_exists())
+            if (!thisAgent->explanationMemory->any_discussed_chunk_exists())
             {
                 return SetError("Please first specify the chunk you want to discuss with the command 'explain chunk [chunk-name | chunk ID]'.");
             }
@@ -191,7 +191,7 @@ bool CommandLineInterface::DoExplain(const std::string* pArg1, const std::string
         }
         else if (my_param == thisAgent->explanationMemory->settings->formation)
         {
-            if (!thisAgent->explanationMemory->current_discussed_chunk_exists())
+            if (!thisAgent->explanationMemory->any_discussed_chunk_exists())
             {
                 return SetError("Please first specify the chunk you want to discuss with the command 'explain chunk [chunk-name | chunk ID]'.");
             }
@@ -200,7 +200,7 @@ bool CommandLineInterface::DoExplain(const std::string* pArg1, const std::string
         }
         else if (my_param == thisAgent->explanationMemory->settings->constraint_analysis)
         {
-            if (!thisAgent->explanationMemory->current_discussed_chunk_exists())
+            if (!thisAgent->explanationMemory->any_discussed_chunk_exists())
             {
                 return SetError("Please first specify the chunk you want to discuss with the command 'explain chunk [chunk-name | chunk ID]'.");
             }
@@ -209,7 +209,7 @@ bool CommandLineInterface::DoExplain(const std::string* pArg1, const std::string
         }
         else if (my_param == thisAgent->explanationMemory->settings->identity_analysis)
         {
-            if (!thisAgent->explanationMemory->current_discussed_chunk_exists())
+            if (!thisAgent->explanationMemory->any_discussed_chunk_exists())
             {
                 return SetError("Please first specify the chunk you want to discuss with the command 'explain chunk [chunk-name | chunk ID]'.");
             }
@@ -219,7 +219,7 @@ bool CommandLineInterface::DoExplain(const std::string* pArg1, const std::string
         }
         else if (my_param == thisAgent->explanationMemory->settings->stats)
         {
-            if (!thisAgent->explanationMemory->current_discussed_chunk_exists())
+            if (!thisAgent->explanationMemory->any_discussed_chunk_exists())
             {
                 return SetError("Please first specify the chunk you want to discuss with the command 'explain chunk [chunk-name | chunk ID]'.");
             }
@@ -255,6 +255,7 @@ void initdocstrings()
 		"  merge                                  [ ON | off ]   Merge redundant conditions\n"
 		"  lhs-repair                             [ ON | off ]   Add conds for unconnected LHS IDs\n"
 		"  rhs-repair                             [ ON | off ]   Add conds for unconnected RHS IDs\n"
+		"  reorder-statistics                     [ on | OFF ]   Order conditions by observed match counts\n"
 		"  user-singletons                        [ ON | off ]   Unify with domain singletons\n"
 		"  ---------- Correctness Guarantee Filters ----------     Allow rules to form that...\n"
 		"  allow-local-negations                  [ ON | off ]   ...used local negative reasoning\n"
@@ -317,6 +318,10 @@ void initdocstrings()
 		"create graphs depicting the dependency between rules in a sub-state.\n"
 		"The stats command will print a detailed table containing statistics about all\n"
 		"chunking activity during that run.\n"
+		"The timers setting records the time spent in each phase of rule formation,\n"
+		"e.g. dependency analysis, variablization, merging, re-ordering and adding the\n"
+		"rule to the rete. 'one' only times learning as a whole. Use 'chunk timers'\n"
+		"with no arguments to print the timers.\n"
 		"The interrupt setting forces Soar to stop after forming any rule.\n"
 		"The explain-interrupt setting forces Soar to stop when it attempts to form a\n"
 		"rule from a production that is being watched by the explainer. See explain for\n"
@@ -410,6 +415,14 @@ void initdocstrings()
 		"(better, best, worse, worst, indifferent) will also be added, producing more\n"
 		"specific and possibly correct chunks. This feature is still experimental, so\n"
 		"the default is to not include operator selection knowledge.\n"
+		"\n"
+		"chunk reorder-statistics\n"
+		"\n"
+		"When this option is enabled, the matcher counts how many values identifiers\n"
+		"have for each attribute, and new chunks order their conditions using those\n"
+		"counts instead of a fixed estimate.  Keeping the counts adds a little to every\n"
+		"working memory change, so the default is off.  Rules that are already loaded\n"
+		"can be reordered the same way with 'production reorder'.\n"
 		"The following commands are not yet enabled. Soar will always use the EBC\n"
 		"mechanisms listed below.\n"
 		"\n"
@@ -483,6 +496,7 @@ void initdocstrings()
 		"  allocate [pool blocks]         Allocates extra memory to a memory pool\n"
 		"  internal-symbols                                   Prints symbol table\n"
 		"  port                                             Prints listening port\n"
+		"  symbol-refcounts                  Checks that symbol refcounts balance\n"
 		"  time <command> [args]           Executes command and prints time spent\n"
 		"\n"
 		"debug allocate\n"
@@ -515,6 +529,13 @@ void initdocstrings()
 		"\n"
 		"The port command prints the port the kernel instance is listening on.\n"
 		"\n"
+		"debug symbol-refcounts\n"
+		"\n"
+		"The symbol-refcounts command checks that the reference counts held by all\n"
+		"symbols add up to the references taken and not released. It only works when\n"
+		"Soar is built with DEBUG_SYMBOL_REFCOUNTS, since that is what counts the\n"
+		"references.\n"
+		"\n"
 		"debug time\n"
 		"\n"
 		"  debug time command [arguments]\n"
@@ -1516,7 +1537,7 @@ void initdocstrings()
 		"  load                            [? | help]\n"
 		"  ------------------------------------------------------------\n"
 		"  load file                       [--all --disable] <filename>\n"
-		"  load file                       [--verbose]     ]\n"
+		"  load file                       [--batch --verbose]\n"
 		"  ------------------------------------------------------------\n"
 		"  load library                    <filename> <args...>\n"
 		"  ------------------------------------------------------------\n"
@@ -1539,6 +1560,7 @@ void initdocstrings()
 		"Option        Description\n"
 		"filename      The file of Soar productions and commands to load.\n"
 		"-a, --all     Enable a summary for each file sourced\n"
+		"-b, --batch   Match all new productions at once, when the file is done\n"
 		"-d, --disable Disable all summaries\n"
 		"-v, --verbose Print excised production names\n"
 		"\n"
@@ -2208,6 +2230,8 @@ void initdocstrings()
 		"  ------------------------------------------------------------------\n"
 		"  production optimize-attribute [symbol [n]]\n"
 		"  ------------------------------------------------------------------\n"
+		"  production reorder            [--all --chunks] | <prod-name>\n"
+		"  ------------------------------------------------------------------\n"
 		"  production watch              [--disable --enable] <prod-name>\n"
 		"  ------------------------------------------------------------------\n"
 		"\n"
@@ -2587,6 +2611,33 @@ void initdocstrings()
 		"\n"
 		"  production optimize-attribute thing 4\n"
 		"\n"
+		"production reorder\n"
+		"\n"
+		"Reorder the conditions of rules already in memory using what the matcher has\n"
+		"seen of working memory.\n"
+		"\n"
+		"Synopsis\n"
+		"\n"
+		"  production reorder [--all --chunks] | <prod-name>\n"
+		"\n"
+		"Options:\n"
+		"\n"
+		"Option       Description\n"
+		"-a, --all    Reorder every rule.\n"
+		"-c, --chunks Reorder only chunks.\n"
+		"prod-name    Reorder only the named rule.\n"
+		"\n"
+		"Description:\n"
+		"\n"
+		"When Soar loads a rule, it orders the conditions using a fixed guess of how\n"
+		"many values each attribute has.  This command orders them again using the\n"
+		"average number of values per identifier that working memory currently holds\n"
+		"for each attribute.  A rule whose order changes is rebuilt as if it had been\n"
+		"sourced again:  its current matches are retracted and it matches again from\n"
+		"scratch.  Its firing count, watches and RL values are kept.  Justifications\n"
+		"and templates are never reordered.  Run it when working memory is in a typical\n"
+		"state for the task.  See also 'chunk reorder-statistics'.\n"
+		"\n"
 		"production watch\n"
 		"\n"
 		"Trace firings and retractions of specific productions.\n"
@@ -293,6 +293,7 @@ bool CommandLineInterface::ParseSource(std::vector< std::string >& argv)
     OptionsData optionsData[] =
     {
         {'a', "all",            OPTARG_NONE},
+        {'b', "batch",          OPTARG_NONE},
         {'d', "disable",        OPTARG_NONE},
         {'v', "verbose",        OPTARG_NONE},
         {0, 0, OPTARG_NONE}
@@ -320,6 +321,9 @@ bool CommandLineInterface::ParseSource(std::vector< std::string >& argv)
             case 'a':
                 options.set(cli::SOURCE_ALL);
                 break;
+            case 'b':
+                options.set(cli::SOURCE_BATCH);
+                break;
             case 'v':
                 options.set(cli::SOURCE_VERBOSE);
                 break;
@@ -328,7 +332,7 @@ bool CommandLineInterface::ParseSource(std::vector< std::string >& argv)
 
     if (opt.GetNonOptionArguments() < 2)
     {
-        return SetError("Syntax: load file [--all | --disable | --verbose] <filename>");
+        return SetError("Syntax: load file [--all | --batch | --disable | --verbose] <filename>");
     }
     else if (opt.GetNonOptionArguments() > 3)
     {
@@ -845,7 +849,19 @@ bool CommandLineInterface::DoSource(std::string path, SourceBitset* pOptions)
             AppendArgTagFast(sml_Names::kParamChunkNamePrefix, sml_Names::kTypeString, outString);
         }
     }
+
+    // In a batch, new rules are matched against working memory all at once
+    // when the outermost file is done, instead of one rule at a time.
+    agent* batchAgent = (m_pAgentSML && m_pSourceOptions && m_pSourceOptions->test(SOURCE_BATCH)) ? m_pAgentSML->GetSoarAgent() : 0;
+    if (batchAgent)
+    {
+        begin_production_batch(batchAgent);
+    }
     bool ret = Source(buffer, true);
+    if (batchAgent)
+    {
+        end_production_batch(batchAgent);
+    }
 
     if (m_pSourceOptions && m_pSourceOptions->test(SOURCE_ALL))
     {
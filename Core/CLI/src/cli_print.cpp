@@ -703,15 +703,12 @@ void print_symbol(agent* thisAgent, const char* arg, bool print_filename, bool i
             break;
 
         case INT_CONSTANT_LEXEME:
-            for (w = thisAgent->all_wmes_in_rete; w != NIL; w = w->rete_next)
+            w = find_wme_by_timetag(thisAgent, static_cast<uint64_t>(lexeme.int_val));
+            if (w)
             {
-                if (w->timetag == static_cast<uint64_t>(lexeme.int_val))
-                {
-                    do_print_for_wme(thisAgent, w, depth, intern, tree);
-                    break;
-                }
+                do_print_for_wme(thisAgent, w, depth, intern, tree);
             }
-            if (!w)
+            else
             {
                 thisAgent->outputManager->printa_sf(thisAgent,  "No wme %d in working memory.", lexeme.int_val);
             }
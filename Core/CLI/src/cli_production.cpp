@@ -88,6 +88,10 @@ bool CommandLineInterface::DoProduction(std::vector<std::string>& argv, const st
     {
         return ParsePWatch(argv);
     }
+    else if (my_param == thisAgent->command_params->production_params->reorder_cmd)
+    {
+        return ParseReorder(argv);
+    }
     else if ((my_param == thisAgent->command_params->production_params->help_cmd) || (my_param == thisAgent->command_params->production_params->qhelp_cmd))
     {
         thisAgent->command_params->production_params->print_settings(thisAgent);
@@ -967,6 +971,112 @@ bool CommandLineInterface::DoMatches(const eMatchesMode mode, const eWMEDetail d
     return true;
 }
 
+bool CommandLineInterface::ParseReorder(std::vector< std::string >& argv)
+{
+    cli::Options opt;
+    OptionsData optionsData[] =
+    {
+        {'a', "all",            OPTARG_NONE},
+        {'c', "chunks",         OPTARG_NONE},
+        {0, 0,                  OPTARG_NONE}
+    };
+
+    bool all = false;
+    bool chunksOnly = false;
+
+    for (;;)
+    {
+        if (!opt.ProcessOptions(argv, optionsData))
+        {
+            return SetError(opt.GetError().c_str());
+        }
+        if (opt.GetOption() == -1)
+        {
+            break;
+        }
+
+        switch (opt.GetOption())
+        {
+            case 'a':
+                all = true;
+                break;
+            case 'c':
+                chunksOnly = true;
+                break;
+        }
+    }
+
+    if (all || chunksOnly)
+    {
+        if (!opt.CheckNumNonOptArgs(1, 1))
+        {
+            return SetError("Invalid additional arguments.");
+        }
+        return DoReorder(chunksOnly);
+    }
+
+    if (opt.GetNonOptionArguments() != 2)
+    {
+        return SetError("Expected --all, --chunks or a single production name.");
+    }
+    return DoReorder(false, &(argv[opt.GetArgument() - opt.GetNonOptionArguments() + 1]));
+}
+
+bool CommandLineInterface::DoReorder(bool chunksOnly, const std::string* pProduction)
+{
+    agent* thisAgent = m_pAgentSML->GetSoarAgent();
+    std::vector<production*> prods;
+
+    if (pProduction)
+    {
+        Symbol* sym = thisAgent->symbolManager->find_str_constant(pProduction->c_str());
+
+        if (!sym || !(sym->sc->production))
+        {
+            return SetError("Production not found.");
+        }
+        prods.push_back(sym->sc->production);
+    }
+    else
+    {
+        for (int i = 0; i < NUM_PRODUCTION_TYPES; i++)
+        {
+            if (chunksOnly && (i != CHUNK_PRODUCTION_TYPE))
+            {
+                continue;
+            }
+            for (production* prod = thisAgent->all_productions_of_type[i]; prod != NIL; prod = prod->next)
+            {
+                prods.push_back(prod);
+            }
+        }
+    }
+
+    /* Rebuilding a rule adds it back to the head of its list, so work from a copy */
+    bool had_statistics = thisAgent->match_statistics;
+    set_match_statistics(thisAgent, true);
+    int64_t reorderCount = 0;
+    for (size_t i = 0; i < prods.size(); i++)
+    {
+        if (reorder_production_with_match_statistics(thisAgent, prods[i]))
+        {
+            ++reorderCount;
+        }
+    }
+    set_match_statistics(thisAgent, had_statistics);
+
+    if (m_RawOutput)
+    {
+        m_Result << reorderCount << " production" << (reorderCount == 1 ? " " : "s ") << "reordered.\n";
+    }
+    else
+    {
+        std::string temp;
+        AppendArgTagFast(sml_Names::kParamCount, sml_Names::kTypeInt, to_string(reorderCount, temp));
+    }
+    return true;
+}
+
 bool CommandLineInterface::DoMultiAttributes(const std::string* pAttribute, int n)
 {
     agent* thisAgent = m_pAgentSML->GetSoarAgent();
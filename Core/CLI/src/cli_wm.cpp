@@ -475,16 +475,8 @@ bool CommandLineInterface::DoAddWME(const std::string& id, std::string attribute
 
 bool CommandLineInterface::DoRemoveWME(uint64_t timetag)
 {
-    wme* pWme = 0;
     agent* thisAgent = m_pAgentSML->GetSoarAgent();
-
-    for (pWme = thisAgent->all_wmes_in_rete; pWme != 0; pWme = pWme->rete_next)
-    {
-        if (pWme->timetag == timetag)
-        {
-            break;
-        }
-    }
+    wme* pWme = find_wme_by_timetag(thisAgent, timetag);
 
     if (pWme)
     {
@@ -815,16 +807,8 @@ bool CommandLineInterface::DoWMA(const char pOp, const std::string* pAttr, const
             return SetError("Invalid timetag.");
         }
 
-        wme* pWme = NULL;
         agent* thisAgent = m_pAgentSML->GetSoarAgent();
-
-        for (pWme = thisAgent->all_wmes_in_rete; pWme; pWme = pWme->rete_next)
-        {
-            if (pWme->timetag == timetag)
-            {
-                break;
-            }
-        }
+        wme* pWme = find_wme_by_timetag(thisAgent, timetag);
 
         if (pWme)
         {
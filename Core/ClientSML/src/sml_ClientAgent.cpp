@@ -1913,6 +1913,11 @@ void Agent::SendSVSInput(const std::string& txt)
     GetKernel()->SendSVSInput(GetAgentName(), txt);
 }
 
+void Agent::SendSVSBinaryInput(const std::string& data)
+{
+    GetKernel()->SendSVSBinaryInput(GetAgentName(), data);
+}
+
 std::string Agent::SVSQuery(const std::string& q)
 {
     return GetKernel()->SVSQuery(GetAgentName(), q);
@@ -821,6 +821,14 @@ namespace sml
             bool ExecuteCommandLineXML(char const* pCommandLine, ClientAnalyzedXML* pResponse) ;
 
             void        SendSVSInput(const std::string& txt);
+            
+            /*************************************************************
+            * @brief Send a binary batch of scene updates to SVS (see
+            *        Core/SVS/src/sgel_batch.h for the layout).  The batch
+            *        is applied as a whole during the next input phase, or
+            *        not at all if any record in it is invalid.
+            *************************************************************/
+            void        SendSVSBinaryInput(const std::string& data);
             std::string GetSVSOutput();
             std::string SVSQuery(const std::string& q);
 
@@ -15,6 +15,7 @@
 #include "sml_ClientKernel.h"
 #include "sml_ClientAgent.h"
 #include "sml_Connection.h"
+#include "sml_TagArg.h"
 #include "sml_Errors.h"
 #include "sml_StringOps.h"
 #include "sml_EventThread.h"
@@ -2605,6 +2606,28 @@ void Kernel::SendSVSInput(const char* agentName, const std::string& txt)
     GetConnection()->SendAgentCommand(&response, sml_Names::kCommand_SVSInput, agentName, sml_Names::kParamLine, txt.c_str());
 }
 
+void Kernel::SendSVSBinaryInput(const char* agentName, const std::string& data)
+{
+    AnalyzeXML response;
+    ElementXML* pMsg = GetConnection()->CreateSMLCommand(sml_Names::kCommand_SVSBinaryInput) ;
+
+    // Add the agent parameter and as a side-effect, get a pointer to the <command> tag.
+    ElementXML_Handle hCommand = GetConnection()->AddParameterToSMLCommand(pMsg, sml_Names::kParamAgent, agentName) ;
+    ElementXML command(hCommand) ;
+
+    // The batch can contain nulls, so it goes in as binary character data
+    TagArg* pArg = new TagArg() ;
+    pArg->SetParam(sml_Names::kParamLine) ;
+    pArg->SetBinaryCharacterData(data.data(), static_cast<int>(data.size())) ;
+    command.AddChild(pArg) ;
+
+    // We are working with a subpart of pMsg, which still owns the handle
+    command.Detach() ;
+
+    GetConnection()->SendMessageGetResponse(&response, pMsg) ;
+    delete pMsg ;
+}
+
 std::string Kernel::GetSVSOutput(const char* agentName)
 {
     AnalyzeXML response;
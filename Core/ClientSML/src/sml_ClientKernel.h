@@ -1002,6 +1002,7 @@ namespace sml
             static Kernel* CreateEmbeddedConnection(bool clientThread, bool optimized, int portToListenOn) ;
 
             void        SendSVSInput(const char* agentName, const std::string& txt);
+            void        SendSVSBinaryInput(const char* agentName, const std::string& data);
             std::string GetSVSOutput(const char* agentName);
             std::string SVSQuery(const char* agentName, const std::string& q);
 
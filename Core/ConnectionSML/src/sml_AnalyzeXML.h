@@ -107,6 +107,17 @@ namespace sml
                 return m_ArgMap.GetArgValue(pArgName, -1) ;
             }
             
+            /*************************************************************
+            * @brief Look up an argument by name and return the <arg> element
+            *        itself, for arguments that carry binary character data.
+            *        Returns NULL if not found.  Wrapping the handle in an
+            *        ElementXML object takes a reference (see GetElementXMLHandle).
+            *************************************************************/
+            ElementXML_Handle GetArgHandle(char const* pArgName) const
+            {
+                return m_ArgMap.GetArgHandle(pArgName, -1) ;
+            }
+            
             /*************************************************************
             * @brief As "GetArgString" but parsed as a boolean.
             *************************************************************/
@@ -446,5 +446,6 @@ char const* const sml_Names::kCommand_GetListenerPort       = "get_listener_port
 char const* const sml_Names::kCommand_CommandLine        = "cmdline" ;
 
 char const* const sml_Names::kCommand_SVSInput   = "svs_input";
+char const* const sml_Names::kCommand_SVSBinaryInput = "svs_binary_input";
 char const* const sml_Names::kCommand_SVSOutput  = "svs_output";
 char const* const sml_Names::kCommand_SVSQuery  = "svs_query";
@@ -436,6 +436,7 @@ namespace sml
             static char const* const kCommand_CommandLine ;
 
             static char const* const kCommand_SVSInput ;
+            static char const* const kCommand_SVSBinaryInput ;
             static char const* const kCommand_SVSOutput ;
             static char const* const kCommand_SVSQuery ;
     } ;
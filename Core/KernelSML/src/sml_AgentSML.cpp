@@ -1231,7 +1231,6 @@ bool AgentSML::RemoveInputWME(char const* pClientTimeTag)
 void AgentSML::AddWmeToWmeMap(int64_t clientTimeTag, wme* w)
 {
     uint64_t timetag = w->timetag ;
-    m_KernelTimeTagToWmeMap[timetag] = w ;
 
     // Keep track of which client timetags correspond to which kernel timetags
     this->RecordTime(clientTimeTag, timetag) ;
@@ -1240,7 +1239,6 @@ void AgentSML::AddWmeToWmeMap(int64_t clientTimeTag, wme* w)
 void AgentSML::RemoveWmeFromWmeMap(wme* w)
 {
     int64_t timetag = w->timetag ;
-    m_KernelTimeTagToWmeMap.erase(timetag) ;
 
     // Keep track of which client timetags correspond to which kernel timetags
     this->RemoveKernelTime(timetag) ;
@@ -1248,12 +1246,7 @@ void AgentSML::RemoveWmeFromWmeMap(wme* w)
 
 wme* AgentSML::FindWmeFromKernelTimetag(uint64_t timetag)
 {
-    WmeMapIter wi = m_KernelTimeTagToWmeMap.find(timetag);
-    if (wi == m_KernelTimeTagToWmeMap.end())
-    {
-        return NULL;
-    }
-    return wi->second;
+    return find_wme_by_timetag(m_agent, timetag);
 }
 
 void AgentSML::InputWmeGarbageCollectedHandler(agent* /*pSoarAgent*/, int eventID, void* pData, void* pCallData)
@@ -69,10 +69,6 @@ namespace sml
     typedef std::list<soarxml::ElementXML*>     PendingInputList ;
     typedef PendingInputList::iterator          PendingInputListIter ;
     
-// Map of kernel time tags to kernel wmes for input
-    typedef std::map< uint64_t, wme* >          WmeMap;
-    typedef WmeMap::iterator                    WmeMapIter;
-    
 // This struct supports the buffered direct input calls
     struct DirectInputDelta
     {
@@ -202,9 +198,8 @@ namespace sml
             
             AgentRunCallback*   m_pAgentRunCallback ;
             
-            WmeMap          m_KernelTimeTagToWmeMap ; // Kernel time tag to kernel wme
-            
             void AddWmeToWmeMap(int64_t clientTimeTag, wme* w);
+            // Any wme in working memory, through the kernel's timetag index
             wme* FindWmeFromKernelTimetag(uint64_t timetag);
             static void InputWmeGarbageCollectedHandler(agent* pAgent, int eventID, void* pData, void* pCallData) ;
             
@@ -95,6 +95,7 @@ void KernelSML::BuildCommandMap()
     m_CommandMap[sml_Names::kCommand_ConvertIdentifier] = &sml::KernelSML::HandleConvertIdentifier;
     m_CommandMap[sml_Names::kCommand_GetListenerPort]   = &sml::KernelSML::HandleGetListenerPort;
     m_CommandMap[sml_Names::kCommand_SVSInput] = &sml::KernelSML::HandleSVSInput;
+    m_CommandMap[sml_Names::kCommand_SVSBinaryInput] = &sml::KernelSML::HandleSVSBinaryInput;
     m_CommandMap[sml_Names::kCommand_SVSOutput] = &sml::KernelSML::HandleSVSOutput;
     m_CommandMap[sml_Names::kCommand_SVSQuery] = &sml::KernelSML::HandleSVSQuery;
 }
@@ -1194,6 +1195,39 @@ bool KernelSML::HandleSVSInput(AgentSML* pAgentSML, char const* pCommandName, Co
     return true;
 }
 
+// Binary scene updates carry raw bytes (including nulls), so they come in as
+// binary character data on the <arg> rather than through GetArgString.
+bool KernelSML::HandleSVSBinaryInput(AgentSML* pAgentSML, char const* pCommandName, Connection* pConnection, AnalyzeXML* pIncoming, soarxml::ElementXML* pResponse)
+{
+#ifndef NO_SVS
+    if (pAgentSML->GetSoarAgent()->svs->is_enabled())
+    {
+#endif
+        ElementXML_Handle hArg = pIncoming->GetArgHandle(sml_Names::kParamLine) ;
+        if (!hArg)
+        {
+            return InvalidArg(pConnection, pResponse, pCommandName, "Binary data missing") ;
+        }
+#ifndef NO_SVS
+        soarxml::ElementXML arg(hArg) ;
+        int length = arg.GetCharacterDataLength() ;
+        if (!arg.IsCharacterDataBinary() && length > 0)
+        {
+            // The string form counts the terminating null
+            --length ;
+        }
+        std::string data(arg.GetCharacterData(), length) ;
+        
+        // The handle still belongs to the incoming message
+        arg.Detach() ;
+        
+        pAgentSML->GetSoarAgent()->svs->add_input(data);
+        return true;
+    }
+#endif
+    return true;
+}
+
 bool KernelSML::HandleSVSOutput(AgentSML* pAgentSML, char const* pCommandName, Connection* pConnection, AnalyzeXML* pIncoming, soarxml::ElementXML* pResponse)
 {
     std::string s;
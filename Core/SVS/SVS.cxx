@@ -6,6 +6,7 @@
 #include "src/commands/copy_node.cpp"
 #include "src/commands/copy_transform.cpp"
 #include "src/commands/delete_node.cpp"
+#include "src/commands/subscribe.cpp"
 
 #include "src/filters/axis_distance.cpp"
 #include "src/filters/axis_relation.cpp"
@@ -14,6 +15,7 @@
 #include "src/filters/contain.cpp"
 #include "src/filters/distance.cpp"
 #include "src/filters/intersect.cpp"
+#include "src/filters/line_of_sight.cpp"
 #include "src/filters/monitor_object.cpp"
 #include "src/filters/node.cpp"
 #include "src/filters/occlusion.cpp"
@@ -25,14 +27,19 @@
 #include "src/command.cpp"
 #include "src/command_table.cpp"
 #include "src/common.cpp"
+#include "src/convex_batch.cpp"
 #include "src/drawer.cpp"
 #include "src/filter.cpp"
 #include "src/filter_input.cpp"
 #include "src/filter_table.cpp"
 #include "src/mat.cpp"
+#include "src/ray_cast.cpp"
 #include "src/scene.cpp"
+#include "src/scene_bvh.cpp"
 #include "src/serialize.cpp"
+#include "src/sgel_batch.cpp"
 #include "src/sgnode.cpp"
 #include "src/sgnode_algs.cpp"
 #include "src/soar_interface.cpp"
 #include "src/svs.cpp"
+#include "src/vertex_buffer.cpp"
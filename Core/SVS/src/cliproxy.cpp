@@ -43,12 +43,12 @@ void cliproxy::proxy_use(const std::string& path, const std::vector<std::string>
 
         partition(path, child, rest);
 
-        if(proxy_uppercase_paths()) {
-            // uppercase child
+        proxy_get_children(c);
+        if(!has(c, child) && proxy_uppercase_paths()) {
+            // uppercase child, so s1 finds S1 without hiding lowercase children
             std::transform(child.begin(), child.end(), child.begin(), ::toupper);
         }
 
-        proxy_get_children(c);
         if (has(c, child))
         {
             c[child]->proxy_use(rest, args, os);
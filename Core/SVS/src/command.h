@@ -26,9 +26,34 @@ class command
             return update_sub();
         }
         
+        /*
+         The two halves of update used when read commands are updated in
+         parallel (see svs::update_read_cmds). begin_update does the working
+         memory side of the update and returns a filter whose update() is
+         safe to run on another thread, or NULL if the command is already
+         fully updated. For a returned filter, end_update is then called with
+         the result of its update() and writes the results back.
+        */
+        virtual filter* begin_update()
+        {
+            update();
+            return NULL;
+        }
+        virtual bool end_update(bool filter_ok)
+        {
+            return filter_ok;
+        }
+        
         command(svs_state* state, Symbol* root);
         virtual ~command();
         
+        /*
+         Called when the state's scene is about to swap its nodes for an
+         identical copy. Commands holding sgnode pointers, directly or
+         through filters, should drop them and rebuild on the next update.
+        */
+        virtual void reset_scene_refs() {}
+        
         /* check if any substructure in the command changed */
         bool changed();
         
@@ -30,6 +30,8 @@ command_table_entry* delete_node_command_entry();
 command_table_entry* set_tag_command_entry();
 command_table_entry* delete_tag_command_entry();
 
+command_table_entry* subscribe_command_entry();
+
 
 command_table::command_table()
 {
@@ -47,6 +49,8 @@ command_table::command_table()
     add(set_tag_command_entry());
     add(delete_tag_command_entry());
 
+    add(subscribe_command_entry());
+
 }
 
 command* command_table::make_command(svs_state* state, wme* w)
@@ -145,6 +145,12 @@ class copy_transform_command : public command
 
         bool copy_transform()
         {
+            /* parse() looked the nodes up before anything was written */
+            std::string dest_id = dest_node->get_id();
+            std::string source_id = source_node->get_id();
+            dest_node = scn->get_node_for_write(dest_id);
+            source_node = scn->get_node(source_id);
+
 						if(copy_pos)
 						{
 							dest_node->set_trans('p', source_node->get_trans('p'));
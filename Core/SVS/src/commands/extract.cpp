@@ -26,7 +26,7 @@ class extract_command : public command, public filter_input::listener
 {
     public:
         extract_command(svs_state* state, Symbol* root, bool once)
-            : command(state, root), root(root), res_root(NULL), state(state), fltr(NULL), first(true), once(once)
+            : command(state, root), root(root), res_root(NULL), state(state), fltr(NULL), first(true), once(once), stale(false), deferring(false)
         {
             si = state->get_svs()->get_soar_interface();
         }
@@ -46,47 +46,47 @@ class extract_command : public command, public filter_input::listener
 
         bool update_sub()
         {
-            if (!once && !first && !svs::get_filter_dirty_bit())
+            bool ok;
+            filter* f = prepare_filter(ok);
+            if (!f)
             {
-                // Don't update filter results if the dirty bit is false
-                return true;
+                return ok;
             }
-
-            if (!res_root)
             {
-                res_root = si->get_wme_val(si->make_id_wme(root, "result"));
+                stage_timer timer(state->get_svs()->get_timers(), timer_name.c_str());
+                ok = f->update();
             }
+            return write_results(ok);
+        }
 
-            if (changed())
+        filter* begin_update()
+        {
+            bool ok;
+            filter* f = prepare_filter(ok);
+            if (f)
             {
-                clear_results();
-                if (fltr)
-                {
-                    delete fltr;
-                }
-
-                fltr = parse_filter_spec(state->get_svs()->get_soar_interface(), root, state->get_scene());
-                if (!fltr)
-                {
-                    set_status("incorrect filter syntax");
-                    return false;
-                }
-                fltr->listen_for_input(this);
-                first = true;
+                deferring = true;
             }
+            return f;
+        }
 
-            if (fltr && (!once || first))
+        bool end_update(bool filter_ok)
+        {
+            deferring = false;
+            fltr->flush_status();
+            bool ok = write_results(filter_ok);
+
+            /*
+             Parameter changes seen during the update are written after the
+             results, once the records of removed outputs (whose parameters
+             may already be gone) have been dropped.
+            */
+            for (size_t i = 0, iend = deferred_changes.size(); i < iend; ++i)
             {
-                if (!fltr->update())
-                {
-                    clear_results();
-                    return false;
-                }
-                update_results();
-                fltr->get_output()->clear_changes();
-                first = false;
+                handle_ctlist_change(deferred_changes[i]);
             }
-            return true;
+            deferred_changes.clear();
+            return ok;
         }
 
         int command_type()
@@ -94,6 +94,18 @@ class extract_command : public command, public filter_input::listener
             return SVS_READ_COMMAND;
         }
 
+        void reset_scene_refs()
+        {
+            clear_results();
+            if (fltr)
+            {
+                delete fltr;
+                fltr = NULL;
+            }
+            stale = true;
+            first = true;
+        }
+
         void reset_results()
         {
             clear_results();
@@ -140,6 +152,76 @@ class extract_command : public command, public filter_input::listener
         }
 
     private:
+        /*
+         Does everything in an update up to running the filter. Returns the
+         filter to run, or NULL with ok set to the update's result.
+        */
+        filter* prepare_filter(bool& ok)
+        {
+            ok = true;
+            if (!once && !first && !svs::get_filter_dirty_bit())
+            {
+                // Don't update filter results if the dirty bit is false
+                return NULL;
+            }
+
+            if (changed() || stale)
+            {
+                stale = false;
+                clear_results();
+                if (fltr)
+                {
+                    delete fltr;
+                }
+
+                fltr = parse_filter_spec(state->get_svs()->get_soar_interface(), root, state->get_scene());
+                if (!fltr)
+                {
+                    make_result_root();
+                    set_status("incorrect filter syntax");
+                    ok = false;
+                    return NULL;
+                }
+                fltr->listen_for_input(this);
+                timer_name = "filter " + fltr->get_type();
+                first = true;
+            }
+
+            if (fltr && (!once || first))
+            {
+                return fltr;
+            }
+            make_result_root();
+            return NULL;
+        }
+
+        /*
+         Made when results are written rather than before the filter runs,
+         so working memory changes come out in the same order whether or
+         not filters are updated in parallel.
+        */
+        void make_result_root()
+        {
+            if (!res_root)
+            {
+                res_root = si->get_wme_val(si->make_id_wme(root, "result"));
+            }
+        }
+
+        bool write_results(bool filter_ok)
+        {
+            make_result_root();
+            if (!filter_ok)
+            {
+                clear_results();
+                return false;
+            }
+            update_results();
+            fltr->get_output()->clear_changes();
+            first = false;
+            return true;
+        }
+
         wme* make_filter_val_wme(Symbol* id, const std::string& attr, filter_val* v)
         {
             int iv;
@@ -293,6 +375,13 @@ class extract_command : public command, public filter_input::listener
         {
             record_map::iterator i;
 
+            if (deferring)
+            {
+                // on a worker thread, so no working memory changes
+                deferred_changes.push_back(p);
+                return;
+            }
+
             for (i = records.begin(); i != records.end(); ++i)
             {
                 if (i->second.params == p)
@@ -311,7 +400,10 @@ class extract_command : public command, public filter_input::listener
         svs_state*      state;
         soar_interface* si;
         filter*         fltr;
-        bool            first, once;
+        bool            first, once, stale, deferring;
+        std::string     timer_name;
+
+        std::vector<const filter_params*> deferred_changes;
 
         struct record
         {
@@ -52,7 +52,7 @@ class set_tag_command : public command
                 return true;
             }
 
-            sgnode* n = scn->get_node(id);
+            sgnode* n = scn->get_node_for_write(id);
             if (!n)
             {
                 set_status(std::string("Couldn't find node ") + id);
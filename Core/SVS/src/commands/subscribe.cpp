@@ -0,0 +1,101 @@
+/**********************************************************
+ *
+ * File: commands/subscribe.cpp
+ * Contains:
+ *  class subscribe_command
+ *
+ *  Soar Command to mirror a node and its descendants on the
+ *    scene link while the command is on the command link.
+ *    Only matters when sparse mirroring is on (svs mirror sparse),
+ *    every node is mirrored otherwise.
+ *  Parameters:
+ *     ^id <string> - id of the node to mirror, which doesn't
+ *                    have to be in the scene yet
+ **********************************************************/
+#include <string>
+#include "command.h"
+#include "svs.h"
+#include "soar_interface.h"
+#include "symbol.h"
+#include "command_table.h"
+
+class subscribe_command : public command
+{
+    public:
+        subscribe_command(svs_state* state, Symbol* root)
+            : command(state, root), state(state), root(root), subscribed(false)
+        {
+            si = state->get_svs()->get_soar_interface();
+        }
+
+        ~subscribe_command()
+        {
+            if (subscribed)
+            {
+                state->unsubscribe(id);
+            }
+        }
+
+        std::string description()
+        {
+            return std::string("subscribe");
+        }
+
+        int command_type()
+        {
+            return SVS_READ_COMMAND;
+        }
+
+        bool update_sub()
+        {
+            if (!changed())
+            {
+                return subscribed;
+            }
+
+            if (subscribed)
+            {
+                state->unsubscribe(id);
+                subscribed = false;
+            }
+
+            wme* idwme;
+            if (!si->find_child_wme(root, "id", idwme))
+            {
+                set_status("no node id specified");
+                return false;
+            }
+            if (!get_symbol_value(si->get_wme_val(idwme), id))
+            {
+                set_status("node id must be a string");
+                return false;
+            }
+
+            state->subscribe(id);
+            subscribed = true;
+            set_status("success");
+            return true;
+        }
+
+    private:
+        svs_state*      state;
+        Symbol*         root;
+        soar_interface* si;
+        std::string     id;
+        bool            subscribed;
+};
+
+command* _make_subscribe_command_(svs_state* state, Symbol* root)
+{
+    return new subscribe_command(state, root);
+}
+
+command_table_entry* subscribe_command_entry()
+{
+    command_table_entry* e = new command_table_entry();
+    e->name = "subscribe";
+    e->description = "Mirrors a node on the scene link when mirroring is sparse";
+    e->parameters["id"] = "Id of the node to mirror, with its descendants";
+    e->create = &_make_subscribe_command_;
+    return e;
+}
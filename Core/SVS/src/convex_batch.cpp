@@ -0,0 +1,327 @@
+#include "convex_batch.h"
+
+#include <algorithm>
+#include <limits>
+#include "sgnode.h"
+#include "ccd/ccd.h"
+#include "params.h"
+
+static void batch_ccd_support(const void* obj, const ccd_vec3_t* dir, ccd_vec3_t* v)
+{
+    const convex_batch::support_data* s = static_cast<const convex_batch::support_data*>(obj);
+    vec3 d(dir->v[0], dir->v[1], dir->v[2]), out;
+
+    s->owner->support(*s, d, out);
+    for (int i = 0; i < 3; ++i)
+    {
+        v->v[i] = out(i);
+    }
+}
+
+convex_batch::convex_batch()
+{}
+
+size_t convex_batch::add_distance(const sgnode* a, const sgnode* b)
+{
+    query q;
+    q.a = a;
+    q.b = b;
+    q.intersect_only = false;
+    q.dist = 0.0;
+    q.hit = false;
+    queries.push_back(q);
+    return queries.size() - 1;
+}
+
+size_t convex_batch::add_intersects(const sgnode* a, const sgnode* b)
+{
+    size_t i = add_distance(a, b);
+    queries[i].intersect_only = true;
+    return i;
+}
+
+size_t convex_batch::add_segment(const vec3& p1, const vec3& p2, const sgnode* b)
+{
+    size_t i = add_distance(NULL, b);
+    queries[i].intersect_only = true;
+    queries[i].p1 = p1;
+    queries[i].p2 = p2;
+    return i;
+}
+
+void convex_batch::clear()
+{
+    queries.clear();
+}
+
+void convex_batch::run()
+{
+    setup_supports();
+    for (size_t i = 0, iend = queries.size(); i < iend; ++i)
+    {
+        if (queries[i].a)
+        {
+            run_query(queries[i]);
+        }
+        else
+        {
+            run_segment_query(queries[i]);
+        }
+    }
+}
+
+void convex_batch::support(const support_data& s, const vec3& dir, vec3& out) const
+{
+    switch (s.kind)
+    {
+        case support_data::POINT:
+            out = s.center;
+            break;
+        case support_data::CONVEX:
+        {
+            Eigen::RowVectorXd::Index best;
+            dots.head(s.num_verts).noalias() = dir.transpose() * verts.middleCols(s.first_vert, s.num_verts);
+            dots.head(s.num_verts).maxCoeff(&best);
+            out = verts.col(s.first_vert + best);
+            break;
+        }
+        case support_data::BALL:
+            out = s.linear * (s.radius * (s.linear.transpose() * dir).normalized()) + s.center;
+            break;
+        case support_data::SEGMENT:
+            out = dir.dot(s.end - s.center) > 0.0 ? s.end : s.center;
+            break;
+    }
+}
+
+/*
+ Collects every geometry node used by the queued pairs and fills in its
+ world-space support data. Convex nodes get their world vertices copied
+ into consecutive columns of verts.
+*/
+void convex_batch::setup_supports()
+{
+    geoms.clear();
+    for (size_t i = 0, iend = queries.size(); i < iend; ++i)
+    {
+        if (queries[i].a)
+        {
+            queries[i].a->walk_geoms(geoms);
+        }
+        queries[i].b->walk_geoms(geoms);
+    }
+    std::sort(geoms.begin(), geoms.end());
+    geoms.erase(std::unique(geoms.begin(), geoms.end()), geoms.end());
+
+    size_t total_verts = 0, max_verts = 0;
+    for (size_t i = 0, iend = geoms.size(); i < iend; ++i)
+    {
+        const convex_node* c = dynamic_cast<const convex_node*>(geoms[i]);
+        if (c)
+        {
+            size_t n = c->get_verts().size();
+            total_verts += n;
+            max_verts = std::max(max_verts, n);
+        }
+    }
+    if (static_cast<size_t>(verts.cols()) < total_verts)
+    {
+        verts.resize(3, total_verts);
+    }
+    if (static_cast<size_t>(dots.size()) < max_verts)
+    {
+        dots.resize(max_verts);
+    }
+
+    supports.resize(geoms.size());
+    size_t next_vert = 0;
+    for (size_t i = 0, iend = geoms.size(); i < iend; ++i)
+    {
+        support_data& s = supports[i];
+        const transform3& t = geoms[i]->get_world_trans();
+        s.owner = this;
+        s.center = t(vec3(0.0, 0.0, 0.0));
+        s.linear = t.get_linear();
+        s.radius = 0.0;
+        s.first_vert = 0;
+        s.num_verts = 0;
+
+        const convex_node* c = dynamic_cast<const convex_node*>(geoms[i]);
+        const ball_node* b = dynamic_cast<const ball_node*>(geoms[i]);
+        if (c && !c->get_verts().empty())
+        {
+            const ptlist& w = c->get_world_verts();
+            s.kind = support_data::CONVEX;
+            s.first_vert = next_vert;
+            s.num_verts = w.size();
+            for (size_t j = 0, jend = w.size(); j < jend; ++j)
+            {
+                verts.col(next_vert++) = w[j];
+            }
+        }
+        else if (b)
+        {
+            s.kind = support_data::BALL;
+            s.radius = b->get_radius();
+        }
+        else
+        {
+            s.kind = support_data::POINT;
+        }
+    }
+}
+
+size_t convex_batch::support_index(const geometry_node* g) const
+{
+    return std::lower_bound(geoms.begin(), geoms.end(), g) - geoms.begin();
+}
+
+double convex_batch::geom_distance(const support_data& a, const support_data& b) const
+{
+    ccd_t ccd;
+    double dist;
+
+    CCD_INIT(&ccd);
+    ccd.support1       = batch_ccd_support;
+    ccd.support2       = batch_ccd_support;
+    ccd.max_iterations = 100;
+    ccd.dist_tolerance = INTERSECT_THRESH;
+
+    dist = ccdGJKDist(&a, &b, &ccd);
+    return dist > 0.0 ? dist : 0.0;
+}
+
+/*
+ Same cases as convex_distance. Intersection queries stop at the first
+ geometry pair that touches, which gives the same answer as comparing
+ the minimum distance against INTERSECT_THRESH.
+*/
+void convex_batch::run_query(query& q)
+{
+    q.dist = 0.0;
+    q.hit = true;
+
+    if (q.a == q.b || q.a->has_descendent(q.b) || q.b->has_descendent(q.a))
+    {
+        return;
+    }
+    if (q.intersect_only && !q.a->get_bounds().intersects(q.b->get_bounds()))
+    {
+        q.hit = false;
+        q.dist = std::numeric_limits<double>::infinity();
+        return;
+    }
+
+    ga.clear();
+    gb.clear();
+    q.a->walk_geoms(ga);
+    q.b->walk_geoms(gb);
+
+    if (ga.empty() && gb.empty())
+    {
+        q.dist = (q.a->get_centroid() - q.b->get_centroid()).norm();
+        q.hit = q.dist < INTERSECT_THRESH;
+        return;
+    }
+
+    support_data point;
+    point.kind = support_data::POINT;
+    point.owner = this;
+    if (ga.empty())
+    {
+        point.center = q.a->get_centroid();
+    }
+    else if (gb.empty())
+    {
+        point.center = q.b->get_centroid();
+    }
+
+    double best = std::numeric_limits<double>::infinity();
+    const std::vector<const geometry_node*>& outer = ga.empty() ? gb : ga;
+    const std::vector<const geometry_node*>& inner = gb.empty() ? ga : gb;
+    bool point_query = ga.empty() || gb.empty();
+
+    for (size_t i = 0, iend = outer.size(); i < iend; ++i)
+    {
+        const support_data& s1 = supports[support_index(outer[i])];
+        for (size_t j = 0, jend = point_query ? 1 : inner.size(); j < jend; ++j)
+        {
+            double d;
+            if (point_query)
+            {
+                d = geom_distance(point, s1);
+            }
+            else
+            {
+                if (outer[i]->get_bounds().distance(inner[j]->get_bounds()) > best)
+                {
+                    continue;
+                }
+                d = geom_distance(s1, supports[support_index(inner[j])]);
+            }
+            if (d < best)
+            {
+                best = d;
+            }
+            if (q.intersect_only && best < INTERSECT_THRESH)
+            {
+                q.dist = best;
+                return;
+            }
+        }
+    }
+    q.dist = best;
+    q.hit = best < INTERSECT_THRESH;
+}
+
+/*
+ A segment is tested the way convex_occlusion tested its view line
+ nodes: against every geometry under b, or against b's centroid if b has
+ no geometry, with a hit only when the distance comes out 0.
+*/
+void convex_batch::run_segment_query(query& q)
+{
+    support_data seg;
+    seg.kind = support_data::SEGMENT;
+    seg.owner = this;
+    seg.center = q.p1;
+    seg.end = q.p2;
+
+    q.dist = std::numeric_limits<double>::infinity();
+    q.hit = false;
+
+    gb.clear();
+    q.b->walk_geoms(gb);
+    if (gb.empty())
+    {
+        support_data point;
+        point.kind = support_data::POINT;
+        point.owner = this;
+        point.center = q.b->get_centroid();
+        q.dist = geom_distance(seg, point);
+        q.hit = q.dist <= 0.0;
+        return;
+    }
+
+    vec3 pad(INTERSECT_THRESH, INTERSECT_THRESH, INTERSECT_THRESH);
+    bbox seg_box(q.p1);
+    seg_box.include(q.p2);
+    seg_box = bbox(seg_box.get_min() - pad, seg_box.get_max() + pad);
+    for (size_t i = 0, iend = gb.size(); i < iend; ++i)
+    {
+        if (!gb[i]->get_bounds().intersects(seg_box))
+        {
+            continue;
+        }
+        double d = geom_distance(seg, supports[support_index(gb[i])]);
+        if (d < q.dist)
+        {
+            q.dist = d;
+        }
+        if (d <= 0.0)
+        {
+            q.hit = true;
+            return;
+        }
+    }
+}
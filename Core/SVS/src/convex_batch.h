@@ -0,0 +1,108 @@
+#ifndef CONVEX_BATCH_H
+#define CONVEX_BATCH_H
+
+/*
+ Computes convex_distance and convex_intersects for many pairs of nodes
+ at once.
+
+ The one-pair functions in sgnode_algs go through geometry_node's virtual
+ support function for every support point GJK asks for, and redo the
+ world transform each time. A batch instead sets up the world-space
+ support data for each geometry node once, no matter how many pairs it
+ appears in. Convex vertices are packed column-wise into one matrix, so
+ a support query is a single Eigen product into a preallocated buffer.
+ A batch keeps its buffers between runs, so reusing the same batch
+ object does no allocation once the buffers are big enough.
+
+ Results are the same as convex_distance and convex_intersects. Geometry
+ pairs whose bounding boxes are further apart than the best distance
+ found so far for the same node pair are skipped.
+*/
+
+#include <vector>
+#include "mat.h"
+
+class sgnode;
+class geometry_node;
+
+class convex_batch
+{
+    public:
+        convex_batch();
+
+        /* Queue a pair and return its index for distance() or intersects() */
+        size_t add_distance(const sgnode* a, const sgnode* b);
+        size_t add_intersects(const sgnode* a, const sgnode* b);
+
+        /*
+         Queue a test of whether the segment from p1 to p2 touches b.
+         intersects() is true when the hull distance is 0, as for the
+         view line nodes convex_occlusion used to test.
+        */
+        size_t add_segment(const vec3& p1, const vec3& p2, const sgnode* b);
+
+        void run();
+        void clear();
+
+        size_t size() const
+        {
+            return queries.size();
+        }
+
+        double distance(size_t i) const
+        {
+            return queries[i].dist;
+        }
+
+        bool intersects(size_t i) const
+        {
+            return queries[i].hit;
+        }
+
+        /* World-space support data for one geometry, read by the ccd callbacks */
+        struct support_data
+        {
+            enum kind_type { POINT, CONVEX, BALL, SEGMENT };
+
+            kind_type                  kind;
+            vec3                       center;
+            vec3                       end;          // other endpoint of a SEGMENT
+            Eigen::Matrix3d            linear;
+            double                     radius;
+            size_t                     first_vert;
+            size_t                     num_verts;
+            const convex_batch*        owner;
+        };
+
+        /* Support point of s in direction dir, called from the ccd callbacks */
+        void support(const support_data& s, const vec3& dir, vec3& out) const;
+
+    private:
+        struct query
+        {
+            const sgnode* a;              // NULL for a segment query
+            const sgnode* b;
+            vec3          p1, p2;
+            bool          intersect_only;
+            double        dist;
+            bool          hit;
+        };
+
+        void   setup_supports();
+        void   run_query(query& q);
+        void   run_segment_query(query& q);
+        size_t support_index(const geometry_node* g) const;
+        double geom_distance(const support_data& a, const support_data& b) const;
+
+        std::vector<query>                       queries;
+        std::vector<const geometry_node*>        geoms;
+        std::vector<support_data>                supports;
+        std::vector<const geometry_node*>        ga, gb;
+
+        Eigen::Matrix<double, 3, Eigen::Dynamic> verts;
+
+        /* Support query scratch; the ccd callbacks only see const data */
+        mutable Eigen::RowVectorXd               dots;
+};
+
+#endif
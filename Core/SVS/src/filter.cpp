@@ -4,10 +4,19 @@
 #include <iterator>
 #include <utility>
 #include <iostream>
+#include <atomic>
 
 #include "scene.h"
 #include "sgnode.h"
 
+/* Filters can set their outputs from several worker threads at once */
+static std::atomic<unsigned long> last_filter_val_version(0);
+
+unsigned long next_filter_val_version()
+{
+    return ++last_filter_val_version;
+}
+
 /**********************************************
  * member functions for filter_val_c<sgnode*>
  ***********************************************/
@@ -30,8 +39,10 @@ std::string filter_val_c<sgnode*>::toString() const
  * filter
  ********/
 
+bool filter::defer_status = false;
+
 filter::filter(Symbol* root, soar_interface* si, filter_input* in)
-    : input(in), si(si), root(root), status_wme(NULL)
+    : input(in), status_pending(false), si(si), root(root), status_wme(NULL)
 {
     if (input == NULL)
     {
@@ -55,6 +66,25 @@ void filter::set_status(const std::string& msg)
         return;
     }
     status = msg;
+    status_pending = true;
+    if (!defer_status)
+    {
+        write_status();
+    }
+}
+
+void filter::flush_status()
+{
+    input->flush_status();
+    if (status_pending)
+    {
+        write_status();
+    }
+}
+
+void filter::write_status()
+{
+    status_pending = false;
     if (status_wme)
     {
         si->remove_wme(status_wme);
@@ -129,6 +129,19 @@ class filter
 
         void set_status(const std::string& msg);
 
+        /*
+         While status changes are deferred, set_status only remembers the
+         new status. flush_status then writes it to working memory for this
+         filter and everything feeding into it. This lets filter trees be
+         updated on worker threads, which must not touch working memory.
+         Only change the deferral setting while no filter is updating.
+        */
+        static void defer_status_changes(bool defer)
+        {
+            defer_status = defer;
+        }
+        void flush_status();
+
         void add_output(filter_val* fv)
         {
             output.add(fv);
@@ -172,6 +185,16 @@ class filter
             p = NULL;
         }
 
+        /* Name of the filter table entry this filter was made from, if any */
+        const std::string& get_type() const
+        {
+            return type;
+        }
+        void set_type(const std::string& t)
+        {
+            type = t;
+        }
+
     protected:
         virtual void clear_output()
         {
@@ -183,12 +206,18 @@ class filter
         virtual bool update_outputs() = 0;
 
     private:
+        void write_status();
+
         filter_input* input;
         filter_output output;
+        std::string type;
         std::string status;
+        bool status_pending;
         soar_interface* si;
         Symbol* root;
         wme* status_wme;
+
+        static bool defer_status;
 };
 
 /******************************
@@ -364,16 +393,15 @@ class typed_filter<sgnode*> : public filter, public sgnode_listener
                 }
                 remove_output(p);
             }
-            else if (v != NULL)
-            {
-                // Create a new output for the given sgnode
-                fv = new filter_val_c<sgnode*>(v);
-            }
             if (v == NULL)
             {
                 return;
             }
 
+            // Create a new output for the given sgnode (the old one, if
+            // any, now belongs to the output list's removed items)
+            fv = new filter_val_c<sgnode*>(v);
+
             // Check to see if we've seen the node before
             std::map<sgnode*, std::set<filter_val*> >::iterator o_it = outputs.find(v);
             if (o_it == outputs.end())
@@ -676,7 +704,7 @@ class rank_filter : public typed_filter<double>
             select_highest = sel_highest;
         }
 
-    private:
+    protected:
 
         virtual bool update_outputs()
         {
@@ -768,6 +796,7 @@ class rank_filter : public typed_filter<double>
             return true;
         }
 
+    private:
         std::map<const filter_params*, double> elems;
         const filter_params* best_input;
         bool select_highest;
@@ -37,6 +37,14 @@ bool filter_input::update()
     return true;
 }
 
+void filter_input::flush_status()
+{
+    for (size_t i = 0, iend = input_info.size(); i < iend; ++i)
+    {
+        input_info[i].in_fltr->flush_status();
+    }
+}
+
 void filter_input::add_param(std::string name, filter* in_fltr)
 {
     param_info i;
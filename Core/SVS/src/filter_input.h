@@ -70,6 +70,9 @@ class filter_input : public change_tracking_list<filter_params>
         bool update();
         void add_param(std::string name, filter* f);
         
+        /* Writes out deferred status changes of the input filters; see filter::flush_status */
+        void flush_status();
+        
         virtual void combine(const input_table& inputs) = 0;
         
         virtual void clear();
@@ -26,6 +26,8 @@ filter_table_entry* distance_filter_entry();
 filter_table_entry* distance_select_filter_entry();
 filter_table_entry* closest_filter_entry();
 filter_table_entry* farthest_filter_entry();
+filter_table_entry* nearest_filter_entry();
+filter_table_entry* within_distance_filter_entry();
 
 // filters/volume.cpp
 filter_table_entry* volume_filter_entry();
@@ -58,6 +60,9 @@ filter_table_entry* contain_select_filter_entry();
 // filters/occlusion.cpp
 filter_table_entry* occlusion_filter_entry();
 
+// filters/line_of_sight.cpp
+filter_table_entry* line_of_sight_filter_entry();
+
 // filters/overlap.cpp
 filter_table_entry* overlap_filter_entry();
 filter_table_entry* overlap_select_filter_entry();
@@ -86,6 +91,8 @@ filter_table::filter_table()
     add(distance_select_filter_entry());
     add(closest_filter_entry());
     add(farthest_filter_entry());
+    add(nearest_filter_entry());
+    add(within_distance_filter_entry());
 
     add(volume_filter_entry());
     add(volume_select_filter_entry());
@@ -110,6 +117,7 @@ filter_table::filter_table()
     add(contain_select_filter_entry());
 
 		add(occlusion_filter_entry());
+    add(line_of_sight_filter_entry());
 
 		add(overlap_filter_entry());
 		add(overlap_select_filter_entry());
@@ -149,7 +157,22 @@ filter* filter_table::make_filter(const std::string& pred, Symbol* root, soar_in
     {
         return NULL;
     }
-    return (*(i->second->create))(root, si, scn, input);
+    filter* f = (*(i->second->create))(root, si, scn, input);
+    if (f)
+    {
+        f->set_type(pred);
+    }
+    return f;
+}
+
+filter_input* filter_table::make_input(const std::string& pred, scene* scn) const
+{
+    std::map<std::string, filter_table_entry*>::const_iterator i = t.find(pred);
+    if (i == t.end() || i->second->create_input == NULL)
+    {
+        return NULL;
+    }
+    return (*(i->second->create_input))(scn);
 }
 
 void filter_table::add(filter_table_entry* e)
@@ -160,7 +183,7 @@ void filter_table::add(filter_table_entry* e)
 
 
 filter_table_entry::filter_table_entry()
-    : create(NULL), description("")
+    : create(NULL), create_input(NULL), description("")
 {
     set_help("Reports information about this filter type.");
 }
@@ -251,7 +274,7 @@ filter* parse_filter_spec(soar_interface* si, Symbol* root, scene* scn)
     {
         input = new null_filter_input();
     }
-    else
+    else if (!(input = get_filter_table().make_input(ftype, scn)))
     {
         input = new product_filter_input();
     }
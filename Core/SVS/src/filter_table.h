@@ -25,6 +25,9 @@ class filter_table_entry : public cliproxy
         
         filter* (*create)(Symbol*, soar_interface*, scene*, filter_input*);
         
+        /* Optional; makes the input used instead of the cartesian product */
+        filter_input* (*create_input)(scene*);
+        
         std::string name;
         std::string description;
         std::map<std::string, std::string> parameters;
@@ -38,6 +41,7 @@ class filter_table : public cliproxy
         friend filter_table& get_filter_table();
         
         filter* make_filter(const std::string& pred, Symbol* root, soar_interface* si, scene* scn, filter_input* input) const;
+        filter_input* make_input(const std::string& pred, scene* scn) const;
         
     private:
         filter_table();
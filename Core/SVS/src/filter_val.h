@@ -25,12 +25,16 @@
 
 class sgnode;
 
+/* Returns a filter_val version that hasn't been used before; see filter_val::get_version */
+unsigned long next_filter_val_version();
+
 /*
  Wrapper for all filter value types so we can cache them uniformly.
 */
 class filter_val
 {
     public:
+        filter_val() : version(next_filter_val_version()) {}
         virtual ~filter_val() {}
         virtual void get_rep(std::map<std::string, std::string>& rep) const = 0;
         virtual filter_val* clone() const = 0;
@@ -39,6 +43,25 @@ class filter_val
         virtual std::string toString() const = 0;
         virtual bool is_dirty() const = 0;
         virtual void reset_dirty() = 0;
+        
+        /*
+         Changes whenever the value does. Versions are never reused, even by
+         other values, so a filter_val together with its version identifies
+         one particular value without comparing it.
+        */
+        unsigned long get_version() const
+        {
+            return version;
+        }
+        
+    protected:
+        void value_changed()
+        {
+            version = next_filter_val_version();
+        }
+        
+    private:
+        unsigned long version;
 };
 
 
@@ -74,6 +97,7 @@ class filter_val_c : public filter_val    // c for concrete
             if (v != c->v)
             {
                 dirty = true;
+                value_changed();
             }
             v = c->v;
             return *this;
@@ -99,6 +123,7 @@ class filter_val_c : public filter_val    // c for concrete
             if (v != n)
             {
                 dirty = true;
+                value_changed();
             }
             v = n;
         }
@@ -175,6 +200,7 @@ class filter_val_c<sgnode*> : public filter_val
             if (v != c->v)
             {
                 dirty = true;
+                value_changed();
             }
             v = c->v;
             return *this;
@@ -200,6 +226,7 @@ class filter_val_c<sgnode*> : public filter_val
             if (v != n)
             {
                 dirty = true;
+                value_changed();
             }
             v = n;
         }
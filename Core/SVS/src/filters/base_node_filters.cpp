@@ -1,7 +1,410 @@
 
 #include "filters/base_node_filters.h"
+#include "sgnode_algs.h"
+#include "scene.h"
+#include "scene_bvh.h"
 
 #include <iostream>
+#include <algorithm>
+
+bool beyond_separation(node_separation* sep, const sgnode* a, const sgnode* b, const filter_params* p)
+{
+    if (!sep)
+    {
+        return false;
+    }
+    double max_dist = sep(p);
+    return max_dist >= 0 && bbox_distance(a, b) > max_dist;
+}
+
+node_cache_counts& get_node_cache_counts()
+{
+    static node_cache_counts counts;
+    return counts;
+}
+
+/*********************************************************
+ * class node_pair_filter_input
+ ********************************************************/
+
+/*
+ Both a and b are needed to look for pairs, so without them there are no
+ parameter sets. The other parameters are normally constants, so any
+ change to them just starts over.
+*/
+void node_pair_filter_input::combine(const input_table& inputs)
+{
+    int ia = -1, ib = -1;
+    bool rest_changed = false;
+    for (size_t i = 0, iend = inputs.size(); i < iend; ++i)
+    {
+        filter_output* o = inputs[i].in_fltr->get_output();
+        if (inputs[i].name == "a")
+        {
+            ia = static_cast<int>(i);
+        }
+        else if (inputs[i].name == "b")
+        {
+            ib = static_cast<int>(i);
+        }
+        else if (o->num_removed() > 0 || o->num_changed() > 0 || o->first_added() < o->num_current())
+        {
+            rest_changed = true;
+        }
+    }
+    if (ia < 0 || ib < 0)
+    {
+        return;
+    }
+    if (!built || rest_changed)
+    {
+        rebuild(inputs, ia, ib);
+        return;
+    }
+
+    filter_output* ao = inputs[ia].in_fltr->get_output();
+    filter_output* bo = inputs[ib].in_fltr->get_output();
+    for (size_t j = 0, jend = ao->num_removed(); j < jend; ++j)
+    {
+        erase_val(ao->get_removed(j));
+    }
+    for (size_t j = 0, jend = bo->num_removed(); j < jend; ++j)
+    {
+        erase_val(bo->get_removed(j));
+    }
+    if (ao->num_removed() > 0 || ao->first_added() < ao->num_current())
+    {
+        index_nodes(ao, a_nodes, a_loose);
+    }
+    if (bo->num_removed() > 0 || bo->first_added() < bo->num_current())
+    {
+        index_nodes(bo, b_nodes, b_loose);
+    }
+
+    /*
+     Whether a pair is a candidate only depends on where its two nodes
+     are, so only the values that are new or whose nodes moved need to
+     look again.
+    */
+    for (size_t j = ao->first_added(), jend = ao->num_current(); j < jend; ++j)
+    {
+        refresh(inputs, ia, ib, ao->get_current(j), true, false);
+    }
+    for (size_t j = 0, jend = ao->num_changed(); j < jend; ++j)
+    {
+        refresh(inputs, ia, ib, ao->get_changed(j), true, true);
+    }
+    for (size_t j = bo->first_added(), jend = bo->num_current(); j < jend; ++j)
+    {
+        refresh(inputs, ia, ib, bo->get_current(j), false, false);
+    }
+    for (size_t j = 0, jend = bo->num_changed(); j < jend; ++j)
+    {
+        refresh(inputs, ia, ib, bo->get_changed(j), false, true);
+    }
+}
+
+void node_pair_filter_input::clear()
+{
+    built = false;
+    rest.clear();
+    keys.clear();
+    val2params.clear();
+    a_nodes.clear();
+    b_nodes.clear();
+    a_loose.clear();
+    b_loose.clear();
+    filter_input::clear();
+}
+
+void node_pair_filter_input::rebuild(const input_table& inputs, int ia, int ib)
+{
+    key_map::iterator i;
+    for (i = keys.begin(); i != keys.end(); ++i)
+    {
+        remove(i->first);
+    }
+    keys.clear();
+    val2params.clear();
+
+    rest.clear();
+    rest.push_back(filter_params());
+    for (size_t j = 0, jend = inputs.size(); j < jend; ++j)
+    {
+        if (static_cast<int>(j) == ia || static_cast<int>(j) == ib)
+        {
+            continue;
+        }
+        filter_output* o = inputs[j].in_fltr->get_output();
+        std::vector<filter_params> next;
+        for (size_t r = 0, rend = rest.size(); r < rend; ++r)
+        {
+            for (size_t v = 0, vend = o->num_current(); v < vend; ++v)
+            {
+                next.push_back(rest[r]);
+                next.back().push_back(std::make_pair(inputs[j].name, o->get_current(v)));
+            }
+        }
+        rest.swap(next);
+    }
+
+    filter_output* ao = inputs[ia].in_fltr->get_output();
+    index_nodes(ao, a_nodes, a_loose);
+    index_nodes(inputs[ib].in_fltr->get_output(), b_nodes, b_loose);
+    for (size_t j = 0, jend = ao->num_current(); j < jend; ++j)
+    {
+        refresh(inputs, ia, ib, ao->get_current(j), true, false);
+    }
+    built = true;
+}
+
+/*
+ Brings the pairs of value v up to date: pairs that are no longer
+ candidates are removed, the ones that still are are marked changed if
+ v's node moved, and new candidates get parameter sets.
+*/
+void node_pair_filter_input::refresh(const input_table& inputs, int ia, int ib, filter_val* v, bool is_a, bool changed)
+{
+    filter_output* other = inputs[is_a ? ib : ia].in_fltr->get_output();
+    for (size_t r = 0, rend = rest.size(); r < rend; ++r)
+    {
+        std::vector<filter_val*> candidates;
+        find_candidates(v, is_a, other, r, candidates);
+        std::set<filter_val*> wanted(candidates.begin(), candidates.end());
+        std::set<filter_val*> kept;
+
+        std::vector<filter_params*> existing = val2params[v];
+        for (size_t j = 0, jend = existing.size(); j < jend; ++j)
+        {
+            const pair_key& k = keys[existing[j]];
+            if (k.rest != r)
+            {
+                continue;
+            }
+            filter_val* o = is_a ? k.b : k.a;
+            if (wanted.find(o) == wanted.end())
+            {
+                erase_pair(existing[j]);
+                continue;
+            }
+            kept.insert(o);
+            if (changed)
+            {
+                change(existing[j]);
+            }
+        }
+
+        for (size_t j = 0, jend = candidates.size(); j < jend; ++j)
+        {
+            if (kept.insert(candidates[j]).second)
+            {
+                pair_key k;
+                k.a = is_a ? v : candidates[j];
+                k.b = is_a ? candidates[j] : v;
+                k.rest = r;
+                add_pair(inputs, ia, ib, k);
+            }
+        }
+    }
+}
+
+/*
+ The values of the other side that v can pair with: those whose nodes the
+ index finds within the separation, plus any that aren't indexed nodes
+ and pass the same test directly. Values that aren't nodes pair with
+ everything so that the filter can report them.
+*/
+void node_pair_filter_input::find_candidates(filter_val* v, bool is_a, filter_output* other, size_t rest_index,
+                                             std::vector<filter_val*>& candidates)
+{
+    double max_dist = sep ? sep(&rest[rest_index]) : -1.0;
+    sgnode* n = NULL;
+    if (max_dist < 0 || !get_filter_val(v, n))
+    {
+        for (size_t i = 0, iend = other->num_current(); i < iend; ++i)
+        {
+            candidates.push_back(other->get_current(i));
+        }
+        return;
+    }
+
+    scene_bvh* index = scn->get_index();
+    const std::vector<filter_val*>& loose = is_a ? b_loose : a_loose;
+    if (!index->contains(n))
+    {
+        for (size_t i = 0, iend = other->num_current(); i < iend; ++i)
+        {
+            sgnode* m;
+            if (!get_filter_val(other->get_current(i), m) || bbox_distance(n, m) <= max_dist)
+            {
+                candidates.push_back(other->get_current(i));
+            }
+        }
+        return;
+    }
+
+    const node2val_map& nodes = is_a ? b_nodes : a_nodes;
+    std::vector<sgnode*> hits;
+    index->query(n->get_bounds(), max_dist, hits);
+    for (size_t i = 0, iend = hits.size(); i < iend; ++i)
+    {
+        node2val_map::const_iterator j = nodes.find(hits[i]);
+        if (j != nodes.end())
+        {
+            candidates.insert(candidates.end(), j->second.begin(), j->second.end());
+        }
+    }
+    for (size_t i = 0, iend = loose.size(); i < iend; ++i)
+    {
+        sgnode* m;
+        if (!get_filter_val(loose[i], m) || bbox_distance(n, m) <= max_dist)
+        {
+            candidates.push_back(loose[i]);
+        }
+    }
+}
+
+void node_pair_filter_input::add_pair(const input_table& inputs, int ia, int ib, const pair_key& k)
+{
+    const filter_params& others = rest[k.rest];
+    filter_params* p = new filter_params();
+    p->reserve(inputs.size());
+    for (size_t i = 0, r = 0, iend = inputs.size(); i < iend; ++i)
+    {
+        if (static_cast<int>(i) == ia)
+        {
+            p->push_back(std::make_pair(inputs[i].name, k.a));
+        }
+        else if (static_cast<int>(i) == ib)
+        {
+            p->push_back(std::make_pair(inputs[i].name, k.b));
+        }
+        else
+        {
+            p->push_back(others[r++]);
+        }
+    }
+    keys[p] = k;
+    val2params[k.a].push_back(p);
+    val2params[k.b].push_back(p);
+    add(p);
+}
+
+void node_pair_filter_input::erase_pair(filter_params* p)
+{
+    key_map::iterator i = keys.find(p);
+    assert(i != keys.end());
+    pair_key k = i->second;
+    std::vector<filter_params*>& al = val2params[k.a];
+    al.erase(std::find(al.begin(), al.end(), p));
+    std::vector<filter_params*>& bl = val2params[k.b];
+    bl.erase(std::find(bl.begin(), bl.end(), p));
+    keys.erase(i);
+    remove(p);
+}
+
+void node_pair_filter_input::erase_val(filter_val* v)
+{
+    val2param_map::iterator i = val2params.find(v);
+    if (i == val2params.end())
+    {
+        return;
+    }
+    std::vector<filter_params*> l = i->second;
+    for (size_t j = 0, jend = l.size(); j < jend; ++j)
+    {
+        erase_pair(l[j]);
+    }
+    val2params.erase(v);
+}
+
+void node_pair_filter_input::index_nodes(filter_output* o, node2val_map& nodes, std::vector<filter_val*>& loose)
+{
+    scene_bvh* index = scn->get_index();
+    nodes.clear();
+    loose.clear();
+    for (size_t i = 0, iend = o->num_current(); i < iend; ++i)
+    {
+        sgnode* n;
+        if (get_filter_val(o->get_current(i), n) && index->contains(n))
+        {
+            nodes[n].push_back(o->get_current(i));
+        }
+        else
+        {
+            loose.push_back(o->get_current(i));
+        }
+    }
+}
+
+static void get_batch_result(const convex_batch& batch, size_t i, bool& r)
+{
+    r = batch.intersects(i);
+}
+
+static void get_batch_result(const convex_batch& batch, size_t i, double& r)
+{
+    r = batch.distance(i);
+}
+
+/*
+ Runs every batchable pair among the added and changed inputs of f that
+ isn't already cached through one convex_batch, and caches the results
+ so that the compute calls in the filter's usual update find them.
+*/
+template <class T>
+static void prefetch_node_pairs(filter* f, node_batch_add* add, node_separation* sep,
+                                node_result_cache<T>& cache, convex_batch& batch)
+{
+    const filter_input* input = f->get_input();
+    std::vector<const filter_params*> queued;
+
+    if (!add || !input)
+    {
+        return;
+    }
+
+    batch.clear();
+    size_t num_added = input->num_current() - input->first_added();
+    for (size_t i = 0, iend = num_added + input->num_changed(); i < iend; ++i)
+    {
+        const filter_params* p;
+        if (i < num_added)
+        {
+            p = input->get_current(input->first_added() + i);
+        }
+        else
+        {
+            p = input->get_changed(i - num_added);
+        }
+
+        sgnode* a = NULL;
+        sgnode* b = NULL;
+        T r;
+        if (!get_filter_param(NULL, p, "a", a) || !get_filter_param(NULL, p, "b", b)
+                || cache.lookup(p, r) || beyond_separation(sep, a, b, p))
+        {
+            continue;
+        }
+        if (add(batch, a, b, p))
+        {
+            queued.push_back(p);
+        }
+    }
+    assert(queued.size() == batch.size());
+    if (queued.empty())
+    {
+        return;
+    }
+
+    batch.run();
+    for (size_t i = 0, iend = queued.size(); i < iend; ++i)
+    {
+        T r;
+        get_batch_result(batch, i, r);
+        cache.store(queued[i], r);
+    }
+}
 
 void node_select_range_filter::set_range_from_params(const filter_params* p){
     double sel_min;
@@ -53,11 +456,29 @@ bool node_test_filter::compute(const filter_params* p, bool& out)
         set_status("Need nodes a and b as input");
         return false;
     }
-    out = test(a, b, p);
+    if (!cache.lookup(p, out))
+    {
+        out = !beyond_separation(max_sep, a, b, p) && test(a, b, p);
+        cache.store(p, out);
+        cache.prune(get_input());
+    }
     return true;
 }
 
 
+bool node_test_filter::update_outputs()
+{
+    prefetch_node_pairs(this, batch_add, max_sep, cache, batch);
+    return map_filter<bool>::update_outputs();
+}
+
+
+bool node_test_select_filter::update_outputs()
+{
+    prefetch_node_pairs(this, batch_add, max_sep, cache, batch);
+    return select_filter<sgnode*>::update_outputs();
+}
+
 bool node_test_select_filter::compute(const filter_params* p, sgnode*& out, bool& select)
 {
     sgnode* a = NULL;
@@ -69,7 +490,14 @@ bool node_test_select_filter::compute(const filter_params* p, sgnode*& out, bool
         return false;
     }
     out = b;
-    if (test(a, b, p) == select_true)
+    bool result;
+    if (!cache.lookup(p, result))
+    {
+        result = !beyond_separation(max_sep, a, b, p) && test(a, b, p);
+        cache.store(p, result);
+        cache.prune(get_input());
+    }
+    if (result == select_true)
     {
         select = true;
     }
@@ -91,10 +519,27 @@ bool node_comparison_filter::compute(const filter_params* p, double& out)
         set_status("Need nodes a and b as input");
         return false;
     }
-    out = comp(a, b, p);
+    if (!cache.lookup(p, out))
+    {
+        out = comp(a, b, p);
+        cache.store(p, out);
+        cache.prune(get_input());
+    }
     return true;
 }
 
+bool node_comparison_filter::update_outputs()
+{
+    prefetch_node_pairs(this, batch_add, NULL, cache, batch);
+    return map_filter<double>::update_outputs();
+}
+
+bool node_comparison_select_filter::update_outputs()
+{
+    prefetch_node_pairs(this, batch_add, max_sep, cache, batch);
+    return node_select_range_filter::update_outputs();
+}
+
 bool node_comparison_select_filter::compute(const filter_params* p, sgnode*& out, bool& select)
 {
     sgnode* a = NULL;
@@ -108,8 +553,19 @@ bool node_comparison_select_filter::compute(const filter_params* p, sgnode*& out
 
 		set_range_from_params(p);
 
-		double res = comp(a, b, p);
 		out = b;
+		if (beyond_separation(max_sep, a, b, p))
+		{
+				select = false;
+				return true;
+		}
+		double res;
+		if (!cache.lookup(p, res))
+		{
+				res = comp(a, b, p);
+				cache.store(p, res);
+				cache.prune(get_input());
+		}
 		select = falls_in_range(res);
     return true;
 }
@@ -126,10 +582,21 @@ bool node_comparison_rank_filter::rank(const filter_params* p, double& r)
         return false;
     }
 
-    r = comp(a, b, p);
+    if (!cache.lookup(p, r))
+    {
+        r = comp(a, b, p);
+        cache.store(p, r);
+        cache.prune(get_input());
+    }
     return true;
 }
 
+bool node_comparison_rank_filter::update_outputs()
+{
+    prefetch_node_pairs(this, batch_add, NULL, cache, batch);
+    return rank_filter::update_outputs();
+}
+
 bool node_evaluation_filter::compute(const filter_params* p, double& out)
 {
     sgnode* a = NULL;
@@ -138,7 +605,12 @@ bool node_evaluation_filter::compute(const filter_params* p, double& out)
         set_status("Need node a input");
         return false;
     }
-    out = eval(a, p);
+    if (!cache.lookup(p, out))
+    {
+        out = eval(a, p);
+        cache.store(p, out);
+        cache.prune(get_input());
+    }
     return true;
 }
 
@@ -154,7 +626,13 @@ bool node_evaluation_select_filter::compute(const filter_params* p, sgnode*& out
 
 		set_range_from_params(p);
 
-    double res = eval(a, p);
+    double res;
+    if (!cache.lookup(p, res))
+    {
+        res = eval(a, p);
+        cache.store(p, res);
+        cache.prune(get_input());
+    }
 		out = a;
 		select = falls_in_range(res);
     return true;
@@ -170,7 +648,12 @@ bool node_evaluation_rank_filter::rank(const filter_params* p, double& r)
         return false;
     }
 
-    r = eval(a, p);
+    if (!cache.lookup(p, r))
+    {
+        r = eval(a, p);
+        cache.store(p, r);
+        cache.prune(get_input());
+    }
     return true;
 }
 
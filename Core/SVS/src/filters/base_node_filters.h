@@ -22,6 +22,52 @@
  *    Settings:
  *      set_select_true(bool) - whether the filter selects nodes if the test is true or false
  *
+ * Node Separation
+ *  double node_separation(fp* p)
+ *    returns the largest bounding box distance between a and b at which
+ *    the test or comparison can still succeed for the given parameters,
+ *    or a negative number if it can succeed at any distance
+ *
+ *  set_max_separation(node_separation*) on node_test_filter,
+ *    node_test_select_filter and node_comparison_select_filter
+ *    gives them a broad phase: pairs whose bounding boxes are further
+ *    apart are treated as failing without calling the test or comparison
+ *
+ * Node Pair Input
+ *  node_pair_filter_input(scene*, node_separation*)
+ *    filter_input used in place of the cartesian product by select
+ *    filters whose failing pairs produce no output. It only makes
+ *    parameter sets for (a, b) pairs that the scene's bounding volume
+ *    hierarchy finds within the separation, and when a node moves it only
+ *    queries the hierarchy again for that node. Any other parameters are
+ *    combined with every pair as in product_filter_input. A filter_table_entry
+ *    asks for one through its create_input function.
+ *
+ * Node Batch
+ *  bool node_batch_add(convex_batch& batch, sgnode* a, sgnode* b, fp* p)
+ *    batched form of a test or comparison: queues exactly one convex_batch
+ *    query for the pair and returns true, or returns false if the pair
+ *    has to go through the ordinary function
+ *
+ *  set_batch(node_batch_add*) on node_test_filter, node_test_select_filter,
+ *    node_comparison_filter, node_comparison_select_filter and
+ *    node_comparison_rank_filter runs every batchable pair among the
+ *    added and changed inputs in one convex_batch before the usual
+ *    per-pair pass, which then finds the results in its cache
+ *
+ * Node Result Cache
+ *  node_result_cache<T>
+ *    remembers the last result computed for each parameter set together
+ *    with the geometry versions of its nodes and the filter_val versions
+ *    of its other parameters, so checking the key never formats or
+ *    compares values. All of the filters below use one, so a parameter
+ *    set that was marked changed without any of its nodes moving (a tag
+ *    change, for example) isn't computed again.
+ *
+ *  get_node_cache_counts()
+ *    hits and computed results over every node_result_cache, shown by
+ *    svs filter_cache
+ *
  * node_select_range_filter
  *   Generic base filter used when you want to select a node
  *   based on a numerical value falling within a specified range
@@ -103,7 +149,13 @@
 #ifndef __BASE_NODE_FILTERS_H__
 #define __BASE_NODE_FILTERS_H__
 
+#include <set>
+#include <atomic>
 #include "filter.h"
+#include "sgnode.h"
+#include "convex_batch.h"
+
+class scene;
 
 /////// Node Functions ///////
 typedef bool node_test(sgnode* a, sgnode* b, const filter_params* p);
@@ -112,6 +164,169 @@ typedef double node_comparison(sgnode* a, sgnode* b, const filter_params* p);
 
 typedef double node_evaluation(sgnode* a, const filter_params* p);
 
+typedef double node_separation(const filter_params* p);
+
+typedef bool node_batch_add(convex_batch& batch, sgnode* a, sgnode* b, const filter_params* p);
+
+/* True if the bounding boxes of a and b are too far apart for sep(p) to allow */
+bool beyond_separation(node_separation* sep, const sgnode* a, const sgnode* b, const filter_params* p);
+
+////// Node Pair Input //////
+class node_pair_filter_input : public filter_input
+{
+    public:
+        node_pair_filter_input(scene* scn, node_separation* sep)
+            : scn(scn), sep(sep), built(false)
+        {}
+        
+        void combine(const input_table& inputs);
+        void clear();
+        
+    private:
+        struct pair_key
+        {
+            filter_val* a;
+            filter_val* b;
+            size_t      rest;
+        };
+        
+        typedef std::map<const filter_params*, pair_key> key_map;
+        typedef std::map<filter_val*, std::vector<filter_params*> > val2param_map;
+        typedef std::map<const sgnode*, std::vector<filter_val*> > node2val_map;
+        
+        void rebuild(const input_table& inputs, int ia, int ib);
+        void refresh(const input_table& inputs, int ia, int ib, filter_val* v, bool is_a, bool changed);
+        void find_candidates(filter_val* v, bool is_a, filter_output* other, size_t rest_index,
+                             std::vector<filter_val*>& candidates);
+        void add_pair(const input_table& inputs, int ia, int ib, const pair_key& k);
+        void erase_pair(filter_params* p);
+        void erase_val(filter_val* v);
+        void index_nodes(filter_output* o, node2val_map& nodes, std::vector<filter_val*>& loose);
+        
+        scene*                      scn;
+        node_separation*            sep;
+        bool                        built;
+        std::vector<filter_params>  rest;   // products of the parameters other than a and b
+        key_map                     keys;
+        val2param_map               val2params;
+        node2val_map                a_nodes, b_nodes;
+        std::vector<filter_val*>    a_loose, b_loose;   // values the index can't find
+};
+
+////// Node Result Cache //////
+struct node_cache_counts
+{
+    node_cache_counts() : hits(0), computed(0) {}
+    
+    std::atomic<unsigned long> hits;
+    std::atomic<unsigned long> computed;
+};
+
+node_cache_counts& get_node_cache_counts();
+
+template <class T>
+class node_result_cache
+{
+    public:
+        node_result_cache() : last_params(NULL) {}
+        
+        /*
+         Looks up the cached result for p. Storing right after a miss
+         for the same p reuses the key computed here.
+         */
+        bool lookup(const filter_params* p, T& result)
+        {
+            make_key(p, last_key);
+            last_params = p;
+            typename entry_map::const_iterator i = entries.find(p);
+            if (i == entries.end() || !(i->second.key == last_key))
+            {
+                return false;
+            }
+            result = i->second.result;
+            ++get_node_cache_counts().hits;
+            return true;
+        }
+        
+        void store(const filter_params* p, const T& result)
+        {
+            if (p != last_params)
+            {
+                make_key(p, last_key);
+                last_params = p;
+            }
+            entry& e = entries[p];
+            e.key = last_key;
+            e.result = result;
+            ++get_node_cache_counts().computed;
+        }
+        
+        /* Drops entries for parameter sets that are no longer in the input */
+        void prune(const filter_input* input)
+        {
+            if (entries.size() <= 2 * input->num_current() + 16)
+            {
+                return;
+            }
+            entry_map live;
+            for (size_t i = 0, iend = input->num_current(); i < iend; ++i)
+            {
+                typename entry_map::iterator j = entries.find(input->get_current(i));
+                if (j != entries.end())
+                {
+                    live.insert(*j);
+                }
+            }
+            entries.swap(live);
+        }
+        
+    private:
+        /*
+         One (identity, version) pair per parameter: the node and its
+         geometry version for nodes, the filter_val and its version for
+         everything else.
+         */
+        struct key_type
+        {
+            std::vector<std::pair<const void*, unsigned long> > parts;
+            
+            bool operator==(const key_type& k) const
+            {
+                return parts == k.parts;
+            }
+        };
+        
+        struct entry
+        {
+            key_type key;
+            T result;
+        };
+        
+        typedef std::map<const filter_params*, entry> entry_map;
+        
+        static void make_key(const filter_params* p, key_type& k)
+        {
+            k.parts.clear();
+            filter_params::const_iterator i;
+            for (i = p->begin(); i != p->end(); ++i)
+            {
+                sgnode* n;
+                if (get_filter_val(i->second, n))
+                {
+                    k.parts.push_back(std::make_pair(static_cast<const void*>(n), n->get_geometry_version()));
+                }
+                else
+                {
+                    k.parts.push_back(std::make_pair(static_cast<const void*>(i->second), i->second->get_version()));
+                }
+            }
+        }
+        
+        entry_map entries;
+        key_type last_key;
+        const filter_params* last_params;
+};
+
 ////// Node Select Range Filter //////
 class node_select_range_filter : public select_filter<sgnode*>
 {
@@ -155,13 +370,27 @@ class node_test_filter : public map_filter<bool>
     public:
         node_test_filter(Symbol* root, soar_interface* si,
                          filter_input* input, node_test* test)
-            : map_filter<bool>(root, si, input), test(test)
+            : map_filter<bool>(root, si, input), test(test), max_sep(NULL), batch_add(NULL)
         {}
         
         bool compute(const filter_params* p, bool& out);
         
+        void set_max_separation(node_separation* sep)
+        {
+            max_sep = sep;
+        }
+        void set_batch(node_batch_add* add)
+        {
+            batch_add = add;
+        }
+    protected:
+        bool update_outputs();
     private:
         node_test* test;
+        node_separation* max_sep;
+        node_result_cache<bool> cache;
+        node_batch_add* batch_add;
+        convex_batch batch;
 };
 
 class node_test_select_filter : public select_filter<sgnode*>
@@ -169,7 +398,7 @@ class node_test_select_filter : public select_filter<sgnode*>
     public:
         node_test_select_filter(Symbol* root, soar_interface* si,
                                 filter_input* input, node_test* test)
-            : select_filter<sgnode * >(root, si, input), test(test), select_true(true)
+            : select_filter<sgnode * >(root, si, input), test(test), select_true(true), max_sep(NULL), batch_add(NULL)
         {}
         
         bool compute(const filter_params* p, sgnode*& out, bool& select);
@@ -178,9 +407,23 @@ class node_test_select_filter : public select_filter<sgnode*>
         {
             select_true = sel_true;
         }
+        void set_max_separation(node_separation* sep)
+        {
+            max_sep = sep;
+        }
+        void set_batch(node_batch_add* add)
+        {
+            batch_add = add;
+        }
+    protected:
+        bool update_outputs();
     private:
         node_test* test;
         bool select_true;
+        node_separation* max_sep;
+        node_result_cache<bool> cache;
+        node_batch_add* batch_add;
+        convex_batch batch;
 };
 
 ////// Node Comparison Filters //////
@@ -189,13 +432,22 @@ class node_comparison_filter : public map_filter<double>
     public:
         node_comparison_filter(Symbol* root, soar_interface* si,
                                filter_input* input, node_comparison* comp)
-            : map_filter<double>(root, si, input), comp(comp)
+            : map_filter<double>(root, si, input), comp(comp), batch_add(NULL)
         {}
         
         bool compute(const filter_params* p, double& out);
         
+        void set_batch(node_batch_add* add)
+        {
+            batch_add = add;
+        }
+    protected:
+        bool update_outputs();
     private:
         node_comparison* comp;
+        node_result_cache<double> cache;
+        node_batch_add* batch_add;
+        convex_batch batch;
 };
 
 
@@ -204,13 +456,27 @@ class node_comparison_select_filter : public node_select_range_filter
     public:
         node_comparison_select_filter(Symbol* root, soar_interface* si,
                                       filter_input* input, node_comparison* comp)
-            : node_select_range_filter(root, si, input), comp(comp)
+            : node_select_range_filter(root, si, input), comp(comp), max_sep(NULL), batch_add(NULL)
         {}
         
         bool compute(const filter_params* p, sgnode*& out, bool& select);
         
+        void set_max_separation(node_separation* sep)
+        {
+            max_sep = sep;
+        }
+        void set_batch(node_batch_add* add)
+        {
+            batch_add = add;
+        }
+    protected:
+        bool update_outputs();
     private:
         node_comparison* comp;
+        node_separation* max_sep;
+        node_result_cache<double> cache;
+        node_batch_add* batch_add;
+        convex_batch batch;
 };
 
 class node_comparison_rank_filter : public rank_filter
@@ -218,13 +484,22 @@ class node_comparison_rank_filter : public rank_filter
     public:
         node_comparison_rank_filter(Symbol* root, soar_interface* si,
                                     filter_input* input, node_comparison* comp)
-            : rank_filter(root, si, input), comp(comp)
+            : rank_filter(root, si, input), comp(comp), batch_add(NULL)
         {}
         
         bool rank(const filter_params* p, double& r);
         
+        void set_batch(node_batch_add* add)
+        {
+            batch_add = add;
+        }
+    protected:
+        bool update_outputs();
     private:
         node_comparison* comp;
+        node_result_cache<double> cache;
+        node_batch_add* batch_add;
+        convex_batch batch;
 };
 
 ////// Node Evaluation Filters //////
@@ -240,6 +515,7 @@ class node_evaluation_filter : public map_filter<double>
         
     private:
         node_evaluation* eval;
+        node_result_cache<double> cache;
 };
 
 class node_evaluation_select_filter : public node_select_range_filter
@@ -254,6 +530,7 @@ class node_evaluation_select_filter : public node_select_range_filter
 
     private:
         node_evaluation* eval;
+        node_result_cache<double> cache;
 };
 
 class node_evaluation_rank_filter : public rank_filter
@@ -268,6 +545,7 @@ class node_evaluation_rank_filter : public rank_filter
         
     private:
         node_evaluation* eval;
+        node_result_cache<double> cache;
 };
 
 #endif //__BASE_NODE_FILTERS_H__
@@ -20,6 +20,9 @@
  *    Returns:
  *      sgnode b - if a contains b
  *
+ *  contain_select only pairs up nodes whose bounding boxes touch,
+ *  which it finds through the scene's bounding volume hierarchy.
+ *
  *********************************************************/
 #include "sgnode_algs.h"
 #include "filters/base_node_filters.h"
@@ -37,10 +40,18 @@ bool contain_test(sgnode* a, sgnode* b, const filter_params* p)
     return bbox_contains(a, b);
 }
 
+// A bounding box can only contain another one that it touches
+double contain_separation(const filter_params* p)
+{
+    return 0.0;
+}
+
 ////// filter contain //////
 filter* make_contain_filter(Symbol* root, soar_interface* si, scene* scn, filter_input* input)
 {
-    return new node_test_filter(root, si, input, &contain_test);
+    node_test_filter* f = new node_test_filter(root, si, input, &contain_test);
+    f->set_max_separation(&contain_separation);
+    return f;
 }
 
 filter_table_entry* contain_filter_entry()
@@ -57,7 +68,14 @@ filter_table_entry* contain_filter_entry()
 ////// filter contain_select //////
 filter* make_contain_select_filter(Symbol* root, soar_interface* si, scene* scn, filter_input* input)
 {
-    return new node_test_select_filter(root, si, input, &contain_test);
+    node_test_select_filter* f = new node_test_select_filter(root, si, input, &contain_test);
+    f->set_max_separation(&contain_separation);
+    return f;
+}
+
+filter_input* make_contain_select_input(scene* scn)
+{
+    return new node_pair_filter_input(scn, &contain_separation);
 }
 
 filter_table_entry* contain_select_filter_entry()
@@ -68,6 +86,7 @@ filter_table_entry* contain_select_filter_entry()
     e->parameters["a"] = "Sgnode a";
     e->parameters["b"] = "Sgnode b";
     e->create = &make_contain_select_filter;
+    e->create_input = &make_contain_select_input;
     return e;
 }
 
@@ -38,6 +38,26 @@
  *    Returns:
  *      The farthest pair of nodes from a and b
  *
+ *  Filter nearest : nearest_filter
+ *    Parameters:
+ *      sgnode a
+ *    Returns:
+ *      The node in the scene with the smallest hull distance to a
+ *      (a, its ancestors, and its descendants are not considered)
+ *
+ *  Filter within_distance : within_distance_filter
+ *    Parameters:
+ *      sgnode a
+ *      double max
+ *    Returns:
+ *      Every node b in the scene with hull distance to a <= max
+ *      (a, its ancestors, and its descendants are not considered)
+ *
+ *  nearest and within_distance search the scene's bounding volume
+ *  hierarchy instead of taking b as input, so they don't need a
+ *  product over all pairs of nodes. distance_select with a hull max
+ *  uses the hierarchy to pair up only the nodes within max.
+ *
  *********************************************************/
 #include "sgnode_algs.h"
 #include "filters/base_node_filters.h"
@@ -45,6 +65,8 @@
 #include "filter_table.h"
 
 #include <string>
+#include <vector>
+#include <map>
 
 double compare_distance(sgnode* a, sgnode* b, const filter_params* p)
 {
@@ -64,10 +86,24 @@ double compare_distance(sgnode* a, sgnode* b, const filter_params* p)
     }
 }
 
+bool distance_batch(convex_batch& batch, sgnode* a, sgnode* b, const filter_params* p)
+{
+    std::string dist_type = "centroid";
+    get_filter_param(0, p, "distance_type", dist_type);
+    if (dist_type != "hull")
+    {
+        return false;
+    }
+    batch.add_distance(a, b);
+    return true;
+}
+
 ///// filter distance //////
 filter* make_distance_filter(Symbol* root, soar_interface* si, scene* scn, filter_input* input)
 {
-    return new node_comparison_filter(root, si, input, &compare_distance);
+    node_comparison_filter* f = new node_comparison_filter(root, si, input, &compare_distance);
+    f->set_batch(&distance_batch);
+    return f;
 }
 
 filter_table_entry* distance_filter_entry()
@@ -82,10 +118,32 @@ filter_table_entry* distance_filter_entry()
     return e;
 }
 
+// Hull distance is never less than bounding box distance, so pairs further
+//   apart than max can be rejected without running GJK
+double distance_separation(const filter_params* p)
+{
+    std::string dist_type = "centroid";
+    double max;
+    get_filter_param(0, p, "distance_type", dist_type);
+    if (dist_type == "hull" && get_filter_param(0, p, "max", max))
+    {
+        return max;
+    }
+    return -1.0;
+}
+
 ///// filter distance_select //////
 filter* make_distance_select_filter(Symbol* root, soar_interface* si, scene* scn, filter_input* input)
 {
-    return new node_comparison_select_filter(root, si, input, &compare_distance);
+    node_comparison_select_filter* f = new node_comparison_select_filter(root, si, input, &compare_distance);
+    f->set_max_separation(&distance_separation);
+    f->set_batch(&distance_batch);
+    return f;
+}
+
+filter_input* make_distance_select_input(scene* scn)
+{
+    return new node_pair_filter_input(scn, &distance_separation);
 }
 
 filter_table_entry* distance_select_filter_entry()
@@ -99,6 +157,7 @@ filter_table_entry* distance_select_filter_entry()
     e->parameters["min"] = "minimum distance to select";
     e->parameters["max"] = "maximum distance to select";
     e->create = &make_distance_select_filter;
+    e->create_input = &make_distance_select_input;
     return e;
 }
 
@@ -107,6 +166,7 @@ filter* make_closest_filter(Symbol* root, soar_interface* si, scene* scn, filter
 {
     node_comparison_rank_filter* f = new node_comparison_rank_filter(root, si, input, &compare_distance);
     f->set_select_highest(false);
+    f->set_batch(&distance_batch);
     return f;
 }
 
@@ -125,7 +185,9 @@ filter_table_entry* closest_filter_entry()
 ////// filter farthest //////
 filter* make_farthest_filter(Symbol* root, soar_interface* si, scene* scn, filter_input* input)
 {
-    return new node_comparison_rank_filter(root, si, input, &compare_distance);
+    node_comparison_rank_filter* f = new node_comparison_rank_filter(root, si, input, &compare_distance);
+    f->set_batch(&distance_batch);
+    return f;
 }
 
 filter_table_entry* farthest_filter_entry()
@@ -139,3 +201,235 @@ filter_table_entry* farthest_filter_entry()
     e->create = &make_farthest_filter;
     return e;
 }
+
+/*
+ Searches the whole scene for each input node a, so the results depend on
+ every node in the scene and not just the inputs. All current inputs are
+ recomputed whenever the scene's index reports a change.
+*/
+class nearest_filter : public typed_filter<sgnode*>
+{
+    public:
+        nearest_filter(Symbol* root, soar_interface* si, filter_input* input, scene* scn)
+            : typed_filter<sgnode*>(root, si, input), scn(scn), version(-1)
+        {}
+
+        bool update_outputs()
+        {
+            const filter_input* input = get_input();
+            bool scene_changed = (scn->get_index()->get_version() != version);
+
+            for (size_t i = (scene_changed ? 0 : input->first_added()); i < input->num_current(); ++i)
+            {
+                if (!compute(input->get_current(i)))
+                {
+                    return false;
+                }
+            }
+            if (!scene_changed)
+            {
+                for (size_t i = 0; i < input->num_changed(); ++i)
+                {
+                    if (!compute(input->get_changed(i)))
+                    {
+                        return false;
+                    }
+                }
+            }
+            for (size_t i = 0; i < input->num_removed(); ++i)
+            {
+                remove_output(input->get_removed(i));
+            }
+            version = scn->get_index()->get_version();
+            return true;
+        }
+
+    private:
+        bool compute(const filter_params* p)
+        {
+            sgnode* a = NULL;
+            double dist;
+            if (!get_filter_param(this, p, "a", a))
+            {
+                set_status("Need node a as input");
+                return false;
+            }
+            set_output(p, scn->get_index()->nearest(a, dist));
+            return true;
+        }
+
+        scene* scn;
+        int version;
+};
+
+/*
+ Like nearest_filter, but each input can produce any number of outputs.
+ Every output gets its own parameter set holding a and b, so downstream
+ filters see the same (a, b) pairs distance_select would have produced.
+*/
+class within_distance_filter : public typed_filter<sgnode*>
+{
+    public:
+        within_distance_filter(Symbol* root, soar_interface* si, filter_input* input, scene* scn)
+            : typed_filter<sgnode*>(root, si, input), scn(scn), version(-1)
+        {}
+
+        ~within_distance_filter()
+        {
+            std::map<const filter_params*, result_set>::iterator i;
+            for (i = results.begin(); i != results.end(); ++i)
+            {
+                clear_results(i->second);
+            }
+        }
+
+        bool update_outputs()
+        {
+            const filter_input* input = get_input();
+            bool scene_changed = (scn->get_index()->get_version() != version);
+
+            for (size_t i = (scene_changed ? 0 : input->first_added()); i < input->num_current(); ++i)
+            {
+                if (!compute(input->get_current(i)))
+                {
+                    return false;
+                }
+            }
+            if (!scene_changed)
+            {
+                for (size_t i = 0; i < input->num_changed(); ++i)
+                {
+                    if (!compute(input->get_changed(i)))
+                    {
+                        return false;
+                    }
+                }
+            }
+            for (size_t i = 0; i < input->num_removed(); ++i)
+            {
+                const filter_params* p = input->get_removed(i);
+                std::map<const filter_params*, result_set>::iterator r = results.find(p);
+                if (r != results.end())
+                {
+                    clear_results(r->second);
+                    results.erase(r);
+                }
+            }
+            version = scn->get_index()->get_version();
+            return true;
+        }
+
+    private:
+        struct result_set
+        {
+            result_set() : a(NULL) {}
+
+            sgnode* a;
+            std::map<sgnode*, filter_params*> found;
+        };
+
+        bool compute(const filter_params* p)
+        {
+            sgnode* a = NULL;
+            double max;
+            if (!get_filter_param(this, p, "a", a))
+            {
+                set_status("Need node a as input");
+                return false;
+            }
+            if (!get_filter_param(this, p, "max", max))
+            {
+                set_status("Need a max distance");
+                return false;
+            }
+
+            result_set& r = results[p];
+            if (r.a != a)
+            {
+                clear_results(r);
+                r.a = a;
+            }
+
+            std::vector<sgnode*> candidates;
+            std::map<sgnode*, filter_params*> found;
+            scn->get_index()->query(a->get_bounds(), max, candidates);
+            for (size_t i = 0, iend = candidates.size(); i < iend; ++i)
+            {
+                sgnode* b = candidates[i];
+                if (b == a || a->has_descendent(b) || b->has_descendent(a) || convex_distance(a, b) > max)
+                {
+                    continue;
+                }
+                filter_params* bp;
+                if (map_get(r.found, b, bp))
+                {
+                    r.found.erase(b);
+                }
+                else
+                {
+                    bp = new filter_params();
+                    bp->push_back(std::make_pair(std::string("a"), static_cast<filter_val*>(new filter_val_c<sgnode*>(a))));
+                    bp->push_back(std::make_pair(std::string("b"), static_cast<filter_val*>(new filter_val_c<sgnode*>(b))));
+                }
+                found[b] = bp;
+                set_output(bp, b);
+            }
+
+            // Whatever is left in the old results is no longer in range
+            clear_results(r);
+            r.found.swap(found);
+            return true;
+        }
+
+        void clear_results(result_set& r)
+        {
+            std::map<sgnode*, filter_params*>::iterator i;
+            for (i = r.found.begin(); i != r.found.end(); ++i)
+            {
+                remove_output(i->second);
+                for (size_t j = 0, jend = i->second->size(); j < jend; ++j)
+                {
+                    delete (*i->second)[j].second;
+                }
+                delete i->second;
+            }
+            r.found.clear();
+        }
+
+        scene* scn;
+        int version;
+        std::map<const filter_params*, result_set> results;
+};
+
+////// filter nearest //////
+filter* make_nearest_filter(Symbol* root, soar_interface* si, scene* scn, filter_input* input)
+{
+    return new nearest_filter(root, si, input, scn);
+}
+
+filter_table_entry* nearest_filter_entry()
+{
+    filter_table_entry* e = new filter_table_entry();
+    e->name = "nearest";
+    e->description = "Output the node in the scene nearest to a (hull distance)";
+    e->parameters["a"] = "Sgnode a";
+    e->create = &make_nearest_filter;
+    return e;
+}
+
+////// filter within_distance //////
+filter* make_within_distance_filter(Symbol* root, soar_interface* si, scene* scn, filter_input* input)
+{
+    return new within_distance_filter(root, si, input, scn);
+}
+
+filter_table_entry* within_distance_filter_entry()
+{
+    filter_table_entry* e = new filter_table_entry();
+    e->name = "within_distance";
+    e->description = "Output every node in the scene within max of a (hull distance)";
+    e->parameters["a"] = "Sgnode a";
+    e->parameters["max"] = "maximum distance to select";
+    e->create = &make_within_distance_filter;
+    return e;
+}
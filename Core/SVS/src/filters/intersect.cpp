@@ -22,6 +22,9 @@
  *    Returns:
  *      sgnode b - if a intersects b
  *
+ *  intersect_select only pairs up nodes whose bounding boxes touch,
+ *  which it finds through the scene's bounding volume hierarchy.
+ *
  *********************************************************/
 #include "sgnode_algs.h"
 #include "filters/base_node_filters.h"
@@ -48,10 +51,31 @@ bool intersect_test(sgnode* a, sgnode* b, const filter_params* p)
     }
 }
 
+bool intersect_batch(convex_batch& batch, sgnode* a, sgnode* b, const filter_params* p)
+{
+    std::string int_type = "bbox";
+    get_filter_param(0, p, "intersect_type", int_type);
+    if (int_type != "hull")
+    {
+        return false;
+    }
+    batch.add_intersects(a, b);
+    return true;
+}
+
+// Both kinds of intersection need the bounding boxes to touch
+double intersect_separation(const filter_params* p)
+{
+    return 0.0;
+}
+
 ////// filter intersect //////
 filter* make_intersect_filter(Symbol* root, soar_interface* si, scene* scn, filter_input* input)
 {
-    return new node_test_filter(root, si, input, &intersect_test);
+    node_test_filter* f = new node_test_filter(root, si, input, &intersect_test);
+    f->set_max_separation(&intersect_separation);
+    f->set_batch(&intersect_batch);
+    return f;
 }
 
 filter_table_entry* intersect_filter_entry()
@@ -69,7 +93,15 @@ filter_table_entry* intersect_filter_entry()
 ////// filter intersect_select //////
 filter* make_intersect_select_filter(Symbol* root, soar_interface* si, scene* scn, filter_input* input)
 {
-    return new node_test_select_filter(root, si, input, &intersect_test);
+    node_test_select_filter* f = new node_test_select_filter(root, si, input, &intersect_test);
+    f->set_max_separation(&intersect_separation);
+    f->set_batch(&intersect_batch);
+    return f;
+}
+
+filter_input* make_intersect_select_input(scene* scn)
+{
+    return new node_pair_filter_input(scn, &intersect_separation);
 }
 
 filter_table_entry* intersect_select_filter_entry()
@@ -81,6 +113,7 @@ filter_table_entry* intersect_select_filter_entry()
     e->parameters["b"] = "Sgnode b";
 		e->parameters["intersect_type"] = "Either bbox or hull";
     e->create = &make_intersect_select_filter;
+    e->create_input = &make_intersect_select_input;
     return e;
 }
 
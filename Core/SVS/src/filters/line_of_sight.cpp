@@ -0,0 +1,115 @@
+/***************************************************
+ *
+ * File: filters/line_of_sight.cpp
+ *
+ * Filter line_of_sight : typed_filter<bool>
+ *   Parameters:
+ *     sgnode a
+ *     sgnode b
+ *   Returns:
+ *     bool - true if the segment between the centroids of a and b
+ *       touches no other node in the scene
+ *
+ *   a, b, and their ancestors and descendants never block the line.
+ *   The lines for every added and changed parameter set are cast
+ *   together with one ray_caster against the scene's bounding volume
+ *   hierarchy. Any change to the scene can open or block a line, so
+ *   every line is cast again when the hierarchy's version changes.
+ *
+ *********************************************************/
+#include <vector>
+#include "filter.h"
+#include "sgnode.h"
+#include "scene.h"
+#include "filter_table.h"
+#include "ray_cast.h"
+
+class line_of_sight_filter : public typed_filter<bool>
+{
+    public:
+        line_of_sight_filter(Symbol* root, soar_interface* si, scene* scn, filter_input* input)
+            : typed_filter<bool>(root, si, input), scn(scn), index_version(-1)
+        {}
+
+    private:
+        bool queue_line(const filter_params* p)
+        {
+            sgnode* a;
+            sgnode* b;
+            if (!get_filter_param(this, p, "a", a))
+            {
+                set_status("expecting parameter a");
+                return false;
+            }
+            if (!get_filter_param(this, p, "b", b))
+            {
+                set_status("expecting parameter b");
+                return false;
+            }
+            rays.add_ray(a->get_centroid(), b->get_centroid(), a, b);
+            queued.push_back(p);
+            return true;
+        }
+
+        bool update_outputs()
+        {
+            const filter_input* input = get_input();
+
+            scene_bvh* index = scn->get_index();
+            bool scene_changed = (index->get_version() != index_version);
+
+            rays.clear();
+            queued.clear();
+            for (size_t i = scene_changed ? 0 : input->first_added(); i < input->num_current(); ++i)
+            {
+                if (!queue_line(input->get_current(i)))
+                {
+                    return false;
+                }
+            }
+            for (size_t i = 0; !scene_changed && i < input->num_changed(); ++i)
+            {
+                if (!queue_line(input->get_changed(i)))
+                {
+                    return false;
+                }
+            }
+
+            if (!queued.empty())
+            {
+                rays.run(index);
+            }
+            index_version = index->get_version();
+            for (size_t i = 0, iend = queued.size(); i < iend; ++i)
+            {
+                set_output(queued[i], !rays.blocked(i));
+            }
+
+            for (size_t i = 0; i < input->num_removed(); ++i)
+            {
+                remove_output(input->get_removed(i));
+            }
+            return true;
+        }
+
+        scene*                              scn;
+        ray_caster                          rays;
+        std::vector<const filter_params*>   queued;
+        int                                 index_version;
+};
+
+filter* make_line_of_sight_filter(Symbol* root, soar_interface* si, scene* scn, filter_input* input)
+{
+    return new line_of_sight_filter(root, si, scn, input);
+}
+
+filter_table_entry* line_of_sight_filter_entry()
+{
+    filter_table_entry* e = new filter_table_entry();
+    e->name = "line_of_sight";
+    e->description = "Returns true if no other node blocks the line between a and b";
+    e->parameters["a"] = "Sgnode a";
+    e->parameters["b"] = "Sgnode b";
+    e->create = &make_line_of_sight_filter;
+    return e;
+}
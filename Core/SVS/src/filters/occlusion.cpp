@@ -17,13 +17,14 @@
  *     Occlusion is based on the fraction of vertices of the node
  *       That are blocked by another node from the eye perspective
  *
+ *  The view lines are cast with a ray_caster against the scene's
+ *    bounding volume hierarchy, so each line is only tested against the
+ *    occluders whose bounding boxes it passes through. They are rebuilt
+ *    from the current positions of a and the eye on every update.
+ *
  *  !!!! NOTE !!!!
  *  This filter does not work well for targets that are sphers
  *    (degrades to testing if the center is occluded Y/N)
- *  Also, this has not been tested with ongoing extraction
- *    (designed for extract_once)
- *    It may work for moving occluders, but will not recalculate the view lines
- *    if object a moves
  ****************************************************************/
 
 #include <iostream>
@@ -35,6 +36,7 @@
 #include "sgnode_algs.h"
 #include "scene.h"
 #include "filter_table.h"
+#include "ray_cast.h"
 
 typedef std::map<const filter_params*, sgnode*> element_map;
 
@@ -45,12 +47,6 @@ public:
 	: typed_filter<double>(root, si, input), scn(scn), a(0), eye(0)
 	{}
 
-	~occlusion_filter(){
-		for(std::vector<view_line>::iterator i = view_lines.begin(); i != view_lines.end(); i++){
-			delete i->first;
-		}
-	}
-
 private:
 	// Gets the eye and target (a) nodes
 	bool initialize(const filter_params* params){
@@ -65,10 +61,27 @@ private:
 				return false;
 			}
 		}
-		calc_view_lines(a, eye, view_lines);
 		return true;
 	}
 
+	// Queues a ray from the eye to each vertex of a
+	void cast_view_lines(){
+		std::vector<const geometry_node*> geoms;
+		vec3 eye_pos = eye->get_centroid();
+
+		rays.clear();
+		a->walk_geoms(geoms);
+		for(size_t i = 0; i < geoms.size(); i++){
+			const convex_node* c = dynamic_cast<const convex_node*>(geoms[i]);
+			if(c){
+				const ptlist& verts = c->get_world_verts();
+				for(size_t j = 0; j < verts.size(); j++){
+					rays.add_ray(eye_pos, verts[j]);
+				}
+			}
+		}
+	}
+
 	virtual bool update_outputs()
 	{
 		const filter_input* input = filter::get_input();
@@ -118,7 +131,14 @@ private:
 			for(element_map::const_iterator i = nodes.begin(); i != nodes.end(); i++){
 				occluders.push_back(i->second);
 			}
-			double res = convex_occlusion(view_lines, occluders);
+			double res = 0;
+			if(!occluders.empty()){
+				cast_view_lines();
+				rays.run(occluders, scn->get_index());
+				if(rays.size() > 0){
+					res = ((double)rays.num_blocked()) / rays.size();
+				}
+			}
 			set_output(NULL, res);
 		}
 
@@ -129,7 +149,7 @@ private:
 
 	sgnode* a;
 	sgnode* eye;
-	std::vector<view_line> view_lines; // Set of lines from eye to vertices of a
+	ray_caster rays; // Lines from eye to vertices of a
 	element_map nodes;  // Set of nodes to check as occluders
 };
 
@@ -57,10 +57,32 @@ filter_table_entry* overlap_filter_entry()
     return e;
 }
 
+// Nodes whose bounding boxes don't touch have no overlap, so they can
+//   be skipped when the filter requires some overlap
+double overlap_separation(const filter_params* p)
+{
+    double min = 0.0;
+    std::string include_min = "true";
+    get_filter_param(0, p, "min", min);
+    get_filter_param(0, p, "include_min", include_min);
+    if (min > 0 || (min == 0 && include_min == "false"))
+    {
+        return 0.0;
+    }
+    return -1.0;
+}
+
 ///// filter overlap_select //////
 filter* make_overlap_select_filter(Symbol* root, soar_interface* si, scene* scn, filter_input* input)
 {
-    return new node_comparison_select_filter(root, si, input, &compare_overlap);
+    node_comparison_select_filter* f = new node_comparison_select_filter(root, si, input, &compare_overlap);
+    f->set_max_separation(&overlap_separation);
+    return f;
+}
+
+filter_input* make_overlap_select_input(scene* scn)
+{
+    return new node_pair_filter_input(scn, &overlap_separation);
 }
 
 filter_table_entry* overlap_select_filter_entry()
@@ -73,6 +95,7 @@ filter_table_entry* overlap_select_filter_entry()
     e->parameters["min"] = "minimum overlap to select";
     e->parameters["max"] = "maximum overlap to select";
     e->create = &make_overlap_select_filter;
+    e->create_input = &make_overlap_select_input;
     return e;
 }
 
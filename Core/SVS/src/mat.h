@@ -2,6 +2,7 @@
 #define MAT_H
 
 #include <iostream>
+#include <algorithm>
 #include <vector>
 #include "serializable.h"
 
@@ -348,6 +349,43 @@ class bbox
             return true;
         }
         
+        /* Distance between the closest points of the two boxes, 0 if they intersect */
+        double distance(const bbox& b) const
+        {
+            return (b.min_pt - max_pt).cwiseMax(min_pt - b.max_pt).cwiseMax(0.0).norm();
+        }
+
+        /* True if the segment from a to b touches the box, by the slab method */
+        bool intersects_segment(const vec3& a, const vec3& b) const
+        {
+            double t0 = 0.0, t1 = 1.0;
+            vec3 d = b - a;
+            for (int i = 0; i < 3; ++i)
+            {
+                if (d[i] == 0.0)
+                {
+                    if (a[i] < min_pt[i] || a[i] > max_pt[i])
+                    {
+                        return false;
+                    }
+                    continue;
+                }
+                double ta = (min_pt[i] - a[i]) / d[i];
+                double tb = (max_pt[i] - a[i]) / d[i];
+                if (ta > tb)
+                {
+                    std::swap(ta, tb);
+                }
+                t0 = std::max(t0, ta);
+                t1 = std::min(t1, tb);
+                if (t0 > t1)
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
         void get_vals(vec3& min_out, vec3& max_out) const
         {
             min_out = min_pt;
@@ -451,6 +489,12 @@ class transform3
             m = trans.matrix();
         }
         
+        /* The rotation and scaling part, without going through a dynamic matrix */
+        Eigen::Matrix3d get_linear() const
+        {
+            return trans.linear();
+        }
+        
     private:
         Eigen::Transform<double, 3, Eigen::Affine> trans;
 };
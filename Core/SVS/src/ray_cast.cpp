@@ -0,0 +1,156 @@
+#include "ray_cast.h"
+
+#include <algorithm>
+#include "sgnode.h"
+#include "scene_bvh.h"
+#include "params.h"
+
+/*
+ Bounding boxes are grown by this much before testing them against a
+ ray, so the broad phase never drops a node that GJK would count as
+ touching.
+*/
+static const double RAY_BOX_PAD = INTERSECT_THRESH;
+
+static bool ray_hits_bounds(const vec3& p1, const vec3& p2, const sgnode* n)
+{
+    vec3 pad(RAY_BOX_PAD, RAY_BOX_PAD, RAY_BOX_PAD);
+    const bbox& b = n->get_bounds();
+    return bbox(b.get_min() - pad, b.get_max() + pad).intersects_segment(p1, p2);
+}
+
+ray_caster::ray_caster()
+{}
+
+size_t ray_caster::add_ray(const vec3& p1, const vec3& p2, const sgnode* ignore1, const sgnode* ignore2)
+{
+    ray r;
+    r.p1 = p1;
+    r.p2 = p2;
+    r.ignore[0] = ignore1;
+    r.ignore[1] = ignore2;
+    r.blocked = false;
+    rays.push_back(r);
+    return rays.size() - 1;
+}
+
+void ray_caster::clear()
+{
+    rays.clear();
+}
+
+size_t ray_caster::num_blocked() const
+{
+    size_t n = 0;
+    for (size_t i = 0, iend = rays.size(); i < iend; ++i)
+    {
+        if (rays[i].blocked)
+        {
+            ++n;
+        }
+    }
+    return n;
+}
+
+void ray_caster::run(const std::vector<const sgnode*>& blockers, scene_bvh* index)
+{
+    std::vector<const sgnode*> indexed, loose;
+
+    for (size_t i = 0, iend = blockers.size(); i < iend; ++i)
+    {
+        if (index && index->contains(blockers[i]))
+        {
+            indexed.push_back(blockers[i]);
+        }
+        else
+        {
+            loose.push_back(blockers[i]);
+        }
+    }
+    std::sort(indexed.begin(), indexed.end());
+    indexed.erase(std::unique(indexed.begin(), indexed.end()), indexed.end());
+    std::sort(loose.begin(), loose.end());
+    loose.erase(std::unique(loose.begin(), loose.end()), loose.end());
+
+    batch.clear();
+    query_rays.clear();
+    for (size_t i = 0, iend = rays.size(); i < iend; ++i)
+    {
+        ray& r = rays[i];
+        r.blocked = false;
+        if (!indexed.empty())
+        {
+            found.clear();
+            index->segment_query(r.p1, r.p2, RAY_BOX_PAD, found);
+            for (size_t j = 0, jend = found.size(); j < jend; ++j)
+            {
+                if (std::binary_search(indexed.begin(), indexed.end(), found[j]))
+                {
+                    add_candidate(i, found[j]);
+                }
+            }
+        }
+        for (size_t j = 0, jend = loose.size(); j < jend; ++j)
+        {
+            if (ray_hits_bounds(r.p1, r.p2, loose[j]))
+            {
+                add_candidate(i, loose[j]);
+            }
+        }
+    }
+    test_candidates();
+}
+
+void ray_caster::run(scene_bvh* index)
+{
+    batch.clear();
+    query_rays.clear();
+    for (size_t i = 0, iend = rays.size(); i < iend; ++i)
+    {
+        ray& r = rays[i];
+        r.blocked = false;
+        found.clear();
+        index->segment_query(r.p1, r.p2, RAY_BOX_PAD, found);
+        for (size_t j = 0, jend = found.size(); j < jend; ++j)
+        {
+            add_candidate(i, found[j]);
+        }
+    }
+    test_candidates();
+}
+
+bool ray_caster::ignored(const ray& r, const sgnode* n) const
+{
+    for (int i = 0; i < 2; ++i)
+    {
+        const sgnode* g = r.ignore[i];
+        if (g && (g == n || g->has_descendent(n) || n->has_descendent(g)))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ray_caster::add_candidate(size_t ray_index, const sgnode* n)
+{
+    const ray& r = rays[ray_index];
+    if (ignored(r, n))
+    {
+        return;
+    }
+    batch.add_segment(r.p1, r.p2, n);
+    query_rays.push_back(ray_index);
+}
+
+void ray_caster::test_candidates()
+{
+    batch.run();
+    for (size_t i = 0, iend = batch.size(); i < iend; ++i)
+    {
+        if (batch.intersects(i))
+        {
+            rays[query_rays[i]].blocked = true;
+        }
+    }
+}
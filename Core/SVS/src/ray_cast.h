@@ -0,0 +1,82 @@
+#ifndef RAY_CAST_H
+#define RAY_CAST_H
+
+/*
+ Tests many line segments ("rays") against the nodes of a scene, for
+ occlusion and line of sight.
+
+ Testing every ray against every candidate blocker with GJK is what made
+ occlusion slow. A caster first narrows each ray down to the nodes whose
+ bounding boxes it passes through, using the scene's bounding volume
+ hierarchy when it is given one, and then runs all of the remaining
+ ray/hull tests as a single convex_batch, so the world-space geometry of
+ each node is set up once however many rays reach it.
+
+ A ray is blocked by a node when the segment touches the node's convex
+ hull, the same test convex_occlusion did with a line-shaped
+ convex_node. Nodes can be ignored per ray, together with their
+ ancestors and descendants, for rays that start or end inside a node.
+*/
+
+#include <vector>
+#include "mat.h"
+#include "convex_batch.h"
+
+class sgnode;
+class scene_bvh;
+
+class ray_caster
+{
+    public:
+        ray_caster();
+
+        /*
+         Queue the segment from p1 to p2 and return its index for
+         blocked(). Up to two nodes can be ignored for this ray.
+        */
+        size_t add_ray(const vec3& p1, const vec3& p2, const sgnode* ignore1 = NULL, const sgnode* ignore2 = NULL);
+
+        /*
+         Tests every queued ray against the nodes in blockers. index is
+         the hierarchy of the scene the blockers belong to, or NULL to
+         check each blocker's bounding box directly. Blockers that aren't
+         in the index are checked directly too.
+        */
+        void run(const std::vector<const sgnode*>& blockers, scene_bvh* index);
+
+        /* Tests every queued ray against every node in index */
+        void run(scene_bvh* index);
+
+        void clear();
+
+        size_t size() const
+        {
+            return rays.size();
+        }
+
+        bool blocked(size_t i) const
+        {
+            return rays[i].blocked;
+        }
+
+        size_t num_blocked() const;
+
+    private:
+        struct ray
+        {
+            vec3          p1, p2;
+            const sgnode* ignore[2];
+            bool          blocked;
+        };
+
+        bool ignored(const ray& r, const sgnode* n) const;
+        void add_candidate(size_t ray_index, const sgnode* n);
+        void test_candidates();
+
+        std::vector<ray>                  rays;
+        std::vector<size_t>               query_rays;   // ray of each batch query
+        std::vector<sgnode*>              found;
+        convex_batch                      batch;
+};
+
+#endif
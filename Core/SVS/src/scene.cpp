@@ -5,6 +5,7 @@
 #include <sstream>
 #include <limits>
 #include <utility>
+#include <algorithm>
 #include "scene.h"
 #include "sgnode.h"
 #include "sgnode_algs.h"
@@ -75,7 +76,7 @@ bool parse_verts(std::vector<std::string>& f, int& start, ptlist& verts, std::st
 
 
 scene::scene(const std::string& name, svs* owner)
-    : name(name), owner(owner), draw(false)
+    : name(name), owner(owner), indexed(false), draw(false), source(NULL), live(false)
 {
     root = new group_node(root_id);
     nodes.push_back(root);
@@ -84,6 +85,12 @@ scene::scene(const std::string& name, svs* owner)
 
 scene::~scene()
 {
+    if (source)
+    {
+        // the nodes belong to the source scene
+        unshare_nodes();
+        return;
+    }
     root->unlisten(this);
     delete root;
 }
@@ -110,6 +117,134 @@ scene* scene::clone(const std::string& cname) const
     return c;
 }
 
+scene* scene::make_overlay(const std::string& oname, bool live_overlay)
+{
+    scene* o = new scene(oname, owner);
+    o->root->unlisten(o);
+    o->nodes.clear();
+    delete o->root;
+
+    scene* src = this;
+    while (!live_overlay && src->source)
+    {
+        src = src->source;
+    }
+    o->live = live_overlay;
+    o->share_nodes(src);
+    return o;
+}
+
+void scene::share_nodes(scene* src)
+{
+    source = src;
+    source->overlays.push_back(this);
+    root = source->root;
+    nodes = source->nodes;
+    for (size_t i = 0, iend = nodes.size(); i < iend; ++i)
+    {
+        nodes[i]->listen(this);
+    }
+    index.clear();
+    indexed = false;
+}
+
+void scene::unshare_nodes()
+{
+    for (size_t i = 0, iend = nodes.size(); i < iend; ++i)
+    {
+        nodes[i]->unlisten(this);
+    }
+    nodes.clear();
+    root = NULL;
+
+    std::vector<scene*>::iterator i = std::find(source->overlays.begin(), source->overlays.end(), this);
+    assert(i != source->overlays.end());
+    source->overlays.erase(i);
+    source = NULL;
+
+    index.clear();
+    indexed = false;
+}
+
+void scene::copy_source_nodes()
+{
+    if (!source)
+    {
+        return;
+    }
+    group_node* shared = root;
+    unshare_nodes();
+
+    root = shared->clone()->as_group();
+    root->walk(nodes);
+    for (size_t i = 0, iend = nodes.size(); i < iend; ++i)
+    {
+        nodes[i]->listen(this);
+    }
+    refresh_draw();
+}
+
+void scene::reshare_source_nodes()
+{
+    scene* src = source;
+    if (!src)
+    {
+        return;
+    }
+    unshare_nodes();
+    share_nodes(src);
+    refresh_draw();
+}
+
+/*
+ Overlays have to stop sharing nodes before anything in them is changed,
+ otherwise the change would show up in the source scene too, and snapshots
+ of this scene have to be given the nodes as they are before the change.
+*/
+void scene::prepare_write()
+{
+    if (source || !overlays.empty())
+    {
+        owner->prepare_scene_write(this);
+    }
+}
+
+scene_bvh* scene::get_index()
+{
+    if (!indexed)
+    {
+        for (size_t i = 1, iend = nodes.size(); i < iend; ++i)
+        {
+            index.insert(nodes[i]);
+        }
+        indexed = true;
+    }
+    return &index;
+}
+
+void scene::update_caches()
+{
+    for (size_t i = 0, iend = nodes.size(); i < iend; ++i)
+    {
+        const sgnode* n = nodes[i];
+        n->get_world_trans();
+        n->get_bounds();
+        n->get_centroid();
+        const convex_node* c = dynamic_cast<const convex_node*>(n);
+        if (c)
+        {
+            c->get_world_verts();
+        }
+    }
+    get_index()->refit();
+}
+
+sgnode* scene::get_node_for_write(const std::string& id)
+{
+    prepare_write();
+    return get_node(id);
+}
+
 sgnode* scene::get_node(const std::string& id)
 {
     node_table::iterator i, iend;
@@ -166,6 +301,7 @@ void scene::get_all_nodes(std::vector<const sgnode*>& n) const
 
 bool scene::add_node(const std::string& parent_id, sgnode* n)
 {
+    prepare_write();
     group_node* par = get_group(parent_id);
     if (!par)
     {
@@ -178,6 +314,7 @@ bool scene::add_node(const std::string& parent_id, sgnode* n)
 
 bool scene::del_node(const std::string& id)
 {
+    prepare_write();
     sgnode* node = get_node(id);
     if (node)
     {
@@ -190,6 +327,7 @@ bool scene::del_node(const std::string& id)
 
 void scene::clear()
 {
+    prepare_write();
     for (int i = static_cast<int>(root->num_children()) - 1; i >= 0; --i)
     {
         delete root->get_child(i);
@@ -490,6 +628,10 @@ bool scene::parse_sgel(const std::string& s)
 {
     std::vector<std::string> lines;
     split(s, "\n", lines);
+    if (!lines.empty())
+    {
+        prepare_write();
+    }
 
     std::vector<std::string>::iterator i;
     for (i = lines.begin(); i != lines.end(); ++i)
@@ -535,6 +677,303 @@ bool scene::parse_sgel(const std::string& s)
     return true;
 }
 
+bool scene::parse_binary(const std::string& data)
+{
+    sgel_batch batch;
+    std::string error;
+
+    if (!batch.decode(data, error) || !apply_batch(batch, error))
+    {
+        std::cerr << "error in binary scene update: " << error << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/*
+ Tracks what a batch would do to the scene's node ids without touching
+ any nodes. Ids are pulled in from the scene the first time a record
+ names them. Each entry remembers which incarnation of its parent it
+ hangs under, so deleting a group (or deleting and re-adding it) also
+ makes everything that was under it disappear.
+*/
+class batch_checker
+{
+    public:
+        batch_checker(const std::map<std::string, sgnode*>& ids) : ids(ids) {}
+
+        /* Returns the node's shape ('g', 'b' or 'v') if it would exist, otherwise 0 */
+        char exists(const std::string& id)
+        {
+            const entry* e = lookup(id);
+            while (e)
+            {
+                if (e->deleted)
+                {
+                    return 0;
+                }
+                if (e->parent.empty())
+                {
+                    break;
+                }
+                const entry* p = lookup(e->parent);
+                if (!p || p->gen != e->parent_gen)
+                {
+                    return 0;
+                }
+                e = p;
+            }
+            return e ? lookup(id)->shape : 0;
+        }
+
+        void add(const std::string& id, const std::string& parent, char shape)
+        {
+            entry* p = lookup(parent);
+            entry* e = lookup(id);
+            if (!e)
+            {
+                e = &entries[id];
+                e->gen = 0;
+            }
+            e->shape = shape;
+            e->parent = parent;
+            e->parent_gen = p->gen;
+            e->deleted = false;
+            ++e->gen;
+        }
+
+        void del(const std::string& id)
+        {
+            lookup(id)->deleted = true;
+        }
+
+    private:
+        struct entry
+        {
+            char        shape;
+            std::string parent;
+            int         gen;
+            int         parent_gen;
+            bool        deleted;
+        };
+
+        entry* lookup(const std::string& id)
+        {
+            std::map<std::string, entry>::iterator i = entries.find(id);
+            if (i != entries.end())
+            {
+                return &i->second;
+            }
+            std::map<std::string, sgnode*>::const_iterator j = ids.find(id);
+            if (j == ids.end())
+            {
+                return NULL;
+            }
+
+            const sgnode* n = j->second;
+            entry& e = entries[id];
+            e.shape = n->as_group() ? 'g' : (dynamic_cast<const ball_node*>(n) ? 'b' : 'v');
+            e.parent = n->get_parent() ? n->get_parent()->get_id() : "";
+            e.gen = 0;
+            e.parent_gen = 0;
+            e.deleted = false;
+            return &e;
+        }
+
+        const std::map<std::string, sgnode*>& ids;
+        std::map<std::string, entry> entries;
+};
+
+bool scene::check_batch(const sgel_batch& batch, const std::map<std::string, sgnode*>& ids, std::string& error) const
+{
+    batch_checker check(ids);
+
+    for (size_t i = 0, iend = batch.size(); i < iend; ++i)
+    {
+        const sgel_batch::record& r = batch.get(i);
+        char shape = check.exists(r.id);
+        std::string err;
+
+        switch (r.cmd)
+        {
+            case 'a':
+                if (shape)
+                {
+                    err = "node already exists";
+                }
+                else if (check.exists(r.parent) != 'g')
+                {
+                    err = "parent node does not exist, or is not group node";
+                }
+                else if ((r.mods & sgel_batch::MOD_VERTS) && (r.mods & sgel_batch::MOD_RADIUS))
+                {
+                    err = "conflicting node type";
+                }
+                else
+                {
+                    shape = (r.mods & sgel_batch::MOD_VERTS) ? 'v' : ((r.mods & sgel_batch::MOD_RADIUS) ? 'b' : 'g');
+                    check.add(r.id, r.parent, shape);
+                }
+                break;
+            case 'c':
+                if (!shape)
+                {
+                    err = "node does not exist";
+                }
+                else if ((r.mods & sgel_batch::MOD_VERTS) && shape != 'v')
+                {
+                    err = "vertices given for a node that is not convex";
+                }
+                else if ((r.mods & sgel_batch::MOD_RADIUS) && shape != 'b')
+                {
+                    err = "radius given for a node that is not a ball";
+                }
+                break;
+            case 'd':
+                if (!shape)
+                {
+                    err = "node does not exist";
+                }
+                else if (r.id == root_id)
+                {
+                    err = "cannot delete the root node";
+                }
+                else
+                {
+                    check.del(r.id);
+                }
+                break;
+            case 't':
+                if (!shape)
+                {
+                    err = "node " + r.id + " does not exist";
+                }
+                else if (r.subcommand != 'a' && r.subcommand != 'c' && r.subcommand != 'd')
+                {
+                    err = "unrecognized tag subcommand (expecting add, change, delete)";
+                }
+                break;
+        }
+        if (!err.empty())
+        {
+            error = "record " + tostring(i + 1) + ": " + err;
+            return false;
+        }
+    }
+    return true;
+}
+
+static void map_node_ids(const std::vector<sgnode*>& nodes, std::map<std::string, sgnode*>& ids)
+{
+    ids.clear();
+    for (size_t i = 0, iend = nodes.size(); i < iend; ++i)
+    {
+        ids[nodes[i]->get_id()] = nodes[i];
+    }
+}
+
+static void set_batch_transforms(sgnode* n, const sgel_batch::record& r)
+{
+    if (r.mods & sgel_batch::MOD_POS)
+    {
+        n->set_trans('p', r.pos);
+    }
+    if (r.mods & sgel_batch::MOD_ROT)
+    {
+        n->set_trans('r', r.rot);
+    }
+    if (r.mods & sgel_batch::MOD_SCALE)
+    {
+        n->set_trans('s', r.scale);
+    }
+}
+
+bool scene::apply_batch(const sgel_batch& batch, std::string& error)
+{
+    std::map<std::string, sgnode*> ids;
+    map_node_ids(nodes, ids);
+    if (!check_batch(batch, ids, error))
+    {
+        return false;
+    }
+    if (batch.size() == 0)
+    {
+        return true;
+    }
+    if (source)
+    {
+        /* the ids point at the shared nodes, not the private copy about to be made */
+        prepare_write();
+        map_node_ids(nodes, ids);
+    }
+    else
+    {
+        prepare_write();
+    }
+
+    std::vector<sgnode*> removed;
+    for (size_t i = 0, iend = batch.size(); i < iend; ++i)
+    {
+        const sgel_batch::record& r = batch.get(i);
+        sgnode* n;
+
+        switch (r.cmd)
+        {
+            case 'a':
+                if (r.mods & sgel_batch::MOD_VERTS)
+                {
+                    n = new convex_node(r.id, r.verts);
+                }
+                else if (r.mods & sgel_batch::MOD_RADIUS)
+                {
+                    n = new ball_node(r.id, r.radius);
+                }
+                else
+                {
+                    n = new group_node(r.id);
+                }
+                set_batch_transforms(n, r);
+                ids[r.parent]->as_group()->attach_child(n);
+                ids[r.id] = n;
+                break;
+            case 'c':
+                n = ids[r.id];
+                set_batch_transforms(n, r);
+                if (r.mods & sgel_batch::MOD_VERTS)
+                {
+                    static_cast<convex_node*>(n)->set_verts(r.verts);
+                }
+                if (r.mods & sgel_batch::MOD_RADIUS)
+                {
+                    static_cast<ball_node*>(n)->set_radius(r.radius);
+                }
+                break;
+            case 'd':
+                n = ids[r.id];
+                removed.clear();
+                n->walk(removed);
+                for (size_t j = 0, jend = removed.size(); j < jend; ++j)
+                {
+                    ids.erase(removed[j]->get_id());
+                }
+                delete n;
+                break;
+            case 't':
+                n = ids[r.id];
+                if (r.subcommand == 'd')
+                {
+                    n->delete_tag(r.tag_name);
+                }
+                else
+                {
+                    n->set_tag(r.tag_name, r.tag_value);
+                }
+                break;
+        }
+    }
+    return true;
+}
+
 void scene::node_update(sgnode* n, sgnode::change_type t, const std::string& update_info)
 {
     sgnode* child;
@@ -553,6 +992,10 @@ void scene::node_update(sgnode* n, sgnode::change_type t, const std::string& upd
         child->listen(this);
         sgnode*& node = grow_vec(nodes);
         node = child;
+        if (indexed)
+        {
+            index.insert(child);
+        }
 
         if (draw)
         {
@@ -578,6 +1021,10 @@ void scene::node_update(sgnode* n, sgnode::change_type t, const std::string& upd
             break;
         case sgnode::DELETED:
             nodes.erase(nodes.begin() + i);
+            if (indexed)
+            {
+                index.remove(n);
+            }
 
             if (draw && i != 0)
             {
@@ -585,12 +1032,20 @@ void scene::node_update(sgnode* n, sgnode::change_type t, const std::string& upd
             }
             break;
         case sgnode::SHAPE_CHANGED:
+            if (indexed)
+            {
+                index.mark_dirty(n);
+            }
             if (!n->is_group() && draw)
             {
                 d->change(name, n, drawer::SHAPE);
             }
             break;
         case sgnode::TRANSFORM_CHANGED:
+            if (indexed)
+            {
+                index.mark_dirty(n);
+            }
             if (draw)
             {
                 d->change(name, n, drawer::POS | drawer::ROT | drawer::SCALE);
@@ -7,6 +7,8 @@
 #include "sgnode.h"
 #include "common.h"
 #include "cliproxy.h"
+#include "scene_bvh.h"
+#include "sgel_batch.h"
 
 class svs;
 
@@ -24,6 +26,45 @@ class scene : public sgnode_listener, public cliproxy
         
         scene* clone(const std::string& name) const;
         
+        /*
+         Returns a scene that shares this scene's nodes instead of copying
+         them. The overlay gets its own copy the first time something writes
+         to it; see svs::make_scene_private.
+         
+         A snapshot overlay (live = false) keeps the nodes as they are now:
+         it is attached to whichever scene owns them, and is given its own
+         copy before that scene changes them. A live overlay is attached to
+         this scene and sees every change made here until it writes.
+        */
+        scene* make_overlay(const std::string& name, bool live);
+        
+        /* The scene this one is an overlay of, or NULL if it owns its nodes */
+        scene* get_source() const
+        {
+            return source;
+        }
+        
+        bool is_live() const
+        {
+            return live;
+        }
+        
+        const std::vector<scene*>& get_overlays() const
+        {
+            return overlays;
+        }
+        
+        /*
+         These should only be called through svs::make_scene_private, which
+         also moves the owning state's sgwmes and commands over.
+         
+         copy_source_nodes replaces the shared nodes with a private deep copy.
+         reshare_source_nodes points an overlay at its source's current nodes,
+         for when the source itself was just given a private copy.
+        */
+        void copy_source_nodes();
+        void reshare_source_nodes();
+        
         group_node*   get_root()
         {
             return root;
@@ -36,15 +77,43 @@ class scene : public sgnode_listener, public cliproxy
         sgnode const* get_node(const std::string& id) const;
         group_node* get_group(const std::string& id);
         
+        /*
+         Like get_node, but for changing the node in place. If the node is
+         shared with an overlay or a snapshot, this scene is given its own
+         nodes first, so commands should only call it once they know they
+         are going to change something.
+        */
+        sgnode*       get_node_for_write(const std::string& id);
+        
         void get_all_nodes(std::vector<sgnode*>& nodes);
         void get_all_nodes(std::vector<const sgnode*>& nodes) const;
         
+        /* Bounding volume hierarchy over every node except the root, built on first use */
+        scene_bvh* get_index();
+        
+        /*
+         Brings the lazily computed transforms, bounds and vertices of every
+         node up to date, and builds or refits the index. Until the next
+         write, reading the scene through const accessors and index queries
+         then changes nothing, so several threads can do it at once.
+        */
+        void update_caches();
+        
         bool add_node(const std::string& parent_id, sgnode* n);
         bool del_node(const std::string& id);
         void clear();
         
         bool parse_sgel(const std::string& s);
         
+        /*
+         Applies a binary batch of updates (see sgel_batch.h). Every record
+         is checked against the scene as the earlier records would leave it
+         before anything is changed, so either the whole batch is applied or
+         the scene is left untouched and false is returned.
+        */
+        bool parse_binary(const std::string& data);
+        bool apply_batch(const sgel_batch& batch, std::string& error);
+        
         std::string parse_query(const std::string& query) const;
         
         void node_update(sgnode* n, sgnode::change_type t, const std::string& update_info);
@@ -66,18 +135,30 @@ class scene : public sgnode_listener, public cliproxy
     private:
         typedef std::vector<sgnode*> node_table;
         
+        void share_nodes(scene* src);
+        void unshare_nodes();
+        void prepare_write();
+        
         std::string  name;
         group_node*  root;
         svs*         owner;
         node_table   nodes;
+        scene_bvh    index;
+        bool         indexed;
         bool         draw;
         
+        scene*              source;
+        bool                live;
+        std::vector<scene*> overlays;
+        
         
         int parse_add(std::vector<std::string>& f, std::string& error);
         int parse_del(std::vector<std::string>& f, std::string& error);
         int parse_change(std::vector<std::string>& f, std::string& error);
         int parse_tag(std::vector<std::string>& f, std::string& error);
         
+        bool check_batch(const sgel_batch& batch, const std::map<std::string, sgnode*>& ids, std::string& error) const;
+        
         void cli_props(const std::vector<std::string>& args, std::ostream& os) const;
         void cli_sgel(const std::vector<std::string>& args, std::ostream& os);
         void cli_draw(const std::vector<std::string>& args, std::ostream& os);
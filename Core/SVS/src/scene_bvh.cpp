@@ -0,0 +1,383 @@
+#include "scene_bvh.h"
+
+#include <queue>
+#include <limits>
+#include <functional>
+#include "sgnode.h"
+#include "sgnode_algs.h"
+
+/*
+ Leaf boxes are enlarged by this fraction of their largest extent, plus a
+ small constant so that points and flat shapes get some slack too.
+*/
+const double FAT_FRACTION = 0.1;
+const double FAT_MIN = 0.001;
+
+static double surface_area(const bbox& b)
+{
+    vec3 e = b.get_max() - b.get_min();
+    return e[0] * e[1] + e[1] * e[2] + e[2] * e[0];
+}
+
+static bbox merge(const bbox& a, const bbox& b)
+{
+    bbox m = a;
+    m.include(b);
+    return m;
+}
+
+scene_bvh::scene_bvh()
+    : root(-1), free_list(-1), version(0)
+{}
+
+void scene_bvh::clear()
+{
+    tree.clear();
+    leaves.clear();
+    dirty.clear();
+    root = -1;
+    free_list = -1;
+    ++version;
+}
+
+void scene_bvh::insert(sgnode* n)
+{
+    if (contains(n))
+    {
+        return;
+    }
+    int leaf = alloc_node();
+    tree[leaf].box = fatten(n->get_bounds());
+    tree[leaf].obj = n;
+    tree[leaf].dirty = false;
+    insert_leaf(leaf);
+    leaves[n] = leaf;
+    ++version;
+}
+
+void scene_bvh::remove(sgnode* n)
+{
+    std::map<const sgnode*, int>::iterator i = leaves.find(n);
+    if (i == leaves.end())
+    {
+        return;
+    }
+    remove_leaf(i->second);
+    free_node(i->second);
+    leaves.erase(i);
+    ++version;
+}
+
+void scene_bvh::mark_dirty(sgnode* n)
+{
+    std::map<const sgnode*, int>::iterator i = leaves.find(n);
+    if (i == leaves.end())
+    {
+        return;
+    }
+    if (!tree[i->second].dirty)
+    {
+        tree[i->second].dirty = true;
+        dirty.push_back(i->second);
+    }
+    ++version;
+}
+
+void scene_bvh::query(const bbox& b, double dist, std::vector<sgnode*>& result)
+{
+    std::vector<int> stack;
+
+    update_dirty();
+    if (root < 0)
+    {
+        return;
+    }
+    stack.push_back(root);
+    while (!stack.empty())
+    {
+        int i = stack.back();
+        stack.pop_back();
+        if (tree[i].box.distance(b) > dist)
+        {
+            continue;
+        }
+        if (tree[i].is_leaf())
+        {
+            if (tree[i].obj->get_bounds().distance(b) <= dist)
+            {
+                result.push_back(tree[i].obj);
+            }
+        }
+        else
+        {
+            stack.push_back(tree[i].left);
+            stack.push_back(tree[i].right);
+        }
+    }
+}
+
+void scene_bvh::segment_query(const vec3& a, const vec3& b, double pad, std::vector<sgnode*>& result)
+{
+    std::vector<int> stack;
+    vec3 p(pad, pad, pad);
+
+    update_dirty();
+    if (root < 0)
+    {
+        return;
+    }
+    stack.push_back(root);
+    while (!stack.empty())
+    {
+        int i = stack.back();
+        stack.pop_back();
+        const bbox& box = tree[i].box;
+        if (!bbox(box.get_min() - p, box.get_max() + p).intersects_segment(a, b))
+        {
+            continue;
+        }
+        if (tree[i].is_leaf())
+        {
+            const bbox& ob = tree[i].obj->get_bounds();
+            if (bbox(ob.get_min() - p, ob.get_max() + p).intersects_segment(a, b))
+            {
+                result.push_back(tree[i].obj);
+            }
+        }
+        else
+        {
+            stack.push_back(tree[i].left);
+            stack.push_back(tree[i].right);
+        }
+    }
+}
+
+sgnode* scene_bvh::nearest(const sgnode* n, double& dist)
+{
+    typedef std::pair<double, int> queue_entry;
+    std::priority_queue<queue_entry, std::vector<queue_entry>, std::greater<queue_entry> > q;
+    sgnode* best = NULL;
+    double best_dist = std::numeric_limits<double>::infinity();
+
+    update_dirty();
+    if (root < 0)
+    {
+        return NULL;
+    }
+
+    /*
+     Best-first search on bounding box distance. Once the closest remaining
+     box is further away than the best hull distance found so far, nothing
+     left in the queue can beat it.
+    */
+    const bbox& nb = n->get_bounds();
+    q.push(queue_entry(tree[root].box.distance(nb), root));
+    while (!q.empty())
+    {
+        queue_entry e = q.top();
+        q.pop();
+        if (e.first > best_dist)
+        {
+            break;
+        }
+        const tree_node& t = tree[e.second];
+        if (t.is_leaf())
+        {
+            if (t.obj == n || n->has_descendent(t.obj) || t.obj->has_descendent(n))
+            {
+                continue;
+            }
+            double d = convex_distance(n, t.obj);
+            if (!best || d < best_dist || (d == best_dist && t.obj->get_id() < best->get_id()))
+            {
+                best = t.obj;
+                best_dist = d;
+            }
+        }
+        else
+        {
+            q.push(queue_entry(tree[t.left].box.distance(nb), t.left));
+            q.push(queue_entry(tree[t.right].box.distance(nb), t.right));
+        }
+    }
+    dist = best_dist;
+    return best;
+}
+
+int scene_bvh::alloc_node()
+{
+    int i;
+    if (free_list >= 0)
+    {
+        i = free_list;
+        free_list = tree[i].parent;
+    }
+    else
+    {
+        i = static_cast<int>(tree.size());
+        tree.push_back(tree_node());
+    }
+    tree[i].parent = -1;
+    tree[i].left = -1;
+    tree[i].right = -1;
+    tree[i].obj = NULL;
+    tree[i].dirty = false;
+    return i;
+}
+
+void scene_bvh::free_node(int i)
+{
+    tree[i].obj = NULL;
+    tree[i].dirty = false;
+    tree[i].parent = free_list;
+    free_list = i;
+}
+
+/*
+ Walk down from the root, at each level going into whichever child grows
+ the least in surface area, and pair the leaf with the node we stop at.
+*/
+void scene_bvh::insert_leaf(int leaf)
+{
+    if (root < 0)
+    {
+        root = leaf;
+        tree[leaf].parent = -1;
+        return;
+    }
+
+    bbox lb = tree[leaf].box;
+    int i = root;
+    while (!tree[i].is_leaf())
+    {
+        int l = tree[i].left, r = tree[i].right;
+        double area = surface_area(tree[i].box);
+        double combined = surface_area(merge(tree[i].box, lb));
+
+        /* cost of making a new parent here vs. pushing the leaf further down */
+        double cost = 2.0 * combined;
+        double inherit = 2.0 * (combined - area);
+        double cost_l = surface_area(merge(tree[l].box, lb)) + inherit;
+        double cost_r = surface_area(merge(tree[r].box, lb)) + inherit;
+        if (!tree[l].is_leaf())
+        {
+            cost_l -= surface_area(tree[l].box);
+        }
+        if (!tree[r].is_leaf())
+        {
+            cost_r -= surface_area(tree[r].box);
+        }
+
+        if (cost < cost_l && cost < cost_r)
+        {
+            break;
+        }
+        i = (cost_l < cost_r) ? l : r;
+    }
+
+    int sibling = i;
+    int old_parent = tree[sibling].parent;
+    int new_parent = alloc_node();
+    tree[new_parent].parent = old_parent;
+    tree[new_parent].left = sibling;
+    tree[new_parent].right = leaf;
+    tree[new_parent].box = merge(tree[sibling].box, lb);
+
+    if (old_parent < 0)
+    {
+        root = new_parent;
+    }
+    else if (tree[old_parent].left == sibling)
+    {
+        tree[old_parent].left = new_parent;
+    }
+    else
+    {
+        tree[old_parent].right = new_parent;
+    }
+    tree[sibling].parent = new_parent;
+    tree[leaf].parent = new_parent;
+    refit_ancestors(old_parent);
+}
+
+void scene_bvh::remove_leaf(int leaf)
+{
+    if (leaf == root)
+    {
+        root = -1;
+        return;
+    }
+
+    int parent = tree[leaf].parent;
+    int grandparent = tree[parent].parent;
+    int sibling = (tree[parent].left == leaf) ? tree[parent].right : tree[parent].left;
+
+    if (grandparent < 0)
+    {
+        root = sibling;
+        tree[sibling].parent = -1;
+    }
+    else
+    {
+        if (tree[grandparent].left == parent)
+        {
+            tree[grandparent].left = sibling;
+        }
+        else
+        {
+            tree[grandparent].right = sibling;
+        }
+        tree[sibling].parent = grandparent;
+        refit_ancestors(grandparent);
+    }
+    free_node(parent);
+    tree[leaf].parent = -1;
+}
+
+void scene_bvh::refit_ancestors(int i)
+{
+    while (i >= 0)
+    {
+        tree[i].box = merge(tree[tree[i].left].box, tree[tree[i].right].box);
+        i = tree[i].parent;
+    }
+}
+
+/*
+ Nodes that moved but still fit inside their enlarged leaf box stay where
+ they are. Others are taken out and reinserted with a new box. Leaves that
+ were removed after being marked have had their flag cleared by free_node,
+ and a slot reused since then is only refit if it was marked again.
+*/
+void scene_bvh::update_dirty()
+{
+    if (dirty.empty())
+    {
+        return;
+    }
+    for (size_t i = 0, iend = dirty.size(); i < iend; ++i)
+    {
+        int leaf = dirty[i];
+        if (!tree[leaf].dirty)
+        {
+            continue;
+        }
+        tree[leaf].dirty = false;
+        const bbox& b = tree[leaf].obj->get_bounds();
+        if (!tree[leaf].box.contains(b))
+        {
+            remove_leaf(leaf);
+            tree[leaf].box = fatten(b);
+            insert_leaf(leaf);
+        }
+    }
+    dirty.clear();
+}
+
+bbox scene_bvh::fatten(const bbox& b) const
+{
+    vec3 extent = b.get_max() - b.get_min();
+    double margin = FAT_FRACTION * extent.maxCoeff() + FAT_MIN;
+    vec3 m(margin, margin, margin);
+    return bbox(b.get_min() - m, b.get_max() + m);
+}
@@ -0,0 +1,108 @@
+#ifndef SCENE_BVH_H
+#define SCENE_BVH_H
+
+/*
+ A dynamic bounding volume hierarchy over the nodes of a scene.
+
+ Each leaf holds one node under a slightly enlarged copy of its bounding
+ box, so small movements don't change the shape of the tree. The owning
+ scene reports added, deleted, and moved nodes as it hears about them from
+ its sgnode listeners. Moved nodes are only refit the next time the tree is
+ queried, so a burst of transform changes in one input phase costs a single
+ refit per node.
+
+ The hierarchy is a broad phase: it rules out nodes that are too far away
+ by bounding box distance, which is never more than the hull distance used
+ by convex_distance.
+*/
+
+#include <vector>
+#include <map>
+#include "mat.h"
+
+class sgnode;
+
+class scene_bvh
+{
+    public:
+        scene_bvh();
+
+        void insert(sgnode* n);
+        void remove(sgnode* n);
+        void mark_dirty(sgnode* n);
+        void clear();
+
+        bool contains(const sgnode* n) const
+        {
+            return leaves.find(n) != leaves.end();
+        }
+
+        size_t size() const
+        {
+            return leaves.size();
+        }
+
+        /*
+         Refits the nodes moved since the last query. Queries do this
+         themselves; calling it first means they don't change the tree.
+        */
+        void refit()
+        {
+            update_dirty();
+        }
+
+        /* Incremented whenever an indexed node is added, removed, or moved */
+        int get_version() const
+        {
+            return version;
+        }
+
+        /* Appends every indexed node whose bounding box is within dist of b */
+        void query(const bbox& b, double dist, std::vector<sgnode*>& result);
+
+        /*
+         Appends every indexed node whose bounding box, grown by pad on
+         every side, touches the segment from a to b.
+        */
+        void segment_query(const vec3& a, const vec3& b, double pad, std::vector<sgnode*>& result);
+
+        /*
+         Returns the indexed node with the smallest convex_distance to n,
+         or NULL if there is none. n, its ancestors, and its descendants are
+         never returned. Ties go to the node with the smallest id.
+        */
+        sgnode* nearest(const sgnode* n, double& dist);
+
+    private:
+        struct tree_node
+        {
+            bbox    box;
+            int     parent;
+            int     left;
+            int     right;
+            sgnode* obj;
+            bool    dirty;
+
+            bool is_leaf() const
+            {
+                return left < 0;
+            }
+        };
+
+        int  alloc_node();
+        void free_node(int i);
+        void insert_leaf(int leaf);
+        void remove_leaf(int leaf);
+        void refit_ancestors(int i);
+        void update_dirty();
+        bbox fatten(const bbox& b) const;
+
+        std::vector<tree_node>       tree;
+        int                          root;
+        int                          free_list;
+        std::map<const sgnode*, int> leaves;
+        std::vector<int>             dirty;     // leaves with their dirty flag set
+        int                          version;
+};
+
+#endif
@@ -0,0 +1,363 @@
+#include "sgel_batch.h"
+
+#include <cstring>
+#include "portability.h"
+#include "common.h"
+
+static const char BATCH_MAGIC[] = "SVSB";
+static const size_t BATCH_MAGIC_LEN = 4;
+
+/*
+ Values are written a byte at a time so the encoding is little-endian
+ regardless of the host.
+*/
+static void put_uint(std::string& out, uint64_t v, int bytes)
+{
+    for (int i = 0; i < bytes; ++i)
+    {
+        out += static_cast<char>((v >> (8 * i)) & 0xff);
+    }
+}
+
+static void put_double(std::string& out, double d)
+{
+    uint64_t v;
+    std::memcpy(&v, &d, sizeof(v));
+    put_uint(out, v, 8);
+}
+
+static void put_str(std::string& out, const std::string& s)
+{
+    put_uint(out, s.size(), 4);
+    out += s;
+}
+
+static void put_vec3(std::string& out, const vec3& v)
+{
+    for (int i = 0; i < 3; ++i)
+    {
+        put_double(out, v(i));
+    }
+}
+
+/* Reads from a byte string, failing instead of running past the end */
+class batch_reader
+{
+    public:
+        batch_reader(const std::string& data) : data(data), pos(0) {}
+
+        bool get_uint(uint64_t& v, int bytes)
+        {
+            if (data.size() - pos < static_cast<size_t>(bytes))
+            {
+                return false;
+            }
+            v = 0;
+            for (int i = 0; i < bytes; ++i)
+            {
+                v |= static_cast<uint64_t>(static_cast<unsigned char>(data[pos++])) << (8 * i);
+            }
+            return true;
+        }
+
+        bool get_double(double& d)
+        {
+            uint64_t v;
+            if (!get_uint(v, 8))
+            {
+                return false;
+            }
+            std::memcpy(&d, &v, sizeof(d));
+            return true;
+        }
+
+        bool get_char(char& c)
+        {
+            uint64_t v;
+            if (!get_uint(v, 1))
+            {
+                return false;
+            }
+            c = static_cast<char>(v);
+            return true;
+        }
+
+        bool get_str(std::string& s)
+        {
+            uint64_t n;
+            if (!get_uint(n, 4) || data.size() - pos < n)
+            {
+                return false;
+            }
+            s.assign(data, pos, n);
+            pos += n;
+            return true;
+        }
+
+        bool get_vec3(vec3& v)
+        {
+            for (int i = 0; i < 3; ++i)
+            {
+                if (!get_double(v(i)))
+                {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        bool done() const
+        {
+            return pos == data.size();
+        }
+
+        size_t remaining() const
+        {
+            return data.size() - pos;
+        }
+
+        void skip(size_t n)
+        {
+            pos += n;
+        }
+
+    private:
+        const std::string& data;
+        size_t pos;
+};
+
+static bool get_mod_values(batch_reader& r, sgel_batch::record& rec)
+{
+    if (rec.mods & ~(sgel_batch::MOD_POS | sgel_batch::MOD_ROT | sgel_batch::MOD_SCALE |
+                     sgel_batch::MOD_VERTS | sgel_batch::MOD_RADIUS))
+    {
+        return false;
+    }
+    if ((rec.mods & sgel_batch::MOD_POS) && !r.get_vec3(rec.pos))
+    {
+        return false;
+    }
+    if ((rec.mods & sgel_batch::MOD_ROT) && !r.get_vec3(rec.rot))
+    {
+        return false;
+    }
+    if ((rec.mods & sgel_batch::MOD_SCALE) && !r.get_vec3(rec.scale))
+    {
+        return false;
+    }
+    if (rec.mods & sgel_batch::MOD_VERTS)
+    {
+        uint64_t n;
+        if (!r.get_uint(n, 4) || r.remaining() / 24 < n)
+        {
+            return false;
+        }
+        rec.verts.resize(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            r.get_vec3(rec.verts[i]);
+        }
+    }
+    if ((rec.mods & sgel_batch::MOD_RADIUS) && !r.get_double(rec.radius))
+    {
+        return false;
+    }
+    return true;
+}
+
+static void put_mod_values(std::string& out, const sgel_batch::record& rec)
+{
+    put_uint(out, rec.mods, 1);
+    if (rec.mods & sgel_batch::MOD_POS)
+    {
+        put_vec3(out, rec.pos);
+    }
+    if (rec.mods & sgel_batch::MOD_ROT)
+    {
+        put_vec3(out, rec.rot);
+    }
+    if (rec.mods & sgel_batch::MOD_SCALE)
+    {
+        put_vec3(out, rec.scale);
+    }
+    if (rec.mods & sgel_batch::MOD_VERTS)
+    {
+        put_uint(out, rec.verts.size(), 4);
+        for (size_t i = 0, iend = rec.verts.size(); i < iend; ++i)
+        {
+            put_vec3(out, rec.verts[i]);
+        }
+    }
+    if (rec.mods & sgel_batch::MOD_RADIUS)
+    {
+        put_double(out, rec.radius);
+    }
+}
+
+bool sgel_batch::is_batch(const std::string& data)
+{
+    return data.compare(0, BATCH_MAGIC_LEN, BATCH_MAGIC) == 0;
+}
+
+bool sgel_batch::decode(const std::string& data, std::string& error)
+{
+    records.clear();
+    if (!is_batch(data))
+    {
+        error = "missing batch header";
+        return false;
+    }
+
+    batch_reader r(data);
+    uint64_t count;
+    r.skip(BATCH_MAGIC_LEN);
+    if (!r.get_uint(count, 4))
+    {
+        error = "missing record count";
+        return false;
+    }
+
+    for (uint64_t i = 0; i < count; ++i)
+    {
+        record rec;
+        uint64_t mods = 0;
+        bool ok;
+
+        rec.subcommand = 0;
+        rec.mods = 0;
+        rec.radius = 0.0;
+        if (!r.get_char(rec.cmd))
+        {
+            error = "truncated batch";
+            records.clear();
+            return false;
+        }
+        switch (rec.cmd)
+        {
+            case 'a':
+                ok = r.get_str(rec.id) && r.get_str(rec.parent) && r.get_uint(mods, 1);
+                rec.mods = static_cast<int>(mods);
+                ok = ok && get_mod_values(r, rec);
+                break;
+            case 'c':
+                ok = r.get_str(rec.id) && r.get_uint(mods, 1);
+                rec.mods = static_cast<int>(mods);
+                ok = ok && get_mod_values(r, rec);
+                break;
+            case 'd':
+                ok = r.get_str(rec.id);
+                break;
+            case 't':
+                ok = r.get_char(rec.subcommand) && r.get_str(rec.id) && r.get_str(rec.tag_name);
+                if (ok && rec.subcommand != 'd')
+                {
+                    ok = r.get_str(rec.tag_value);
+                }
+                break;
+            default:
+                ok = false;
+        }
+        if (!ok)
+        {
+            error = "malformed record " + tostring(i + 1);
+            records.clear();
+            return false;
+        }
+        records.push_back(rec);
+    }
+    if (!r.done())
+    {
+        error = "trailing bytes after last record";
+        records.clear();
+        return false;
+    }
+    return true;
+}
+
+void sgel_batch::encode(std::string& data) const
+{
+    data.assign(BATCH_MAGIC, BATCH_MAGIC_LEN);
+    put_uint(data, records.size(), 4);
+    for (size_t i = 0, iend = records.size(); i < iend; ++i)
+    {
+        const record& rec = records[i];
+        data += rec.cmd;
+        switch (rec.cmd)
+        {
+            case 'a':
+                put_str(data, rec.id);
+                put_str(data, rec.parent);
+                put_mod_values(data, rec);
+                break;
+            case 'c':
+                put_str(data, rec.id);
+                put_mod_values(data, rec);
+                break;
+            case 'd':
+                put_str(data, rec.id);
+                break;
+            case 't':
+                data += rec.subcommand;
+                put_str(data, rec.id);
+                put_str(data, rec.tag_name);
+                if (rec.subcommand != 'd')
+                {
+                    put_str(data, rec.tag_value);
+                }
+                break;
+        }
+    }
+}
+
+void sgel_batch::add(const std::string& id, const std::string& parent, int mods,
+                     const vec3& pos, const vec3& rot, const vec3& scale,
+                     const ptlist& verts, double radius)
+{
+    change(id, mods, pos, rot, scale, verts, radius);
+    records.back().cmd = 'a';
+    records.back().parent = parent;
+}
+
+void sgel_batch::change(const std::string& id, int mods,
+                        const vec3& pos, const vec3& rot, const vec3& scale,
+                        const ptlist& verts, double radius)
+{
+    record rec;
+    rec.cmd = 'c';
+    rec.subcommand = 0;
+    rec.id = id;
+    rec.mods = mods;
+    rec.pos = pos;
+    rec.rot = rot;
+    rec.scale = scale;
+    if (mods & MOD_VERTS)
+    {
+        rec.verts = verts;
+    }
+    rec.radius = radius;
+    records.push_back(rec);
+}
+
+void sgel_batch::del(const std::string& id)
+{
+    record rec;
+    rec.cmd = 'd';
+    rec.subcommand = 0;
+    rec.mods = 0;
+    rec.radius = 0.0;
+    rec.id = id;
+    records.push_back(rec);
+}
+
+void sgel_batch::tag(char subcommand, const std::string& id, const std::string& name, const std::string& value)
+{
+    record rec;
+    rec.cmd = 't';
+    rec.subcommand = subcommand;
+    rec.mods = 0;
+    rec.radius = 0.0;
+    rec.id = id;
+    rec.tag_name = name;
+    rec.tag_value = value;
+    records.push_back(rec);
+}
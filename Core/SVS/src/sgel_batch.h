@@ -0,0 +1,112 @@
+#ifndef SGEL_BATCH_H
+#define SGEL_BATCH_H
+
+/*
+ Binary form of SGEL scene updates.
+
+ A text SGEL line has to be split into fields and every number parsed
+ from a string. An environment that sends transforms for hundreds of
+ objects every cycle can instead send a binary batch that carries node
+ ids and doubles as they are. svs::add_input recognizes a batch by its
+ leading magic bytes, and the scene applies the whole batch or none of
+ it; see scene::apply_batch.
+
+ Layout, all integers and doubles little-endian:
+
+   "SVSB"                   magic
+   uint32  count            number of records
+   record * count
+
+ Each record starts with the same command letter as its SGEL line:
+
+   'a' str id, str parent, uint8 mods, values
+   'c' str id, uint8 mods, values
+   'd' str id
+   't' uint8 subcommand ('a', 'c' or 'd'), str id, str tag name,
+       str value (not present for 'd')
+
+ A str is a uint32 byte count followed by that many bytes. mods is a bit
+ set of the SGEL modifiers present, and their values follow in this
+ order:
+
+   MOD_POS, MOD_ROT, MOD_SCALE   3 doubles each
+   MOD_VERTS                     uint32 n, then 3n doubles
+   MOD_RADIUS                    1 double
+
+ The encoding functions below are for environments that link against
+ SVS directly. Anything else only has to produce the same bytes.
+*/
+
+#include <string>
+#include <vector>
+#include "mat.h"
+
+class sgel_batch
+{
+    public:
+        enum modifier
+        {
+            MOD_POS    = 1,
+            MOD_ROT    = 2,
+            MOD_SCALE  = 4,
+            MOD_VERTS  = 8,
+            MOD_RADIUS = 16
+        };
+
+        struct record
+        {
+            char          cmd;
+            char          subcommand;
+            int           mods;
+            std::string   id;
+            std::string   parent;
+            std::string   tag_name;
+            std::string   tag_value;
+            vec3          pos;
+            vec3          rot;
+            vec3          scale;
+            ptlist        verts;
+            double        radius;
+        };
+
+        /* True if data starts with the batch magic */
+        static bool is_batch(const std::string& data);
+
+        /*
+         Replaces the contents of this batch with the records in data.
+         Returns false and leaves the batch empty on any malformed or
+         truncated record.
+        */
+        bool decode(const std::string& data, std::string& error);
+        void encode(std::string& data) const;
+
+        /* Appending records; mods selects which of the values are sent */
+        void add(const std::string& id, const std::string& parent, int mods,
+                 const vec3& pos, const vec3& rot, const vec3& scale,
+                 const ptlist& verts, double radius);
+        void change(const std::string& id, int mods,
+                    const vec3& pos, const vec3& rot, const vec3& scale,
+                    const ptlist& verts, double radius);
+        void del(const std::string& id);
+        void tag(char subcommand, const std::string& id, const std::string& name, const std::string& value);
+
+        void clear()
+        {
+            records.clear();
+        }
+
+        size_t size() const
+        {
+            return records.size();
+        }
+
+        const record& get(size_t i) const
+        {
+            return records[i];
+        }
+
+    private:
+        std::vector<record> records;
+};
+
+#endif
@@ -3,6 +3,7 @@
 #include <vector>
 #include <iterator>
 #include <algorithm>
+#include <mutex>
 #include "sgnode.h"
 #include "sgnode_algs.h"
 #include "ccd/ccd.h"
@@ -13,10 +14,19 @@
 typedef std::vector<sgnode*>::iterator childiter;
 typedef std::vector<sgnode*>::const_iterator const_childiter;
 
+static unsigned long last_geometry_version = 0;
+
+/*
+ Filters updated on worker threads (see svs::update_read_cmds) start and
+ stop listening to nodes they share with other filters.
+*/
+static std::mutex listener_lock;
+
 sgnode::sgnode(const std::string& id, bool group)
     : id(id), parent(NULL), group(group),
       pos(0.0, 0.0, 0.0), rot(0.0, 0.0, 0.0), scale(1.0, 1.0, 1.0),
-      shape_dirty(true), bounds_dirty(true), trans_dirty(true)
+      shape_dirty(true), bounds_dirty(true), trans_dirty(true),
+      geometry_version(++last_geometry_version)
 {
     set_help("Reports information about this node.");
 }
@@ -99,6 +109,7 @@ void sgnode::set_transform_dirty()
 {
     trans_dirty = true;
     bounds_dirty = true;
+    geometry_version = ++last_geometry_version;
     if (parent)
     {
         parent->set_shape_dirty();
@@ -111,6 +122,7 @@ void sgnode::set_shape_dirty()
 {
     shape_dirty = true;
     bounds_dirty = true;
+    geometry_version = ++last_geometry_version;
     if (parent)
     {
         parent->set_shape_dirty();
@@ -153,11 +165,13 @@ void sgnode::send_update(sgnode::change_type t, const std::string& update_info)
 
 void sgnode::listen(sgnode_listener* o)
 {
+    std::lock_guard<std::mutex> lock(listener_lock);
     listeners.push_back(o);
 }
 
 void sgnode::unlisten(sgnode_listener* o)
 {
+    std::lock_guard<std::mutex> lock(listener_lock);
     listeners.remove(o);
 }
 
@@ -449,12 +463,9 @@ double group_node::min_project_on_axis(const vec3& axis) const
 void geometry_node::gjk_support(const vec3& dir, vec3& support) const
 {
     vec3 tdir;
-    mat B;
-    transform3 t;
+    const transform3& t = get_world_trans();
 
-    t = get_world_trans();
-    t.get_matrix(B);
-    tdir = B.block(0, 0, 3, 3).transpose() * dir;
+    tdir = t.get_linear().transpose() * dir;
     gjk_local_support(tdir, support);
     support = t(support);
 }
@@ -470,45 +481,53 @@ void geometry_node::walk_geoms(std::vector<const geometry_node*>& g) const
 }
 
 convex_node::convex_node(const std::string& id, const ptlist& v)
-    : geometry_node(id), verts(v), world_verts_dirty(true)
+    : geometry_node(id), vbuf(vertex_buffer::intern(v)), world_verts_version(0)
 {}
 
-sgnode* convex_node::clone_sub() const
+convex_node::convex_node(const std::string& id, const vertex_buffer* v)
+    : geometry_node(id), vbuf(v), world_verts_version(0)
 {
-    return new convex_node(get_id(), verts);
+    vbuf->add_ref();
 }
 
-void convex_node::update_shape()
+convex_node::~convex_node()
 {
-    set_bounds(bbox(get_world_verts()));
+    vbuf->release();
 }
 
-void convex_node::set_transform_dirty_sub()
+sgnode* convex_node::clone_sub() const
 {
-    world_verts_dirty = true;
+    return new convex_node(get_id(), vbuf);
+}
+
+void convex_node::update_shape()
+{
+    set_bounds(bbox(get_world_verts()));
 }
 
 void convex_node::set_verts(const ptlist& v)
 {
-    verts = v;
-    world_verts_dirty = true;
+    const vertex_buffer* old = vbuf;
+    vbuf = vertex_buffer::intern(v);
+    old->release();
     set_shape_dirty();
 }
 
 const ptlist& convex_node::get_world_verts() const
 {
-    if (world_verts_dirty)
+    if (world_verts_version != get_geometry_version())
     {
-        world_verts.clear();
-        world_verts.resize(verts.size());
-        transform(verts.begin(), verts.end(), world_verts.begin(), get_world_trans());
-        world_verts_dirty = false;
+        const ptlist& local = get_verts();
+        world_verts.resize(local.size());
+        transform(local.begin(), local.end(), world_verts.begin(), get_world_trans());
+        world_verts_version = get_geometry_version();
     }
     return world_verts;
 }
 
 void convex_node::get_shape_sgel(std::string& s) const
 {
+    const ptlist& verts = get_verts();
     std::stringstream ss;
     ss << "v ";
     for (size_t i = 0; i < verts.size(); ++i)
@@ -523,6 +542,7 @@ void convex_node::get_shape_sgel(std::string& s) const
 */
 void convex_node::gjk_local_support(const vec3& dir, vec3& support) const
 {
+    const ptlist& verts = get_verts();
     double dp, best = 0.0;
     long long best_i = -1;
 
@@ -542,13 +562,20 @@ void convex_node::proxy_use_sub(const std::vector<std::string>& args, std::ostre
 {
     sgnode::proxy_use_sub(args, os);
 
+    const ptlist& verts = get_verts();
     table_printer t;
     for (size_t i = 0, iend = verts.size(); i < iend; ++i)
     {
         t.add_row() << verts[i](0) << verts[i](1) << verts[i](2);
     }
 
-    os << std::endl << "vertices" << std::endl;
+    os << std::endl << "vertices";
+    int sharing = vbuf->num_refs() - 1;
+    if (sharing > 0)
+    {
+        os << " (shared with " << sharing << " other nodes)";
+    }
+    os << std::endl;
     t.print(os);
 }
 
@@ -9,6 +9,7 @@
 #include "common.h"
 #include "mat.h"
 #include "cliproxy.h"
+#include "vertex_buffer.h"
 
 class sgnode_listener;
 class group_node;
@@ -80,6 +81,16 @@ class sgnode : public cliproxy
         
         const bbox& get_bounds() const;
         vec3 get_centroid() const;
+        
+        /*
+         Changes whenever the world transform or shape of this node does.
+         Versions are never reused, even by other nodes, so a node together
+         with its version identifies one particular geometry.
+        */
+        unsigned long get_geometry_version() const
+        {
+            return geometry_version;
+        }
         bool has_descendent(const sgnode* n) const;
         
         void proxy_use_sub(const std::vector<std::string>& args, std::ostream& os);
@@ -135,6 +146,8 @@ class sgnode : public cliproxy
         mutable transform3 ltransform;
         mutable bool       trans_dirty;
         
+        unsigned long geometry_version;
+        
         std::list<sgnode_listener*> listeners;
         
         tag_map tags;
@@ -196,14 +209,20 @@ class geometry_node : public sgnode
         virtual void gjk_local_support(const vec3& dir, vec3& support) const = 0;
 };
 
+/*
+ Local vertices live in a shared vertex_buffer, see vertex_buffer.h. The
+ world-space vertices are computed the first time they're asked for at
+ each geometry version.
+*/
 class convex_node : public geometry_node
 {
     public:
         convex_node(const std::string& id, const ptlist& v);
+        ~convex_node();
         
         const ptlist& get_verts() const
         {
-            return verts;
+            return vbuf->get_verts();
         }
         const ptlist& get_world_verts() const;
         void set_verts(const ptlist& v);
@@ -216,13 +235,14 @@ class convex_node : public geometry_node
         double min_project_on_axis(const vec3& axis) const; 
         
     private:
-        void set_transform_dirty_sub();
+        convex_node(const std::string& id, const vertex_buffer* v);
+
         void update_shape();
         sgnode* clone_sub() const;
         
-        ptlist verts;
-        mutable ptlist world_verts;
-        mutable bool world_verts_dirty;
+        const vertex_buffer*  vbuf;
+        mutable ptlist        world_verts;
+        mutable unsigned long world_verts_version;  // 0 until computed
 };
 
 class ball_node : public geometry_node
@@ -9,6 +9,7 @@
 #include "ccd/ccd.h"
 #include "params.h"
 #include "scene.h"
+#include "ray_cast.h"
 
 #include <iostream>
 
@@ -270,6 +271,13 @@ bool bbox_contains(const sgnode* a, const sgnode* b)
     return boxa.contains(boxb);
 }
 
+// Returns the distance between the bounding boxes of nodes a and b,
+//   which is never more than their convex_distance
+double bbox_distance(const sgnode* a, const sgnode* b)
+{
+    return a->get_bounds().distance(b->get_bounds());
+}
+
 /*
  * Returns the estimated percentage of node n1
  *   that is contained within node n2
@@ -425,39 +433,20 @@ double convex_occlusion(view_line_list& view_lines, const c_sgnode_list& occlude
 		return 0;
 	}
 
-	// Go through every other object in the given set and see if it occludes any view lines
-	int num_occluded = 0;
-
+	// Each view line is a two point convex node between the eye and a vertex
+	ray_caster rays;
 	for(view_line_list::iterator i = view_lines.begin(); i != view_lines.end(); i++){
-		i->second = false;
+		const ptlist& ends = i->first->get_world_verts();
+		rays.add_ray(ends[0], ends[1]);
 	}
+	rays.run(occluders, NULL);
 
-	for(c_sgnode_list::const_iterator i = occluders.begin(); i != occluders.end(); i++){
-		const sgnode* n = *i;
-		//std::cout << "Testing Object " << n->get_id() << std::endl;
-		for(view_line_list::iterator j = view_lines.begin(); j != view_lines.end(); j++){
-			view_line& view_line = *j;
-			if(view_line.second){
-				// Already occluded, don't bother checking again
-				continue;
-			}
-			double dist = convex_distance(n, view_line.first);
-			if(dist <= 0){
-				if(n->get_id() == "arm"){
-					//std::cout << "ARM OCCLUSION!" << std::endl;
-				}
-				//std::cout << "Occlusion detected" << std::endl;
-				//std::cout << "  " << j->first->get_id() << std::endl;
-				//std::cout << "  " << n->get_id() << std::endl;
-
-				view_line.second = true;
-				num_occluded++;
-			}
-		}
+	for(size_t i = 0; i < view_lines.size(); i++){
+		view_lines[i].second = rays.blocked(i);
 	}
 
 	// Count the number of view lines occluded and return the fraction
-	return ((double)num_occluded)/view_lines.size();
+	return ((double)rays.num_blocked())/view_lines.size();
 }
 
 double convex_occlusion(const sgnode* a, const sgnode* eye, const std::vector<const sgnode*>& occluders){
@@ -26,6 +26,8 @@ bool bbox_intersects(const sgnode* a, const sgnode* b);
 
 bool bbox_contains(const sgnode* a, const sgnode* b);
 
+double bbox_distance(const sgnode* a, const sgnode* b);
+
 double convex_overlap(const sgnode* a, const sgnode* b, int nsamples);
 
 typedef std::pair<convex_node*, bool> view_line;
@@ -0,0 +1,115 @@
+#ifndef STAGE_TIMERS_H
+#define STAGE_TIMERS_H
+
+/*
+ Wall-clock time spent in each stage of SVS's work, for profiling.
+
+ Each agent's svs object owns one set, shown and controlled with
+ "svs timers". Timing is off until turned on, so the stages cost nothing
+ more than a flag check in normal runs. Stages are named by the code
+ that times them:
+
+   input            applying SGEL and binary scene updates
+   sgwme_update     mirroring scene graph changes into working memory
+   state_creation   making the svs state and scene for a new Soar state
+   scene_copy       giving a substate scene its own copy of shared nodes
+   commands         reading new and changed commands off the command links
+   write_commands   updating commands that change the scene
+   filters          updating commands that only read the scene
+   filter <type>    the part of filters spent in filters of one type
+
+ Stages can nest. sgwme_update, for example, also counts toward the
+ input or command stage whose scene change it mirrors.
+
+ Only use a set from one thread at a time.
+*/
+
+#include <chrono>
+#include <map>
+#include <string>
+#include <iomanip>
+#include <ostream>
+
+class stage_timers
+{
+    public:
+        stage_timers() : enabled(false) {}
+
+        bool is_enabled() const
+        {
+            return enabled;
+        }
+
+        void set_enabled(bool e)
+        {
+            enabled = e;
+        }
+
+        void add(const std::string& stage, double seconds)
+        {
+            entry& e = entries[stage];
+            e.seconds += seconds;
+            ++e.calls;
+        }
+
+        void reset()
+        {
+            entries.clear();
+        }
+
+        /* One line per stage: name, calls, total seconds, and microseconds per call */
+        void print(std::ostream& os) const
+        {
+            std::map<std::string, entry>::const_iterator i;
+            os << std::left << std::setw(32) << "stage" << std::right << std::setw(10) << "calls"
+               << std::setw(14) << "total_sec" << std::setw(14) << "usec_per_call" << std::endl;
+            for (i = entries.begin(); i != entries.end(); ++i)
+            {
+                os << std::left << std::setw(32) << i->first << std::right << std::setw(10) << i->second.calls
+                   << std::fixed << std::setprecision(6) << std::setw(14) << i->second.seconds
+                   << std::setprecision(2) << std::setw(14) << (1e6 * i->second.seconds / i->second.calls) << std::endl;
+            }
+        }
+
+    private:
+        struct entry
+        {
+            entry() : seconds(0.0), calls(0) {}
+            double seconds;
+            long   calls;
+        };
+
+        bool enabled;
+        std::map<std::string, entry> entries;
+};
+
+/* Adds the time from construction to destruction to one stage, if timing is on */
+class stage_timer
+{
+    public:
+        stage_timer(stage_timers& timers, const char* stage)
+            : timers(timers), stage(stage), running(timers.is_enabled())
+        {
+            if (running)
+            {
+                start = std::chrono::steady_clock::now();
+            }
+        }
+
+        ~stage_timer()
+        {
+            if (running)
+            {
+                std::chrono::duration<double> d = std::chrono::steady_clock::now() - start;
+                timers.add(stage, d.count());
+            }
+        }
+
+    private:
+        stage_timers& timers;
+        const char* stage;
+        bool running;
+        std::chrono::steady_clock::time_point start;
+};
+
+#endif
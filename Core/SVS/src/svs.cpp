@@ -17,6 +17,9 @@
 #include "filter_table.h"
 #include "command_table.h"
 #include "drawer.h"
+#include "filter.h"
+#include "worker_pool.h"
+#include "filters/base_node_filters.h"
 
 #include "symbol.h"
 
@@ -28,18 +31,23 @@ svs_interface* make_svs(agent* a)
 }
 
 
-sgwme::sgwme(soar_interface* si, Symbol* ident, sgwme* parent, sgnode* node)
-    : parent(parent), node(node), id(ident), soarint(si)
+sgwme::sgwme(svs_state* owner, Symbol* ident, sgwme* parent, sgnode* node)
+    : owner(owner), parent(parent), node(node), id(ident)
 {
+    soarint = owner->get_svs()->get_soar_interface();
+    timers = &owner->get_svs()->get_timers();
     node->listen(this);
-    id_wme = soarint->make_wme(id, si->get_common_syms().id, node->get_id());
+    id_wme = soarint->make_wme(id, soarint->get_common_syms().id, node->get_id());
 
     if (node->is_group())
     {
         group_node* g = node->as_group();
         for (size_t i = 0; i < g->num_children(); ++i)
         {
-            add_child(g->get_child(i));
+            if (owner->mirrors(g->get_child(i)))
+            {
+                add_child(g->get_child(i));
+            }
         }
     }
 
@@ -55,6 +63,7 @@ sgwme::~sgwme()
 {
     std::map<sgwme*, wme*>::iterator i;
 
+    owner->sgwme_deleted(this);
     if (node)
     {
         node->unlisten(this);
@@ -84,6 +93,7 @@ sgwme::~sgwme()
 
 void sgwme::node_update(sgnode* n, sgnode::change_type t, const std::string& update_info)
 {
+    stage_timer timer(*timers, "sgwme_update");
     int added_child = 0;
     group_node* g;
     switch (t)
@@ -92,7 +102,15 @@ void sgwme::node_update(sgnode* n, sgnode::change_type t, const std::string& upd
             if (parse_int(update_info, added_child))
             {
                 g = node->as_group();
-                add_child(g->get_child(added_child));
+                if (owner->mirrors(g->get_child(added_child)))
+                {
+                    add_child(g->get_child(added_child));
+                }
+                else if (g->get_child(added_child)->is_group())
+                {
+                    // a subscribed node could be added under it later this cycle
+                    owner->declined_child();
+                }
             }
             break;
         case sgnode::DELETED:
@@ -100,16 +118,81 @@ void sgwme::node_update(sgnode* n, sgnode::change_type t, const std::string& upd
             delete this;
             break;
         case sgnode::TAG_CHANGED:
-            update_tag(update_info);
-            break;
         case sgnode::TAG_DELETED:
-            delete_tag(update_info);
+            changed_tags.insert(update_info);
+            owner->tags_changed(this);
             break;
         default:
             break;
     };
 }
 
+void sgwme::rebind(sgnode* n)
+{
+    node->unlisten(this);
+    node = n;
+    node->listen(this);
+
+    if (childs.empty())
+    {
+        return;
+    }
+
+    group_node* g = node->as_group();
+    std::map<std::string, sgnode*> by_id;
+    for (size_t i = 0, iend = g->num_children(); i < iend; ++i)
+    {
+        by_id[g->get_child(i)->get_id()] = g->get_child(i);
+    }
+
+    std::map<sgwme*, wme*>::iterator i;
+    for (i = childs.begin(); i != childs.end(); ++i)
+    {
+        sgnode* c = NULL;
+        map_get(by_id, i->first->node->get_id(), c);
+        assert(c);
+        i->first->rebind(c);
+    }
+}
+
+void sgwme::sync()
+{
+    if (!node->is_group())
+    {
+        return;
+    }
+
+    std::map<sgnode*, sgwme*> mirrored;
+    std::map<sgwme*, wme*>::iterator i;
+    for (i = childs.begin(); i != childs.end(); ++i)
+    {
+        mirrored[i->first->node] = i->first;
+    }
+
+    group_node* g = node->as_group();
+    for (size_t j = 0, jend = g->num_children(); j < jend; ++j)
+    {
+        sgnode* c = g->get_child(j);
+        sgwme* w = NULL;
+        bool wanted = owner->mirrors(c);
+        if (map_get(mirrored, c, w))
+        {
+            if (wanted)
+            {
+                w->sync();
+            }
+            else
+            {
+                delete w;
+            }
+        }
+        else if (wanted)
+        {
+            add_child(c);
+        }
+    }
+}
+
 void sgwme::add_child(sgnode* c)
 {
     char letter;
@@ -126,7 +209,7 @@ void sgwme::add_child(sgnode* c)
     }
     wme* cid_wme = soarint->make_id_wme(id, "child");
 
-    child = new sgwme(soarint, soarint->get_wme_val(cid_wme), this, c);
+    child = new sgwme(owner, soarint->get_wme_val(cid_wme), this, c);
     childs[child] = cid_wme;
 }
 
@@ -138,18 +221,32 @@ void sgwme::set_tag(const std::string& tag_name, const std::string& tag_value)
     wme* value_wme;
     if (map_get(tags, tag_name, value_wme))
     {
+        std::string old_value;
+        if (get_symbol_value(soarint->get_wme_val(value_wme), old_value) && old_value == tag_value)
+        {
+            return;
+        }
         soarint->remove_wme(value_wme);
     }
     tags[tag_name] = soarint->make_wme(rootID, att, tag_value);
 }
 
-void sgwme::update_tag(const std::string& tag_name)
+void sgwme::flush_tags()
 {
-    std::string tag_value;
-    if (node->get_tag(tag_name, tag_value))
+    std::set<std::string>::iterator i;
+    for (i = changed_tags.begin(); i != changed_tags.end(); ++i)
     {
-        set_tag(tag_name, tag_value);
+        std::string tag_value;
+        if (node->get_tag(*i, tag_value))
+        {
+            set_tag(*i, tag_value);
+        }
+        else
+        {
+            delete_tag(*i);
+        }
     }
+    changed_tags.clear();
 }
 
 void sgwme::delete_tag(const std::string& tag_name)
@@ -165,7 +262,7 @@ void sgwme::delete_tag(const std::string& tag_name)
 
 svs_state::svs_state(svs* svsp, Symbol* state, soar_interface* si, scene* scn)
     : svsp(svsp), level(0), parent(NULL), scn(scn), si(si),
-      state(state), scene_link(NULL), scene_num(-1), scene_num_wme(NULL)
+      state(state), scene_link(NULL), scene_num(-1), scene_num_wme(NULL), mirror_dirty(false)
 {
     assert(state->is_top_state());
     state->get_id_name(name);
@@ -174,7 +271,7 @@ svs_state::svs_state(svs* svsp, Symbol* state, soar_interface* si, scene* scn)
 
 svs_state::svs_state(Symbol* state, svs_state* parent)
     : svsp(parent->svsp), level(parent->level + 1), parent(parent), scn(NULL),
-      si(parent->si), state(state), scene_link(NULL), scene_num(-1), scene_num_wme(NULL)
+      si(parent->si), state(state), scene_link(NULL), scene_num(-1), scene_num_wme(NULL), mirror_dirty(false)
 {
     assert(state->get_parent_state() == parent->state);
     init();
@@ -189,10 +286,14 @@ svs_state::~svs_state()
         delete i->cmd;
     }
 
+    if (root)
+    {
+        delete root;
+    }
     if (scn)
     {
         svsp->get_drawer()->delete_scene(scn->get_name());
-        delete scn; // results in root being deleted also
+        delete scn;
     }
 }
 
@@ -208,7 +309,7 @@ void svs_state::init()
     {
         if (parent)
         {
-            scn = parent->scn->clone(name);
+            scn = parent->scn->make_overlay(name, svsp->is_live_substate_scenes());
         }
         else
         {
@@ -218,7 +319,7 @@ void svs_state::init()
         }
     }
     scn->refresh_draw();
-    root = new sgwme(si, scene_link, (sgwme*) NULL, scn->get_root());
+    root = new sgwme(this, scene_link, (sgwme*) NULL, scn->get_root());
 }
 
 void svs_state::update_scene_num()
@@ -254,6 +355,23 @@ void svs_state::update_cmd_results(int command_type)
     }
 }
 
+void svs_state::begin_cmd_results(int command_type, std::vector<command*>& cmds, std::vector<filter*>& filters)
+{
+    command_set_it i;
+    for (i = curr_cmds.begin(); i != curr_cmds.end(); ++i)
+    {
+        if (i->cmd->command_type() == command_type)
+        {
+            filter* f = i->cmd->begin_update();
+            if (f)
+            {
+                cmds.push_back(i->cmd);
+                filters.push_back(f);
+            }
+        }
+    }
+}
+
 void svs_state::process_cmds()
 {
     wme_vector all;
@@ -327,6 +445,10 @@ void svs_state::process_cmds()
         command* c = get_command_table().make_command(this, new_cmd->cmd_wme);
         if (c)
         {
+            if (c->command_type() == SVS_WRITE_COMMAND)
+            {
+                svsp->make_scene_private(scn);
+            }
             curr_cmds.insert(command_entry(new_cmd->id, c, 0));
             svs::mark_filter_dirty_bit();
         }
@@ -351,11 +473,133 @@ void svs_state::proxy_get_children(std::map<std::string, cliproxy*>& c)
 void svs_state::disown_scene()
 {
     delete root;
+    root = NULL;
     scn = NULL;
 }
 
+void svs_state::make_scene_private()
+{
+    if (!scn->get_source())
+    {
+        return;
+    }
+    reset_scene_refs();
+    scn->copy_source_nodes();
+    root->rebind(scn->get_root());
+}
+
+void svs_state::reshare_scene()
+{
+    reset_scene_refs();
+    scn->reshare_source_nodes();
+    root->rebind(scn->get_root());
+}
+
+bool svs_state::mirrors(const sgnode* n) const
+{
+    if (!svsp->is_sparse_mirror())
+    {
+        return true;
+    }
+    for (const sgnode* a = n; a; a = a->get_parent())
+    {
+        if (subscriptions.find(a->get_id()) != subscriptions.end())
+        {
+            return true;
+        }
+    }
+    if (!n->is_group())
+    {
+        return false;
+    }
+    std::map<std::string, subscription>::const_iterator i;
+    for (i = subscriptions.begin(); i != subscriptions.end(); ++i)
+    {
+        const sgnode* s = scn->get_node(i->first);
+        if (s && n->has_descendent(s))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void svs_state::subscribe(const std::string& node_id)
+{
+    if (subscriptions[node_id].count++ == 0)
+    {
+        mirror_dirty = true;
+    }
+}
+
+void svs_state::unsubscribe(const std::string& node_id)
+{
+    std::map<std::string, subscription>::iterator i = subscriptions.find(node_id);
+    if (i != subscriptions.end() && --i->second.count == 0)
+    {
+        subscriptions.erase(i);
+        mirror_dirty = true;
+    }
+}
+
+void svs_state::tags_changed(sgwme* w)
+{
+    tag_changes.insert(w);
+}
+
+void svs_state::sgwme_deleted(sgwme* w)
+{
+    tag_changes.erase(w);
+}
+
+void svs_state::update_mirror()
+{
+    if (!root)
+    {
+        return;
+    }
+
+    /* a subscribed node coming or going can change which of its ancestors are needed */
+    std::map<std::string, subscription>::iterator i;
+    for (i = subscriptions.begin(); i != subscriptions.end(); ++i)
+    {
+        if ((scn->get_node(i->first) != NULL) != i->second.present)
+        {
+            mirror_dirty = true;
+        }
+    }
+
+    if (mirror_dirty)
+    {
+        stage_timer timer(svsp->get_timers(), "sgwme_update");
+        root->sync();
+        for (i = subscriptions.begin(); i != subscriptions.end(); ++i)
+        {
+            i->second.present = (scn->get_node(i->first) != NULL);
+        }
+        mirror_dirty = false;
+    }
+
+    std::set<sgwme*>::iterator j;
+    for (j = tag_changes.begin(); j != tag_changes.end(); ++j)
+    {
+        (**j).flush_tags();
+    }
+    tag_changes.clear();
+}
+
+/* Commands must let go of the old nodes before the scene swaps them out */
+void svs_state::reset_scene_refs()
+{
+    command_set_it i, iend;
+    for (i = curr_cmds.begin(), iend = curr_cmds.end(); i != iend; ++i)
+    {
+        i->cmd->reset_scene_refs();
+    }
+}
+
 svs::svs(agent* a)
-    : scn_cache(NULL), enabled(false)
+    : scn_cache(NULL), filter_pool(NULL), enabled(false), sparse_mirror(false), live_substate_scenes(false)
 {
     si = new soar_interface(a);
     draw = new drawer();
@@ -365,7 +609,8 @@ bool svs::filter_dirty_bit = true;
 
 svs::~svs()
 {
-    for (size_t i = 0, iend = state_stack.size(); i < iend; ++i)
+    // substate scenes may share nodes with their parents, so go bottom up
+    for (int i = static_cast<int>(state_stack.size()) - 1; i >= 0; --i)
     {
         delete state_stack[i];
     }
@@ -374,6 +619,7 @@ svs::~svs()
         delete scn_cache;
     }
 
+    delete filter_pool;
     delete si;
     delete draw;
 }
@@ -387,6 +633,7 @@ void svs::state_creation_callback(Symbol* state)
     {
         return;
     }
+    stage_timer timer(timers, "state_creation");
 
     if (state_stack.empty())
     {
@@ -427,10 +674,56 @@ void svs::state_deletion_callback(Symbol* state)
     state_stack.pop_back();
 }
 
+void svs::make_scene_private(scene* s)
+{
+    size_t i, iend;
+    if (!s->get_source())
+    {
+        return;
+    }
+    stage_timer timer(timers, "scene_copy");
+    for (i = 0, iend = state_stack.size(); i < iend && state_stack[i]->get_scene() != s; ++i)
+        ;
+    if (i == iend)
+    {
+        s->copy_source_nodes();
+        return;
+    }
+    state_stack[i]->make_scene_private();
+    for (++i; i < iend && state_stack[i]->get_scene()->get_source() == state_stack[i - 1]->get_scene(); ++i)
+    {
+        state_stack[i]->reshare_scene();
+    }
+}
+
+void svs::prepare_scene_write(scene* s)
+{
+    std::vector<scene*> snapshots;
+    const std::vector<scene*>& overlays = s->get_overlays();
+    for (size_t i = 0, iend = overlays.size(); i < iend; ++i)
+    {
+        if (!overlays[i]->is_live())
+        {
+            snapshots.push_back(overlays[i]);
+        }
+    }
+    for (size_t i = 0, iend = snapshots.size(); i < iend; ++i)
+    {
+        make_scene_private(snapshots[i]);
+    }
+    make_scene_private(s);
+}
+
 void svs::proc_input(svs_state* s)
 {
+    stage_timer timer(timers, "input");
     for (size_t i = 0; i < env_inputs.size(); ++i)
     {
+        if (sgel_batch::is_batch(env_inputs[i]))
+        {
+            s->get_scene()->parse_binary(env_inputs[i]);
+            continue;
+        }
         strip(env_inputs[i], " \t");
         s->get_scene()->parse_sgel(env_inputs[i]);
     }
@@ -449,6 +742,7 @@ void svs::output_callback()
     }
     std::vector<svs_state*>::iterator i;
     std::string sgel;
+    stage_timer timer(timers, "commands");
 
     for (i = state_stack.begin(); i != state_stack.end(); ++i)
     {
@@ -472,26 +766,111 @@ void svs::input_callback()
 
     std::vector<svs_state*>::iterator i;
 
-    for (i = state_stack.begin(); i != state_stack.end(); ++i)
     {
-        (**i).update_cmd_results(SVS_WRITE_COMMAND);
+        stage_timer timer(timers, "write_commands");
+        for (i = state_stack.begin(); i != state_stack.end(); ++i)
+        {
+            (**i).update_cmd_results(SVS_WRITE_COMMAND);
+        }
+    }
+
+    {
+        stage_timer timer(timers, "filters");
+        if (filter_pool)
+        {
+            update_read_cmds();
+        }
+        else
+        {
+            for (i = state_stack.begin(); i != state_stack.end(); ++i)
+            {
+                (**i).update_cmd_results(SVS_READ_COMMAND);
+            }
+        }
     }
 
     for (i = state_stack.begin(); i != state_stack.end(); ++i)
     {
-        (**i).update_cmd_results(SVS_READ_COMMAND);
+        (**i).update_mirror();
     }
 
     svs::filter_dirty_bit = false;
 }
 
+/*
+ Same as calling update_cmd_results(SVS_READ_COMMAND) on every state, but
+ the filters are updated on the worker pool. Everything that touches
+ working memory happens on this thread: the commands start their updates
+ state by state, the filters run, and then the commands write their
+ results in the same order they started in, so working memory changes
+ come out the same no matter how the filters were scheduled.
+*/
+void svs::update_read_cmds()
+{
+    std::vector<command*> cmds;
+    std::vector<filter*> filters;
+
+    for (size_t i = 0, iend = state_stack.size(); i < iend; ++i)
+    {
+        state_stack[i]->begin_cmd_results(SVS_READ_COMMAND, cmds, filters);
+    }
+    if (filters.empty())
+    {
+        return;
+    }
+
+    /* filters only read the scenes, as long as nothing is left to compute lazily */
+    for (size_t i = 0, iend = state_stack.size(); i < iend; ++i)
+    {
+        state_stack[i]->get_scene()->update_caches();
+    }
+
+    std::vector<char> ok(filters.size());
+    std::vector<double> secs(filters.size());
+    bool timed = timers.is_enabled();
+    filter::defer_status_changes(true);
+    filter_pool->run(filters.size(), [&filters, &ok, &secs, timed](size_t i)
+    {
+        std::chrono::steady_clock::time_point start;
+        if (timed)
+        {
+            start = std::chrono::steady_clock::now();
+        }
+        ok[i] = filters[i]->update();
+        if (timed)
+        {
+            secs[i] = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    });
+    filter::defer_status_changes(false);
+
+    /* stage_timers isn't thread safe, so the workers' times are added here */
+    for (size_t i = 0; timed && i < filters.size(); ++i)
+    {
+        timers.add("filter " + filters[i]->get_type(), secs[i]);
+    }
+
+    for (size_t i = 0, iend = cmds.size(); i < iend; ++i)
+    {
+        cmds[i]->end_update(ok[i] != 0);
+    }
+}
+
 /*
  This is a naive implementation. If this method is called concurrently
  with proc_input, the env_inputs std::vector will probably become
  inconsistent. This eventually needs to be replaced by a thread-safe FIFO.
+
+ Binary batches (see sgel_batch.h) are queued whole, in order with any
+ SGEL lines around them.
 */
 void svs::add_input(const std::string& in)
 {
+    if (sgel_batch::is_batch(in))
+    {
+        env_inputs.push_back(in);
+        return;
+    }
     split(in, "\n", env_inputs);
 }
 
@@ -514,6 +893,31 @@ void svs::proxy_get_children(std::map<std::string, cliproxy*>& c)
     c["disconnect_viewer"] = new memfunc_proxy<svs>(this, &svs::cli_disconnect_viewer);
     c["disconnect_viewer"]->set_help("Disconnect from viewer.");
 
+    c["filter_threads"]    = new memfunc_proxy<svs>(this, &svs::cli_filter_threads);
+    c["filter_threads"]->set_help("Print or set the number of worker threads for filter updates.")
+    .add_arg("[N]", "Number of workers. 0 updates filters serially.")
+    ;
+
+    c["timers"]            = new memfunc_proxy<svs>(this, &svs::cli_timers);
+    c["timers"]->set_help("Print time spent in each stage of SVS processing.")
+    .add_arg("[on | off | reset]", "Turn timing on or off, or clear the times.")
+    ;
+
+    c["filter_cache"]      = new memfunc_proxy<svs>(this, &svs::cli_filter_cache);
+    c["filter_cache"]->set_help("Print how often node filters reused a cached result instead of computing one.")
+    .add_arg("[reset]", "Set both counts back to zero.")
+    ;
+
+    c["mirror"]            = new memfunc_proxy<svs>(this, &svs::cli_mirror);
+    c["mirror"]->set_help("Print or set which scene nodes are mirrored on the scene links.")
+    .add_arg("[full | sparse]", "Mirror every node, or only nodes named by subscribe commands.")
+    ;
+
+    c["substate_scenes"]   = new memfunc_proxy<svs>(this, &svs::cli_substate_scenes);
+    c["substate_scenes"]->set_help("Print or set whether new substate scenes keep a snapshot of their parent's scene or follow its changes.")
+    .add_arg("[snapshot | live]", "Keep the parent's scene as it was when the substate was created, or see its changes until the substate writes.")
+    ;
+
     c["filters"]           = &get_filter_table();
     c["commands"]          = &get_command_table();
 
@@ -569,3 +973,97 @@ void svs::cli_disconnect_viewer(const std::vector<std::string>& args, std::ostre
 {
     draw->disconnect();
 }
+
+void svs::cli_filter_threads(const std::vector<std::string>& args, std::ostream& os)
+{
+    int n;
+    if (args.empty())
+    {
+        os << (filter_pool ? filter_pool->size() : 0) << std::endl;
+        return;
+    }
+    if (!parse_int(args[0], n) || n < 0)
+    {
+        os << "expecting a non-negative number of threads" << std::endl;
+        return;
+    }
+    delete filter_pool;
+    filter_pool = (n > 0) ? new worker_pool(n) : NULL;
+}
+
+void svs::cli_timers(const std::vector<std::string>& args, std::ostream& os)
+{
+    if (args.empty())
+    {
+        if (!timers.is_enabled())
+        {
+            os << "timers are off, use \"svs timers on\" to turn them on" << std::endl;
+        }
+        timers.print(os);
+    }
+    else if (args[0] == "on" || args[0] == "off")
+    {
+        timers.set_enabled(args[0] == "on");
+    }
+    else if (args[0] == "reset")
+    {
+        timers.reset();
+    }
+    else
+    {
+        os << "expecting on, off, or reset" << std::endl;
+    }
+}
+
+void svs::cli_filter_cache(const std::vector<std::string>& args, std::ostream& os)
+{
+    node_cache_counts& counts = get_node_cache_counts();
+    if (args.empty())
+    {
+        os << "hits: " << counts.hits << std::endl;
+        os << "computed: " << counts.computed << std::endl;
+    }
+    else if (args[0] == "reset")
+    {
+        counts.hits = 0;
+        counts.computed = 0;
+    }
+    else
+    {
+        os << "expecting reset" << std::endl;
+    }
+}
+
+void svs::cli_substate_scenes(const std::vector<std::string>& args, std::ostream& os)
+{
+    if (args.empty())
+    {
+        os << (live_substate_scenes ? "live" : "snapshot") << std::endl;
+        return;
+    }
+    if (args[0] != "snapshot" && args[0] != "live")
+    {
+        os << "expecting snapshot or live" << std::endl;
+        return;
+    }
+    live_substate_scenes = (args[0] == "live");
+}
+
+void svs::cli_mirror(const std::vector<std::string>& args, std::ostream& os)
+{
+    if (args.empty())
+    {
+        os << (sparse_mirror ? "sparse" : "full") << std::endl;
+        return;
+    }
+    if (args[0] != "full" && args[0] != "sparse")
+    {
+        os << "expecting full or sparse" << std::endl;
+        return;
+    }
+    sparse_mirror = (args[0] == "sparse");
+    for (size_t i = 0, iend = state_stack.size(); i < iend; ++i)
+    {
+        state_stack[i]->set_mirror_dirty();
+    }
+}
@@ -9,16 +9,29 @@
 #include "common.h"
 #include "svs_interface.h"
 #include "cliproxy.h"
+#include "stage_timers.h"
 
 class command;
 class scene;
 class drawer;
+class filter;
+class worker_pool;
 
-/* working memory scene graph object - mediates between wmes and scene graph nodes */
+class svs_state;
+
+/*
+ working memory scene graph object - mediates between wmes and scene graph nodes
+
+ Which children get mirrored is up to the owning state (see
+ svs_state::mirrors). Tag changes are only noted as they happen and are
+ written to working memory together by svs_state::update_mirror, so a tag
+ that changes several times, or changes and changes back, in one cycle
+ costs at most one wme change.
+*/
 class sgwme : public sgnode_listener
 {
     public:
-        sgwme(soar_interface* si, Symbol* ident, sgwme* parent, sgnode* node);
+        sgwme(svs_state* owner, Symbol* ident, sgwme* parent, sgnode* node);
         ~sgwme();
         void node_update(sgnode* n, sgnode::change_type t, const std::string& update_info);
         Symbol* get_id()
@@ -34,23 +47,40 @@ class sgwme : public sgnode_listener
             return &childs;
         }
 
+        /*
+         Switch this sgwme and its children over to an identical copy of the
+         nodes they mirror, leaving working memory alone.
+        */
+        void rebind(sgnode* n);
+
+        /*
+         Mirror the children the owner now wants mirrored and drop the
+         rest, all the way down.
+        */
+        void sync();
+
+        /* Write the tags changed since the last call to working memory */
+        void flush_tags();
+
     private:
         void add_child(sgnode* c);
 
         // Functions dealing with maintaining tags on sgnodes
-        void update_tag(const std::string& tag_name);
         void delete_tag(const std::string& tag_name);
         void set_tag(const std::string& tag_name, const std::string& tag_value);
 
+        svs_state*      owner;
         sgwme*          parent;
         sgnode*         node;
         Symbol*         id;
         wme*            id_wme;
         soar_interface* soarint;
+        stage_timers*   timers;
 
         std::map<sgwme*, wme*> childs;
 
         std::map<std::string, wme*> tags;
+        std::set<std::string>       changed_tags;
 };
 
 
@@ -82,6 +112,13 @@ class svs_state : public cliproxy
 
         void           process_cmds();
         void           update_cmd_results(int command_type);
+        
+        /*
+         Starts the update of every command of the given type, appending
+         those with a filter left to run to cmds and their filters to
+         filters. See command::begin_update.
+        */
+        void           begin_cmd_results(int command_type, std::vector<command*>& cmds, std::vector<filter*>& filters);
         void           update_scene_num();
         void           clear_scene();
 
@@ -116,8 +153,45 @@ class svs_state : public cliproxy
         */
         void disown_scene();
 
+        /*
+         Give this state's overlay scene its own nodes, or point it at its
+         source's new ones, carrying the sgwmes and commands along. Called
+         by svs::make_scene_private.
+        */
+        void make_scene_private();
+        void reshare_scene();
+
+        /*
+         Nodes are mirrored into working memory on demand when the agent
+         asks for sparse mirroring (svs mirror sparse): only nodes that a
+         subscribe command names, their descendants, and the ancestors
+         leading to them. Otherwise every node is mirrored.
+        */
+        bool mirrors(const sgnode* n) const;
+        void subscribe(const std::string& node_id);
+        void unsubscribe(const std::string& node_id);
+
+        /* Called by sgwmes */
+        void tags_changed(sgwme* w);
+        void sgwme_deleted(sgwme* w);
+        void declined_child()
+        {
+            mirror_dirty = true;
+        }
+        void set_mirror_dirty()
+        {
+            mirror_dirty = true;
+        }
+
+        /*
+         Bring working memory up to date with the subscriptions and write
+         this cycle's tag changes. Called once per input phase.
+        */
+        void update_mirror();
+
     private:
         void init();
+        void reset_scene_refs();
         void collect_cmds(Symbol* id, std::set<wme*>& all_cmds);
 
         void proxy_get_children(std::map<std::string, cliproxy*>& c);
@@ -141,6 +215,20 @@ class svs_state : public cliproxy
 
         /* command changes per decision cycle */
         command_set curr_cmds;
+
+        /*
+         Subscribed node ids, with the number of commands subscribing to
+         each and whether the node was in the scene at the last sync.
+        */
+        struct subscription
+        {
+            subscription() : count(0), present(false) {}
+            int  count;
+            bool present;
+        };
+        std::map<std::string, subscription> subscriptions;
+        std::set<sgwme*>                    tag_changes;
+        bool                                mirror_dirty;
 };
 
 
@@ -157,6 +245,21 @@ class svs : public svs_interface, public cliproxy
         void add_input(const std::string& in);
         std::string svs_query(const std::string& query);
 
+        /*
+         Substate scenes start out as overlays sharing their parent's nodes.
+         This must be called before anything writes to such a scene. The
+         live overlays of deeper states that shared the same nodes are
+         pointed at the new copy so they keep seeing what their parent sees.
+        */
+        void make_scene_private(scene* s);
+
+        /*
+         Called before anything writes to scene s. Besides making s private,
+         gives the snapshot overlays of s their own copy of its nodes as
+         they are now.
+        */
+        void prepare_scene_write(scene* s);
+
         soar_interface* get_soar_interface()
         {
             return si;
@@ -165,6 +268,10 @@ class svs : public svs_interface, public cliproxy
         {
             return draw;
         }
+        stage_timers& get_timers()
+        {
+            return timers;
+        }
 
         bool do_cli_command(const std::vector<std::string>& args, std::string& output);
 
@@ -196,6 +303,17 @@ class svs : public svs_interface, public cliproxy
             return state_stack.size() > 1;
         }
 
+        bool is_sparse_mirror() const
+        {
+            return sparse_mirror;
+        }
+
+        /* See scene::make_overlay */
+        bool is_live_substate_scenes() const
+        {
+            return live_substate_scenes;
+        }
+
         // dirty bit is true only if there has been a new command
         //   from soar or from SendSVSInput
         //   (no need to recheck filters)
@@ -211,6 +329,7 @@ class svs : public svs_interface, public cliproxy
 
     private:
         void proc_input(svs_state* s);
+        void update_read_cmds();
 
         void proxy_get_children(std::map<std::string, cliproxy*>& c);
         // For consistency with the rest of Soar, we allow scene names to be lower or upper case (s1 or S1)
@@ -220,6 +339,11 @@ class svs : public svs_interface, public cliproxy
         }
         void cli_connect_viewer(const std::vector<std::string>& args, std::ostream& os);
         void cli_disconnect_viewer(const std::vector<std::string>& args, std::ostream& os);
+        void cli_filter_threads(const std::vector<std::string>& args, std::ostream& os);
+        void cli_timers(const std::vector<std::string>& args, std::ostream& os);
+        void cli_filter_cache(const std::vector<std::string>& args, std::ostream& os);
+        void cli_mirror(const std::vector<std::string>& args, std::ostream& os);
+        void cli_substate_scenes(const std::vector<std::string>& args, std::ostream& os);
 
         soar_interface*           si;
         std::vector<svs_state*>   state_stack;
@@ -227,10 +351,16 @@ class svs : public svs_interface, public cliproxy
         std::string               env_output;
         mutable drawer*           draw;
         scene*                    scn_cache;      // temporarily holds top-state scene during init
+        worker_pool*              filter_pool;    // NULL unless filters are updated in parallel
+        stage_timers              timers;
 
         bool enabled;
         // when enabled is true but enabled_in_substates is false, only the top state is enabled
         bool enabled_in_substates = true;
+        // only mirror subscribed nodes into working memory, see svs_state::mirrors
+        bool sparse_mirror;
+        // substate scenes follow their parent's changes instead of keeping a snapshot
+        bool live_substate_scenes;
 
         static bool filter_dirty_bit;
 };
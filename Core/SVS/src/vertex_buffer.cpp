@@ -0,0 +1,111 @@
+#include "vertex_buffer.h"
+
+#include <cassert>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+typedef std::unordered_map<size_t, std::vector<vertex_buffer*> > buffer_table;
+
+static std::mutex buffer_lock;
+
+/* Never destroyed, so buffers released during static destruction still find it */
+static buffer_table& get_buffer_table()
+{
+    static buffer_table* table = new buffer_table();
+    return *table;
+}
+
+static size_t hash_verts(const ptlist& verts)
+{
+    std::hash<double> h;
+    size_t seed = verts.size();
+    for (size_t i = 0, iend = verts.size(); i < iend; ++i)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            seed ^= h(verts[i](j)) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+        }
+    }
+    return seed;
+}
+
+static bool same_verts(const ptlist& a, const ptlist& b)
+{
+    if (a.size() != b.size())
+    {
+        return false;
+    }
+    for (size_t i = 0, iend = a.size(); i < iend; ++i)
+    {
+        if (a[i] != b[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+vertex_buffer::vertex_buffer(const ptlist& verts, size_t hash)
+    : verts(verts), hash(hash), refs(1)
+{}
+
+const vertex_buffer* vertex_buffer::intern(const ptlist& verts)
+{
+    size_t h = hash_verts(verts);
+    std::lock_guard<std::mutex> lock(buffer_lock);
+    std::vector<vertex_buffer*>& bucket = get_buffer_table()[h];
+    for (size_t i = 0, iend = bucket.size(); i < iend; ++i)
+    {
+        if (same_verts(bucket[i]->verts, verts))
+        {
+            ++bucket[i]->refs;
+            return bucket[i];
+        }
+    }
+    vertex_buffer* b = new vertex_buffer(verts, h);
+    bucket.push_back(b);
+    return b;
+}
+
+void vertex_buffer::add_ref() const
+{
+    std::lock_guard<std::mutex> lock(buffer_lock);
+    ++refs;
+}
+
+void vertex_buffer::release() const
+{
+    std::lock_guard<std::mutex> lock(buffer_lock);
+    assert(refs > 0);
+    if (--refs > 0)
+    {
+        return;
+    }
+
+    buffer_table& table = get_buffer_table();
+    buffer_table::iterator t = table.find(hash);
+    assert(t != table.end());
+    std::vector<vertex_buffer*>& bucket = t->second;
+    for (size_t i = 0, iend = bucket.size(); i < iend; ++i)
+    {
+        if (bucket[i] == this)
+        {
+            bucket[i] = bucket.back();
+            bucket.pop_back();
+            break;
+        }
+    }
+    if (bucket.empty())
+    {
+        table.erase(t);
+    }
+    delete this;
+}
+
+int vertex_buffer::num_refs() const
+{
+    std::lock_guard<std::mutex> lock(buffer_lock);
+    return refs;
+}
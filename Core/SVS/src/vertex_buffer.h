@@ -0,0 +1,47 @@
+#ifndef VERTEX_BUFFER_H
+#define VERTEX_BUFFER_H
+
+/*
+ An immutable list of local-space vertices, shared by every convex node
+ with exactly the same shape.
+
+ Scenes tend to repeat a few shapes many times, and a substate scene
+ copies all of its parent's nodes the first time either scene writes to
+ them, so convex nodes don't keep their own copy of their vertices. Buffers are interned: intern() returns the existing
+ buffer for a vertex list if there is one, so hundreds of identical boxes
+ hold one list between them and cloning a node only adds a reference.
+
+ Buffers are reference counted by hand. intern() and add_ref() each take
+ a reference that must be given back with release(), and a buffer is
+ freed with its last reference. The table is shared by every agent in
+ the process, so all of this is done under a lock.
+*/
+
+#include <cstddef>
+#include "mat.h"
+
+class vertex_buffer
+{
+    public:
+        static const vertex_buffer* intern(const ptlist& verts);
+
+        void add_ref() const;
+        void release() const;
+
+        const ptlist& get_verts() const
+        {
+            return verts;
+        }
+
+        /* number of convex nodes and other holders sharing this buffer */
+        int num_refs() const;
+
+    private:
+        vertex_buffer(const ptlist& verts, size_t hash);
+
+        const ptlist  verts;
+        const size_t  hash;
+        mutable int   refs;
+};
+
+#endif
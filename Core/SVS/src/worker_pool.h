@@ -0,0 +1,133 @@
+#ifndef WORKER_POOL_H
+#define WORKER_POOL_H
+
+/*
+ A fixed set of worker threads for running independent jobs.
+
+ run(n, job) calls job(i) for every i in [0, n), spread over the workers
+ and the calling thread, and returns once all of them are done. Jobs are
+ handed out in index order, but may finish in any order, so anything that
+ has to happen in a fixed order belongs after run returns.
+*/
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class worker_pool
+{
+    public:
+        worker_pool(size_t num_workers)
+            : job(NULL), num_jobs(0), next_job(0), active(0), generation(0), stop(false)
+        {
+            for (size_t i = 0; i < num_workers; ++i)
+            {
+                workers.push_back(std::thread(&worker_pool::work, this));
+            }
+        }
+
+        ~worker_pool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stop = true;
+            }
+            start_cv.notify_all();
+            for (size_t i = 0, iend = workers.size(); i < iend; ++i)
+            {
+                workers[i].join();
+            }
+        }
+
+        size_t size() const
+        {
+            return workers.size();
+        }
+
+        void run(size_t n, const std::function<void(size_t)>& f)
+        {
+            if (n == 0)
+            {
+                return;
+            }
+            if (workers.empty() || n == 1)
+            {
+                for (size_t i = 0; i < n; ++i)
+                {
+                    f(i);
+                }
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                job = &f;
+                num_jobs = n;
+                next_job.store(0);
+                active = workers.size();
+                ++generation;
+            }
+            start_cv.notify_all();
+
+            run_jobs(f, n);
+
+            std::unique_lock<std::mutex> lock(mutex);
+            done_cv.wait(lock, [this] { return active == 0; });
+            job = NULL;
+        }
+
+    private:
+        void run_jobs(const std::function<void(size_t)>& f, size_t n)
+        {
+            for (size_t i = next_job.fetch_add(1); i < n; i = next_job.fetch_add(1))
+            {
+                f(i);
+            }
+        }
+
+        void work()
+        {
+            unsigned long seen = 0;
+            for (;;)
+            {
+                const std::function<void(size_t)>* f;
+                size_t n;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    start_cv.wait(lock, [this, seen] { return stop || generation != seen; });
+                    if (stop)
+                    {
+                        return;
+                    }
+                    seen = generation;
+                    f = job;
+                    n = num_jobs;
+                }
+
+                run_jobs(*f, n);
+
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (--active == 0)
+                    {
+                        done_cv.notify_one();
+                    }
+                }
+            }
+        }
+
+        std::vector<std::thread>              workers;
+        std::mutex                            mutex;
+        std::condition_variable               start_cv;
+        std::condition_variable               done_cv;
+        const std::function<void(size_t)>*    job;
+        size_t                                num_jobs;
+        std::atomic<size_t>                   next_job;
+        size_t                                active;
+        unsigned long                         generation;
+        bool                                  stop;
+};
+
+#endif
@@ -21,6 +21,7 @@
 #include <ebc_reinstantiate.cpp>
 #include <ebc_repair.cpp>
 #include <ebc_settings.cpp>
+#include <ebc_timers.cpp>
 #include <ebc_unify.cpp>
 #include <ebc_update_justification.cpp>
 #include <ebc_variablize_rl.cpp>
@@ -29,6 +30,7 @@
 #include <ebc.cpp>
 #include <episodic_memory.cpp>
 #include <explain_print.cpp>
+#include <explanation_log.cpp>
 #include <explanation_memory.cpp>
 #include <explanation_settings.cpp>
 #include <exploration.cpp>
@@ -1891,8 +1891,9 @@ Symbol* create_new_impasse(agent* thisAgent, bool isa_goal, Symbol* object, Symb
             }
             if (level > TOP_GOAL_LEVEL)
             {
-                lSSWME->local_singleton_id_identity_set = thisAgent->explanationBasedChunker->get_floating_identity(impasseID);
-                lSSWME->local_singleton_value_identity_set = thisAgent->explanationBasedChunker->get_floating_identity(impasseID);
+                wme_rare_fields& lSSRare = get_rare_fields(thisAgent, lSSWME);
+                lSSRare.local_singleton_id_identity_set = thisAgent->explanationBasedChunker->get_floating_identity(impasseID);
+                lSSRare.local_singleton_value_identity_set = thisAgent->explanationBasedChunker->get_floating_identity(impasseID);
             }
         }
         Symbol* lreward_header = thisAgent->symbolManager->make_new_identifier('R', level);
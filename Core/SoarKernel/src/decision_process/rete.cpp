@@ -1242,6 +1242,19 @@ inline uint32_t get_next_alpha_mem_id(agent* thisAgent)
     return thisAgent->alpha_mem_id_counter++;
 }
 
+/* --- Is there a right_mem other than rm in the bucket for the same alpha
+   memory and id?  Right_mems are hashed by alpha memory and id, so they
+   all share rm's bucket. --- */
+inline bool other_wme_with_same_id_in_bucket(right_mem* bucket, right_mem* rm)
+{
+    for (; bucket != NIL; bucket = bucket->next_in_bucket)
+        if ((bucket != rm) && (bucket->am == rm->am) && (bucket->w->id == rm->w->id))
+        {
+            return true;
+        }
+    return false;
+}
+
 /* --- Adds a WME to an alpha memory (create a right_mem for it), but doesn't
    inform any successors --- */
 void add_wme_to_alpha_mem(agent* thisAgent, wme* w, alpha_mem* am)
@@ -1260,6 +1273,15 @@ void add_wme_to_alpha_mem(agent* thisAgent, wme* w, alpha_mem* am)
     insert_at_head_of_dll(*header, rm, next_in_bucket, prev_in_bucket);
     insert_at_head_of_dll(am->right_mems, rm, next_in_am, prev_in_am);
     insert_at_head_of_dll(w->right_mems, rm, next_from_wme, prev_from_wme);
+
+    if (thisAgent->match_statistics)
+    {
+        am->num_wmes++;
+        if (! other_wme_with_same_id_in_bucket(*header, rm))
+        {
+            am->num_ids++;
+        }
+    }
 }
 
 /* --- Removes a WME (right_mem) from its alpha memory, but doesn't inform
@@ -1281,6 +1303,15 @@ void remove_wme_from_alpha_mem(agent* thisAgent, right_mem* rm)
     remove_from_dll(am->right_mems, rm, next_in_am, prev_in_am);
     remove_from_dll(w->right_mems, rm, next_from_wme, prev_from_wme);
 
+    if (thisAgent->match_statistics)
+    {
+        am->num_wmes--;
+        if (! other_wme_with_same_id_in_bucket(*header, rm))
+        {
+            am->num_ids--;
+        }
+    }
+
     /* --- deallocate it --- */
     thisAgent->memoryManager->free_with_pool(MP_right_mem, rm);
 }
@@ -1348,6 +1379,8 @@ alpha_mem* find_or_make_alpha_mem(agent* thisAgent, Symbol* id, Symbol* attr,
     }
     am->acceptable = acceptable;
     am->am_id = get_next_alpha_mem_id(thisAgent);
+    am->num_wmes = 0;
+    am->num_ids = 0;
     ht = table_for_tests(thisAgent, id, attr, value, acceptable);
     add_to_hash_table(thisAgent, ht, am);
 
@@ -1383,6 +1416,74 @@ alpha_mem* find_or_make_alpha_mem(agent* thisAgent, Symbol* id, Symbol* attr,
     return am;
 }
 
+/* ------------------------------------------------------------------------
+                          Match Statistics
+
+   While match statistics are on, every alpha memory counts its wmes and
+   the distinct ids among them, so the reorderer can see how many values
+   an id really has for an attribute instead of guessing (see
+   cost_of_adding_condition()).  Keeping the id count costs a scan of the
+   wme's right_ht bucket on every alpha memory add and remove, so the
+   counts are only kept while statistics are on, and are rebuilt from the
+   alpha memories whenever statistics are turned on.
+------------------------------------------------------------------------ */
+
+void set_match_statistics(agent* thisAgent, bool pOn)
+{
+    if (pOn == thisAgent->match_statistics)
+    {
+        return;
+    }
+    thisAgent->match_statistics = pOn;
+    if (!pOn)
+    {
+        return;
+    }
+
+    for (int i = 0; i < 16; i++)
+    {
+        hash_table* ht = thisAgent->alpha_hash_tables[i];
+        for (uint32_t b = 0; b < ht->size; b++)
+        {
+            for (alpha_mem* am = reinterpret_cast<alpha_mem*>(*(ht->buckets + b)); am != NIL; am = am->next_in_hash_table)
+            {
+                tc_number tc = get_new_tc_number(thisAgent);
+                am->num_wmes = 0;
+                am->num_ids = 0;
+                for (right_mem* rm = am->right_mems; rm != NIL; rm = rm->next_in_am)
+                {
+                    am->num_wmes++;
+                    if (rm->w->id->tc_num != tc)
+                    {
+                        rm->w->id->tc_num = tc;
+                        am->num_ids++;
+                    }
+                }
+            }
+        }
+    }
+}
+
+/* --- Gives the average number of values an id has for the given attribute,
+   rounded up, from the alpha memory for (* ^attr *).  Returns false if
+   statistics are off or no such alpha memory exists. --- */
+bool get_values_per_id_for_attribute(agent* thisAgent, Symbol* attr, bool acceptable, uint64_t* values_per_id)
+{
+    alpha_mem* am;
+
+    if (!thisAgent->match_statistics)
+    {
+        return false;
+    }
+    am = find_alpha_mem(thisAgent, NIL, attr, NIL, acceptable);
+    if (!am)
+    {
+        return false;
+    }
+    *values_per_id = am->num_ids ? ((am->num_wmes + am->num_ids - 1) / am->num_ids) : 0;
+    return true;
+}
+
 /* --- Using the given hash table and hash value, try to find a
    matching alpha memory in the indicated hash bucket.  If we find one,
    we add the wme to it and inform successor nodes. --- */
@@ -1419,10 +1520,26 @@ inline uint32_t xor_op(uint32_t i, uint32_t a, uint32_t v)
     return ((i) ^ (a) ^ (v));
 }
 
-/* --- Adds a WME to the Rete. --- */
-void add_wme_to_rete(agent* thisAgent, wme* w)
+/* --- Returns a bit for each alpha hash table that holds any alpha
+   memories.  A wme can't match anything in the other tables, so they
+   needn't be searched. --- */
+inline uint32_t get_nonempty_alpha_tables(agent* thisAgent)
+{
+    uint32_t mask = 0;
+    for (int i = 0; i < 16; i++)
+        if (thisAgent->alpha_hash_tables[i]->count)
+        {
+            mask |= (1 << i);
+        }
+    return mask;
+}
+
+/* --- Adds a WME to the Rete, searching only the alpha hash tables in
+   the given mask. --- */
+void add_wme_to_rete(agent* thisAgent, wme* w, uint32_t table_mask)
 {
     uint32_t hi, ha, hv;
+    int first_table, i;
 
     /* --- add w to all_wmes_in_rete --- */
     insert_at_head_of_dll(thisAgent->all_wmes_in_rete, w, rete_next, rete_prev);
@@ -1432,35 +1549,28 @@ void add_wme_to_rete(agent* thisAgent, wme* w)
     w->right_mems = NIL;
     w->tokens = NIL;
 
-    /* --- add w to the appropriate alpha_mem in each of 8 possible tables --- */
+    /* --- add w to the appropriate alpha_mem in each of 8 possible tables.
+       Bit 0 of a table's number means it tests the id, bit 1 the attr,
+       bit 2 the value, and bit 3 means it's for acceptable preferences --- */
     hi = w->id->hash_id;
     ha = w->attr->hash_id;
     hv = w->value->hash_id;
 
-    if (w->acceptable)
-    {
-        add_wme_to_aht(thisAgent, thisAgent->alpha_hash_tables[8],  xor_op(0, 0, 0), w);
-        add_wme_to_aht(thisAgent, thisAgent->alpha_hash_tables[9],  xor_op(hi, 0, 0), w);
-        add_wme_to_aht(thisAgent, thisAgent->alpha_hash_tables[10], xor_op(0, ha, 0), w);
-        add_wme_to_aht(thisAgent, thisAgent->alpha_hash_tables[11], xor_op(hi, ha, 0), w);
-        add_wme_to_aht(thisAgent, thisAgent->alpha_hash_tables[12], xor_op(0, 0, hv), w);
-        add_wme_to_aht(thisAgent, thisAgent->alpha_hash_tables[13], xor_op(hi, 0, hv), w);
-        add_wme_to_aht(thisAgent, thisAgent->alpha_hash_tables[14], xor_op(0, ha, hv), w);
-        add_wme_to_aht(thisAgent, thisAgent->alpha_hash_tables[15], xor_op(hi, ha, hv), w);
-    }
-    else
+    first_table = w->acceptable ? 8 : 0;
+    for (i = 0; i < 8; i++)
+        if (table_mask & (1 << (first_table + i)))
+        {
+            add_wme_to_aht(thisAgent, thisAgent->alpha_hash_tables[first_table + i],
+                           xor_op((i & 1) ? hi : 0, (i & 2) ? ha : 0, (i & 4) ? hv : 0), w);
+        }
+
+    const wme_rare_fields& rare = peek_rare_fields(thisAgent, w);
+    if ((rare.epmem_id != EPMEM_NODEID_BAD) || (rare.epmem_valid != NIL))
     {
-        add_wme_to_aht(thisAgent, thisAgent->alpha_hash_tables[0],  xor_op(0, 0, 0), w);
-        add_wme_to_aht(thisAgent, thisAgent->alpha_hash_tables[1],  xor_op(hi, 0, 0), w);
-        add_wme_to_aht(thisAgent, thisAgent->alpha_hash_tables[2],  xor_op(0, ha, 0), w);
-        add_wme_to_aht(thisAgent, thisAgent->alpha_hash_tables[3],  xor_op(hi, ha, 0), w);
-        add_wme_to_aht(thisAgent, thisAgent->alpha_hash_tables[4],  xor_op(0, 0, hv), w);
-        add_wme_to_aht(thisAgent, thisAgent->alpha_hash_tables[5],  xor_op(hi, 0, hv), w);
-        add_wme_to_aht(thisAgent, thisAgent->alpha_hash_tables[6],  xor_op(0, ha, hv), w);
-        add_wme_to_aht(thisAgent, thisAgent->alpha_hash_tables[7],  xor_op(hi, ha, hv), w);
+        wme_rare_fields& stale = get_rare_fields(thisAgent, w);
+        stale.epmem_id = EPMEM_NODEID_BAD;
+        stale.epmem_valid = NIL;
     }
-    w->epmem_id = EPMEM_NODEID_BAD;
-    w->epmem_valid = NIL;
     {
         if (thisAgent->EpMem->epmem_db->get_status() == soar_module::connected)
         {
@@ -1487,19 +1597,51 @@ void add_wme_to_rete(agent* thisAgent, wme* w)
     }
 }
 
+/* --- Adds a WME to the Rete. --- */
+void add_wme_to_rete(agent* thisAgent, wme* w)
+{
+    /* --- new nodes from an open production batch must see w like any other --- */
+    if (!thisAgent->deferred_rete_nodes->empty())
+    {
+        flush_deferred_rete_nodes(thisAgent);
+    }
+    add_wme_to_rete(thisAgent, w, get_nonempty_alpha_tables(thisAgent));
+}
+
+/* --- Adds a phase's worth of WMEs to the Rete, in order.  Adding wmes
+   never makes or removes alpha memories, so the pending nodes are
+   flushed and the empty tables found once for the whole batch. --- */
+void add_wmes_to_rete(agent* thisAgent, wme** wmes, size_t num_wmes)
+{
+    if (!num_wmes)
+    {
+        return;
+    }
+    if (!thisAgent->deferred_rete_nodes->empty())
+    {
+        flush_deferred_rete_nodes(thisAgent);
+    }
+    uint32_t table_mask = get_nonempty_alpha_tables(thisAgent);
+    for (size_t i = 0; i < num_wmes; i++)
+    {
+        add_wme_to_rete(thisAgent, wmes[i], table_mask);
+    }
+}
+
 inline void _epmem_remove_wme(agent* thisAgent, wme* w)
 {
+    const wme_rare_fields& rare = peek_rare_fields(thisAgent, w);
     bool was_encoded = false;
 
     if (w->value->symbol_type == IDENTIFIER_SYMBOL_TYPE)
     {
         bool lti = (w->value->id->LTI_ID != NIL);
 
-        if ((w->epmem_id != EPMEM_NODEID_BAD) && (w->epmem_valid == thisAgent->EpMem->epmem_validation))
+        if ((rare.epmem_id != EPMEM_NODEID_BAD) && (rare.epmem_valid == thisAgent->EpMem->epmem_validation))
         {
             was_encoded = true;
 
-            (*thisAgent->EpMem->epmem_edge_removals)[ std::make_pair(w->epmem_id,static_cast<int64_t>((lti ? w->value->id->LTI_ID : 0))) ] = true;
+            (*thisAgent->EpMem->epmem_edge_removals)[ std::make_pair(rare.epmem_id,static_cast<int64_t>((lti ? w->value->id->LTI_ID : 0))) ] = true;
 
 #ifdef DEBUG_EPMEM_WME_ADD
             fprintf(stderr, "   wme destroyed: %d %d %d\n",
@@ -1513,8 +1655,8 @@ inline void _epmem_remove_wme(agent* thisAgent, wme* w)
                 fprintf(stderr, "   returning WME to pool: %d %d %d\n",
                         (unsigned int) w->id->id->epmem_id, (unsigned int) epmem_temporal_hash(thisAgent, w->attr), (unsigned int) w->value->id->epmem_id);
 #endif
-                epmem_return_id_pool::iterator p = thisAgent->EpMem->epmem_id_replacement->find(w->epmem_id);
-                (*p->second).push_front(std::make_pair(w->value->id->epmem_id, w->epmem_id));
+                epmem_return_id_pool::iterator p = thisAgent->EpMem->epmem_id_replacement->find(rare.epmem_id);
+                (*p->second).push_front(std::make_pair(w->value->id->epmem_id, rare.epmem_id));
                 thisAgent->EpMem->epmem_id_replacement->erase(p);
             }
         }
@@ -1545,17 +1687,18 @@ inline void _epmem_remove_wme(agent* thisAgent, wme* w)
             }
         }
     }
-    else if ((w->epmem_id != EPMEM_NODEID_BAD) && (w->epmem_valid == thisAgent->EpMem->epmem_validation))
+    else if ((rare.epmem_id != EPMEM_NODEID_BAD) && (rare.epmem_valid == thisAgent->EpMem->epmem_validation))
     {
         was_encoded = true;
 
-        (*thisAgent->EpMem->epmem_node_removals)[ w->epmem_id ] = true;
+        (*thisAgent->EpMem->epmem_node_removals)[ rare.epmem_id ] = true;
     }
 
     if (was_encoded)
     {
-        w->epmem_id = EPMEM_NODEID_BAD;
-        w->epmem_valid = NIL;
+        wme_rare_fields& encoded = get_rare_fields(thisAgent, w);
+        encoded.epmem_id = EPMEM_NODEID_BAD;
+        encoded.epmem_valid = NIL;
     }
 }
 
@@ -1823,6 +1966,113 @@ void remove_node_from_parents_list_of_children(rete_node* node)
     prev_sibling->next_sibling = node->next_sibling;
 }
 
+/* ------------------------------------------------------------------------
+                           Join Node Index
+
+   Every positive join node below a beta memory and every negative node
+   is also kept in thisAgent->join_index, keyed on its parent and its
+   alpha memory.  When many productions share the same first few
+   conditions, the node at the end of that prefix can have tens of
+   thousands of children, and looking for a node to share by walking
+   them made loading a large rule base quadratic.  Make_node_for_
+   positive_cond() and make_node_for_negative_cond() probe the index
+   instead.
+
+   The nodes add and remove themselves as they're created, destroyed,
+   split out of MP nodes and merged back into them.  Deletion shifts
+   later entries of a probe run back instead of leaving tombstones, as
+   in the slot index, so a lookup always stops at the first empty entry.
+------------------------------------------------------------------------ */
+
+#define JOIN_INDEX_INITIAL_SIZE 1024
+
+inline bool node_is_in_join_index(byte node_type)
+{
+    return (bnode_is_bottom_of_split_mp(node_type) || bnode_is_negative(node_type));
+}
+
+inline uint32_t join_index_home(beta_node_index* idx, rete_node* parent, alpha_mem* am)
+{
+    uint32_t h = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(parent) >> 4) * 2654435761u;
+    return (h ^ (am->am_id * 0x85EBCA6Bu)) & (idx->size - 1);
+}
+
+static void join_index_insert(beta_node_index* idx, rete_node* node)
+{
+    uint32_t i = join_index_home(idx, node->parent, node->b.posneg.alpha_mem_);
+    while (idx->entries[i])
+    {
+        i = (i + 1) & (idx->size - 1);
+    }
+    idx->entries[i] = node;
+    idx->count++;
+}
+
+/* Replaces the index with one of the given size holding the same nodes */
+static void resize_join_index(agent* thisAgent, uint32_t size)
+{
+    beta_node_index* old_idx = thisAgent->join_index;
+    beta_node_index* idx = static_cast<beta_node_index*>(thisAgent->memoryManager->allocate_memory_and_zerofill(sizeof(beta_node_index) + size * sizeof(rete_node*), MISCELLANEOUS_MEM_USAGE));
+    idx->size = size;
+    idx->count = 0;
+    idx->entries = reinterpret_cast<rete_node**>(idx + 1);
+    if (old_idx)
+    {
+        for (uint32_t i = 0; i < old_idx->size; i++)
+            if (old_idx->entries[i])
+            {
+                join_index_insert(idx, old_idx->entries[i]);
+            }
+        thisAgent->memoryManager->free_memory(old_idx, MISCELLANEOUS_MEM_USAGE);
+    }
+    thisAgent->join_index = idx;
+}
+
+void add_node_to_join_index(agent* thisAgent, rete_node* node)
+{
+    if (!thisAgent->join_index)
+    {
+        resize_join_index(thisAgent, JOIN_INDEX_INITIAL_SIZE);
+    }
+    else if ((thisAgent->join_index->count + 1) * 2 > thisAgent->join_index->size)
+    {
+        resize_join_index(thisAgent, thisAgent->join_index->size * 2);
+    }
+    join_index_insert(thisAgent->join_index, node);
+}
+
+/* Must be called while the node still has the parent and alpha memory it was added with */
+void remove_node_from_join_index(agent* thisAgent, rete_node* node)
+{
+    beta_node_index* idx = thisAgent->join_index;
+    uint32_t mask = idx->size - 1;
+    uint32_t i = join_index_home(idx, node->parent, node->b.posneg.alpha_mem_);
+    while (idx->entries[i] != node)
+    {
+        if (!idx->entries[i])
+        {
+            return;
+        }
+        i = (i + 1) & mask;
+    }
+    idx->entries[i] = NIL;
+    idx->count--;
+
+    /* --- move back any later entry of the run that can't be found past the hole now --- */
+    uint32_t hole = i;
+    for (i = (i + 1) & mask; idx->entries[i]; i = (i + 1) & mask)
+    {
+        rete_node* entry = idx->entries[i];
+        uint32_t home = join_index_home(idx, entry->parent, entry->b.posneg.alpha_mem_);
+        if (((i - home) & mask) >= ((i - hole) & mask))
+        {
+            idx->entries[hole] = entry;
+            idx->entries[i] = NIL;
+            hole = i;
+        }
+    }
+}
+
 /* ------------------------------------------------------------------------
                  Update Node With Matches From Above
 
@@ -1893,6 +2143,202 @@ void update_node_with_matches_from_above(agent* thisAgent, rete_node* child)
         }
 }
 
+/* ------------------------------------------------------------------------
+                          Production Batches
+
+   Adding a production to an agent with a populated working memory
+   normally fills in each new node from its parent as soon as the node is
+   built.  Loading many productions that way walks the same upstream
+   matches over and over.  Inside a batch (begin_production_batch() ...
+   end_production_batch()), new nodes are only recorded, and are filled in
+   when the outermost batch ends.  Only the topmost recorded nodes -- those
+   with no recorded ancestor -- are updated from their parents; their left
+   additions carry the matches down through all the new nodes below them,
+   so every new node is filled once, however many productions share it.
+   New nodes below the same existing parent are filled in together, with
+   one walk over the parent's matches.
+
+   A partially filled network must never be matched against, so the
+   recorded nodes are also flushed before a WME is added to the rete and
+   before each phase is run.  Productions added with a refracted
+   instantiation need their matches immediately, so they flush the batch
+   first and are never deferred.
+
+   Node merging and splitting move a recorded node's tokens to another
+   node; merge_into_mp_node() and split_mp_node() move the record along
+   with them.
+------------------------------------------------------------------------ */
+
+bool Deferred_Rete_Nodes::end_batch()
+{
+    if (m_batch_depth == 0)
+    {
+        return false;
+    }
+    return (--m_batch_depth == 0);
+}
+
+void Deferred_Rete_Nodes::add(rete_node* pNode)
+{
+    m_positions[pNode] = m_nodes.size();
+    m_nodes.push_back(pNode);
+}
+
+void Deferred_Rete_Nodes::remove(rete_node* pNode)
+{
+    std::unordered_map< rete_node*, size_t >::iterator it = m_positions.find(pNode);
+    if (it != m_positions.end())
+    {
+        m_nodes[it->second] = NIL;
+        m_positions.erase(it);
+    }
+}
+
+void Deferred_Rete_Nodes::replace(rete_node* pOld, rete_node* pNew)
+{
+    std::unordered_map< rete_node*, size_t >::iterator it = m_positions.find(pOld);
+    if (it != m_positions.end())
+    {
+        size_t lPosition = it->second;
+        m_positions.erase(it);
+        m_nodes[lPosition] = pNew;
+        m_positions[pNew] = lPosition;
+    }
+}
+
+/* --- Moves the recorded nodes without a recorded ancestor into pNodes,
+       in the order they were built, and forgets all the others --- */
+void Deferred_Rete_Nodes::take_topmost(std::vector< rete_node* >& pNodes)
+{
+    for (size_t i = 0; i < m_nodes.size(); ++i)
+    {
+        rete_node* lNode = m_nodes[i];
+        if (!lNode)
+        {
+            continue;
+        }
+        rete_node* lAncestor = lNode->parent;
+        while (lAncestor && (m_positions.find(lAncestor) == m_positions.end()))
+        {
+            lAncestor = lAncestor->parent;
+        }
+        if (!lAncestor)
+        {
+            pNodes.push_back(lNode);
+        }
+    }
+    m_nodes.clear();
+    m_positions.clear();
+}
+
+void begin_production_batch(agent* thisAgent)
+{
+    thisAgent->deferred_rete_nodes->begin_batch();
+}
+
+void end_production_batch(agent* thisAgent)
+{
+    if (thisAgent->deferred_rete_nodes->end_batch())
+    {
+        flush_deferred_rete_nodes(thisAgent);
+    }
+}
+
+/* --- Like update_node_with_matches_from_above(), but for several new
+       children of the same parent at once, so the parent's alpha memory or
+       tokens are only walked once for all of them --- */
+void update_siblings_with_matches_from_above(agent* thisAgent, rete_node* parent,
+                                             std::vector< rete_node* >& children)
+{
+    rete_node* saved_parents_first_child;
+    std::vector< rete_node* > saved_next_siblings;
+    right_mem* rm;
+    token* tok;
+    size_t i;
+
+    if (parent->node_type == DUMMY_TOP_BNODE)
+    {
+        for (i = 0; i < children.size(); ++i)
+        {
+            (*(left_addition_routines[children[i]->node_type]))(thisAgent, children[i], thisAgent->dummy_top_token, NIL);
+        }
+        return;
+    }
+
+    if (bnode_is_positive(parent->node_type))
+    {
+        if (node_is_right_unlinked(parent))
+        {
+            return;
+        }
+        /* --- give the parent a child list of just the new nodes --- */
+        saved_parents_first_child = parent->first_child;
+        saved_next_siblings.resize(children.size());
+        for (i = 0; i < children.size(); ++i)
+        {
+            saved_next_siblings[i] = children[i]->next_sibling;
+            children[i]->next_sibling = (i + 1 < children.size()) ? children[i + 1] : NIL;
+        }
+        parent->first_child = children[0];
+        for (rm = parent->b.posneg.alpha_mem_->right_mems; rm != NIL; rm = rm->next_in_am)
+        {
+            (*(right_addition_routines[parent->node_type]))(thisAgent, parent, rm->w);
+        }
+        parent->first_child = saved_parents_first_child;
+        for (i = 0; i < children.size(); ++i)
+        {
+            children[i]->next_sibling = saved_next_siblings[i];
+        }
+        return;
+    }
+
+    for (tok = parent->a.np.tokens; tok != NIL; tok = tok->next_of_node)
+        if (! tok->negrm_tokens)
+        {
+            for (i = 0; i < children.size(); ++i)
+            {
+                (*(left_addition_routines[children[i]->node_type]))(thisAgent, children[i], tok, NIL);
+            }
+        }
+}
+
+void flush_deferred_rete_nodes(agent* thisAgent)
+{
+    std::vector< rete_node* > lTopmost;
+    std::vector< rete_node* > lParents;
+    std::unordered_map< rete_node*, std::vector< rete_node* > > lChildren;
+
+    thisAgent->deferred_rete_nodes->take_topmost(lTopmost);
+
+    /* --- group the topmost nodes by parent, in the order they were built --- */
+    for (size_t i = 0; i < lTopmost.size(); ++i)
+    {
+        std::vector< rete_node* >& lSiblings = lChildren[lTopmost[i]->parent];
+        if (lSiblings.empty())
+        {
+            lParents.push_back(lTopmost[i]->parent);
+        }
+        lSiblings.push_back(lTopmost[i]);
+    }
+    for (size_t i = 0; i < lParents.size(); ++i)
+    {
+        update_siblings_with_matches_from_above(thisAgent, lParents[i], lChildren[lParents[i]]);
+    }
+}
+
+/* --- Fills in a newly built node, or records it if a batch is open --- */
+inline void update_new_node_with_matches_from_above(agent* thisAgent, rete_node* node)
+{
+    if (thisAgent->deferred_rete_nodes->batch_is_open())
+    {
+        thisAgent->deferred_rete_nodes->add(node);
+    }
+    else
+    {
+        update_node_with_matches_from_above(thisAgent, node);
+    }
+}
+
 /* ------------------------------------------------------------------------
                      Nearest Ancestor With Same AM
 
@@ -1949,7 +2395,7 @@ rete_node* make_new_mem_node(agent* thisAgent,
     node->a.np.tokens = NIL;
 
     /* --- call new node's add_left routine with all the parent's tokens --- */
-    update_node_with_matches_from_above(thisAgent, node);
+    update_new_node_with_matches_from_above(thisAgent, node);
 
     return node;
 }
@@ -1980,6 +2426,7 @@ rete_node* make_new_positive_node(agent* thisAgent,
     node->b.posneg.nearest_ancestor_with_same_am =
         nearest_ancestor_with_same_am(node, am);
     relink_to_right_mem(node);
+    add_node_to_join_index(thisAgent, node);
 
     /* --- don't need to force WM through new node yet, as it's just a
        join node with no children --- */
@@ -2057,6 +2504,7 @@ rete_node* split_mp_node(agent* thisAgent, rete_node* mp_node)
     {
         t->node = mem_node;
     }
+    thisAgent->deferred_rete_nodes->replace(mp_node, mem_node);
 
     /* --- transmogrify the old MP node into the new Pos node --- */
     init_new_rete_node_with_type(thisAgent, pos_node, node_type);
@@ -2072,6 +2520,7 @@ rete_node* split_mp_node(agent* thisAgent, rete_node* mp_node)
     {
         unlink_from_left_mem(pos_node);
     }
+    add_node_to_join_index(thisAgent, pos_node);
 
     return mem_node;
 }
@@ -2113,6 +2562,7 @@ rete_node* merge_into_mp_node(agent* thisAgent, rete_node* mem_node)
     }
 
     /* --- save a copy of the Pos data, then kill the Pos node --- */
+    remove_node_from_join_index(thisAgent, pos_node);
     pos_copy = *pos_node;
     update_stats_for_destroying_node(thisAgent, pos_node);   /* clean up rete stats stuff */
 
@@ -2128,6 +2578,7 @@ rete_node* merge_into_mp_node(agent* thisAgent, rete_node* mem_node)
     {
         t->node = mp_node;
     }
+    thisAgent->deferred_rete_nodes->replace(mem_node, mp_node);
     mp_node->left_hash_loc_field_num = mem_node->left_hash_loc_field_num;
     mp_node->left_hash_loc_levels_up = mem_node->left_hash_loc_levels_up;
     mp_node->node_id = mem_node->node_id;
@@ -2209,11 +2660,12 @@ rete_node* make_new_negative_node(agent* thisAgent,
     node->b.posneg.nearest_ancestor_with_same_am =
         nearest_ancestor_with_same_am(node, am);
     relink_to_right_mem(node);
+    add_node_to_join_index(thisAgent, node);
 
     node->node_id = get_next_beta_node_id(thisAgent);
 
     /* --- call new node's add_left routine with all the parent's tokens --- */
-    update_node_with_matches_from_above(thisAgent, node);
+    update_new_node_with_matches_from_above(thisAgent, node);
 
     /* --- if no tokens arrived from parent, unlink the node --- */
     if (! node->a.np.tokens)
@@ -2269,9 +2721,9 @@ rete_node* make_new_cn_node(agent* thisAgent,
     partner->b.cn.partner = node;
 
     /* --- call partner's add_left routine with all the parent's tokens --- */
-    update_node_with_matches_from_above(thisAgent, partner);
+    update_new_node_with_matches_from_above(thisAgent, partner);
     /* --- call new node's add_left routine with all the parent's tokens --- */
-    update_node_with_matches_from_above(thisAgent, node);
+    update_new_node_with_matches_from_above(thisAgent, node);
 
     return node;
 }
@@ -2382,10 +2834,15 @@ void deallocate_rete_node(agent* thisAgent, rete_node* node)
         {
             remove_token_and_subtree(thisAgent, node->a.np.tokens);
         }
+    thisAgent->deferred_rete_nodes->remove(node);
 
     /* --- stuff for posneg nodes only --- */
     if (bnode_is_posneg(node->node_type))
     {
+        if (node_is_in_join_index(node->node_type))
+        {
+            remove_node_from_join_index(thisAgent, node);
+        }
         deallocate_rete_test_list(thisAgent, node->b.posneg.other_tests);
         /* --- right unlink the node, cleanup alpha memory --- */
         if (! node_is_right_unlinked(node))
@@ -3167,6 +3624,41 @@ bool extract_rete_test_to_hash_with(agent* thisAgent,
     return true;
 }
 
+/* ------------------------------------------------------------------------
+                         Find Shareable Join Node
+
+   Looks in the join index for a child of <parent> of the given type that
+   uses <am> and has exactly the tests <rt>.  For negative nodes, which
+   sit directly below the previous condition's node, <left_hash_loc> must
+   match too; pass NIL for unhashed nodes and for positive nodes, whose
+   hash location is kept by their parent memory node.
+------------------------------------------------------------------------ */
+
+rete_node* find_shareable_join_node(agent* thisAgent, rete_node* parent,
+                                    byte node_type, alpha_mem* am,
+                                    var_location* left_hash_loc, rete_test* rt)
+{
+    beta_node_index* idx = thisAgent->join_index;
+    rete_node* node;
+
+    if (!idx)
+    {
+        return NIL;
+    }
+    for (uint32_t i = join_index_home(idx, parent, am); (node = idx->entries[i]) != NIL; i = (i + 1) & (idx->size - 1))
+        if ((node->parent == parent) &&
+                (node->node_type == node_type) &&
+                (node->b.posneg.alpha_mem_ == am) &&
+                ((!left_hash_loc) ||
+                 ((node->left_hash_loc_field_num == left_hash_loc->field_num) &&
+                  (node->left_hash_loc_levels_up == left_hash_loc->levels_up))) &&
+                rete_test_lists_are_identical(thisAgent, node->b.posneg.other_tests, rt))
+        {
+            return node;
+        }
+    return NIL;
+}
+
 /* ------------------------------------------------------------------------
                        Make Node for Positive Cond
 
@@ -3257,13 +3749,7 @@ rete_node* make_node_for_positive_cond(agent* thisAgent,
     if (mem_node)     /* -- A matching memory node was found --- */
     {
         /* --- look for a matching existing join node --- */
-        for (node = mem_node->first_child; node != NIL; node = node->next_sibling)
-            if ((node->node_type == pos_node_type) &&
-                    (am == node->b.posneg.alpha_mem_) &&
-                    rete_test_lists_are_identical(thisAgent, node->b.posneg.other_tests, rt))
-            {
-                break;
-            }
+        node = find_shareable_join_node(thisAgent, mem_node, pos_node_type, am, NIL, rt);
 
         if (node)      /* --- A matching join node was found --- */
         {
@@ -3368,16 +3854,8 @@ rete_node* make_node_for_negative_cond(agent* thisAgent,
     node_type = hash_this_node ? NEGATIVE_BNODE : UNHASHED_NEGATIVE_BNODE;
 
     /* --- look for a matching existing node --- */
-    for (node = parent->first_child; node != NIL; node = node->next_sibling)
-        if ((node->node_type == node_type) &&
-                (am == node->b.posneg.alpha_mem_) &&
-                ((!hash_this_node) ||
-                 ((node->left_hash_loc_field_num == left_hash_loc.field_num) &&
-                  (node->left_hash_loc_levels_up == left_hash_loc.levels_up))) &&
-                rete_test_lists_are_identical(thisAgent, node->b.posneg.other_tests, rt))
-        {
-            break;
-        }
+    node = find_shareable_join_node(thisAgent, parent, node_type, am,
+                                    hash_this_node ? &left_hash_loc : NIL, rt);
 
     if (node)      /* --- A matching node was found --- */
     {
@@ -3607,6 +4085,278 @@ bool same_rhs(action* rhs1, action* rhs2, bool rl_chunk_stop)
     return true;
 }
 
+/* ---------------------------------------------------------------------
+                       Canonical Production Index
+
+   Every production added to the rete is also recorded by its canonical
+   form.  This is a flat list of tokens describing the production's
+   reordered, variablized LHS and its RHS.  Variables are renamed by the
+   order in which they first appear, so the form doesn't depend on the
+   variable names a rule happens to use.  Two productions with the same
+   canonical form build exactly the same rete path and have the same
+   RHS, so a new production whose form is already in the index can be
+   rejected as a duplicate before any rete node is built or shared.
+
+   The hash only picks the bucket.  Forms are always compared token by
+   token, so a hash collision can never make a rule look like a duplicate.
+   For that to hold, the token stream must also decode only one way.  Test
+   types are written as raw TestType values, so the canonical tokens are
+   numbered above NUM_TEST_TYPES.  That way a test type inside a conjunct
+   list can't be mistaken for the CANON_END that closes it.
+   A production that isn't found here still goes through the normal
+   p-node comparison below, which also handles the looser comparison
+   used when RL chunk-stop is on.
+
+   Constants are recorded by address, so the index must never hold a
+   symbol the production no longer uses.  When RL changes a rule's value
+   in place, replace_symbol() swaps the old float for the new one in the
+   rule's form before the old one can be freed and its address reused.
+--------------------------------------------------------------------- */
+
+enum CanonicalToken
+{
+    CANON_END = NUM_TEST_TYPES + 1,
+    CANON_NULL,
+    CANON_VARIABLE,
+    CANON_SYMBOL,
+    CANON_CONDITION,
+    CANON_ACTION,
+    CANON_FUNCALL,
+    CANON_RETE_VALUE,
+    CANON_RHS
+};
+
+typedef struct canonical_builder_struct
+{
+    canonical_form  form;
+    tc_number       var_tc;
+    uint64_t        num_vars;
+} canonical_builder;
+
+inline void add_canonical_token(canonical_builder& pBuilder, uintptr_t pToken)
+{
+    pBuilder.form.push_back(pToken);
+}
+
+void add_canonical_symbol(canonical_builder& pBuilder, Symbol* pSym)
+{
+    if (pSym->symbol_type != VARIABLE_SYMBOL_TYPE)
+    {
+        add_canonical_token(pBuilder, CANON_SYMBOL);
+        add_canonical_token(pBuilder, reinterpret_cast<uintptr_t>(pSym));
+        return;
+    }
+    if (pSym->tc_num != pBuilder.var_tc)
+    {
+        pSym->tc_num = pBuilder.var_tc;
+        pSym->var->current_binding_value = reinterpret_cast<Symbol*>(pBuilder.num_vars++);
+    }
+    add_canonical_token(pBuilder, CANON_VARIABLE);
+    add_canonical_token(pBuilder, reinterpret_cast<uintptr_t>(pSym->var->current_binding_value));
+}
+
+void add_canonical_test(canonical_builder& pBuilder, test t)
+{
+    cons* c;
+
+    if (!t)
+    {
+        add_canonical_token(pBuilder, CANON_NULL);
+        return;
+    }
+    add_canonical_token(pBuilder, t->type);
+    switch (t->type)
+    {
+        case DISJUNCTION_TEST:
+            for (c = t->data.disjunction_list; c != NIL; c = c->rest)
+            {
+                add_canonical_token(pBuilder, reinterpret_cast<uintptr_t>(c->first));
+            }
+            add_canonical_token(pBuilder, CANON_END);
+            break;
+        case CONJUNCTIVE_TEST:
+            for (c = t->data.conjunct_list; c != NIL; c = c->rest)
+            {
+                add_canonical_test(pBuilder, static_cast<test>(c->first));
+            }
+            add_canonical_token(pBuilder, CANON_END);
+            break;
+        case GOAL_ID_TEST:
+        case IMPASSE_ID_TEST:
+        case SMEM_LINK_UNARY_TEST:
+        case SMEM_LINK_UNARY_NOT_TEST:
+            break;
+        default:
+            add_canonical_symbol(pBuilder, t->data.referent);
+            break;
+    }
+}
+
+void add_canonical_conditions(canonical_builder& pBuilder, condition* pCondList)
+{
+    for (condition* cond = pCondList; cond != NIL; cond = cond->next)
+    {
+        add_canonical_token(pBuilder, CANON_CONDITION);
+        add_canonical_token(pBuilder, cond->type);
+        if (cond->type == CONJUNCTIVE_NEGATION_CONDITION)
+        {
+            add_canonical_conditions(pBuilder, cond->data.ncc.top);
+        }
+        else
+        {
+            add_canonical_test(pBuilder, cond->data.tests.id_test);
+            add_canonical_test(pBuilder, cond->data.tests.attr_test);
+            add_canonical_test(pBuilder, cond->data.tests.value_test);
+            add_canonical_token(pBuilder, cond->test_for_acceptable_preference);
+        }
+    }
+    add_canonical_token(pBuilder, CANON_END);
+}
+
+void add_canonical_rhs_value(canonical_builder& pBuilder, rhs_value rv)
+{
+    if (rhs_value_is_null(rv))
+    {
+        add_canonical_token(pBuilder, CANON_NULL);
+    }
+    else if (rhs_value_is_symbol(rv))
+    {
+        add_canonical_symbol(pBuilder, rhs_value_to_symbol(rv));
+    }
+    else if (rhs_value_is_funcall(rv))
+    {
+        cons* fl = rhs_value_to_funcall_list(rv);
+        add_canonical_token(pBuilder, CANON_FUNCALL);
+        add_canonical_token(pBuilder, reinterpret_cast<uintptr_t>(fl->first));
+        for (cons* c = fl->rest; c != NIL; c = c->rest)
+        {
+            add_canonical_rhs_value(pBuilder, static_cast<rhs_value>(c->first));
+        }
+        add_canonical_token(pBuilder, CANON_END);
+    }
+    else
+    {
+        /* Retelocs and unbound variable indices are already position-based */
+        add_canonical_token(pBuilder, CANON_RETE_VALUE);
+        add_canonical_token(pBuilder, reinterpret_cast<uintptr_t>(rv));
+    }
+}
+
+uint64_t hash_canonical_form(const canonical_form& pForm)
+{
+    uint64_t lHash = 14695981039346656037ULL;
+
+    for (size_t i = 0; i < pForm.size(); ++i)
+    {
+        lHash = (lHash ^ static_cast<uint64_t>(pForm[i])) * 1099511628211ULL;
+    }
+    return lHash;
+}
+
+uint64_t build_canonical_form(agent* thisAgent, condition* lhs_top, action* rhs, canonical_form& pForm)
+{
+    canonical_builder lBuilder;
+
+    lBuilder.form.swap(pForm);
+    lBuilder.form.clear();
+    lBuilder.var_tc = get_new_tc_number(thisAgent);
+    lBuilder.num_vars = 0;
+
+    add_canonical_conditions(lBuilder, lhs_top);
+    add_canonical_token(lBuilder, CANON_RHS);
+    for (action* a = rhs; a != NIL; a = a->next)
+    {
+        add_canonical_token(lBuilder, CANON_ACTION);
+        add_canonical_token(lBuilder, a->type);
+        add_canonical_rhs_value(lBuilder, a->value);
+        if (a->type == MAKE_ACTION)
+        {
+            add_canonical_token(lBuilder, a->preference_type);
+            add_canonical_rhs_value(lBuilder, a->id);
+            add_canonical_rhs_value(lBuilder, a->attr);
+            if (preference_is_binary(a->preference_type))
+            {
+                add_canonical_rhs_value(lBuilder, a->referent);
+            }
+        }
+    }
+    add_canonical_token(lBuilder, CANON_END);
+
+    lBuilder.form.swap(pForm);
+    return hash_canonical_form(pForm);
+}
+
+production* Canonical_Production_Index::find(uint64_t pHash, const canonical_form& pForm)
+{
+    std::pair< form_map::iterator, form_map::iterator > lRange = m_forms.equal_range(pHash);
+    for (form_map::iterator it = lRange.first; it != lRange.second; ++it)
+    {
+        if (it->second.second == pForm)
+        {
+            return it->second.first;
+        }
+    }
+    return NIL;
+}
+
+void Canonical_Production_Index::add(production* pProd, uint64_t pHash, canonical_form& pForm)
+{
+    form_map::iterator it = m_forms.insert(std::make_pair(pHash, std::make_pair(pProd, canonical_form())));
+    it->second.second.swap(pForm);
+    m_prod_hashes[pProd] = pHash;
+}
+
+void Canonical_Production_Index::replace_symbol(production* pProd, Symbol* pOld, Symbol* pNew)
+{
+    std::unordered_map< production*, uint64_t >::iterator lProdIter = m_prod_hashes.find(pProd);
+    if (lProdIter == m_prod_hashes.end())
+    {
+        return;
+    }
+    std::pair< form_map::iterator, form_map::iterator > lRange = m_forms.equal_range(lProdIter->second);
+    for (form_map::iterator it = lRange.first; it != lRange.second; ++it)
+    {
+        if (it->second.first != pProd)
+        {
+            continue;
+        }
+        /* The changed value is in the RHS, which is at the end of the form */
+        canonical_form lForm;
+        lForm.swap(it->second.second);
+        m_forms.erase(it);
+        for (size_t i = lForm.size(); i-- > 1;)
+        {
+            if ((lForm[i] == reinterpret_cast<uintptr_t>(pOld)) && (lForm[i - 1] == CANON_SYMBOL))
+            {
+                lForm[i] = reinterpret_cast<uintptr_t>(pNew);
+                break;
+            }
+        }
+        m_prod_hashes.erase(lProdIter);
+        add(pProd, hash_canonical_form(lForm), lForm);
+        return;
+    }
+}
+
+void Canonical_Production_Index::remove(production* pProd)
+{
+    std::unordered_map< production*, uint64_t >::iterator lProdIter = m_prod_hashes.find(pProd);
+    if (lProdIter == m_prod_hashes.end())
+    {
+        return;
+    }
+    std::pair< form_map::iterator, form_map::iterator > lRange = m_forms.equal_range(lProdIter->second);
+    for (form_map::iterator it = lRange.first; it != lRange.second; ++it)
+    {
+        if (it->second.first == pProd)
+        {
+            m_forms.erase(it);
+            break;
+        }
+    }
+    m_prod_hashes.erase(lProdIter);
+}
+
 /* ---------------------------------------------------------------------
                     Fixup RHS-Value Variable References
 
@@ -3732,6 +4482,20 @@ void update_max_rhs_unbound_variables(agent* thisAgent, uint64_t num_for_new_pro
    BUGBUG should we check for duplicate justifications?
 --------------------------------------------------------------------- */
 
+void warn_about_duplicate_production(agent* thisAgent, production* p, production* duplicate_rule)
+{
+    std::stringstream output;
+    output << "\nIgnoring "
+           << p->name->to_string(true)
+           << " because it is a duplicate of "
+           << duplicate_rule->name->to_string(true)
+           << " ";
+    xml_generate_warning(thisAgent, output.str().c_str());
+
+    thisAgent->outputManager->printa_sf(thisAgent, "Ignoring %y because it is a duplicate of %y\n",
+                       p->name, duplicate_rule->name);
+}
+
 byte add_production_to_rete(agent* thisAgent, production* p, condition* lhs_top, instantiation* refracted_inst, bool warn_on_duplicates, production* &duplicate_rule, bool ignore_rhs)
 {
     rete_node* bottom_node, *p_node;
@@ -3740,6 +4504,24 @@ byte add_production_to_rete(agent* thisAgent, production* p, condition* lhs_top,
     ms_change* msc;
     action* a;
     byte production_addition_result;
+    canonical_form lCanonicalForm;
+    uint64_t lCanonicalHash;
+
+    /* --- reject exact duplicates before touching the network --- */
+    lCanonicalHash = build_canonical_form(thisAgent, lhs_top, p->action_list, lCanonicalForm);
+    if (!ignore_rhs)
+    {
+        production* lExisting = thisAgent->canonical_production_index->find(lCanonicalHash, lCanonicalForm);
+        if (lExisting)
+        {
+            duplicate_rule = lExisting;
+            if (warn_on_duplicates)
+            {
+                warn_about_duplicate_production(thisAgent, p, lExisting);
+            }
+            return DUPLICATE_PRODUCTION;
+        }
+    }
 
     /* --- build the network for all the conditions --- */
     build_network_for_condition_list(thisAgent, lhs_top, 1, thisAgent->dummy_top_node,
@@ -3804,24 +4586,25 @@ byte add_production_to_rete(agent* thisAgent, production* p, condition* lhs_top,
         duplicate_rule = p_node->b.p.prod;
         if (warn_on_duplicates)
         {
-            std::stringstream output;
-            output << "\nIgnoring "
-                   << p->name->to_string(true)
-                   << " because it is a duplicate of "
-                   << p_node->b.p.prod->name->to_string(true)
-                   << " ";
-            xml_generate_warning(thisAgent, output.str().c_str());
-
-            thisAgent->outputManager->printa_sf(thisAgent, "Ignoring %y because it is a duplicate of %y\n",
-                               p->name, p_node->b.p.prod->name);
+            warn_about_duplicate_production(thisAgent, p, p_node->b.p.prod);
         }
         thisAgent->symbolManager->deallocate_symbol_list_removing_references(rhs_unbound_vars_for_new_prod);
         return DUPLICATE_PRODUCTION;
     }
 
+    /* --- a refracted instantiation must be checked against a complete
+       network, so don't leave any of it deferred --- */
+    if (refracted_inst && !thisAgent->deferred_rete_nodes->empty())
+    {
+        flush_deferred_rete_nodes(thisAgent);
+    }
+
     /* --- build a new p node --- */
     p_node = make_new_production_node(thisAgent, bottom_node, p);
+    deallocate_rhs_program(thisAgent, p->compiled_rhs);
+    p->compiled_rhs = compile_rhs_program(thisAgent, p->action_list);
     adjust_sharing_factors_from_here_to_top(p_node, 1);
+    thisAgent->canonical_production_index->add(p, lCanonicalHash, lCanonicalForm);
 
 
     /* KJC 1/28/98  left these comments in to support REW comments below
@@ -3891,7 +4674,14 @@ byte add_production_to_rete(agent* thisAgent, production* p, condition* lhs_top,
     }
 
     /* --- call new node's add_left routine with all the parent's tokens --- */
-    update_node_with_matches_from_above(thisAgent, p_node);
+    if (refracted_inst)
+    {
+        update_node_with_matches_from_above(thisAgent, p_node);
+    }
+    else
+    {
+        update_new_node_with_matches_from_above(thisAgent, p_node);
+    }
 
     /* --- store result indicator --- */
     if (! refracted_inst)
@@ -3958,6 +4748,8 @@ void excise_production_from_rete(agent* thisAgent, production* pProd)
 
     soar_invoke_callbacks(thisAgent, PRODUCTION_JUST_ABOUT_TO_BE_EXCISED_CALLBACK, static_cast<soar_call_data>(pProd));
 
+    thisAgent->canonical_production_index->remove(pProd);
+
     p_node = pProd->p_node;
     pProd->p_node = NIL;      /* mark production as not being in the rete anymore */
     parent = p_node->parent;
@@ -3983,6 +4775,7 @@ void excise_production_from_rete(agent* thisAgent, production* pProd)
     }
 
     /* --- finally, excise the p_node --- */
+    thisAgent->deferred_rete_nodes->remove(p_node);
     remove_node_from_parents_list_of_children(p_node);
     update_stats_for_destroying_node(thisAgent, p_node);    /* clean up rete stats stuff */
     thisAgent->memoryManager->free_with_pool(MP_rete_node, p_node);
@@ -7743,6 +8536,7 @@ void reteload_node_and_children(agent* thisAgent, rete_node* parent, FILE* f)
             prod->type = static_cast<ProductionType>(reteload_one_byte(f));
             prod->declared_support = static_cast<SupportType>(reteload_one_byte(f));
             prod->action_list = reteload_action_list(thisAgent, f);
+            prod->compiled_rhs = compile_rhs_program(thisAgent, prod->action_list);
 
             count = reteload_eight_bytes(f);
             update_max_rhs_unbound_variables(thisAgent, count);
@@ -7795,7 +8589,7 @@ void reteload_node_and_children(agent* thisAgent, rete_node* parent, FILE* f)
             }
 
             /* --- call new node's add_left routine with all the parent's tokens --- */
-            update_node_with_matches_from_above(thisAgent, New);
+            update_new_node_with_matches_from_above(thisAgent, New);
 
             /* --- invoke callback on the production --- */
             soar_invoke_callbacks(thisAgent, PRODUCTION_JUST_ADDED_CALLBACK, static_cast<soar_call_data>(prod));
@@ -9479,6 +10273,10 @@ void init_rete(agent* thisAgent)
     thisAgent->right_ht = thisAgent->memoryManager->allocate_memory_and_zerofill(sizeof(char*) * RIGHT_HT_SIZE, HASH_TABLE_MEM_USAGE);
 
     init_dummy_top_node(thisAgent);
+    thisAgent->join_index = NIL;
+    thisAgent->canonical_production_index = new Canonical_Production_Index();
+    thisAgent->deferred_rete_nodes = new Deferred_Rete_Nodes();
+    thisAgent->match_statistics = false;
 
     thisAgent->max_rhs_unbound_variables = 1;
     thisAgent->rhs_variable_bindings = (Symbol**)
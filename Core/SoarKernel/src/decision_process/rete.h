@@ -29,7 +29,8 @@
    retractions.
 
    Add_wme_to_rete() and remove_wme_from_rete() inform the rete of changes
-   to WM.
+   to WM.  Add_wmes_to_rete() adds a whole array of wmes, in order, doing
+   the per-call setup only once.
 
    P_node_to_conditions_and_nots() takes a p_node and (optionally) a
    token/wme pair, and reconstructs the (optionally instantiated) LHS
@@ -57,6 +58,9 @@
 #include <stdio.h>  // Needed for FILE token below
 #include "kernel.h"
 
+#include <unordered_map>
+#include <vector>
+
 extern void abort_with_fatal_error_noagent(const char* msg);
 
 inline varnames* one_var_to_varnames(Symbol* x)
@@ -142,6 +146,9 @@ typedef struct alpha_mem_struct
     uint32_t am_id;            /* id for hashing */
     uint64_t reference_count;  /* number of beta nodes using this mem */
     uint64_t retesave_amindex;
+    uint64_t num_wmes;         /* wmes in right_mems, and how many distinct */
+    uint64_t num_ids;          /* ids they have; only kept while match
+                                  statistics are on */
 } alpha_mem;
 
 /* --- the entry for one WME in one alpha memory --- */
@@ -260,6 +267,16 @@ typedef struct rete_node_struct
     } b;
 } rete_node;
 
+/* --- positive join and negative nodes by parent and alpha memory, for
+       finding a node to share without walking the parent's children;
+       see "Join Node Index" in rete.cpp --- */
+typedef struct beta_node_index_struct
+{
+    uint32_t size;          /* number of entries, always a power of two */
+    uint32_t count;         /* number of non-NIL entries */
+    rete_node** entries;    /* linear probing, no tombstones */
+} beta_node_index;
+
 /* --- for the last two (i.e., the relational tests), we add in one of
        the following, to specifiy the kind of relation --- */
 #define RELATIONAL_EQUAL_RETE_TEST            0x00
@@ -377,6 +394,69 @@ extern bool get_next_retraction(agent* thisAgent, struct instantiation_struct**
 extern bool get_next_nil_goal_retraction(agent* thisAgent, struct instantiation_struct** inst);
 /* REW: end   08.20.97 */
 
+/* -- Canonical_Production_Index
+ *
+ *    Maps the canonical form of every production added to the rete back
+ *    to that production, so duplicates can be found before any rete nodes
+ *    are built.  See "Canonical Production Index" in rete.cpp. -- */
+
+typedef std::vector< uintptr_t > canonical_form;
+
+class Canonical_Production_Index
+{
+    public:
+
+        production* find(uint64_t pHash, const canonical_form& pForm);
+        void        add(production* pProd, uint64_t pHash, canonical_form& pForm);
+        void        replace_symbol(production* pProd, Symbol* pOld, Symbol* pNew);
+        void        remove(production* pProd);
+
+        size_t      size() { return m_prod_hashes.size(); }
+
+    private:
+
+        typedef std::unordered_multimap< uint64_t, std::pair< production*, canonical_form > > form_map;
+
+        form_map                                    m_forms;
+        std::unordered_map< production*, uint64_t > m_prod_hashes;
+};
+
+/* -- Deferred_Rete_Nodes
+ *
+ *    Beta nodes built while a production batch is open, in the order they
+ *    were built.  They are not populated with the current matches until
+ *    the batch ends or the rete is about to be used.  See "Production
+ *    Batches" in rete.cpp. -- */
+
+class Deferred_Rete_Nodes
+{
+    public:
+
+        Deferred_Rete_Nodes() : m_batch_depth(0) {}
+
+        void        begin_batch() { ++m_batch_depth; }
+        bool        end_batch();
+        bool        batch_is_open() { return (m_batch_depth > 0); }
+
+        void        add(rete_node* pNode);
+        void        remove(rete_node* pNode);
+        void        replace(rete_node* pOld, rete_node* pNew);
+        void        take_topmost(std::vector< rete_node* >& pNodes);
+
+        bool        empty() { return m_positions.empty(); }
+        size_t      size() { return m_positions.size(); }
+
+    private:
+
+        std::vector< rete_node* >                   m_nodes;
+        std::unordered_map< rete_node*, size_t >    m_positions;
+        uint64_t                                    m_batch_depth;
+};
+
+extern void begin_production_batch(agent* thisAgent);
+extern void end_production_batch(agent* thisAgent);
+extern void flush_deferred_rete_nodes(agent* thisAgent);
+
 #define NO_REFRACTED_INST 0              /* no refracted inst. was given */
 #define REFRACTED_INST_MATCHED 1         /* there was a match for the inst. */
 #define REFRACTED_INST_DID_NOT_MATCH 2   /* there was no match for it */
@@ -387,8 +467,12 @@ extern byte add_production_to_rete(agent* thisAgent, production* p, condition* l
 extern void excise_production_from_rete(agent* thisAgent, production* p);
 
 extern void add_wme_to_rete(agent* thisAgent, wme* w);
+extern void add_wmes_to_rete(agent* thisAgent, wme** wmes, size_t num_wmes);
 extern void remove_wme_from_rete(agent* thisAgent, wme* w);
 
+extern void set_match_statistics(agent* thisAgent, bool pOn);
+extern bool get_values_per_id_for_attribute(agent* thisAgent, Symbol* attr, bool acceptable, uint64_t* values_per_id);
+
 void retesave_eight_bytes(uint64_t w, FILE* f);
 void retesave_string(const char* s, FILE* f);
 
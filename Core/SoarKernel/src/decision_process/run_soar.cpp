@@ -290,6 +290,7 @@ void reset_statistics(agent* thisAgent)
     thisAgent->WM->wma_timers->reset();
     thisAgent->EpMem->epmem_timers->reset();
     thisAgent->SMem->timers->reset();
+    thisAgent->explanationBasedChunker->ebc_timers->reset();
 
     thisAgent->WM->wma_d_cycle_count = 0;
 }
@@ -438,6 +439,12 @@ void do_one_top_level_phase(agent* thisAgent)
         return;
     }
 
+    /* --- productions loaded in a batch that is still open must match --- */
+    if (!thisAgent->deferred_rete_nodes->empty())
+    {
+        flush_deferred_rete_nodes(thisAgent);
+    }
+
     switch (thisAgent->current_phase)
     {
 
@@ -1484,6 +1491,7 @@ void init_agent_memory(agent* thisAgent)
     thisAgent->WM->wma_timers->reset();
     thisAgent->EpMem->epmem_timers->reset();
     thisAgent->SMem->timers->reset();
+    thisAgent->explanationBasedChunker->ebc_timers->reset();
 
     // This is an important part of the state of the agent for io purposes
     // (see io.cpp for details)
@@ -37,12 +37,13 @@ Explanation_Based_Chunker::Explanation_Based_Chunker(agent* myAgent)
     /* Create the parameter object where the cli settings are stored.
      * This also initializes the ebc_settings array */
     ebc_params = new ebc_param_container(thisAgent, ebc_settings, max_chunks, max_dupes);
+    ebc_timers = new ebc_timer_container(thisAgent);
 
     /* Create data structures used for EBC */
-    instantiation_identities = new sym_to_id_map();
-    constraints = new constraint_list();
-    inst_id_to_identity_map = new id_to_join_map();
-    cond_merge_map = new triple_merge_map();
+    instantiation_identities = new ebc_sym_to_id_map();
+    constraints = new ebc_constraint_list();
+    inst_id_to_identity_map = new ebc_id_to_identity_map();
+    cond_merge_map = new ebc_cond_merge_map();
     local_linked_STIs = new rhs_value_list();
     m_sym_to_var_map = new sym_to_sym_id_map();
 
@@ -55,6 +56,10 @@ Explanation_Based_Chunker::Explanation_Based_Chunker(agent* myAgent)
     singletons = new symbol_set();
 
     lti_link_function = NULL;
+
+    /* Productions survive an init-soar, so their ids are never reset.  The explainer
+     * looks rules up by id and would otherwise confuse a new chunk with an old rule. */
+    prod_id_counter = 0;
     reinit();
 }
 
@@ -62,6 +67,7 @@ Explanation_Based_Chunker::~Explanation_Based_Chunker()
 {
     clear_data();
     delete ebc_params;
+    delete ebc_timers;
     delete instantiation_identities;
     delete constraints;
     delete inst_id_to_identity_map;
@@ -78,7 +84,6 @@ void Explanation_Based_Chunker::reinit()
 {
     clear_data();
     inst_id_counter                     = 0;
-    prod_id_counter                     = 0;
     identity_counter                    = 0;
     inst_identity_counter               = 0;
     backtrace_number                    = 0;
@@ -86,6 +91,7 @@ void Explanation_Based_Chunker::reinit()
     justification_naming_counter        = 0;
     grounds_tc                          = 0;
     m_results_match_goal_level          = 0;
+    m_memory_at_start                   = 0;
     m_goal_level                        = 0;
     m_results_tc                        = 0;
     m_correctness_issue_possible        = true;
@@ -12,6 +12,7 @@
 
 #include "ebc_structs.h"
 #include "ebc_identity.h"
+#include "ebc_scratch.h"
 #include "stl_typedefs.h"
 
 #include <list>
@@ -43,6 +44,7 @@ class Explanation_Based_Chunker
         ebc_param_container*    ebc_params;
         bool                    ebc_settings[num_ebc_settings];
         uint64_t                max_chunks, max_dupes;
+        ebc_timer_container*    ebc_timers;
 
         /* Cached pointer to lti link rhs function since it may be used often */
         rhs_function*           lti_link_function;
@@ -200,10 +202,14 @@ class Explanation_Based_Chunker
         ProductionType      m_prod_type;
         bool                m_should_print_name, m_should_print_prod;
 
+        /* Bytes the memory manager had handed out when the current rule began forming */
+        uint64_t            m_memory_at_start;
+
         /* Core tables used by EBC during identity assignment during instantiation
-         * creation. The data stored within them is temporary and cleared after use. */
-        sym_to_id_map*      instantiation_identities;
-        id_to_join_map*     inst_id_to_identity_map;
+         * creation. The data stored within them is temporary and cleared after use,
+         * so they are scratch maps that can be reset in constant time. */
+        ebc_sym_to_id_map*      instantiation_identities;
+        ebc_id_to_identity_map* inst_id_to_identity_map;
 
         /* A variablization map used for old school soar identifier variablization */
         sym_to_sym_id_map*  m_sym_to_var_map;
@@ -215,11 +221,11 @@ class Explanation_Based_Chunker
         symbol_set*         singletons;
 
         /* Data structures used to track and assign loose constraints */
-        constraint_list*    constraints;
+        ebc_constraint_list*    constraints;
 
         /* Table of previously seen conditions.  Used to determine whether to
          * merge or eliminate positive conditions on the LHS of a chunk. */
-        triple_merge_map*   cond_merge_map;
+        ebc_cond_merge_map* cond_merge_map;
 
         /* List of STIs created in the sub-state that are linked to LTMs.  Used to add link-stm-to-ltm actions */
         rhs_value_list*     local_linked_STIs;
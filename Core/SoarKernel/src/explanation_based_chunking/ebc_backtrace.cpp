@@ -55,6 +55,13 @@ using namespace soar_TraceNames;
    macros below are used to add conditions to these sets.  The negated
    conditions are maintained in the chunk_cond_set "negated_set."
 
+   Backtracing runs on the calling thread.  Each step unifies identity
+   sets, appends to the grounds and locals lists and records the
+   explanation as it goes, and the order of those steps decides the
+   variablization and condition order of the learned rule, so the
+   independent branches of the trace can't be explored concurrently without
+   changing the rules that get learned.
+
 ==================================================================== */
 
 void Explanation_Based_Chunker::add_to_grounds(condition* cond)
@@ -62,9 +69,9 @@ void Explanation_Based_Chunker::add_to_grounds(condition* cond)
     if ((cond)->bt.wme_->tc != grounds_tc)
     {
         (cond)->bt.wme_->tc = grounds_tc;
-        cond->bt.wme_->chunker_bt_last_ground_cond = cond;
+        get_rare_fields(thisAgent, cond->bt.wme_).chunker_bt_last_ground_cond = cond;
     }
-    if ((cond->bt.wme_->chunker_bt_last_ground_cond != cond) && ebc_settings[SETTING_EBC_LEARNING_ON])
+    if ((peek_rare_fields(thisAgent, cond->bt.wme_).chunker_bt_last_ground_cond != cond) && ebc_settings[SETTING_EBC_LEARNING_ON])
     {
         check_for_singleton_unification(cond);
     }
@@ -675,7 +675,7 @@ bool Explanation_Based_Chunker::add_chunk_to_rete()
     }
     if (rete_addition_result == REFRACTED_INST_MATCHED)
     {
-        thisAgent->explanationMemory->record_chunk_contents(m_prod, m_lhs, m_rhs, m_results, inst_id_to_identity_map, m_inst, m_chunk_inst, m_prod_type);
+        thisAgent->explanationMemory->record_chunk_contents(m_prod, m_lhs, m_rhs, m_results, m_inst, m_chunk_inst, m_prod_type);
         if (m_prod_type == JUSTIFICATION_PRODUCTION_TYPE) {
             thisAgent->explanationMemory->increment_stat_justifications_succeeded();
             /* We'll interrupt on justification learning only if explainer is recording justifications.  In
@@ -735,7 +735,7 @@ bool Explanation_Based_Chunker::add_chunk_to_rete()
             }
         }
 
-        thisAgent->explanationMemory->record_chunk_contents(m_prod, m_lhs, m_rhs, m_results, inst_id_to_identity_map, m_inst, m_chunk_inst, m_prod_type);
+        thisAgent->explanationMemory->record_chunk_contents(m_prod, m_lhs, m_rhs, m_results, m_inst, m_chunk_inst, m_prod_type);
 
         m_chunk_inst->in_ms = false;
         return true;
@@ -797,6 +797,9 @@ void Explanation_Based_Chunker::learn_rule_from_instance(instantiation* inst, in
         return;
     }
 
+    ebc_timers->ebc_total->start();
+    m_memory_at_start = thisAgent->memoryManager->get_bytes_allocated();
+
     /* Set up a new instantiation and ID for this chunk's refracted instantiation */
     init_instantiation(thisAgent, m_chunk_inst, NULL);
     l_clean_up_id = m_chunk_inst->i_id;
@@ -825,10 +828,14 @@ void Explanation_Based_Chunker::learn_rule_from_instance(instantiation* inst, in
     m_tested_ltm_recall = false;
     m_tested_quiescence = false;
 
+    ebc_timers->dependency_analysis->start();
     perform_dependency_analysis();
+    ebc_timers->dependency_analysis->stop();
 
     /* Collect the grounds into the chunk condition lists */
+    ebc_timers->identity_unification->start();
     create_initial_chunk_condition_lists();
+    ebc_timers->identity_unification->stop();
 
     /* If there aren't any conditions, abort chunk */
     if (!m_lhs)
@@ -881,13 +888,21 @@ void Explanation_Based_Chunker::learn_rule_from_instance(instantiation* inst, in
 
     if (ebc_settings[SETTING_EBC_LEARNING_ON] && (m_rule_type == ebc_chunk))
     {
+        ebc_timers->variablization_lhs->start();
         thisAgent->symbolManager->reset_variable_generator(m_lhs, NIL);
         variablize_condition_list(m_lhs);
+        ebc_timers->variablization_lhs->stop();
+        ebc_timers->merging->start();
         merge_conditions();
+        ebc_timers->merging->stop();
+        ebc_timers->variablization_rhs->start();
         m_rhs = variablize_results_into_actions();
+        ebc_timers->variablization_rhs->stop();
     } else {
+        ebc_timers->identity_update->start();
         update_identities_in_condition_list(m_lhs);
         m_rhs = convert_results_into_actions();
+        ebc_timers->identity_update->stop();
     }
 
     /* Add isa_goal tests for first conditions seen with a goal identifier */
@@ -897,7 +912,9 @@ void Explanation_Based_Chunker::learn_rule_from_instance(instantiation* inst, in
     thisAgent->name_of_production_being_reordered = m_prod_name->sc->name;
     if (m_rule_type == ebc_chunk)
     {
+        ebc_timers->reorder->start();
         lChunkValidated = reorder_and_validate_chunk();
+        ebc_timers->reorder->stop();
     }
 
     /* Handle rule learning failure.  With the addition of rule repair, this should only happen when there
@@ -926,6 +943,7 @@ void Explanation_Based_Chunker::learn_rule_from_instance(instantiation* inst, in
      * level (m_chunk_inst).  After being submitted to the RETE, it is then chunked over
      * if necessary for bottom up chunking. */
 
+    ebc_timers->reinstantiate->start();
     if (ebc_settings[SETTING_EBC_LEARNING_ON] && ((m_rule_type == ebc_chunk) || lRevertedChunk))
     {
         l_inst_top = reinstantiate_current_rule();
@@ -934,8 +952,10 @@ void Explanation_Based_Chunker::learn_rule_from_instance(instantiation* inst, in
     } else {
         copy_condition_list(thisAgent, m_lhs, &l_inst_top, &l_inst_bottom, false, false, false, false);
     }
+    ebc_timers->reinstantiate->stop();
 
     /* Create the production that will be added to the RETE */
+    ebc_timers->chunk_instantiation_creation->start();
     m_prod = make_production(thisAgent, m_prod_type, m_prod_name, m_inst->prod ? m_inst->prod->original_rule_name : m_inst->prod_name->sc->name, &m_lhs, &m_rhs, false, NULL);
     m_prod->naming_depth = m_chunk_inst->prod_naming_depth;
 
@@ -962,12 +982,17 @@ void Explanation_Based_Chunker::learn_rule_from_instance(instantiation* inst, in
     find_match_goal(thisAgent, m_chunk_inst);
     make_clones_of_results();
     finalize_instantiation(thisAgent, m_chunk_inst, true, m_inst, true, true);
+    ebc_timers->chunk_instantiation_creation->stop();
 
     /* Add to RETE */
+    ebc_timers->add_to_rete->start();
     bool lAddedSuccessfully = add_chunk_to_rete();
+    ebc_timers->add_to_rete->stop();
 
     if (lAddedSuccessfully)
     {
+        thisAgent->explanationMemory->increment_stat_rule_memory(thisAgent->memoryManager->get_bytes_allocated(), m_memory_at_start);
+
         /* --- Add chunk instantiation to list of newly generated instantiations --- */
         m_chunk_inst->next = (*new_inst_list);
         (*new_inst_list) = m_chunk_inst;
@@ -998,6 +1023,7 @@ void Explanation_Based_Chunker::learn_rule_from_instance(instantiation* inst, in
 
 void Explanation_Based_Chunker::clean_up (uint64_t pClean_up_id, soar_timer* pTimer)
 {
+    ebc_timers->clean_up->start();
     thisAgent->explanationMemory->end_chunk_record();
     if (m_chunk_inst)
     {
@@ -1030,6 +1056,8 @@ void Explanation_Based_Chunker::clean_up (uint64_t pClean_up_id, soar_timer* pTi
         clear_cached_constraints();
         clear_sti_variablization_map();
     }
+    ebc_timers->clean_up->stop();
+    ebc_timers->ebc_total->stop();
     #if !defined(NO_TIMING_STUFF) && defined(DETAILED_TIMING_STATS)
     pTimer->stop();
     thisAgent->timers_chunking_cpu_time[thisAgent->current_phase].update(*pTimer);
@@ -11,31 +11,22 @@
 
 void Explanation_Based_Chunker::clear_cached_constraints()
 {
-    for (constraint_list::iterator it = constraints->begin(); it != constraints->end(); ++it)
-    {
-        /* We intentionally used the tests in the conditions backtraced through instead of copying
-         * them, so we don't need to deallocate the tests in the constraint. We just delete the
-         * constraint struct that contains the two pointers.*/
-        thisAgent->memoryManager->free_with_pool(MP_constraints, *it);
-    }
+    /* We intentionally used the tests in the conditions backtraced through instead of copying
+     * them, so we don't need to deallocate the tests in the constraint.  Constraints are stored
+     * by value, so clearing just resets the list and keeps its storage for the next rule. */
     constraints->clear();
 }
 
 void Explanation_Based_Chunker::cache_constraints_in_test(test t)
 {
     test ctest;
-    constraint* new_constraint = NULL;
 
     for (cons* c = t->data.conjunct_list; c != NIL; c = c->rest)
     {
         ctest = static_cast<test>(c->first);
         if (test_can_be_transitive_constraint(ctest))
         {
-
-            thisAgent->memoryManager->allocate_with_pool(MP_constraints, &new_constraint);
-            new_constraint->eq_test = t->eq_test;
-            new_constraint->constraint_test = ctest;
-            constraints->push_back(new_constraint);
+            constraints->push_back(constraint(t->eq_test, ctest));
             thisAgent->explanationMemory->increment_stat_constraints_collected();
         }
     }
@@ -103,9 +94,9 @@ void Explanation_Based_Chunker::add_additional_constraints()
     constraint* lConstraint = NULL;
     test eq_copy = NULL, constraint_test = NULL;
 
-    for (constraint_list::iterator iter = constraints->begin(); iter != constraints->end();)
+    for (ebc_constraint_list::iterator iter = constraints->begin(); iter != constraints->end();)
     {
-        lConstraint = *iter;
+        lConstraint = &(*iter);
         condition* lOperationalCond = lConstraint->eq_test->identity ? lConstraint->eq_test->identity->get_operational_cond() : NULL;
         condition* lOperationalConstraintCond = lConstraint->constraint_test->identity ? lConstraint->constraint_test->identity->get_operational_cond() : NULL;
 
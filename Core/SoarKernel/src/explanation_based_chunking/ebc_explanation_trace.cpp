@@ -15,12 +15,12 @@
 
 uint64_t Explanation_Based_Chunker::get_or_create_inst_identity_for_sym(Symbol* pSym)
 {
-    int64_t existing_o_id = 0;
+    uint64_t existing_o_id = 0;
 
-    auto iter_sym = instantiation_identities->find(pSym);
-    if (iter_sym != instantiation_identities->end())
+    uint64_t* lFound = instantiation_identities->find(pSym);
+    if (lFound)
     {
-        existing_o_id = iter_sym->second;
+        existing_o_id = *lFound;
     }
 
     if (!existing_o_id)
@@ -87,17 +87,17 @@ Identity* Explanation_Based_Chunker::get_floating_identity(Symbol* pGoal)
 
 Identity* Explanation_Based_Chunker::get_identity_for_id(uint64_t pID)
 {
-    auto iter = (*inst_id_to_identity_map).find(pID);
-    if (iter != (*inst_id_to_identity_map).end()) return iter->second;
+    Identity** lFound = inst_id_to_identity_map->find(pID);
+    if (lFound) return *lFound;
     else return NULL_IDENTITY_SET;
 }
 
 Identity* Explanation_Based_Chunker::get_or_add_identity(uint64_t pID, Identity* pIdentity, Symbol* pGoal)
 {
-    auto iter = (*inst_id_to_identity_map).find(pID);
-    if (iter != (*inst_id_to_identity_map).end())
+    Identity** lFound = inst_id_to_identity_map->find(pID);
+    if (lFound)
     {
-        Identity* l_identity = iter->second;
+        Identity* l_identity = *lFound;
 
         if (pIdentity) thisAgent->explanationMemory->increment_stat_identity_propagations_blocked();
         return l_identity;
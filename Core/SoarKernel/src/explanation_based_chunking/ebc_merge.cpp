@@ -21,24 +21,12 @@ void Explanation_Based_Chunker::merge_values_in_conds(condition* pDestCond, cond
 
 condition* Explanation_Based_Chunker::get_previously_seen_cond(condition* pCond)
 {
-    triple_merge_map::iterator          iter_id;
-    sym_to_sym_to_cond_map::iterator    iter_attr;
-    sym_to_cond_map::iterator           iter_value;
+    ebc_cond_key lKey = { pCond->data.tests.id_test->eq_test->data.referent,
+                          pCond->data.tests.attr_test->eq_test->data.referent,
+                          pCond->data.tests.value_test->eq_test->data.referent };
 
-    iter_id = cond_merge_map->find(pCond->data.tests.id_test->eq_test->data.referent);
-    if (iter_id != cond_merge_map->end())
-    {
-        iter_attr = iter_id->second.find(pCond->data.tests.attr_test->eq_test->data.referent);
-        if (iter_attr != iter_id->second.end())
-        {
-            iter_value = iter_attr->second.find(pCond->data.tests.value_test->eq_test->data.referent);
-            if (iter_value != iter_attr->second.end())
-            {
-                return iter_value->second;
-            }
-        }
-    }
-    return NULL;
+    condition** lFound = cond_merge_map->find(lKey);
+    return lFound ? *lFound : NULL;
 }
 
 
@@ -100,7 +88,10 @@ void Explanation_Based_Chunker::merge_conditions()
             }
             else
             {
-                (*cond_merge_map)[cond->data.tests.id_test->eq_test->data.referent][cond->data.tests.attr_test->eq_test->data.referent][cond->data.tests.value_test->eq_test->data.referent] = cond;
+                ebc_cond_key lKey = { cond->data.tests.id_test->eq_test->data.referent,
+                                      cond->data.tests.attr_test->eq_test->data.referent,
+                                      cond->data.tests.value_test->eq_test->data.referent };
+                (*cond_merge_map)[lKey] = cond;
             }
         }
         else
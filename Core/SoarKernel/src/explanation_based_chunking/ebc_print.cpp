@@ -60,23 +60,30 @@ void Explanation_Based_Chunker::print_merge_map(TraceMode mode)
     outputManager->printa_sf(thisAgent, "            Merge Map\n");
     outputManager->printa_sf(thisAgent, "------------------------------------\n");
 
-    if (cond_merge_map->size() == 0)
+    if (cond_merge_map->empty())
     {
         outputManager->printa_sf(thisAgent, "EMPTY MAP\n");
     }
 
-    triple_merge_map::iterator          iter_id;
-    sym_to_sym_to_cond_map::iterator    iter_attr;
-    sym_to_cond_map::iterator           iter_value;
-
-    for (iter_id = cond_merge_map->begin(); iter_id != cond_merge_map->end(); ++iter_id)
+    /* Group the conditions under their identifier, printing each id's
+     * header at the first entry that has it */
+    size_t i, j;
+    Symbol* lId;
+    for (i = 0; i < cond_merge_map->size(); ++i)
     {
-        outputManager->printa_sf(thisAgent, "%y conditions: \n", iter_id->first);
-        for (iter_attr = iter_id->second.begin(); iter_attr != iter_id->second.end(); ++iter_attr)
+        lId = cond_merge_map->key_at(i).id;
+        for (j = 0; j < i; ++j)
+        {
+            if (cond_merge_map->key_at(j).id == lId) break;
+        }
+        if (j < i) continue;
+
+        outputManager->printa_sf(thisAgent, "%y conditions: \n", lId);
+        for (j = i; j < cond_merge_map->size(); ++j)
         {
-            for (iter_value = iter_attr->second.begin(); iter_value != iter_attr->second.end(); ++iter_value)
+            if (cond_merge_map->key_at(j).id == lId)
             {
-                outputManager->printa_sf(thisAgent, "   %l\n", iter_value->second);
+                outputManager->printa_sf(thisAgent, "   %l\n", cond_merge_map->value_at(j));
             }
         }
     }
@@ -91,16 +98,14 @@ void Explanation_Based_Chunker::print_instantiation_identities_map(TraceMode mod
     outputManager->printa_sf(thisAgent, "     Instantiation Identity Map\n");
     outputManager->printa_sf(thisAgent, "------------------------------------\n");
 
-    if (instantiation_identities->size() == 0)
+    if (instantiation_identities->empty())
     {
         outputManager->printa_sf(thisAgent, "EMPTY MAP\n");
     }
 
-    sym_to_id_map::iterator iter_sym;
-
-    for (auto iter_sym = instantiation_identities->begin(); iter_sym != instantiation_identities->end(); ++iter_sym)
+    for (size_t i = 0; i < instantiation_identities->size(); ++i)
     {
-        outputManager->printa_sf(thisAgent, "   %y = o%u\n", iter_sym->first, iter_sym->second);
+        outputManager->printa_sf(thisAgent, "   %y = o%u\n", instantiation_identities->key_at(i), instantiation_identities->value_at(i));
     }
 
     outputManager->printa_sf(thisAgent, "------------------------------------\n");
@@ -114,16 +119,14 @@ void Explanation_Based_Chunker::print_id_to_identity_map(TraceMode mode)
     outputManager->printa_sf(thisAgent, "     Identity to Identity Set Map\n");
     outputManager->printa_sf(thisAgent, "------------------------------------\n");
 
-    if (inst_id_to_identity_map->size() == 0)
+    if (inst_id_to_identity_map->empty())
     {
         outputManager->printa_sf(thisAgent, "EMPTY MAP\n");
     }
 
-    id_to_join_map::iterator iter;
-
-    for (iter = inst_id_to_identity_map->begin(); iter != inst_id_to_identity_map->end(); ++iter)
+    for (size_t i = 0; i < inst_id_to_identity_map->size(); ++i)
     {
-        outputManager->printa_sf(thisAgent, "   %u = %u\n", iter->first, iter->second->get_identity());
+        outputManager->printa_sf(thisAgent, "   %u = %u\n", inst_id_to_identity_map->key_at(i), inst_id_to_identity_map->value_at(i)->get_identity());
     }
 
     outputManager->printa_sf(thisAgent, "------------------------------------\n");
@@ -139,9 +142,9 @@ void Explanation_Based_Chunker::print_constraints(TraceMode mode)
     {
         outputManager->printa_sf(thisAgent, "NO CONSTRAINTS RECORDED\n");
     }
-    for (constraint_list::iterator it = constraints->begin(); it != constraints->end(); ++it)
+    for (ebc_constraint_list::iterator it = constraints->begin(); it != constraints->end(); ++it)
     {
-        outputManager->printa_sf(thisAgent, "%t[%g]:   %t[%g]\n", (*it)->eq_test, (*it)->eq_test, (*it)->constraint_test, (*it)->constraint_test);
+        outputManager->printa_sf(thisAgent, "%t[%g]:   %t[%g]\n", it->eq_test, it->eq_test, it->constraint_test, it->constraint_test);
     }
 
     outputManager->printa_sf(thisAgent, "------------------------------------\n");
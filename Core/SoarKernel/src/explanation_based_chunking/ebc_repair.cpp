@@ -305,7 +305,9 @@ bool Explanation_Based_Chunker::reorder_and_validate_chunk()
 {
     matched_symbol_list* unconnected_syms = new matched_symbol_list();
 
+    thisAgent->reorder_with_match_statistics = ebc_settings[SETTING_EBC_REORDER_STATISTICS];
     auto reorder_result = reorder_and_validate_lhs_and_rhs(thisAgent, &m_lhs, &m_rhs, false, unconnected_syms, true, true);
+    thisAgent->reorder_with_match_statistics = false;
 
     if (reorder_result != reorder_success)
     {
@@ -315,12 +317,20 @@ bool Explanation_Based_Chunker::reorder_and_validate_chunk()
             thisAgent->outputManager->display_soar_feedback(thisAgent, ebc_progress_repairing, thisAgent->trace_settings[TRACE_CHUNKS_WARNINGS_SYSPARAM]);
 
             Repair_Manager* lRepairManager = new Repair_Manager(thisAgent, m_results_match_goal_level, m_chunk_inst->i_id);
+            /* Repair time is reported on its own, so it is kept out of the reorder timer */
+            ebc_timers->reorder->stop();
+            ebc_timers->repair->start();
             lRepairManager->repair_rule(m_lhs, unconnected_syms);
+            ebc_timers->repair->stop();
+            ebc_timers->reorder->start();
 
             delete_ungrounded_symbol_list(thisAgent, &unconnected_syms);
             unconnected_syms = new matched_symbol_list();
             thisAgent->outputManager->display_soar_feedback(thisAgent, ebc_progress_validating, thisAgent->trace_settings[TRACE_CHUNKS_WARNINGS_SYSPARAM]);
-            if (reorder_and_validate_lhs_and_rhs(thisAgent, &m_lhs, &m_rhs, false, unconnected_syms, false, false) == reorder_success)
+            thisAgent->reorder_with_match_statistics = ebc_settings[SETTING_EBC_REORDER_STATISTICS];
+            reorder_result = reorder_and_validate_lhs_and_rhs(thisAgent, &m_lhs, &m_rhs, false, unconnected_syms, false, false);
+            thisAgent->reorder_with_match_statistics = false;
+            if (reorder_result == reorder_success)
             {
                 delete_ungrounded_symbol_list(thisAgent, &unconnected_syms);
                 if (thisAgent->trace_settings[TRACE_CHUNKS_WARNINGS_SYSPARAM])
@@ -0,0 +1,156 @@
+/*
+ * ebc_scratch.h
+ *
+ *  Scratch tables used by EBC while it learns a single rule.
+ *
+ *  Every table here is cleared after each learning episode (and the identity
+ *  map after each instantiation is created), so they are built on flat,
+ *  reusable storage instead of node-based STL containers.  Entries are stamped
+ *  with the episode they were added in.  Clearing a table simply starts a new
+ *  episode, so it costs O(1) and never returns memory to the allocator.  The
+ *  backing arrays only grow, up to the largest rule the agent has learned.
+ */
+
+#ifndef CORE_SOARKERNEL_SRC_EXPLANATION_BASED_CHUNKING_EBC_SCRATCH_H_
+#define CORE_SOARKERNEL_SRC_EXPLANATION_BASED_CHUNKING_EBC_SCRATCH_H_
+
+#include "kernel.h"
+
+#include "stl_structs.h"
+
+#include <cstdint>
+#include <vector>
+
+/* Key used to find previously seen conditions when merging chunk conditions */
+typedef struct ebc_cond_key_struct
+{
+    Symbol* id;
+    Symbol* attr;
+    Symbol* value;
+
+    bool operator==(const ebc_cond_key_struct& other) const { return (id == other.id) && (attr == other.attr) && (value == other.value); }
+} ebc_cond_key;
+
+inline uint64_t ebc_scratch_mix(uint64_t x)
+{
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    return x;
+}
+
+inline uint64_t ebc_scratch_hash(uint64_t pKey)         { return ebc_scratch_mix(pKey); }
+inline uint64_t ebc_scratch_hash(const void* pKey)      { return ebc_scratch_mix(reinterpret_cast<uintptr_t>(pKey)); }
+inline uint64_t ebc_scratch_hash(const ebc_cond_key& pKey)
+{
+    return ebc_scratch_mix(reinterpret_cast<uintptr_t>(pKey.id) ^
+                           (reinterpret_cast<uintptr_t>(pKey.attr) * 31) ^
+                           (reinterpret_cast<uintptr_t>(pKey.value) * 1031));
+}
+
+/* -- EBC_Scratch_Map
+ *
+ *    An open-addressing hash map with linear probing whose clear() is O(1).
+ *    Keys and values must be trivially copyable.  Entries cannot be removed
+ *    individually, which EBC never needs.  Iteration (used only by debug
+ *    printing) visits entries in insertion order via key_at() / value_at(). -- */
+
+template <typename KeyT, typename ValueT>
+class EBC_Scratch_Map
+{
+    public:
+
+        EBC_Scratch_Map(size_t pInitialCapacity = 64) : m_epoch(1)
+        {
+            size_t lCapacity = 16;
+            while (lCapacity < pInitialCapacity) lCapacity <<= 1;
+            m_slots.resize(lCapacity);
+            m_mask = lCapacity - 1;
+        }
+
+        ValueT* find(const KeyT& pKey)
+        {
+            for (size_t i = ebc_scratch_hash(pKey) & m_mask; m_slots[i].epoch == m_epoch; i = (i + 1) & m_mask)
+            {
+                if (m_slots[i].key == pKey) return &(m_slots[i].value);
+            }
+            return NULL;
+        }
+
+        ValueT& operator[](const KeyT& pKey)
+        {
+            size_t i;
+            for (i = ebc_scratch_hash(pKey) & m_mask; m_slots[i].epoch == m_epoch; i = (i + 1) & m_mask)
+            {
+                if (m_slots[i].key == pKey) return m_slots[i].value;
+            }
+            if ((m_live.size() + 1) * 2 > m_slots.size())
+            {
+                grow();
+                for (i = ebc_scratch_hash(pKey) & m_mask; m_slots[i].epoch == m_epoch; i = (i + 1) & m_mask);
+            }
+            m_slots[i].key = pKey;
+            m_slots[i].value = ValueT();
+            m_slots[i].epoch = m_epoch;
+            m_live.push_back(static_cast<uint32_t>(i));
+            return m_slots[i].value;
+        }
+
+        void clear()
+        {
+            m_live.clear();
+            if (++m_epoch == 0)
+            {
+                /* Stamp counter wrapped, so old stamps could look current again */
+                for (size_t i = 0; i < m_slots.size(); ++i) m_slots[i].epoch = 0;
+                m_epoch = 1;
+            }
+        }
+
+        size_t          size() const            { return m_live.size(); }
+        bool            empty() const           { return m_live.empty(); }
+        const KeyT&     key_at(size_t pIndex)   { return m_slots[m_live[pIndex]].key; }
+        ValueT&         value_at(size_t pIndex) { return m_slots[m_live[pIndex]].value; }
+
+    private:
+
+        struct scratch_slot
+        {
+            KeyT        key;
+            ValueT      value;
+            uint32_t    epoch;
+            scratch_slot() : key(), value(), epoch(0) {}
+        };
+
+        std::vector<scratch_slot>   m_slots;
+        std::vector<uint32_t>       m_live;
+        size_t                      m_mask;
+        uint32_t                    m_epoch;
+
+        void grow()
+        {
+            std::vector<scratch_slot> lOldSlots;
+            lOldSlots.swap(m_slots);
+            m_slots.resize(lOldSlots.size() * 2);
+            m_mask = m_slots.size() - 1;
+
+            for (size_t j = 0; j < m_live.size(); ++j)
+            {
+                scratch_slot& lOld = lOldSlots[m_live[j]];
+                size_t i;
+                for (i = ebc_scratch_hash(lOld.key) & m_mask; m_slots[i].epoch == m_epoch; i = (i + 1) & m_mask);
+                m_slots[i] = lOld;
+                m_live[j] = static_cast<uint32_t>(i);
+            }
+        }
+};
+
+typedef EBC_Scratch_Map< Symbol*, uint64_t >            ebc_sym_to_id_map;
+typedef EBC_Scratch_Map< uint64_t, Identity* >          ebc_id_to_identity_map;
+typedef EBC_Scratch_Map< ebc_cond_key, condition* >     ebc_cond_merge_map;
+
+/* Constraints are stored by value.  Since constraint is trivially destructible,
+ * clearing the list keeps its capacity and costs nothing per element. */
+typedef std::vector< constraint >                       ebc_constraint_list;
+
+#endif /* CORE_SOARKERNEL_SRC_EXPLANATION_BASED_CHUNKING_EBC_SCRATCH_H_ */
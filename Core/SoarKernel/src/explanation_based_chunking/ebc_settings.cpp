@@ -4,6 +4,7 @@
 #include "ebc.h"
 #include "explanation_memory.h"
 #include "output_manager.h"
+#include "rete.h"
 
 #define setting_on(s) pEBC_settings[s] ? on : off
 
@@ -25,6 +26,7 @@ ebc_param_container::ebc_param_container(agent* new_agent, bool pEBC_settings[],
     pEBC_settings[SETTING_EBC_ALLOW_OPAQUE] = true;
     pEBC_settings[SETTING_EBC_ADD_LTM_LINKS] = false;
     pEBC_settings[SETTING_AUTOMATICALLY_CREATE_SINGLETONS] = true;
+    pEBC_settings[SETTING_EBC_REORDER_STATISTICS] = false;
 
     pMaxChunks = 50;
     pMaxDupes = 3;
@@ -91,6 +93,12 @@ ebc_param_container::ebc_param_container(agent* new_agent, bool pEBC_settings[],
     add(interrupt_on_watched);
     automatically_create_singletons = new soar_module::boolean_param("automatically-create-singletons", setting_on(SETTING_AUTOMATICALLY_CREATE_SINGLETONS), new soar_module::f_predicate<boolean>());
     add(automatically_create_singletons);
+    timers = new soar_module::constant_param<soar_module::timer::timer_level>("timers", soar_module::timer::zero, new soar_module::f_predicate<soar_module::timer::timer_level>());
+    timers->add_mapping(soar_module::timer::zero, "off");
+    timers->add_mapping(soar_module::timer::one, "one");
+    timers->add_mapping(soar_module::timer::two, "two");
+    timers->add_mapping(soar_module::timer::two, "on");
+    add(timers);
 
     // mechanisms
     mechanism_add_OSK = new soar_module::boolean_param("add-osk", setting_on(SETTING_EBC_ADD_OSK), new soar_module::f_predicate<boolean>());
@@ -99,6 +107,9 @@ ebc_param_container::ebc_param_container(agent* new_agent, bool pEBC_settings[],
     mechanism_add_ltm_links = new soar_module::boolean_param("add-ltm-links", setting_on(SETTING_EBC_ADD_LTM_LINKS), new soar_module::f_predicate<boolean>());
     add(mechanism_add_ltm_links);
 
+    mechanism_reorder_statistics = new soar_module::boolean_param("reorder-statistics", setting_on(SETTING_EBC_REORDER_STATISTICS), new soar_module::f_predicate<boolean>());
+    add(mechanism_reorder_statistics);
+
     allow_missing_negative_reasoning = new soar_module::boolean_param("allow-local-negations", setting_on(SETTING_EBC_ALLOW_LOCAL_NEGATIONS), new soar_module::f_predicate<boolean>());
     add(allow_missing_negative_reasoning);
     allow_opaque_knowledge = new soar_module::boolean_param("allow-opaque", setting_on(SETTING_EBC_ALLOW_OPAQUE), new soar_module::f_predicate<boolean>());
@@ -179,6 +190,11 @@ void ebc_param_container::update_ebc_settings(agent* thisAgent, soar_module::boo
     {
         thisAgent->explanationBasedChunker->ebc_settings[SETTING_EBC_ADD_LTM_LINKS] = pChangedParam->get_value();
     }
+    else if (pChangedParam == mechanism_reorder_statistics)
+    {
+        thisAgent->explanationBasedChunker->ebc_settings[SETTING_EBC_REORDER_STATISTICS] = pChangedParam->get_value();
+        set_match_statistics(thisAgent, thisAgent->explanationBasedChunker->ebc_settings[SETTING_EBC_REORDER_STATISTICS]);
+    }
     else if (pChangedParam == allow_missing_negative_reasoning)
     {
         thisAgent->explanationBasedChunker->ebc_settings[SETTING_EBC_ALLOW_LOCAL_NEGATIONS] = pChangedParam->get_value();
@@ -249,6 +265,7 @@ void ebc_param_container::update_params(bool pEBC_settings[])
 
     mechanism_add_OSK->set_value(pEBC_settings[SETTING_EBC_ADD_OSK] ? on : off);
     mechanism_add_ltm_links->set_value(pEBC_settings[SETTING_EBC_ADD_LTM_LINKS] ? on : off);
+    mechanism_reorder_statistics->set_value(pEBC_settings[SETTING_EBC_REORDER_STATISTICS] ? on : off);
     allow_missing_negative_reasoning->set_value(pEBC_settings[SETTING_EBC_ALLOW_LOCAL_NEGATIONS] ? on : off);
     automatically_create_singletons->set_value(pEBC_settings[SETTING_AUTOMATICALLY_CREATE_SINGLETONS] ? on : off);
 }
@@ -320,6 +337,7 @@ void Explanation_Based_Chunker::print_chunking_settings()
     outputManager->printa(thisAgent,    "===================================================\n");
     outputManager->printa_sf(thisAgent, "chunk ? | help %-%-%s\n", "Print all EBC settings");
     outputManager->printa_sf(thisAgent, "chunk stats %-%-%s\n", "Print statistics on learning that has occurred");
+    outputManager->printa_sf(thisAgent, "chunk timers %-%-%s\n", "Print time spent in each phase of rule learning");
     outputManager->printa_sf(thisAgent, "------------------- Settings ----------------------\n");
     outputManager->printa_sf(thisAgent, "%s | %s | %s | %s                   %-%s\n",
         ebc_params->chunk_in_states->get_value() == ebc_always  ? "ALWAYS" : "always",
@@ -341,6 +359,7 @@ void Explanation_Based_Chunker::print_chunking_settings()
     outputManager->printa_sf(thisAgent, "interrupt                  %-%s%-%s\n", capitalizeOnOff(ebc_params->interrupt_on_chunk->get_value()), "Stop Soar after learning from any rule");
     outputManager->printa_sf(thisAgent, "explain-interrupt          %-%s%-%s\n", capitalizeOnOff(ebc_params->interrupt_on_watched->get_value()), "Stop Soar after learning rule watched by explainer");
     outputManager->printa_sf(thisAgent, "warning-interrupt          %-%s%-%s\n", capitalizeOnOff(ebc_params->interrupt_on_warning->get_value()), "Stop Soar after detecting learning issue");
+    outputManager->printa_sf(thisAgent, "%s   %-%s\n", concatJustified("timers", ebc_params->timers->get_string().c_str(), 45).c_str(), "Time each phase of rule learning (off, one, on)");
     outputManager->printa_sf(thisAgent, "------------------- Fine Tune ---------------------\n");
     outputManager->printa_sf(thisAgent, "singleton %-%-%s\n", "Print all WME singletons");
     outputManager->printa_sf(thisAgent, "%s   %-%s\n", concatJustified("singleton", "<type> <attribute> <type>", 50).c_str(), "Add a WME singleton pattern");
@@ -349,6 +368,7 @@ void Explanation_Based_Chunker::print_chunking_settings()
     outputManager->printa_sf(thisAgent, "----------------- EBC Mechanisms ------------------\n");
     outputManager->printa_sf(thisAgent, "add-ltm-links              %-%s%-%s\n", capitalizeOnOff(ebc_params->mechanism_add_ltm_links->get_value()), "Recreate LTM links in original results");
     outputManager->printa_sf(thisAgent, "add-osk                    %-%s%-%s\n", capitalizeOnOff(ebc_params->mechanism_add_OSK->get_value()), "Incorporate operator selection knowledge");
+    outputManager->printa_sf(thisAgent, "reorder-statistics         %-%s%-%s\n", capitalizeOnOff(ebc_params->mechanism_reorder_statistics->get_value()), "Order conditions by observed match counts");
     outputManager->printa_sf(thisAgent, "---------- Correctness Guarantee Filters ----------%-%s\n", "Allow rules to form that...");
     outputManager->printa_sf(thisAgent, "allow-local-negations          %-%s%-%s\n", capitalizeOnOff(ebc_params->allow_missing_negative_reasoning->get_value()), "...used local negative reasoning");
     outputManager->printa_sf(thisAgent, "allow-opaque                   %-%s%-%s\n", capitalizeOnOff(ebc_params->allow_opaque_knowledge->get_value()), "...used knowledge from a LTM recall");
@@ -38,6 +38,7 @@ class ebc_param_container: public soar_module::param_container
         soar_module::boolean_param* interrupt_on_warning;
         soar_module::boolean_param* interrupt_on_watched;
         soar_module::boolean_param* automatically_create_singletons;
+        soar_module::constant_param<soar_module::timer::timer_level>* timers;
 
         /* Mechanisms */
         soar_module::boolean_param* mechanism_add_OSK;
@@ -46,6 +47,7 @@ class ebc_param_container: public soar_module::param_container
         soar_module::boolean_param* mechanism_repair_lhs;
         soar_module::boolean_param* mechanism_merge;
         soar_module::boolean_param* mechanism_user_singletons;
+        soar_module::boolean_param* mechanism_reorder_statistics;
 
         /* Correctness filters */
         soar_module::boolean_param* allow_missing_negative_reasoning;
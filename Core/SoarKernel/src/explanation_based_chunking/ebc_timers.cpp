@@ -0,0 +1,70 @@
+/*
+ * ebc_timers.cpp
+ *
+ *  Created on: Feb 14, 2017
+ *      Author: mazzin
+ */
+
+#include "ebc_timers.h"
+
+#include "agent.h"
+#include "ebc.h"
+#include "ebc_settings.h"
+
+ebc_timer_container::ebc_timer_container(agent* new_agent): soar_module::timer_container(new_agent)
+{
+    // one
+
+    ebc_total = new ebc_timer("_total", thisAgent, soar_module::timer::one);
+    add(ebc_total);
+
+    // two
+
+    instantiation_creation = new ebc_timer("instantiation_creation", thisAgent, soar_module::timer::two);
+    add(instantiation_creation);
+
+    dependency_analysis = new ebc_timer("dependency_analysis", thisAgent, soar_module::timer::two);
+    add(dependency_analysis);
+
+    identity_unification = new ebc_timer("identity_unification", thisAgent, soar_module::timer::two);
+    add(identity_unification);
+
+    identity_update = new ebc_timer("identity_update", thisAgent, soar_module::timer::two);
+    add(identity_update);
+
+    variablization_lhs = new ebc_timer("variablization_lhs", thisAgent, soar_module::timer::two);
+    add(variablization_lhs);
+
+    variablization_rhs = new ebc_timer("variablization_rhs", thisAgent, soar_module::timer::two);
+    add(variablization_rhs);
+
+    merging = new ebc_timer("merging", thisAgent, soar_module::timer::two);
+    add(merging);
+
+    repair = new ebc_timer("repair", thisAgent, soar_module::timer::two);
+    add(repair);
+
+    reorder = new ebc_timer("reorder", thisAgent, soar_module::timer::two);
+    add(reorder);
+
+    reinstantiate = new ebc_timer("reinstantiate", thisAgent, soar_module::timer::two);
+    add(reinstantiate);
+
+    chunk_instantiation_creation = new ebc_timer("chunk_instantiation_creation", thisAgent, soar_module::timer::two);
+    add(chunk_instantiation_creation);
+
+    add_to_rete = new ebc_timer("add_to_rete", thisAgent, soar_module::timer::two);
+    add(add_to_rete);
+
+    clean_up = new ebc_timer("clean_up", thisAgent, soar_module::timer::two);
+    add(clean_up);
+}
+
+ebc_timer_level_predicate::ebc_timer_level_predicate(agent* new_agent): soar_module::agent_predicate<soar_module::timer::timer_level>(new_agent) {}
+
+bool ebc_timer_level_predicate::operator()(soar_module::timer::timer_level val)
+{
+    return (thisAgent->explanationBasedChunker->ebc_params->timers->get_value() >= val);
+}
+
+ebc_timer::ebc_timer(const char* new_name, agent* new_agent, soar_module::timer::timer_level new_level): soar_module::timer(new_name, new_agent, new_level, new ebc_timer_level_predicate(new_agent)) {}
@@ -135,7 +135,7 @@ void Explanation_Based_Chunker::check_for_singleton_unification(condition* pCond
 {
     if (wme_is_a_singleton(pCond->bt.wme_))
     {
-        condition* last_cond = pCond->bt.wme_->chunker_bt_last_ground_cond;
+        condition* last_cond = peek_rare_fields(thisAgent, pCond->bt.wme_).chunker_bt_last_ground_cond;
         if (pCond->data.tests.value_test->eq_test->identity || last_cond->data.tests.value_test->eq_test->identity)
         {
             if (!pCond->data.tests.value_test->eq_test->identity)
@@ -158,7 +158,7 @@ void Explanation_Based_Chunker::check_for_singleton_unification(condition* pCond
         (pCond->bt.wme_->value->is_sti() &&  pCond->bt.wme_->value->id->isa_operator) &&
         (!pCond->test_for_acceptable_preference))
     {
-        condition* last_cond = pCond->bt.wme_->chunker_bt_last_ground_cond;
+        condition* last_cond = peek_rare_fields(thisAgent, pCond->bt.wme_).chunker_bt_last_ground_cond;
         if (pCond->data.tests.value_test->eq_test->identity || last_cond->data.tests.value_test->eq_test->identity)
         {
             Identity* pCondIDSet = get_joined_identity(pCond->data.tests.value_test->eq_test->identity);
@@ -16,6 +16,7 @@ class production_record;
 class action_record
 {
         friend class Explanation_Memory;
+        friend class instantiation_record;
 
     public:
         action_record() {};
@@ -31,6 +31,8 @@ void chunk_record::init(agent* myAgent, uint64_t pChunkID)
     excised_production          = NULL;
     time_formed                 = 0;
     match_level                 = 0;
+    lru_prev                    = NULL;
+    lru_next                    = NULL;
 
     baseInstantiation           = NULL;
     result_instantiations       = new inst_set();
@@ -75,7 +77,7 @@ void chunk_record::clean_up()
     identity_analysis.clean_up();
 }
 
-void chunk_record::record_chunk_contents(production* pProduction, condition* lhs, action* rhs, preference* results, id_to_join_map* pIdentitySetMappings, instantiation* pBaseInstantiation, tc_number pBacktraceNumber, instantiation* pChunkInstantiation, ProductionType prodType)
+void chunk_record::record_chunk_contents(production* pProduction, condition* lhs, action* rhs, preference* results, instantiation* pBaseInstantiation, tc_number pBacktraceNumber, instantiation* pChunkInstantiation, ProductionType prodType)
 {
     name = pProduction->name;
     type = (prodType == CHUNK_PRODUCTION_TYPE) ? ebc_chunk : ebc_justification;
@@ -48,7 +48,7 @@ class chunk_record
         void init(agent* myAgent, uint64_t pChunkID);
         void clean_up();
 
-        void                    record_chunk_contents(production* pProduction, condition* lhs, action* rhs, preference* results, id_to_join_map* pIdentitySetMappings, instantiation* pBaseInstantiation, tc_number pBacktraceNumber, instantiation* pChunkInstantiation, ProductionType prodType);
+        void                    record_chunk_contents(production* pProduction, condition* lhs, action* rhs, preference* results, instantiation* pBaseInstantiation, tc_number pBacktraceNumber, instantiation* pChunkInstantiation, ProductionType prodType);
         void                    generate_dependency_paths();
         void                    end_chunk_record();
         void                    excise_chunk_record();
@@ -67,6 +67,10 @@ class chunk_record
         uint64_t                time_formed;
         goal_stack_level        match_level;
 
+        /* Doubly-linked list of in-memory explanations, most recently used first */
+        chunk_record*           lru_prev;
+        chunk_record*           lru_next;
+
         instantiation_record*   chunkInstantiation;
         instantiation_record*   baseInstantiation;
         inst_set*               result_instantiations;
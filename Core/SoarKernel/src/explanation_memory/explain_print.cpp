@@ -23,6 +23,10 @@
 void Explanation_Memory::switch_to_explanation_trace(bool pEnableExplanationTrace)
 {
     print_explanation_trace = pEnableExplanationTrace;
+    if (current_archived_chunk && pEnableExplanationTrace)
+    {
+        outputManager->printa_sf(thisAgent, "The explanation log only keeps the working memory trace of %s.\n\n", current_archived_chunk->name.c_str());
+    }
     if (!last_printed_id)
     {
         print_chunk_explanation();
@@ -33,6 +37,11 @@ void Explanation_Memory::switch_to_explanation_trace(bool pEnableExplanationTrac
 
 void Explanation_Memory::print_formation_explanation()
 {
+    if (current_archived_chunk)
+    {
+        print_archived_formation_explanation();
+        return;
+    }
     assert(current_discussed_chunk);
     outputManager->printa_sf(thisAgent, "------------------------------------------------------------------------------------\n");
     outputManager->printa_sf(thisAgent, "The formation of chunk '%y' (c %u) \n", current_discussed_chunk->name, current_discussed_chunk->chunkID);
@@ -65,6 +74,113 @@ void Explanation_Memory::print_formation_explanation()
     print_footer(true);
 }
 
+void Explanation_Memory::print_archived_formation_explanation()
+{
+    const archived_chunk* lChunk = current_archived_chunk;
+    const archived_instantiation* lInst;
+
+    outputManager->printa_sf(thisAgent, "------------------------------------------------------------------------------------\n");
+    outputManager->printa_sf(thisAgent, "The formation of chunk '%s' (c %u) \n", lChunk->name.c_str(), lChunk->chunkID);
+    outputManager->printa_sf(thisAgent, "------------------------------------------------------------------------------------\n\n");
+
+    if (lChunk->result_instantiationIDs.size() > 0)
+    {
+        outputManager->printa_sf(thisAgent, "The following %d instantiations fired to produce results...\n\n------\n\n",
+        static_cast<int64_t>(lChunk->result_instantiationIDs.size() + 1));
+    }
+
+    lInst = lChunk->find_instantiation(lChunk->baseInstantiationID);
+    if (lInst)
+    {
+        outputManager->printa_sf(thisAgent, "Initial base instantiation (i %u) that fired when %s matched at level %d at time %u:\n\n",
+            lInst->instantiationID, lInst->production_name.c_str(), lInst->match_level, lChunk->time_formed);
+        print_archived_instantiation(*lInst);
+    }
+
+    if (lChunk->result_instantiationIDs.size() > 0)
+    {
+        outputManager->printa_sf(thisAgent, "\n%d instantiation(s) that created extra results indirectly because they were connected to the results of the base instantiation:\n\n", static_cast<int64_t>((lChunk->result_instantiationIDs.size() - 1)));
+        for (auto it = lChunk->result_instantiationIDs.begin(); it != lChunk->result_instantiationIDs.end(); ++it)
+        {
+            lInst = lChunk->find_instantiation(*it);
+            if (lInst) print_archived_instantiation(*lInst);
+        }
+    }
+    outputManager->printa(thisAgent, "\n");
+
+    outputManager->printa_sf(thisAgent, "This chunk summarizes the problem-solving involved in the following %d rule firings:\n\n", static_cast<int64_t>(lChunk->instantiations.size()));
+    for (auto it = lChunk->instantiations.begin(); it != lChunk->instantiations.end(); ++it)
+    {
+        outputManager->printa_sf(thisAgent, "   i %u (%s)\n", it->instantiationID, it->production_name.c_str());
+    }
+    outputManager->printa(thisAgent, "\n");
+    print_footer(true);
+}
+
+/* Same layout as instantiation_record::print_for_wme_trace */
+void Explanation_Memory::print_archived_instantiation(const archived_instantiation& pInst)
+{
+    if (pInst.conditions.empty())
+    {
+        outputManager->printa(thisAgent, "No conditions on left-hand-side\n");
+        return;
+    }
+
+    bool lInNegativeConditions = false;
+    int lConditionCount = 0;
+
+    outputManager->set_column_indent(0, 7);
+    outputManager->set_column_indent(1, 57);
+    outputManager->set_column_indent(2, 72);
+    outputManager->printa_sf(thisAgent, "Working memory trace of instantiation # %u %-(match of rule %s at level %d)\n",
+        pInst.instantiationID, pInst.production_name.c_str(), pInst.match_level);
+    outputManager->printa_sf(thisAgent, "%- %-Operational %-Creator\n\n");
+
+    for (auto it = pInst.conditions.begin(); it != pInst.conditions.end(); ++it)
+    {
+        ++lConditionCount;
+        if (lInNegativeConditions)
+        {
+            if (it->type != CONJUNCTIVE_NEGATION_CONDITION)
+            {
+                outputManager->printa(thisAgent, "     }\n");
+                lInNegativeConditions = false;
+            }
+        } else {
+            if (it->type == CONJUNCTIVE_NEGATION_CONDITION)
+            {
+                outputManager->printa(thisAgent, "     -{\n");
+                lInNegativeConditions = true;
+            }
+        }
+        outputManager->printa_sf(thisAgent, "%d:%-%s%-%s", static_cast<int64_t>(lConditionCount), it->text.c_str(), (it->operational ? "    Yes" : "    No"));
+        if (it->creatorID)
+        {
+            outputManager->printa_sf(thisAgent, "%-i %u (%s)%-", it->creatorID, it->creator_name.c_str());
+        } else if (it->type == POSITIVE_CONDITION)
+        {
+            outputManager->printa_sf(thisAgent, it->operational ? "%-Higher-level Problem Space%-" : "%-Soar Architecture%-");
+        } else {
+            outputManager->printa_sf(thisAgent, "%-N/A%-");
+        }
+        outputManager->printa(thisAgent, "\n");
+    }
+    if (lInNegativeConditions)
+    {
+        outputManager->printa(thisAgent, "     }\n");
+    }
+    outputManager->printa(thisAgent, "   -->\n");
+    if (pInst.actions.empty())
+    {
+        outputManager->printa(thisAgent, "No actions on right-hand-side\n");
+    }
+    int lActionCount = 0;
+    for (auto it = pInst.actions.begin(); it != pInst.actions.end(); ++it)
+    {
+        outputManager->printa_sf(thisAgent, "%d:%-%s\n", static_cast<int64_t>(++lActionCount), it->c_str());
+    }
+}
+
 void Explanation_Memory::print_footer(bool pPrintDiscussedChunkCommands)
 {
     outputManager->printa(thisAgent, "---------------------------------------------------------------------------------------------------------------------\n");
@@ -249,6 +365,11 @@ void Explanation_Memory::print_instantiation_explanation(instantiation_record* p
 
 void Explanation_Memory::print_chunk_explanation()
 {
+    if (current_archived_chunk)
+    {
+        print_archived_instantiation(current_archived_chunk->chunkInstantiation);
+        return;
+    }
     assert(current_discussed_chunk);
 
     if (print_explanation_trace)
@@ -271,6 +392,11 @@ void Explanation_Memory::print_explain_summary()
     outputManager->printa_sf(thisAgent,   "Watch all chunk formations        %-%s\n", (m_all_enabled ? "Yes" : "No"));
     outputManager->printa_sf(thisAgent,   "Explain justifications            %-%s\n", (m_justifications_enabled ? "Yes" : "No"));
     outputManager->printa_sf(thisAgent,   "Number of specific rules watched  %-%d\n", static_cast<int64_t>(num_rules_watched));
+    if (settings->record_limit->get_value() || explanation_log->is_open())
+    {
+        outputManager->printa_sf(thisAgent,   "Explanations kept in memory       %-%u of %d\n", static_cast<uint64_t>(chunks->size()), settings->record_limit->get_value());
+        outputManager->printa_sf(thisAgent,   "Explanations in explanation log   %-%u\n", static_cast<uint64_t>(explanation_log->get_index().size()));
+    }
 
     /* Print specific watched rules and time interval when watch all disabled */
     if (!m_all_enabled)
@@ -285,6 +411,9 @@ void Explanation_Memory::print_explain_summary()
     if (current_discussed_chunk)
     {
         outputManager->printa_sf(thisAgent, "Current rule being explained: %-%s (c %u)\n\n", current_discussed_chunk->name->sc->name, current_discussed_chunk->chunkID);
+    } else if (current_archived_chunk)
+    {
+        outputManager->printa_sf(thisAgent, "Current rule being explained: %-%s (c %u, archived)\n\n", current_archived_chunk->name.c_str(), current_archived_chunk->chunkID);
     } else {
         outputManager->printa(thisAgent, "No rule is currently being explained.\n");
     }
@@ -328,6 +457,7 @@ void Explanation_Memory::print_EBC_stats()
     outputManager->printa_sf(thisAgent, "Sub-states analyzed                                    %-%u\n", stats.chunks_attempted);
     outputManager->printa_sf(thisAgent, "Number of rules fired in substates analyzed            %-%u\n", thisAgent->explanationBasedChunker->get_instantiation_count());
     outputManager->printa_sf(thisAgent, "Number of rule firings analyzed during backtracing     %-%u\n", stats.instantations_backtraced);
+    outputManager->printa_sf(thisAgent, "Memory allocated while forming learned rules (bytes)   %-%u\n", stats.rule_memory);
     outputManager->printa_sf(thisAgent, "\nConditions merged                                    %- %u\n", stats.merged_conditions);
     outputManager->printa_sf(thisAgent, "Disjunction tests merged                               %-%u\n", stats.merged_disjunctions);
     outputManager->printa_sf(thisAgent, "Operational constraints                                %-%u\n", stats.operational_constraints);
@@ -363,6 +493,36 @@ void Explanation_Memory::print_EBC_stats()
 
 void Explanation_Memory::print_chunk_stats(chunk_record* pChunkRecord, bool pPrintHeader) {
 
+    if (!pChunkRecord && current_archived_chunk)
+    {
+        const archived_chunk* lChunk = current_archived_chunk;
+        const archived_instantiation* lInst;
+
+        outputManager->set_column_indent(0, 72);
+        if (pPrintHeader)
+        {
+        outputManager->printa_sf(thisAgent, "\nStatistics for learned rule %s (c %u):\n\n",   lChunk->name.c_str(), lChunk->chunkID);
+        }
+        outputManager->printa_sf(thisAgent, "Number of conditions:           %-%u\n",          static_cast<uint64_t>(lChunk->chunkInstantiation.conditions.size()));
+        outputManager->printa_sf(thisAgent, "- Operational constraints:              %-%u\n", lChunk->stats.operational_constraints);
+        outputManager->printa_sf(thisAgent, "- Non-operational constraints detected: %-%u\n", lChunk->stats.constraints_collected);
+        outputManager->printa_sf(thisAgent, "- Non-operational constraints enforced: %-%u\n\n", lChunk->stats.constraints_attached);
+        outputManager->printa_sf(thisAgent, "Number of actions:              %-%u\n",          static_cast<uint64_t>(lChunk->chunkInstantiation.actions.size()));
+        lInst = lChunk->find_instantiation(lChunk->baseInstantiationID);
+        outputManager->printa_sf(thisAgent, "Base instantiation:             %-i %u (%s)\n",    lChunk->baseInstantiationID, (lInst ? lInst->production_name.c_str() : "?"));
+        if (lChunk->result_instantiationIDs.size() > 0)
+        {
+            outputManager->printa_sf(thisAgent, "Number of child result instantiations:  %-%u\n",          static_cast<uint64_t>(lChunk->result_instantiationIDs.size()));
+            outputManager->printa_sf(thisAgent, "Child result instantiations: " );
+            for (auto it = lChunk->result_instantiationIDs.begin(); it != lChunk->result_instantiationIDs.end(); ++it)
+            {
+                lInst = lChunk->find_instantiation(*it);
+                outputManager->printa_sf(thisAgent, "%-i %u (%s)\n", (*it), (lInst ? lInst->production_name.c_str() : "?"));
+            }
+        }
+        print_chunk_stats_details(lChunk->stats);
+        return;
+    }
     assert(pChunkRecord);
     outputManager->set_column_indent(0, 72);
     if (pPrintHeader)
@@ -384,27 +544,32 @@ void Explanation_Memory::print_chunk_stats(chunk_record* pChunkRecord, bool pPri
             outputManager->printa_sf(thisAgent, "%-i %u (%y)\n", (*it)->instantiationID, (*it)->production_name);
         }
     }
+    print_chunk_stats_details(pChunkRecord->stats);
+}
+
+void Explanation_Memory::print_chunk_stats_details(const chunk_stats& pStats)
+{
     outputManager->printa_sf(thisAgent, "\n---------------------------------------------------------------------------\n");
     outputManager->printa_sf(thisAgent, "                            Work Performed\n");
     outputManager->printa_sf(thisAgent, "---------------------------------------------------------------------------\n");
-    outputManager->printa_sf(thisAgent, "Number of rule firings analyzed during backtracing:     %-%u\n", pChunkRecord->stats.instantations_backtraced);
-    outputManager->printa_sf(thisAgent, "Duplicates chunks later created:                        %-%u\n", pChunkRecord->stats.duplicates);
-    outputManager->printa_sf(thisAgent, "\nConditions merged:                                    %- %u\n", pChunkRecord->stats.merged_conditions);
-    outputManager->printa_sf(thisAgent, "Disjunction tests merged:                               %-%u\n", pChunkRecord->stats.merged_disjunctions);
+    outputManager->printa_sf(thisAgent, "Number of rule firings analyzed during backtracing:     %-%u\n", pStats.instantations_backtraced);
+    outputManager->printa_sf(thisAgent, "Duplicates chunks later created:                        %-%u\n", pStats.duplicates);
+    outputManager->printa_sf(thisAgent, "\nConditions merged:                                    %- %u\n", pStats.merged_conditions);
+    outputManager->printa_sf(thisAgent, "Disjunction tests merged:                               %-%u\n", pStats.merged_disjunctions);
     outputManager->printa_sf(thisAgent, "\n---------------------------------------------------------------------------\n");
     outputManager->printa_sf(thisAgent, "                           Identity Analysis\n");
     outputManager->printa_sf(thisAgent, "---------------------------------------------------------------------------\n");
-    outputManager->printa_sf(thisAgent, "Identities created in rule's sub-state:                             %-%u\n", pChunkRecord->stats.identities_created);
-    outputManager->printa_sf(thisAgent, "Distinct identities in learned rules:                               %-%u\n", pChunkRecord->stats.identities_participated);
-    outputManager->printa_sf(thisAgent, "Identities joined:                                                  %-%u\n", pChunkRecord->stats.identities_joined);
-    outputManager->printa_sf(thisAgent, "Identities literalized:                                             %-%u\n", pChunkRecord->stats.identities_literalized);
+    outputManager->printa_sf(thisAgent, "Identities created in rule's sub-state:                             %-%u\n", pStats.identities_created);
+    outputManager->printa_sf(thisAgent, "Distinct identities in learned rules:                               %-%u\n", pStats.identities_participated);
+    outputManager->printa_sf(thisAgent, "Identities joined:                                                  %-%u\n", pStats.identities_joined);
+    outputManager->printa_sf(thisAgent, "Identities literalized:                                             %-%u\n", pStats.identities_literalized);
     outputManager->printa_sf(thisAgent, "\n---------------------------------------------------------------------------\n");
     outputManager->printa_sf(thisAgent, "                    Problem-Solving Characteristics\n");
     outputManager->printa_sf(thisAgent, "---------------------------------------------------------------------------\n");
-    outputManager->printa_sf(thisAgent, "Used negated reasoning about sub-state:              %-%s\n", (pChunkRecord->stats.tested_local_negation ? "Yes" : "No"));
-    outputManager->printa_sf(thisAgent, "Tested ^quiescence true:                             %-%s\n", (pChunkRecord->stats.tested_quiescence ? "Yes" : "No"));
-    outputManager->printa_sf(thisAgent, "Tested knowledge retrieved from long-term memory:    %-%s\n", (pChunkRecord->stats.tested_ltm_recall ? "Yes" : "No"));
-    outputManager->printa_sf(thisAgent, "Added conditions to repair unconnected conditions or actions:    %-%s\n", (pChunkRecord->stats.repaired ? "Yes" : "No"));
+    outputManager->printa_sf(thisAgent, "Used negated reasoning about sub-state:              %-%s\n", (pStats.tested_local_negation ? "Yes" : "No"));
+    outputManager->printa_sf(thisAgent, "Tested ^quiescence true:                             %-%s\n", (pStats.tested_quiescence ? "Yes" : "No"));
+    outputManager->printa_sf(thisAgent, "Tested knowledge retrieved from long-term memory:    %-%s\n", (pStats.tested_ltm_recall ? "Yes" : "No"));
+    outputManager->printa_sf(thisAgent, "Added conditions to repair unconnected conditions or actions:    %-%s\n", (pStats.repaired ? "Yes" : "No"));
 }
 
 void Explanation_Memory::list_explained_rules(short pNumToPrint, bool pChunks, bool pNewLine)
@@ -436,15 +601,29 @@ void Explanation_Memory::list_explained_rules(short pNumToPrint, bool pChunks, b
         outputManager->printa_sf(thisAgent, "%-%y (c %u)\n", it->first, it->second->chunkID);
         if (pNumToPrint && (++lNumPrinted == pNumToPrint)) break;
     }
+    const explain_log_index& lArchived = explanation_log->get_index();
+    for (auto it = lArchived.begin(); it != lArchived.end(); ++it)
+    {
+        if (pNumToPrint && (lNumPrinted == pNumToPrint)) break;
+        if (it->second.type != lRuleType) continue;
+        if (!lHeaderPrinted)
+        {
+            outputManager->printa_sf (thisAgent, pChunks ? "Chunks available for explanation:%s" : "Justifications available for explanation:%s", pNewLine ? "\n" : " ");
+            lHeaderPrinted = true;
+        }
+        outputManager->printa_sf(thisAgent, "%-%s (c %u, archived)\n", it->second.name.c_str(), it->first);
+        ++lNumPrinted;
+    }
     if (!lHeaderPrinted)
     {
         outputManager->printa_sf (thisAgent, "No %s have been recorded.", lRuleTypeString.c_str());
     }
     else
     {
-        if (pNumToPrint && (lNumPrinted < chunks->size()))
+        size_t lNumRecorded = chunks->size() + lArchived.size();
+        if (pNumToPrint && (lNumPrinted < lNumRecorded))
         {
-            outputManager->printa_sf(thisAgent, "\n* Note:  Only listed the first %d %s recorded.  Type 'explain list-%s' to see the other %d %s.\n", static_cast<int64_t>(pNumToPrint), lRuleTypeString.c_str(), lRuleTypeString.c_str(), static_cast<int64_t>(chunks->size() - lNumPrinted), lRuleTypeString.c_str());
+            outputManager->printa_sf(thisAgent, "\n* Note:  Only listed the first %d %s recorded.  Type 'explain list-%s' to see the other %d %s.\n", static_cast<int64_t>(pNumToPrint), lRuleTypeString.c_str(), lRuleTypeString.c_str(), static_cast<int64_t>(lNumRecorded - lNumPrinted), lRuleTypeString.c_str());
         }
     }
 }
@@ -507,6 +686,11 @@ void Explanation_Memory::print_rules_watched(short pNumToPrint)
 
 void Explanation_Memory::print_identity_set_explanation()
 {
+    if (current_archived_chunk)
+    {
+        outputManager->printa_sf(thisAgent, "\nThe explanation log does not keep the identity analysis of rule %s (c %u).\n", current_archived_chunk->name.c_str(), current_archived_chunk->chunkID);
+        return;
+    }
     assert(current_discussed_chunk);
     outputManager->printa_sf(thisAgent, "\nIdentity analysis of problem-solving behind rule %y (c %u):\n\n",   current_discussed_chunk->name, current_discussed_chunk->chunkID);
 
@@ -516,6 +700,11 @@ void Explanation_Memory::print_identity_set_explanation()
 
 void Explanation_Memory::print_constraints_enforced()
 {
+    if (current_archived_chunk)
+    {
+        outputManager->printa_sf(thisAgent, "\nThe explanation log does not keep the constraint analysis of rule %s (c %u).\n", current_archived_chunk->name.c_str(), current_archived_chunk->chunkID);
+        return;
+    }
     assert(current_discussed_chunk);
     outputManager->printa_sf(thisAgent, "\nConstraint analysis of problem-solving behind rule %y (c %u):\n\n",   current_discussed_chunk->name, current_discussed_chunk->chunkID);
 }
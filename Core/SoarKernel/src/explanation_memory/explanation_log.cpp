@@ -0,0 +1,316 @@
+#include "explanation_log.h"
+
+#define EXPLAIN_LOG_MAGIC       "SOAREXPL"
+#define EXPLAIN_LOG_MAGIC_SIZE  8
+#define EXPLAIN_LOG_VERSION     2
+
+/* ----------------------------------------------------------------------
+ *  Little-endian encoding helpers.  Records are built in a buffer and
+ *  written with a single fwrite, so a record is never half-written
+ *  unless the write itself fails.
+ * ---------------------------------------------------------------------- */
+
+static void put_u8(std::string& pBuffer, uint8_t pValue)
+{
+    pBuffer.push_back(static_cast<char>(pValue));
+}
+
+static void put_u32(std::string& pBuffer, uint32_t pValue)
+{
+    for (int i = 0; i < 4; ++i) pBuffer.push_back(static_cast<char>((pValue >> (8 * i)) & 0xFF));
+}
+
+static void put_u64(std::string& pBuffer, uint64_t pValue)
+{
+    for (int i = 0; i < 8; ++i) pBuffer.push_back(static_cast<char>((pValue >> (8 * i)) & 0xFF));
+}
+
+static void put_string(std::string& pBuffer, const std::string& pString)
+{
+    put_u32(pBuffer, static_cast<uint32_t>(pString.size()));
+    pBuffer.append(pString);
+}
+
+static bool get_u8(const std::string& pBuffer, size_t& pPos, uint8_t& pValue)
+{
+    if (pPos + 1 > pBuffer.size()) return false;
+    pValue = static_cast<uint8_t>(pBuffer[pPos++]);
+    return true;
+}
+
+static bool get_u32(const std::string& pBuffer, size_t& pPos, uint32_t& pValue)
+{
+    if (pPos + 4 > pBuffer.size()) return false;
+    pValue = 0;
+    for (int i = 0; i < 4; ++i) pValue |= static_cast<uint32_t>(static_cast<uint8_t>(pBuffer[pPos++])) << (8 * i);
+    return true;
+}
+
+static bool get_u64(const std::string& pBuffer, size_t& pPos, uint64_t& pValue)
+{
+    if (pPos + 8 > pBuffer.size()) return false;
+    pValue = 0;
+    for (int i = 0; i < 8; ++i) pValue |= static_cast<uint64_t>(static_cast<uint8_t>(pBuffer[pPos++])) << (8 * i);
+    return true;
+}
+
+static bool get_string(const std::string& pBuffer, size_t& pPos, std::string& pString)
+{
+    uint32_t lLength;
+    if (!get_u32(pBuffer, pPos, lLength) || (pPos + lLength > pBuffer.size())) return false;
+    pString.assign(pBuffer, pPos, lLength);
+    pPos += lLength;
+    return true;
+}
+
+static void put_instantiation(std::string& pBuffer, const archived_instantiation& pInst)
+{
+    put_u64(pBuffer, pInst.instantiationID);
+    put_string(pBuffer, pInst.production_name);
+    put_u64(pBuffer, static_cast<uint64_t>(pInst.match_level));
+    put_u32(pBuffer, static_cast<uint32_t>(pInst.conditions.size()));
+    for (auto it = pInst.conditions.begin(); it != pInst.conditions.end(); ++it)
+    {
+        put_u8(pBuffer, static_cast<uint8_t>(it->type));
+        put_u8(pBuffer, it->operational ? 1 : 0);
+        put_string(pBuffer, it->text);
+        put_u64(pBuffer, it->creatorID);
+        put_string(pBuffer, it->creator_name);
+    }
+    put_u32(pBuffer, static_cast<uint32_t>(pInst.actions.size()));
+    for (auto it = pInst.actions.begin(); it != pInst.actions.end(); ++it)
+    {
+        put_string(pBuffer, *it);
+    }
+}
+
+static bool get_instantiation(const std::string& pBuffer, size_t& pPos, archived_instantiation& pInst)
+{
+    uint64_t lMatchLevel;
+    uint32_t lCount;
+    uint8_t lType, lOperational;
+
+    if (!get_u64(pBuffer, pPos, pInst.instantiationID) ||
+        !get_string(pBuffer, pPos, pInst.production_name) ||
+        !get_u64(pBuffer, pPos, lMatchLevel) ||
+        !get_u32(pBuffer, pPos, lCount))
+    {
+        return false;
+    }
+    pInst.match_level = static_cast<int64_t>(lMatchLevel);
+    pInst.conditions.resize(lCount);
+    for (auto it = pInst.conditions.begin(); it != pInst.conditions.end(); ++it)
+    {
+        if (!get_u8(pBuffer, pPos, lType) ||
+            !get_u8(pBuffer, pPos, lOperational) ||
+            !get_string(pBuffer, pPos, it->text) ||
+            !get_u64(pBuffer, pPos, it->creatorID) ||
+            !get_string(pBuffer, pPos, it->creator_name))
+        {
+            return false;
+        }
+        it->type = static_cast<ConditionType>(lType);
+        it->operational = (lOperational != 0);
+    }
+    if (!get_u32(pBuffer, pPos, lCount)) return false;
+    pInst.actions.resize(lCount);
+    for (auto it = pInst.actions.begin(); it != pInst.actions.end(); ++it)
+    {
+        if (!get_string(pBuffer, pPos, *it)) return false;
+    }
+    return true;
+}
+
+const archived_instantiation* archived_chunk::find_instantiation(uint64_t pInstID) const
+{
+    if (chunkInstantiation.instantiationID == pInstID) return &chunkInstantiation;
+    for (auto it = instantiations.begin(); it != instantiations.end(); ++it)
+    {
+        if (it->instantiationID == pInstID) return &(*it);
+    }
+    return NULL;
+}
+
+Explanation_Log::Explanation_Log()
+{
+    m_file = NULL;
+    m_end = 0;
+}
+
+Explanation_Log::~Explanation_Log()
+{
+    close();
+}
+
+/* An empty path logs to an anonymous temporary file that is removed when
+ * the log is closed.  A named log must be a new file, so an existing file is
+ * never overwritten.  The only exception is a log this object created itself,
+ * which is re-created when explanations are cleared. */
+bool Explanation_Log::open(const char* pPath)
+{
+    std::string lPath(pPath ? pPath : "");
+    bool lCreatedByUs = (!lPath.empty() && (lPath == m_path));
+
+    close();
+
+    if (!lPath.empty() && !lCreatedByUs)
+    {
+        FILE* lExisting = fopen(lPath.c_str(), "rb");
+        if (lExisting)
+        {
+            fclose(lExisting);
+            return false;
+        }
+    }
+    m_file = lPath.empty() ? tmpfile() : fopen(lPath.c_str(), "w+b");
+    if (!m_file) return false;
+    m_path = lPath;
+
+    std::string lHeader(EXPLAIN_LOG_MAGIC, EXPLAIN_LOG_MAGIC_SIZE);
+    put_u32(lHeader, EXPLAIN_LOG_VERSION);
+    if (fwrite(lHeader.data(), 1, lHeader.size(), m_file) != lHeader.size())
+    {
+        close();
+        return false;
+    }
+    m_end = lHeader.size();
+    return true;
+}
+
+void Explanation_Log::close()
+{
+    if (m_file)
+    {
+        fclose(m_file);
+        m_file = NULL;
+    }
+    m_end = 0;
+    m_index.clear();
+    m_name_index.clear();
+}
+
+bool Explanation_Log::append(const archived_chunk& pChunk)
+{
+    if (!m_file) return false;
+
+    std::string lPayload;
+    put_u64(lPayload, pChunk.chunkID);
+    put_u8(lPayload, static_cast<uint8_t>(pChunk.type));
+    put_u64(lPayload, pChunk.time_formed);
+    put_string(lPayload, pChunk.name);
+    put_u64(lPayload, pChunk.stats.instantations_backtraced);
+    put_u64(lPayload, pChunk.stats.duplicates);
+    put_u64(lPayload, pChunk.stats.merged_conditions);
+    put_u64(lPayload, pChunk.stats.merged_disjunctions);
+    put_u64(lPayload, pChunk.stats.operational_constraints);
+    put_u64(lPayload, pChunk.stats.constraints_attached);
+    put_u64(lPayload, pChunk.stats.constraints_collected);
+    put_u64(lPayload, pChunk.stats.identities_created);
+    put_u64(lPayload, pChunk.stats.identities_participated);
+    put_u64(lPayload, pChunk.stats.identities_joined);
+    put_u64(lPayload, pChunk.stats.identities_literalized);
+    put_u8(lPayload, (pChunk.stats.tested_local_negation ? 1 : 0) | (pChunk.stats.tested_quiescence ? 2 : 0) |
+                     (pChunk.stats.tested_ltm_recall ? 4 : 0) | (pChunk.stats.repaired ? 8 : 0));
+    put_u64(lPayload, pChunk.baseInstantiationID);
+    put_u32(lPayload, static_cast<uint32_t>(pChunk.result_instantiationIDs.size()));
+    for (auto it = pChunk.result_instantiationIDs.begin(); it != pChunk.result_instantiationIDs.end(); ++it)
+    {
+        put_u64(lPayload, *it);
+    }
+    put_instantiation(lPayload, pChunk.chunkInstantiation);
+    put_u32(lPayload, static_cast<uint32_t>(pChunk.instantiations.size()));
+    for (auto it = pChunk.instantiations.begin(); it != pChunk.instantiations.end(); ++it)
+    {
+        put_instantiation(lPayload, *it);
+    }
+
+    std::string lRecord;
+    put_u32(lRecord, static_cast<uint32_t>(lPayload.size()));
+    lRecord.append(lPayload);
+
+    if ((fseek(m_file, static_cast<long>(m_end), SEEK_SET) != 0) ||
+        (fwrite(lRecord.data(), 1, lRecord.size(), m_file) != lRecord.size()))
+    {
+        return false;
+    }
+    fflush(m_file);
+
+    explain_log_entry& lEntry = m_index[pChunk.chunkID];
+    lEntry.chunkID = pChunk.chunkID;
+    lEntry.type = pChunk.type;
+    lEntry.offset = m_end;
+    lEntry.length = static_cast<uint32_t>(lRecord.size());
+    lEntry.name = pChunk.name;
+    m_name_index[pChunk.name] = pChunk.chunkID;
+
+    m_end += lRecord.size();
+    return true;
+}
+
+bool Explanation_Log::read(uint64_t pChunkID, archived_chunk& pChunk)
+{
+    const explain_log_entry* lEntry = find(pChunkID);
+    if (!m_file || !lEntry) return false;
+
+    std::string lRecord(lEntry->length, '\0');
+    if ((fseek(m_file, static_cast<long>(lEntry->offset), SEEK_SET) != 0) ||
+        (fread(&lRecord[0], 1, lEntry->length, m_file) != lEntry->length))
+    {
+        return false;
+    }
+
+    size_t lPos = 0;
+    uint32_t lPayloadLength, lCount;
+    uint8_t lType, lFlags;
+    if (!get_u32(lRecord, lPos, lPayloadLength) || (lPayloadLength + 4 != lRecord.size())) return false;
+    if (!get_u64(lRecord, lPos, pChunk.chunkID) ||
+        !get_u8(lRecord, lPos, lType) ||
+        !get_u64(lRecord, lPos, pChunk.time_formed) ||
+        !get_string(lRecord, lPos, pChunk.name) ||
+        !get_u64(lRecord, lPos, pChunk.stats.instantations_backtraced) ||
+        !get_u64(lRecord, lPos, pChunk.stats.duplicates) ||
+        !get_u64(lRecord, lPos, pChunk.stats.merged_conditions) ||
+        !get_u64(lRecord, lPos, pChunk.stats.merged_disjunctions) ||
+        !get_u64(lRecord, lPos, pChunk.stats.operational_constraints) ||
+        !get_u64(lRecord, lPos, pChunk.stats.constraints_attached) ||
+        !get_u64(lRecord, lPos, pChunk.stats.constraints_collected) ||
+        !get_u64(lRecord, lPos, pChunk.stats.identities_created) ||
+        !get_u64(lRecord, lPos, pChunk.stats.identities_participated) ||
+        !get_u64(lRecord, lPos, pChunk.stats.identities_joined) ||
+        !get_u64(lRecord, lPos, pChunk.stats.identities_literalized) ||
+        !get_u8(lRecord, lPos, lFlags) ||
+        !get_u64(lRecord, lPos, pChunk.baseInstantiationID) ||
+        !get_u32(lRecord, lPos, lCount))
+    {
+        return false;
+    }
+    pChunk.type = static_cast<ebc_rule_type>(lType);
+    pChunk.stats.tested_local_negation = ((lFlags & 1) != 0);
+    pChunk.stats.tested_quiescence = ((lFlags & 2) != 0);
+    pChunk.stats.tested_ltm_recall = ((lFlags & 4) != 0);
+    pChunk.stats.repaired = ((lFlags & 8) != 0);
+    pChunk.result_instantiationIDs.resize(lCount);
+    for (auto it = pChunk.result_instantiationIDs.begin(); it != pChunk.result_instantiationIDs.end(); ++it)
+    {
+        if (!get_u64(lRecord, lPos, *it)) return false;
+    }
+    if (!get_instantiation(lRecord, lPos, pChunk.chunkInstantiation) || !get_u32(lRecord, lPos, lCount)) return false;
+    pChunk.instantiations.resize(lCount);
+    for (auto it = pChunk.instantiations.begin(); it != pChunk.instantiations.end(); ++it)
+    {
+        if (!get_instantiation(lRecord, lPos, *it)) return false;
+    }
+    return true;
+}
+
+const explain_log_entry* Explanation_Log::find(uint64_t pChunkID)
+{
+    explain_log_index::iterator lIter = m_index.find(pChunkID);
+    return (lIter != m_index.end()) ? &(lIter->second) : NULL;
+}
+
+const explain_log_entry* Explanation_Log::find(const std::string& pName)
+{
+    std::unordered_map< std::string, uint64_t >::iterator lIter = m_name_index.find(pName);
+    return (lIter != m_name_index.end()) ? find(lIter->second) : NULL;
+}
@@ -0,0 +1,119 @@
+/*
+ * explanation_log.h
+ *
+ *  Append-only binary log of chunk explanations that were evicted from
+ *  explanation memory when a record limit is set.
+ *
+ *  Each record is built straight from the chunk's explanation records when
+ *  it is evicted:  the chunk's id, name, type, formation time and statistics,
+ *  plus the working memory trace of the chunk instantiation and of every
+ *  instantiation that was backtraced through.  Identity and constraint
+ *  analysis refer to live identity sets and are not kept.  Only a small
+ *  index (chunk id and name -> file offset) is kept in memory.  A record is
+ *  read back from disk whenever the explain command asks for it.
+ *
+ *  File layout (all integers little-endian, strings are u32 length + bytes):
+ *
+ *      header:         "SOAREXPL" u32 version
+ *      record:         u32 payload_length, then the payload:
+ *                      u64 chunk_id, u8 rule_type, u64 time_formed, string name,
+ *                      11 x u64 chunk statistics, u8 statistic flags,
+ *                      u64 base_instantiation_id,
+ *                      u32 count, count x u64 result_instantiation_id,
+ *                      instantiation (the chunk instantiation),
+ *                      u32 count, count x instantiation
+ *      instantiation:  u64 id, string rule_name, u64 match_level,
+ *                      u32 count, count x condition,
+ *                      u32 count, count x string action
+ *      condition:      u8 condition_type, u8 operational, string condition,
+ *                      u64 creator_id, string creator_rule_name
+ */
+
+#ifndef CORE_SOARKERNEL_SRC_EXPLANATION_MEMORY_EXPLANATION_LOG_H_
+#define CORE_SOARKERNEL_SRC_EXPLANATION_MEMORY_EXPLANATION_LOG_H_
+
+#include "kernel.h"
+
+#include "chunk_record.h"
+
+#include <cstdio>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+typedef struct explain_log_entry_struct
+{
+    uint64_t        chunkID;
+    ebc_rule_type   type;
+    uint64_t        offset;
+    uint32_t        length;
+    std::string     name;
+} explain_log_entry;
+
+typedef struct archived_condition_struct
+{
+    ConditionType   type;
+    bool            operational;
+    std::string     text;
+    uint64_t        creatorID;          /* 0 if no instantiation created the wme */
+    std::string     creator_name;
+} archived_condition;
+
+typedef struct archived_instantiation_struct
+{
+    uint64_t                            instantiationID;
+    std::string                         production_name;
+    int64_t                             match_level;
+    std::vector< archived_condition >   conditions;
+    std::vector< std::string >          actions;
+} archived_instantiation;
+
+typedef struct archived_chunk_struct
+{
+    uint64_t                                chunkID;
+    ebc_rule_type                           type;
+    uint64_t                                time_formed;
+    std::string                             name;
+    chunk_stats                             stats;
+    uint64_t                                baseInstantiationID;
+    std::vector< uint64_t >                 result_instantiationIDs;
+    archived_instantiation                  chunkInstantiation;
+    std::vector< archived_instantiation >   instantiations;     /* Every instantiation backtraced through */
+
+    const archived_instantiation*           find_instantiation(uint64_t pInstID) const;
+} archived_chunk;
+
+typedef std::map< uint64_t, explain_log_entry > explain_log_index;
+
+class Explanation_Log
+{
+    public:
+
+        Explanation_Log();
+        ~Explanation_Log();
+
+        bool                        open(const char* pPath);
+        void                        close();
+        bool                        is_open()           { return (m_file != NULL); }
+
+        bool                        append(const archived_chunk& pChunk);
+        bool                        read(uint64_t pChunkID, archived_chunk& pChunk);
+
+        const explain_log_entry*    find(uint64_t pChunkID);
+        const explain_log_entry*    find(const std::string& pName);
+        const explain_log_index&    get_index()         { return m_index; }
+
+        const std::string&          get_path()          { return m_path; }
+        uint64_t                    get_size()          { return m_end; }
+
+    private:
+
+        FILE*                                       m_file;
+        std::string                                 m_path;         /* Kept after close() so the same log can be re-created */
+        uint64_t                                    m_end;
+        explain_log_index                           m_index;
+        std::unordered_map< std::string, uint64_t > m_name_index;
+};
+
+#endif /* CORE_SOARKERNEL_SRC_EXPLANATION_MEMORY_EXPLANATION_LOG_H_ */
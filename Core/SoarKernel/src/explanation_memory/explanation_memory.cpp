@@ -40,6 +40,12 @@ Explanation_Memory::Explanation_Memory(agent* myAgent)
     print_explanation_trace = true;
     last_printed_id = 0;
 
+    explanation_log = new Explanation_Log();
+    current_archived_chunk = NULL;
+    lru_head = NULL;
+    lru_tail = NULL;
+    inst_sweep_threshold = 0;
+
     /* Create data structures used for EBC */
     all_actions = new action_record_map();
     all_conditions = new condition_record_map();
@@ -66,6 +72,7 @@ Explanation_Memory::~Explanation_Memory()
     delete chunks_by_ID;
     delete instantiations;
     delete production_id_map;
+    delete explanation_log;
     delete settings;
 }
 
@@ -100,6 +107,7 @@ void Explanation_Memory::initialize_counters()
     stats.identity_propagations             = 0;
     stats.identity_propagations_blocked     = 0;
     stats.operational_constraints           = 0;
+    stats.rule_memory                       = 0;
 }
 
 void Explanation_Memory::clear_explanations()
@@ -144,6 +152,12 @@ void Explanation_Memory::clear_explanations()
 
     cached_production->clear();
     production_id_map->clear();
+
+    clear_archived_chunk();
+    explanation_log->close();
+    lru_head = NULL;
+    lru_tail = NULL;
+    inst_sweep_threshold = 0;
 }
 
 void Explanation_Memory::re_init()
@@ -173,6 +187,10 @@ void Explanation_Memory::end_chunk_record()
     {
         current_recording_chunk->end_chunk_record();
         current_recording_chunk = NULL;
+        if (settings->record_limit->get_value() > 0)
+        {
+            enforce_record_limit();
+        }
     }
 }
 
@@ -214,14 +232,15 @@ void Explanation_Memory::add_result_instantiations(instantiation* pBaseInst, pre
     }
 }
 
-void Explanation_Memory::record_chunk_contents(production* pProduction, condition* lhs, action* rhs, preference* results, id_to_join_map* pIdentitySetMappings, instantiation* pBaseInstantiation, instantiation* pChunkInstantiation, ProductionType prodType)
+void Explanation_Memory::record_chunk_contents(production* pProduction, condition* lhs, action* rhs, preference* results, instantiation* pBaseInstantiation, instantiation* pChunkInstantiation, ProductionType prodType)
 {
     if (current_recording_chunk)
     {
-        current_recording_chunk->record_chunk_contents(pProduction, lhs, rhs, results, pIdentitySetMappings, pBaseInstantiation, backtrace_number, pChunkInstantiation, prodType);
+        current_recording_chunk->record_chunk_contents(pProduction, lhs, rhs, results, pBaseInstantiation, backtrace_number, pChunkInstantiation, prodType);
         chunks->insert({pProduction->name, current_recording_chunk});
         chunks_by_ID->insert({current_recording_chunk->chunkID, current_recording_chunk});
         thisAgent->symbolManager->symbol_add_ref(pProduction->name);
+        add_to_lru(current_recording_chunk);
     }
 }
 
@@ -260,6 +279,13 @@ instantiation_record* Explanation_Memory::add_instantiation(instantiation* pInst
 
     bool lIsTerminalInstantiation = false;
 
+    /* The record may have been released after the chunks that used it were
+     * moved to the explanation log, so record it again from scratch */
+    if ((pInst->explain_status == explain_recorded) && !get_instantiation(pInst))
+    {
+        pInst->explain_status = explain_unrecorded;
+    }
+
     if (pInst->explain_status == explain_unrecorded)
     {
 
@@ -409,6 +435,10 @@ bool Explanation_Memory::explain_chunk(const std::string* pStringParameter)
     {
         if (!print_chunk_explanation_for_id(lObjectID))
         {
+            if (page_in_chunk(explanation_log->find(lObjectID)))
+            {
+                return true;
+            }
             outputManager->printa_sf(thisAgent, "Could not find a rule name or id %s.\nType 'explain list-chunks' or 'explain list-justifications' to see a list of rule formations Soar has recorded.\n", pStringParameter->c_str());
         } else {
             outputManager->printa_sf(thisAgent, "Now explaining %y.\n", current_discussed_chunk->name);
@@ -429,7 +459,15 @@ bool Explanation_Memory::explain_chunk(const std::string* pStringParameter)
                 print_chunk_explanation();
                 return true;
             }
+        }
 
+        /* The explanation may have been moved to the explanation log */
+        if (page_in_chunk(explanation_log->find(*pStringParameter)))
+        {
+            return true;
+        }
+        if (sym && sym->sc->production)
+        {
             outputManager->printa_sf(thisAgent, "Soar has not recorded an explanation for %s.\nType 'explain list-chunks' or 'explain list-justifications' to see a list of rule formations Soar has recorded.\n", pStringParameter->c_str());
             return false;
         }
@@ -449,8 +487,210 @@ void Explanation_Memory::discuss_chunk(chunk_record* pChunkRecord)
         current_discussed_chunk = pChunkRecord;
         current_discussed_chunk->generate_dependency_paths();
     }
+    clear_archived_chunk();
+    touch_chunk(pChunkRecord);
+    last_printed_id = 0;
+
+}
+
+void Explanation_Memory::add_to_lru(chunk_record* pChunkRecord)
+{
+    insert_at_head_of_dll(lru_head, pChunkRecord, lru_next, lru_prev);
+    if (!lru_tail) lru_tail = pChunkRecord;
+}
+
+void Explanation_Memory::remove_from_lru(chunk_record* pChunkRecord)
+{
+    if (lru_tail == pChunkRecord) lru_tail = pChunkRecord->lru_prev;
+    remove_from_dll(lru_head, pChunkRecord, lru_next, lru_prev);
+    pChunkRecord->lru_prev = pChunkRecord->lru_next = NULL;
+}
+
+void Explanation_Memory::touch_chunk(chunk_record* pChunkRecord)
+{
+    if (lru_head == pChunkRecord) return;
+    remove_from_lru(pChunkRecord);
+    add_to_lru(pChunkRecord);
+}
+
+/* When a record limit is set, the least recently used chunk explanations are
+ * appended to the explanation log and freed.  Instantiation records are shared
+ * between chunk explanations, so they are only released once no chunk left in
+ * memory can reach them.  Finding them takes a sweep over all records, so it is
+ * only done when their number has doubled since the last sweep. */
+void Explanation_Memory::enforce_record_limit()
+{
+    uint64_t lLimit = static_cast<uint64_t>(settings->record_limit->get_value());
+
+    while (chunks->size() > lLimit)
+    {
+        assert(lru_tail);
+        archive_chunk(lru_tail);
+    }
+    if (instantiations->size() >= inst_sweep_threshold)
+    {
+        release_unreferenced_instantiations();
+        inst_sweep_threshold = 2 * instantiations->size() + 64;
+    }
+}
+
+void Explanation_Memory::archive_chunk(chunk_record* pChunkRecord)
+{
+    if (!explanation_log->is_open() && !explanation_log->open(settings->log_file->get_string().c_str()))
+    {
+        outputManager->printa_sf(thisAgent, "%eExplainer could not create explanation log '%s'.  The log must be a new file.  Explanation of %y will be discarded.\n",
+            settings->log_file->get_string().c_str(), pChunkRecord->name);
+    }
+
+    if (explanation_log->is_open())
+    {
+        archived_chunk lArchived;
+        lArchived.chunkID = pChunkRecord->chunkID;
+        lArchived.type = pChunkRecord->type;
+        lArchived.time_formed = pChunkRecord->time_formed;
+        lArchived.name = pChunkRecord->name->to_string();
+        lArchived.stats = pChunkRecord->stats;
+        lArchived.baseInstantiationID = pChunkRecord->baseInstantiation->instantiationID;
+        for (auto it = pChunkRecord->result_inst_records->begin(); it != pChunkRecord->result_inst_records->end(); ++it)
+        {
+            lArchived.result_instantiationIDs.push_back((*it)->instantiationID);
+        }
+        pChunkRecord->chunkInstantiation->archive(lArchived.chunkInstantiation);
+        lArchived.instantiations.resize(pChunkRecord->backtraced_inst_records->size());
+        auto lArchivedInst = lArchived.instantiations.begin();
+        for (auto it = pChunkRecord->backtraced_inst_records->begin(); it != pChunkRecord->backtraced_inst_records->end(); ++it, ++lArchivedInst)
+        {
+            (*it)->archive(*lArchivedInst);
+        }
+
+        if (!explanation_log->append(lArchived))
+        {
+            outputManager->printa_sf(thisAgent, "%eExplainer could not write explanation of %y to log '%s'.\n",
+                pChunkRecord->name, explanation_log->get_path().c_str());
+        }
+    }
+
+    if (current_discussed_chunk == pChunkRecord)
+    {
+        clear_chunk_from_instantiations();
+        thisAgent->visualizationManager->reset_colors_for_id();
+        current_discussed_chunk = NULL;
+        last_printed_id = 0;
+    }
+
+    Symbol* lSym = pChunkRecord->name;
+    remove_from_lru(pChunkRecord);
+    chunks->erase(lSym);
+    chunks_by_ID->erase(pChunkRecord->chunkID);
+    thisAgent->symbolManager->symbol_remove_ref(&lSym);
+    pChunkRecord->clean_up();
+    thisAgent->memoryManager->free_with_pool(MP_chunk_record, pChunkRecord);
+}
+
+void Explanation_Memory::release_unreferenced_instantiations()
+{
+    std::unordered_set< instantiation_record* > lReachable;
+    std::list< instantiation_record* > lToVisit;
+    instantiation_record* lInstRecord;
+    condition_record* lCondRecord;
+
+    auto mark = [&lReachable, &lToVisit](instantiation_record* pInstRecord)
+    {
+        if (pInstRecord && lReachable.insert(pInstRecord).second)
+        {
+            lToVisit.push_back(pInstRecord);
+        }
+    };
+
+    for (auto it = chunks->begin(); it != chunks->end(); ++it)
+    {
+        chunk_record* lChunk = it->second;
+        mark(lChunk->chunkInstantiation);
+        mark(lChunk->baseInstantiation);
+        for (auto it2 = lChunk->result_inst_records->begin(); it2 != lChunk->result_inst_records->end(); ++it2) mark(*it2);
+        for (auto it2 = lChunk->backtraced_inst_records->begin(); it2 != lChunk->backtraced_inst_records->end(); ++it2) mark(*it2);
+    }
+    while (!lToVisit.empty())
+    {
+        lInstRecord = lToVisit.front();
+        lToVisit.pop_front();
+        if (lInstRecord->path_to_base)
+        {
+            for (auto it = lInstRecord->path_to_base->begin(); it != lInstRecord->path_to_base->end(); ++it) mark(*it);
+        }
+        for (auto it = lInstRecord->conditions->begin(); it != lInstRecord->conditions->end(); ++it)
+        {
+            lCondRecord = (*it);
+            mark(lCondRecord->my_instantiation);
+            mark(lCondRecord->parent_instantiation);
+            if (lCondRecord->path_to_base)
+            {
+                for (auto it2 = lCondRecord->path_to_base->begin(); it2 != lCondRecord->path_to_base->end(); ++it2) mark(*it2);
+            }
+        }
+    }
+
+    for (auto it = instantiations->begin(); it != instantiations->end(); )
+    {
+        lInstRecord = it->second;
+        if (lReachable.find(lInstRecord) != lReachable.end())
+        {
+            ++it;
+            continue;
+        }
+        for (auto it2 = lInstRecord->conditions->begin(); it2 != lInstRecord->conditions->end(); ++it2)
+        {
+            all_conditions->erase((*it2)->conditionID);
+            (*it2)->clean_up();
+            thisAgent->memoryManager->free_with_pool(MP_condition_record, (*it2));
+        }
+        for (auto it2 = lInstRecord->actions->begin(); it2 != lInstRecord->actions->end(); ++it2)
+        {
+            all_actions->erase((*it2)->get_actionID());
+            (*it2)->clean_up();
+            thisAgent->memoryManager->free_with_pool(MP_action_record, (*it2));
+        }
+        it = instantiations->erase(it);
+        lInstRecord->clean_up();
+        thisAgent->memoryManager->free_with_pool(MP_instantiation_record, lInstRecord);
+    }
+}
+
+bool Explanation_Memory::page_in_chunk(const explain_log_entry* pEntry)
+{
+    if (!pEntry) return false;
+
+    archived_chunk* lArchived = new archived_chunk();
+    if (!explanation_log->read(pEntry->chunkID, *lArchived))
+    {
+        delete lArchived;
+        outputManager->printa_sf(thisAgent, "Could not read the explanation of %s (c %u) back from explanation log '%s'.\n",
+            pEntry->name.c_str(), pEntry->chunkID, explanation_log->get_path().c_str());
+        return false;
+    }
+
+    if (current_discussed_chunk)
+    {
+        clear_chunk_from_instantiations();
+        thisAgent->visualizationManager->reset_colors_for_id();
+        current_discussed_chunk = NULL;
+    }
+    clear_archived_chunk();
+    current_archived_chunk = lArchived;
     last_printed_id = 0;
 
+    outputManager->printa_sf(thisAgent, "Now explaining %s.  (Paged in from the explanation log, which keeps the working memory trace, formation and statistics.)\n\n", current_archived_chunk->name.c_str());
+    print_chunk_explanation();
+    return true;
+}
+
+void Explanation_Memory::clear_archived_chunk()
+{
+    if (current_archived_chunk)
+    {
+        delete current_archived_chunk;
+        current_archived_chunk = NULL;
+    }
 }
 
 void Explanation_Memory::save_excised_production(production* pProd)
@@ -476,6 +716,19 @@ bool Explanation_Memory::print_chunk_explanation_for_id(uint64_t pChunkID)
 
 bool Explanation_Memory::print_instantiation_explanation_for_id(uint64_t pInstID)
 {
+    /* A chunk paged in from the explanation log keeps its own instantiations */
+    if (current_archived_chunk)
+    {
+        const archived_instantiation* lArchivedInst = current_archived_chunk->find_instantiation(pInstID);
+        if (!lArchivedInst)
+        {
+            outputManager->printa_sf(thisAgent, "Could not find an instantiation with ID %u in the explanation of %s.\n", pInstID, current_archived_chunk->name.c_str());
+            return false;
+        }
+        last_printed_id = pInstID;
+        print_archived_instantiation(*lArchivedInst);
+        return true;
+    }
     auto iter_inst = instantiations->find(pInstID);
     if (iter_inst == instantiations->end())
     {
@@ -569,6 +822,11 @@ bool Explanation_Memory::current_discussed_chunk_exists()
     return current_discussed_chunk;
 }
 
+bool Explanation_Memory::any_discussed_chunk_exists()
+{
+    return (current_discussed_chunk || current_archived_chunk);
+}
+
 void Explanation_Memory::increment_stat_duplicates(production* duplicate_rule)
 {
     assert(duplicate_rule);
@@ -657,6 +915,14 @@ bool Explanation_Memory::visualize_instantiation_explanation_for_id(uint64_t pIn
     auto iter_inst = instantiations->find(pInstID);
     if (iter_inst == instantiations->end())
     {
+        /* A chunk paged in from the explanation log keeps its own instantiations */
+        const archived_instantiation* lArchivedInst = current_archived_chunk ? current_archived_chunk->find_instantiation(pInstID) : NULL;
+        if (lArchivedInst)
+        {
+            last_printed_id = pInstID;
+            print_archived_instantiation(*lArchivedInst);
+            return true;
+        }
         outputManager->printa_sf(thisAgent, "Could not find an instantiation with ID %u.\n", pInstID);
         return false;
     }
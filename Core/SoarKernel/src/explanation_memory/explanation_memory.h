@@ -11,6 +11,7 @@
 #include "kernel.h"
 
 #include "chunk_record.h"
+#include "explanation_log.h"
 #include "explanation_settings.h"
 #include "identity_record.h"
 #include "stl_typedefs.h"
@@ -51,6 +52,8 @@ typedef struct chunking_stats_struct {
         uint64_t            identities_literalized;
         uint64_t            identity_propagations;
         uint64_t            identity_propagations_blocked;
+
+        uint64_t            rule_memory;
 } chunking_stats;
 
 
@@ -84,7 +87,7 @@ class Explanation_Memory
 
         void                    add_chunk_record(instantiation* pBaseInstantiation);
         void                    add_result_instantiations(instantiation* pBaseInst, preference* pResults);
-        void                    record_chunk_contents(production* pProduction, condition* lhs, action* rhs, preference* results, id_to_join_map* pIdentitySetMappings, instantiation* pBaseInstantiation, instantiation* pChunkInstantiation, ProductionType prodType);
+        void                    record_chunk_contents(production* pProduction, condition* lhs, action* rhs, preference* results, instantiation* pBaseInstantiation, instantiation* pChunkInstantiation, ProductionType prodType);
         void                    cancel_chunk_record();
         void                    end_chunk_record();
         void                    save_excised_production(production* pProd);
@@ -108,6 +111,7 @@ class Explanation_Memory
         void increment_stat_chunks_attempted() { stats.chunks_attempted++; };
         void increment_stat_chunks_succeeded() { stats.chunks_succeeded++; };
         void increment_stat_justifications_succeeded() { stats.justifications_succeeded++; };
+        void increment_stat_rule_memory(uint64_t pMemoryNow, uint64_t pMemoryBefore) { if (pMemoryNow > pMemoryBefore) stats.rule_memory += (pMemoryNow - pMemoryBefore); };
         void increment_stat_instantations_backtraced() { stats.instantations_backtraced++; if (current_recording_chunk) current_recording_chunk->stats.instantations_backtraced++; };
         void increment_stat_constraints_attached() { stats.constraints_attached++; if (current_recording_chunk) current_recording_chunk->stats.constraints_attached++; };
         void increment_stat_constraints_collected() { stats.constraints_collected++; if (current_recording_chunk) current_recording_chunk->stats.constraints_collected++; };
@@ -127,8 +131,10 @@ class Explanation_Memory
         uint64_t get_stat_succeeded() { return stats.chunks_succeeded; };
         uint64_t get_stat_chunks_attempted() { return stats.chunks_attempted; };
         uint64_t get_stat_justifications() { return stats.justifications_succeeded; };
+        uint64_t get_stat_rule_memory() { return stats.rule_memory; };
 
         bool current_discussed_chunk_exists();
+        bool any_discussed_chunk_exists();
         bool watch_rule(const std::string* pStringParameter);
         bool toggle_production_watch(production* pProduction);
 
@@ -176,6 +182,16 @@ class Explanation_Memory
         chunk_record*           current_recording_chunk;
         identity_quadruple      current_explained_ids;
 
+        /* Explanations evicted when a record limit is set.  The chunk being
+         * discussed may be one that was paged back in from the log.  Eviction
+         * takes the tail of the LRU list; instantiation records are swept once
+         * their number has doubled since the last sweep. */
+        Explanation_Log*        explanation_log;
+        archived_chunk*         current_archived_chunk;
+        chunk_record*           lru_head;
+        chunk_record*           lru_tail;
+        uint64_t                inst_sweep_threshold;
+
         std::string             after_action_report_file;
 
         void                    initialize_counters();
@@ -187,6 +203,18 @@ class Explanation_Memory
         production*             get_production(uint64_t pId);
 
         void                    discuss_chunk(chunk_record* pChunkRecord);
+        void                    add_to_lru(chunk_record* pChunkRecord);
+        void                    remove_from_lru(chunk_record* pChunkRecord);
+        void                    touch_chunk(chunk_record* pChunkRecord);
+
+        void                    enforce_record_limit();
+        void                    archive_chunk(chunk_record* pChunkRecord);
+        void                    release_unreferenced_instantiations();
+        bool                    page_in_chunk(const explain_log_entry* pEntry);
+        void                    clear_archived_chunk();
+        void                    print_archived_formation_explanation();
+        void                    print_archived_instantiation(const archived_instantiation& pInst);
+        void                    print_chunk_stats_details(const chunk_stats& pStats);
 
         void                    clear_chunk_from_instantiations();
         void                    clear_identities_in_set(identity_set* lIdenty_set);
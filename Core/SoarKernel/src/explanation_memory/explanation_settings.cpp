@@ -26,6 +26,8 @@ Explainer_Parameters::Explainer_Parameters(agent* new_agent): soar_module::param
     constraint_analysis = new soar_module::boolean_param("constraints", on, new soar_module::f_predicate<boolean>());
     identity_analysis = new soar_module::boolean_param("identity", on, new soar_module::f_predicate<boolean>());
     stats = new soar_module::boolean_param("stats", on, new soar_module::f_predicate<boolean>());
+    record_limit = new soar_module::integer_param("record-limit", 0, new soar_module::gt_predicate<int64_t>(0, true), new soar_module::f_predicate<int64_t>());
+    log_file = new soar_module::string_param("log-file", "", new soar_module::predicate<const char*>(), new soar_module::f_predicate<const char*>());
     help_cmd = new soar_module::boolean_param("help", on, new soar_module::f_predicate<boolean>());
     qhelp_cmd = new soar_module::boolean_param("?", on, new soar_module::f_predicate<boolean>());
 
@@ -44,6 +46,8 @@ Explainer_Parameters::Explainer_Parameters(agent* new_agent): soar_module::param
     add(constraint_analysis);
     add(identity_analysis);
     add(stats);
+    add(record_limit);
+    add(log_file);
     add(help_cmd);
     add(qhelp_cmd);
 }
@@ -61,6 +65,8 @@ void Explainer_Parameters::print_explanation_settings(agent* thisAgent)
     outputManager->printa_sf(thisAgent, "all                        %-%s%-%s\n", capitalizeOnOff(all->get_value()), "Whether to record all rules that are learned");
     outputManager->printa_sf(thisAgent, "justifications             %-%s%-%s\n", capitalizeOnOff(include_justifications->get_value()), "Whether to record justifications");
     outputManager->printa_sf(thisAgent, "record <chunk-name>        %-%-%s\n", "Record any chunks formed from a specific rule");
+    outputManager->printa_sf(thisAgent, "record-limit               %-%d%-%s\n", record_limit->get_value(), "Explanations kept in memory before older ones are moved to the log (0 = no limit)");
+    outputManager->printa_sf(thisAgent, "log-file                   %-%s%-%s\n", (log_file->get_string().empty() ? "(temp)" : log_file->get_string().c_str()), "File that evicted explanations are written to");
     outputManager->printa_sf(thisAgent, "list-chunks                %-%-%s\n", "List all rules learned");
     outputManager->printa_sf(thisAgent, "list-justifications        %-%-%s\n", "List all justifications learned");
     outputManager->printa_sf(thisAgent, "------------- Starting an Explanation -------------\n");
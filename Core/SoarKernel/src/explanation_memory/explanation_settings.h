@@ -34,6 +34,9 @@ class Explainer_Parameters: public soar_module::param_container
         soar_module::boolean_param* stats;
         soar_module::boolean_param* only_print_chunk_identities;
 
+        soar_module::integer_param* record_limit;
+        soar_module::string_param*  log_file;
+
         soar_module::boolean_param* help_cmd;
         soar_module::boolean_param* qhelp_cmd;
 
@@ -191,6 +191,24 @@ void instantiation_record::create_identity_paths(const inst_record_list* pInstPa
     }
 }
 
+/* The rule in the RETE may no longer line up with what was recorded, for example if a
+ * rule with the same name was sourced after the instantiation fired.  The explanation
+ * trace walks both condition lists in parallel, so they must be the same length. */
+bool instantiation_record::matches_rule_conditions(condition* pRuleConds)
+{
+    size_t lNumRuleConds = 0;
+    for (condition* lCond = pRuleConds; lCond != NIL; lCond = lCond->next)
+    {
+        if (lCond->type == CONJUNCTIVE_NEGATION_CONDITION)
+        {
+            for (condition* lNCond = lCond->data.ncc.top; lNCond != NIL; lNCond = lNCond->next) ++lNumRuleConds;
+        } else {
+            ++lNumRuleConds;
+        }
+    }
+    return (lNumRuleConds == conditions->size());
+}
+
 id_set* instantiation_record::get_lhs_identities()
 {
     if (lhs_identities) return lhs_identities;
@@ -289,6 +307,54 @@ void instantiation_record::print_for_wme_trace(bool isChunk, bool printFooter)
         }
     }
 }
+/* Copies what the working memory trace shows into a self-contained record for the
+ * explanation log.  Formats each condition and action the way print_for_wme_trace does. */
+void instantiation_record::archive(archived_instantiation& pArchived)
+{
+    Output_Manager* outputManager = thisAgent->outputManager;
+    test id_test_without_goal_test;
+
+    pArchived.instantiationID = instantiationID;
+    pArchived.production_name = production_name->to_string();
+    pArchived.match_level = match_level;
+    pArchived.conditions.resize(conditions->size());
+    pArchived.actions.resize(actions->size());
+
+    outputManager->set_print_test_format(false, true);
+    auto lArchivedCond = pArchived.conditions.begin();
+    for (condition_record_list::iterator it = conditions->begin(); it != conditions->end(); ++it, ++lArchivedCond)
+    {
+        condition_record* lCond = (*it);
+        id_test_without_goal_test = copy_test(thisAgent, lCond->condition_tests.id, false, false, true);
+        lArchivedCond->text.clear();
+        outputManager->sprinta_sf(thisAgent, lArchivedCond->text, "(%t%s^%t %t%s)",
+            id_test_without_goal_test, ((lCond->type == NEGATIVE_CONDITION) ? " -" : " "),
+            lCond->condition_tests.attr, lCond->condition_tests.value,
+            lCond->test_for_acceptable_preference ? " +" : "");
+        deallocate_test(thisAgent, id_test_without_goal_test);
+
+        lArchivedCond->type = static_cast<ConditionType>(lCond->type);
+        lArchivedCond->operational = (match_level > 0) && (lCond->wme_level_at_firing < match_level);
+        if (lCond->parent_instantiation)
+        {
+            lArchivedCond->creatorID = lCond->parent_instantiation->instantiationID;
+            lArchivedCond->creator_name = lCond->parent_instantiation->production_name->to_string();
+        } else {
+            lArchivedCond->creatorID = 0;
+            lArchivedCond->creator_name.clear();
+        }
+    }
+
+    outputManager->set_print_test_format(true, false);
+    auto lArchivedAction = pArchived.actions.begin();
+    for (action_record_list::iterator it = actions->begin(); it != actions->end(); ++it, ++lArchivedAction)
+    {
+        lArchivedAction->clear();
+        outputManager->sprinta_sf(thisAgent, *lArchivedAction, "%p", (*it)->instantiated_pref);
+    }
+    outputManager->clear_print_test_format();
+}
+
 void instantiation_record::print_for_explanation_trace(bool isChunk, bool printFooter)
 {
     Output_Manager* outputManager = thisAgent->outputManager;
@@ -333,6 +399,23 @@ void instantiation_record::print_for_explanation_trace(bool isChunk, bool printF
         } else {
             p_node_to_conditions_and_rhs(thisAgent, originalProduction->p_node, NIL, NIL, &top, &bottom, &rhs);
         }
+        if (!matches_rule_conditions(top))
+        {
+            if (originalProduction && originalProduction->p_node)
+            {
+                deallocate_condition_list(thisAgent, top);
+                deallocate_action_list(thisAgent, rhs);
+            }
+            outputManager->printa_sf(thisAgent, "Explanation trace of instantiation # %u %-(match of rule %y at level %d)\n",
+                instantiationID, production_name, static_cast<int64_t>(match_level));
+            outputManager->printa_sf(thisAgent,
+                "\nWarning:  Cannot print explanation trace for this instantiation because the rule in\n"
+                "            RETE no longer matches what was recorded.  Printing working memory trace instead.\n\n");
+            thisAgent->explanationMemory->print_explanation_trace = false;
+            print_arch_inst_for_explanation_trace(isChunk, printFooter);
+            thisAgent->explanationMemory->print_explanation_trace = true;
+            return;
+        }
         current_cond = top;
         if (current_cond->type == CONJUNCTIVE_NEGATION_CONDITION)
         {
@@ -631,6 +714,18 @@ void instantiation_record::viz_et_instantiation(visObjectType objectType)
         } else {
             p_node_to_conditions_and_rhs(thisAgent, originalProduction->p_node, NIL, NIL, &top, &bottom, &rhs);
         }
+        if (!matches_rule_conditions(top))
+        {
+            if (originalProduction && originalProduction->p_node)
+            {
+                deallocate_condition_list(thisAgent, top);
+                deallocate_action_list(thisAgent, rhs);
+            }
+            thisAgent->explanationMemory->print_explanation_trace = false;
+            viz_wm_instantiation(objectType);
+            thisAgent->explanationMemory->print_explanation_trace = true;
+            return;
+        }
         current_cond = top;
         if (current_cond->type == CONJUNCTIVE_NEGATION_CONDITION)
         {
@@ -14,6 +14,7 @@
 class condition_record;
 class production_record;
 class action_record;
+struct archived_instantiation_struct;
 
 class instantiation_record
 {
@@ -42,6 +43,7 @@ class instantiation_record
         void                    print_for_explanation_trace(bool isChunk, bool printFooter);
         void                    print_arch_inst_for_explanation_trace(bool isChunk, bool printFooter);
         void                    print_for_wme_trace(bool isChunk, bool printFooter);
+        void                    archive(archived_instantiation_struct& pArchived);
         void                    visualize();
 
         void                    delete_instantiation();
@@ -68,6 +70,7 @@ class instantiation_record
         void                    viz_wm_instantiation(visObjectType objectType);
         void                    viz_simple_instantiation(visObjectType objectType);
         void                    viz_connect_conditions(bool isChunkInstantiation = false);
+        bool                    matches_rule_conditions(condition* pRuleConds);
 
 };
 
@@ -112,7 +112,7 @@ void remove_output_function(agent* thisAgent, const char* name)
         if (ol->cb == cb)
         {
             /* Remove ol entry */
-            ol->link_wme->output_link = NULL;
+            get_rare_fields(thisAgent, ol->link_wme).output_link = NULL;
             wme_remove_ref(thisAgent, ol->link_wme);
             remove_from_dll(thisAgent->existing_output_links, ol, next, prev);
             thisAgent->memoryManager->free_with_pool(MP_output_link, ol);
@@ -448,7 +448,7 @@ void update_for_top_state_wme_addition(agent* thisAgent, wme* w)
     ol->ids_in_tc = NIL;
     ol->cb = cb;
     /* --- make wme point to the structure --- */
-    w->output_link = ol;
+    get_rare_fields(thisAgent, w).output_link = ol;
 
     /* SW 07 10 2003
        previously, this wouldn't be done until the first OUTPUT phase.
@@ -477,13 +477,14 @@ void update_for_top_state_wme_addition(agent* thisAgent, wme* w)
     //push(thisAgent, thisAgent->output_link_for_tc, ol->link_wme->value->id->associated_output_links);
 }
 
-void update_for_top_state_wme_removal(wme* w)
+void update_for_top_state_wme_removal(agent* thisAgent, wme* w)
 {
-    if (! w->output_link)
+    output_link* ol = peek_rare_fields(thisAgent, w).output_link;
+    if (! ol)
     {
         return;
     }
-    w->output_link->status = REMOVED_OL_STATUS;
+    ol->status = REMOVED_OL_STATUS;
 }
 
 void update_for_io_wme_change(wme* w)
@@ -557,7 +558,7 @@ void inform_output_module_of_wm_changes(agent* thisAgent,
         w = static_cast<wme_struct*>(c->first);
         if (w->id == thisAgent->io_header)
         {
-            update_for_top_state_wme_removal(w);
+            update_for_top_state_wme_removal(thisAgent, w);
         }
         if (w->id->id->associated_output_links)
         {
@@ -38,7 +38,7 @@ bool Output_Manager::wme_to_string(agent* thisAgent, wme* w, std::string &destSt
         w->timetag, w->id, w->attr, w->value, (w->acceptable ? " +)" : ")"),
         static_cast<int64_t>(w->id->id->level),
         w->value->is_sti() ? static_cast<int64_t>(w->value->id->level) : 0,
-        w->reference_count);
+        static_cast<uint64_t>(w->reference_count));
 
     /* This is a bool, b/c sometimes we limit printing of WM to certain wme's.
      * Return value used to determine whether to print newline*/
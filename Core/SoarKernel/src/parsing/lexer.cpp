@@ -23,6 +23,11 @@
 #include <ctype.h>
 #include <cassert>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LEXER_USE_SSE2
+#include <emmintrin.h>
+#endif
+
 using soar::Lexer;
 using soar::Lexeme;
 
@@ -75,10 +80,72 @@ inline void Lexer::store_and_advance()
     get_next_char();
 }
 
+#ifdef LEXER_USE_SSE2
+/* Mask of the bytes in x that are in [lo, hi], as unsigned values */
+static inline __m128i bytes_in_range(__m128i x, char lo, char hi)
+{
+  __m128i above_lo = _mm_cmpeq_epi8(_mm_max_epu8(x, _mm_set1_epi8(lo)), x);
+  __m128i below_hi = _mm_cmpeq_epi8(_mm_min_epu8(x, _mm_set1_epi8(hi)), x);
+  return _mm_and_si128(above_lo, below_hi);
+}
+
+/* Same classification as constituent_char; Lexer::init checks they agree */
+static inline int constituent_mask(__m128i x)
+{
+  __m128i lower = _mm_or_si128(x, _mm_set1_epi8(0x20));
+  __m128i c = bytes_in_range(lower, 'a', 'z');
+  c = _mm_or_si128(c, bytes_in_range(x, '$', '&'));
+  c = _mm_or_si128(c, bytes_in_range(x, '*', '+'));
+  c = _mm_or_si128(c, _mm_cmpeq_epi8(x, _mm_set1_epi8('-')));
+  c = _mm_or_si128(c, bytes_in_range(x, '/', ':'));
+  c = _mm_or_si128(c, bytes_in_range(x, '<', 'Z'));
+  c = _mm_or_si128(c, _mm_cmpeq_epi8(x, _mm_set1_epi8('_')));
+  return _mm_movemask_epi8(c);
+}
+#endif
+
+const char* Lexer::skip_constituents(const char* p, const char* end)
+{
+#ifdef LEXER_USE_SSE2
+  while (end - p >= 16) {
+    int mask = constituent_mask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)));
+    if (mask != 0xFFFF) {
+      int i = 0;
+      while (mask & (1 << i)) i++;
+      return p + i;
+    }
+    p += 16;
+  }
+#endif
+  while ((p < end) && constituent_char[static_cast<unsigned char>(*p)])
+    p++;
+  return p;
+}
+
+/* Finds the end of the string in the input and appends it to the lexeme
+ * in one go, leaving the lexer as if store_and_advance had been called on
+ * each character. */
 void Lexer::read_constituent_string () {
-  while ((current_char!=EOF) &&
-         constituent_char[static_cast<unsigned char>(current_char)])
-    store_and_advance();
+  if ((current_char==EOF) ||
+      !constituent_char[static_cast<unsigned char>(current_char)])
+    return;
+
+  const char* input_start = orig_string.c_str();
+  const char* input_end = input_start + orig_string.length();
+  if ((production_string <= input_start) || (production_string > input_end) ||
+      (production_string[-1] != static_cast<char>(current_char))) {
+    while ((current_char!=EOF) &&
+           constituent_char[static_cast<unsigned char>(current_char)])
+      store_and_advance();
+    return;
+  }
+
+  const char* start = production_string - 1;
+  const char* end = skip_constituents(production_string, input_end);
+  current_lexeme.lex_string.append(start, end - start);
+  production_string = end;
+  current_char = end[-1];
+  get_next_char();
 }
 
 // At entry, current_char=="."; we read the "." and rest of number.
@@ -554,6 +621,16 @@ bool Lexer::init ()
       constituent_char[i] = (isalnum(i) != 0);
     }
   }
+#ifdef LEXER_USE_SSE2
+  for (i=0; i<256; i+=16)
+  {
+    char block[16];
+    for (int j=0; j<16; j++) block[j] = static_cast<char>(i+j);
+    int mask = constituent_mask(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block)));
+    for (int j=0; j<16; j++) assert(((mask >> j) & 1) == constituent_char[i+j]);
+    (void) mask;
+  }
+#endif
 
   /* --- setup whitespace array --- */
   for (i=0; i<256; i++)
@@ -248,11 +248,17 @@ namespace soar
          */
         void store_and_advance();
         /**
-         * Calls store_and_advance until a non-constituent character
-         * is found (constituent characters are alphanumerics and
-         * $%&*+-/:<=>?_@).
+         * Reads up to the next non-constituent character (constituent
+         * characters are alphanumerics and $%&*+-/:<=>?_@), with the
+         * same result as calling store_and_advance on each character.
+         * The run is found with skip_constituents and appended at once.
          */
         void read_constituent_string ();
+        /**
+         * Returns the first non-constituent character in [p, end), or end.
+         * Checks 16 characters at a time where SSE2 is available.
+         */
+        static const char* skip_constituents(const char* p, const char* end);
         /**
          * This is called when the current character is "." and we believe
          * the current lexeme will be a floating point number. Calls
@@ -987,8 +987,15 @@ void rl_perform_update(agent* thisAgent, double op_value, bool op_rl, Symbol* go
                     }
 
                     // Change value of rule
+                    Symbol* new_value = thisAgent->symbolManager->make_float_constant(new_combined);
+                    thisAgent->canonical_production_index->replace_symbol(prod, rhs_value_to_symbol(prod->action_list->referent), new_value);
                     deallocate_rhs_value(thisAgent, prod->action_list->referent);
-                    prod->action_list->referent = allocate_rhs_value_for_symbol_no_refcount(thisAgent, thisAgent->symbolManager->make_float_constant(new_combined), 0, 0);
+                    prod->action_list->referent = allocate_rhs_value_for_symbol_no_refcount(thisAgent, new_value, 0, 0);
+
+                    // The compiled rhs borrows the old value, so point its referent op at the new one
+                    rhs_op* referent_op = &prod->compiled_rhs->ops[prod->compiled_rhs->field_starts[3]];
+                    assert(referent_op->type == RHS_OP_SYMBOL);
+                    referent_op->sym = new_value;
 
                     prod->rl_update_count += 1;
                     prod->rl_ecr = new_ecr;
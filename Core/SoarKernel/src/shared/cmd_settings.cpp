@@ -123,7 +123,7 @@ void load_param_container::print_settings(agent* thisAgent)
     outputManager->printa_sf(thisAgent, "load %-[? | help]\n");
     outputManager->printa(thisAgent,    "------------------------------------------------------------\n");
     outputManager->printa_sf(thisAgent, "load file %-[--all --disable] %-<filename>\n");
-    outputManager->printa_sf(thisAgent, "load file %-[--verbose]     ]\n");
+    outputManager->printa_sf(thisAgent, "load file %-[--batch --verbose]\n");
     outputManager->printa(thisAgent,    "------------------------------------------------------------\n");
     outputManager->printa_sf(thisAgent, "load library %-<filename> <args...>\n");
     outputManager->printa(thisAgent,    "------------------------------------------------------------\n");
@@ -201,6 +201,8 @@ production_param_container::production_param_container(agent* new_agent): soar_m
     add(find_cmd);
     watch_cmd = new soar_module::boolean_param("watch", on, new soar_module::f_predicate<boolean>());
     add(watch_cmd);
+    reorder_cmd = new soar_module::boolean_param("reorder", on, new soar_module::f_predicate<boolean>());
+    add(reorder_cmd);
 
     help_cmd = new soar_module::boolean_param("help", on, new soar_module::f_predicate<boolean>());
     add(help_cmd);
@@ -248,6 +250,8 @@ void production_param_container::print_settings(agent* thisAgent)
     outputManager->printa(thisAgent,    "------------------------------------------------------------------\n");
     outputManager->printa_sf(thisAgent, "production optimize-attribute [symbol [n]]\n");
     outputManager->printa(thisAgent,    "------------------------------------------------------------------\n");
+    outputManager->printa_sf(thisAgent, "production reorder %-[--all --chunks] | <prod-name>\n");
+    outputManager->printa(thisAgent,    "------------------------------------------------------------------\n");
     outputManager->printa_sf(thisAgent, "production watch %-[--disable --enable] <prod-name>\n");
     outputManager->printa(thisAgent,    "------------------------------------------------------------------\n\n");
     outputManager->printa_sf(thisAgent, "For a detailed explanation of sub-commands:    help production\n");
@@ -62,6 +62,7 @@ class production_param_container: public soar_module::param_container
         soar_module::boolean_param* break_cmd;
         soar_module::boolean_param* find_cmd;
         soar_module::boolean_param* watch_cmd;
+        soar_module::boolean_param* reorder_cmd;
 
         soar_module::boolean_param* help_cmd;
         soar_module::boolean_param* qhelp_cmd;
@@ -153,6 +153,7 @@ enum ChunkingSettings {
     SETTING_EBC_ALLOW_OPAQUE,
     SETTING_EBC_ADD_LTM_LINKS,
     SETTING_AUTOMATICALLY_CREATE_SINGLETONS,
+    SETTING_EBC_REORDER_STATISTICS,
     num_ebc_settings
  };
 
@@ -292,7 +293,6 @@ MP_epmem_literal,
 MP_epmem_pedge,
 MP_epmem_uedge,
 MP_epmem_interval,
-MP_constraints,
 MP_action_record,
 MP_chunk_element,
 MP_chunk_record,
@@ -447,6 +447,13 @@ enum ActionType {
     FUNCALL_ACTION = 1,
 };
 
+enum RHSOpType {
+    RHS_OP_SYMBOL = 0,
+    RHS_OP_RETELOC = 1,
+    RHS_OP_UNBOUNDVAR = 2,
+    RHS_OP_FUNCALL = 3,
+};
+
 enum SupportType {
     UNKNOWN_SUPPORT = 0,
     O_SUPPORT = 1,
@@ -30,6 +30,7 @@ typedef struct production_struct production;
 typedef struct rete_node_struct rete_node;
 typedef struct rete_test_struct rete_test;
 typedef struct rhs_function_struct rhs_function;
+typedef struct rhs_program_struct rhs_program;
 typedef struct saved_test_struct saved_test;
 typedef struct select_info_struct select_info;
 typedef struct slot_struct slot;
@@ -60,6 +60,12 @@
 //    #define DETAILED_TIMING_STATS
 #endif
 
+/* COMPACT_WMES: Keeps the wme fields that only I/O, EBC, epmem and wma use in a
+ * per-agent side table instead of in every wme, and narrows the wme reference
+ * count to 32 bits.  A wme then fits in two cache lines, at the cost of a hash
+ * lookup whenever one of those modules touches its fields. */
+//#define COMPACT_WMES
+
 /* Spreading Activation Switch: Spreading can incur some small cost even when off
  * because of record-keeping in case it is later turned on. To reduce this cost,
  * spreading can be "more disabled" by eliminating that record-keeping.*/
@@ -92,6 +98,7 @@
     //#define DEBUG_WATERFALL       /* Use DT_WATERFALL. This setting adds retraction and nil goal retraction list printing */
     //#define DEBUG_GDS             /* Use DT_GDS and DT_GDS_HIGH.  This setting just adds parent instantiations that it recurses through */
     //#define DEBUG_INCOMING_SML    /* Prints message coming in via KernelSML::ProcessIncomingSML */
+    //#define DEBUG_SYMBOL_REFCOUNTS    /* Counts symbol references so 'debug symbol-refcounts' can check that they balance */
 
 #endif
 
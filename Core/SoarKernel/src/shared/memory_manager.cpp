@@ -44,6 +44,7 @@
 Memory_Manager::Memory_Manager()
 {
     memory_for_usage_overhead = memory_for_usage + STATS_OVERHEAD_MEM_USAGE;
+    bytes_allocated = 0;
 
     for (int i = 0; i < NUM_MEM_USAGE_CODES; i++)
     {
@@ -264,6 +265,7 @@ void* Memory_Manager::allocate_memory(size_t size, int usage_code)
     char* p;
 
     memory_for_usage[usage_code] += size;
+    bytes_allocated += size;
     size += sizeof(size_t);
     (*memory_for_usage_overhead) += sizeof(size_t);
 
@@ -139,6 +139,10 @@ class Memory_Manager
         void* allocate_memory_and_zerofill(size_t size, int usage_code);
         void free_memory(void* mem, int usage_code);
 
+        /* Running total of bytes handed out by the pools and allocate_memory.  It is
+         * never decremented, so the difference across a task is what the task allocated,
+         * even when every item came from a pool's free list. */
+        uint64_t get_bytes_allocated() { return bytes_allocated; }
         void print_memory_statistics();
         void debug_print_memory_stats(agent* thisAgent);
 
@@ -154,6 +158,7 @@ class Memory_Manager
 
         memory_pool         memory_pools[num_memory_pools];
         size_t              memory_for_usage[NUM_MEM_USAGE_CODES];
+        uint64_t            bytes_allocated;
         memory_pool*        memory_pools_in_use;
         size_t*             memory_for_usage_overhead;
 
@@ -182,6 +187,7 @@ class Memory_Manager
             lThisPool->free_list =  *(void**)(*(dest_item_pointer));
 
             increment_used_count(lThisPool);
+            bytes_allocated += lThisPool->item_size;
 
         #else // !MEM_POOLS_ENABLED
             // this is for debugging -- it disables the memory pool usage and just allocates
@@ -218,6 +224,7 @@ class Memory_Manager
             pThisPool->free_list =  *(void**)(*(dest_item_pointer));
 
             increment_used_count(pThisPool);
+            bytes_allocated += pThisPool->item_size;
 
         #else // !MEM_POOLS_ENABLED
             // this is for debugging -- it disables the memory pool usage and just allocates
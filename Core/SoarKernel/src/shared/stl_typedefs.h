@@ -197,5 +197,6 @@ struct IDSetLessThan;
 
 typedef std::pair< double, uint64_t >                           smem_activated_lti;
 typedef std::unordered_multimap<uint64_t,wma_decay_element*>    smem_wma_map;
+typedef std::unordered_map<uint64_t, wme*>                      timetag_to_wme_map;
 
 #endif /* STL_TYPEDEFS_H_ */
@@ -93,7 +93,6 @@ void init_soar_agent(agent* thisAgent)
     predict_init(thisAgent);
 
     thisAgent->memoryManager->init_memory_pool(MP_chunk_cond, sizeof(chunk_cond), "chunk_condition");
-    thisAgent->memoryManager->init_memory_pool(MP_constraints, sizeof(constraint_struct), "constraints");
     thisAgent->memoryManager->init_memory_pool(MP_sym_triple, sizeof(symbol_triple), "symbol_triple");
     thisAgent->memoryManager->init_memory_pool(MP_identity_mapping, sizeof(identity_mapping), "id_mapping");
     thisAgent->memoryManager->init_memory_pool(MP_chunk_element, sizeof(chunk_element), "chunk_element");
@@ -210,6 +209,7 @@ agent* create_soar_agent(char* agent_name)
     thisAgent->wmes_to_remove                           = NIL;
     thisAgent->wme_filter_list                          = NIL;
     thisAgent->multi_attributes                         = NIL;
+    thisAgent->reorder_with_match_statistics            = false;
 
     thisAgent->did_PE                                   = false;
     thisAgent->FIRING_TYPE                              = IE_PRODS;
@@ -356,6 +356,10 @@ void destroy_soar_agent(agent* delete_agent)
 
     delete_agent->memoryManager->free_with_pool(MP_rete_node, delete_agent->dummy_top_node);
     delete_agent->memoryManager->free_with_pool(MP_token, delete_agent->dummy_top_token);
+    delete delete_agent->canonical_production_index;
+    delete_agent->canonical_production_index = NULL;
+    delete delete_agent->deferred_rete_nodes;
+    delete_agent->deferred_rete_nodes = NULL;
 
     soar_remove_all_monitorable_callbacks(delete_agent);
 
@@ -386,6 +390,10 @@ void destroy_soar_agent(agent* delete_agent)
     {
         free_hash_table(delete_agent, delete_agent->alpha_hash_tables[i]);
     }
+    if (delete_agent->join_index)
+    {
+        delete_agent->memoryManager->free_memory(delete_agent->join_index, MISCELLANEOUS_MEM_USAGE);
+    }
 
     /* Release module managers */
     delete delete_agent->WM;
@@ -41,6 +41,8 @@ typedef void* xml_handle;
 
 typedef struct alpha_mem_struct alpha_mem;
 typedef struct token_struct token;
+class Canonical_Production_Index;
+class Deferred_Rete_Nodes;
 
 class stats_statement_container;
 #ifndef NO_SVS
@@ -67,6 +69,7 @@ typedef struct EXPORT agent_struct
     uint64_t    placeholder_counter[26];
     int64_t     firer_highest_rhs_unboundvar_index;
     char*       name_of_production_being_reordered;
+    bool        reorder_with_match_statistics;
     Symbol*     action_id_to_match;
     test        id_test_to_match;
     tc_number   current_tc_number;
@@ -87,6 +90,18 @@ typedef struct EXPORT agent_struct
     struct rete_node_struct* dummy_top_node;
     struct token_struct* dummy_top_token;
 
+    /* Join and negative nodes by parent and alpha memory, for node sharing */
+    struct beta_node_index_struct* join_index;
+
+    /* Canonical forms of all productions in the rete, for duplicate detection */
+    Canonical_Production_Index* canonical_production_index;
+
+    /* New beta nodes waiting to be populated, for production batches */
+    Deferred_Rete_Nodes* deferred_rete_nodes;
+
+    /* Whether alpha memories count their wmes and ids, for reordering */
+    bool                match_statistics;
+
     /* Various Rete statistics counters */
     uint64_t       rete_node_counts[256];
     uint64_t       rete_node_counts_if_no_sharing[256];
@@ -36,6 +36,7 @@
 #include <list>
 #include <stdlib.h>
 #include <string>
+#include <vector>
 
 using namespace soar_TraceNames;
 
@@ -228,6 +229,89 @@ uint64_t get_rhs_function_first_arg_identity(agent* thisAgent, rhs_value rv)
     return returnVal;
 }
 
+/* -----------------------------------------------------------------------
+   Helpers shared by instantiate_rhs_value() and the compiled RHS program
+   runner below.  Both return a symbol with a reference added for the
+   caller (or NIL).
+----------------------------------------------------------------------- */
+
+static Symbol* instantiate_rhs_unboundvar(agent* thisAgent, int64_t index,
+                                          goal_stack_level new_id_level, char new_id_letter)
+{
+    Symbol* sym;
+
+    if (thisAgent->firer_highest_rhs_unboundvar_index < index)
+    {
+        thisAgent->firer_highest_rhs_unboundvar_index = index;
+    }
+    sym = *(thisAgent->rhs_variable_bindings + index);
+
+    if (!sym)
+    {
+        sym = thisAgent->symbolManager->make_new_identifier(new_id_letter, new_id_level);
+        *(thisAgent->rhs_variable_bindings + index) = sym;
+        return sym;
+    }
+    else if (sym->is_variable())
+    {
+        new_id_letter = *(sym->var->name + 1);
+        sym = thisAgent->symbolManager->make_new_identifier(new_id_letter, new_id_level);
+        *(thisAgent->rhs_variable_bindings + index) = sym;
+        return sym;
+    }
+    else
+    {
+        thisAgent->symbolManager->symbol_add_ref(sym);
+        return sym;
+    }
+}
+
+/* Calls rf on arglist unless one of the arguments was NIL, then releases
+ * the arguments and deallocates arglist */
+static Symbol* call_rhs_function(agent* thisAgent, rhs_function* rf, cons* arglist, bool nil_arg_found)
+{
+    Symbol* result;
+    cons* c;
+
+    /* if all args were ok, call the function */
+
+    if (!nil_arg_found)
+    {
+        // stop the kernel timer while doing RHS funcalls  KJC 11/04
+        // the total_cpu timer needs to be updated in case RHS fun is statsCmd
+#ifndef NO_TIMING_STUFF
+        thisAgent->timers_kernel.stop();
+        thisAgent->timers_cpu.stop();
+        thisAgent->timers_total_kernel_time.update(thisAgent->timers_kernel);
+        thisAgent->timers_total_cpu_time.update(thisAgent->timers_cpu);
+        thisAgent->timers_cpu.start();
+#endif
+
+        result = (*(rf->f))(thisAgent, arglist, rf->user_data);
+
+        #ifndef NO_TIMING_STUFF  // restart the kernel timer
+        thisAgent->timers_kernel.start();
+#endif
+
+    }
+    else
+    {
+        result = NIL;
+    }
+
+    /* scan through arglist, dereference symbols and deallocate conses */
+    Symbol* lSym;
+    for (c = arglist; c != NIL; c = c->rest)
+        if (c->first)
+        {
+            lSym = static_cast<Symbol *>(c->first);
+            thisAgent->symbolManager->symbol_remove_ref(&lSym);
+        }
+    free_list(thisAgent, arglist);
+
+    return result;
+}
+
 Symbol* instantiate_rhs_value(agent* thisAgent, rhs_value rv,
                               goal_stack_level new_id_level, char new_id_letter,
                               struct token_struct* tok, wme* w, bool& wasUnboundVar)
@@ -251,35 +335,8 @@ Symbol* instantiate_rhs_value(agent* thisAgent, rhs_value rv,
 
     if (rhs_value_is_unboundvar(rv))
     {
-        int64_t index;
-        Symbol* sym;
-
         wasUnboundVar = true;
-        index = static_cast<int64_t>(rhs_value_to_unboundvar(rv));
-        if (thisAgent->firer_highest_rhs_unboundvar_index < index)
-        {
-            thisAgent->firer_highest_rhs_unboundvar_index = index;
-        }
-        sym = *(thisAgent->rhs_variable_bindings + index);
-
-        if (!sym)
-        {
-            sym = thisAgent->symbolManager->make_new_identifier(new_id_letter, new_id_level);
-            *(thisAgent->rhs_variable_bindings + index) = sym;
-            return sym;
-        }
-        else if (sym->is_variable())
-        {
-            new_id_letter = *(sym->var->name + 1);
-            sym = thisAgent->symbolManager->make_new_identifier(new_id_letter, new_id_level);
-            *(thisAgent->rhs_variable_bindings + index) = sym;
-            return sym;
-        }
-        else
-        {
-            thisAgent->symbolManager->symbol_add_ref(sym);
-            return sym;
-        }
+        return instantiate_rhs_unboundvar(thisAgent, static_cast<int64_t>(rhs_value_to_unboundvar(rv)), new_id_level, new_id_letter);
     }
 
     if (rhs_value_is_reteloc(rv))
@@ -326,56 +383,108 @@ Symbol* instantiate_rhs_value(agent* thisAgent, rhs_value rv,
         arglist = NIL;
     }
 
-    /* if all args were ok, call the function */
+    return call_rhs_function(thisAgent, rf, arglist, nil_arg_found);
+}
 
-    if (!nil_arg_found)
-    {
-        // stop the kernel timer while doing RHS funcalls  KJC 11/04
-        // the total_cpu timer needs to be updated in case RHS fun is statsCmd
-#ifndef NO_TIMING_STUFF
-        thisAgent->timers_kernel.stop();
-        thisAgent->timers_cpu.stop();
-        thisAgent->timers_total_kernel_time.update(thisAgent->timers_kernel);
-        thisAgent->timers_total_cpu_time.update(thisAgent->timers_cpu);
-        thisAgent->timers_cpu.start();
-#endif
+/* -----------------------------------------------------------------------
+                     Running Compiled RHS Programs
 
-        result = (*(rf->f))(thisAgent, arglist, rf->user_data);
+   create_instantiation() fires a production by running its compiled_rhs
+   (see rhs.h) rather than walking its action list.  Before running it,
+   the firer looks up the wme at every level of the token that a Rete
+   location can refer to, so each one is an array index:  wmes[0] is the
+   wme that completed the match, and wmes[n] is the one n levels up.
 
-        #ifndef NO_TIMING_STUFF  // restart the kernel timer
-        thisAgent->timers_kernel.start();
-#endif
+   run_rhs_program_field() evaluates one field of one action the same way
+   instantiate_rhs_value() would evaluate its rhs_value.
+----------------------------------------------------------------------- */
 
-    }
-    else
+/* Value stacks and wme arrays up to this size are kept on the C stack */
+#define RHS_PROGRAM_LOCAL_SIZE 16
+
+static Symbol* run_rhs_program_field(agent* thisAgent, rhs_program* prog, uint32_t field,
+                                     goal_stack_level new_id_level, char new_id_letter,
+                                     wme** wmes, bool& wasUnboundVar)
+{
+    rhs_op* op = prog->ops + prog->field_starts[field];
+    rhs_op* end = prog->ops + prog->field_starts[field + 1];
+    Symbol* local_stack[RHS_PROGRAM_LOCAL_SIZE];
+    std::vector<Symbol*> big_stack;
+    Symbol** stack;
+    Symbol* result;
+    uint32_t depth, i;
+    cons* arglist;
+    cons* c;
+    bool nil_arg_found;
+    wme* w;
+
+    wasUnboundVar = ((end - op) == 1) && (op->type == RHS_OP_UNBOUNDVAR);
+
+    stack = local_stack;
+    if (prog->max_stack_depth > RHS_PROGRAM_LOCAL_SIZE)
     {
-        result = NIL;
+        big_stack.resize(prog->max_stack_depth);
+        stack = &big_stack[0];
     }
 
-    /* scan through arglist, dereference symbols and deallocate conses */
-    Symbol* lSym;
-    for (c = arglist; c != NIL; c = c->rest)
-        if (c->first)
+    depth = 0;
+    for (; op != end; op++)
+    {
+        switch (op->type)
         {
-            lSym = static_cast<Symbol *>(c->first);
-            thisAgent->symbolManager->symbol_remove_ref(&lSym);
+            case RHS_OP_SYMBOL:
+                result = op->sym;
+                thisAgent->symbolManager->symbol_add_ref(result);
+                break;
+
+            case RHS_OP_RETELOC:
+                w = wmes[op->reteloc.levels_up];
+                result = (op->reteloc.field_num == 0) ? w->id : (op->reteloc.field_num == 1) ? w->attr : w->value;
+                thisAgent->symbolManager->symbol_add_ref(result);
+                break;
+
+            case RHS_OP_UNBOUNDVAR:
+                result = instantiate_rhs_unboundvar(thisAgent, static_cast<int64_t>(op->unboundvar_index), new_id_level, new_id_letter);
+                break;
+
+            default: /* RHS_OP_FUNCALL */
+                depth -= op->num_args;
+                arglist = NIL;
+                nil_arg_found = false;
+                for (i = op->num_args; i > 0; i--)
+                {
+                    allocate_cons(thisAgent, &c);
+                    c->first = stack[depth + i - 1];
+                    c->rest = arglist;
+                    arglist = c;
+                    if (!c->first)
+                    {
+                        nil_arg_found = true;
+                    }
+                }
+                result = call_rhs_function(thisAgent, op->function, arglist, nil_arg_found);
+                break;
         }
-    free_list(thisAgent, arglist);
+        stack[depth++] = result;
+    }
 
-    return result;
+    return stack[0];
 }
 
-preference* execute_action(agent* thisAgent, action* a, struct token_struct* tok, wme* w, action* rule_action)
+/* Executes action number action_index of prog's production.  a is the same action in the
+ * production's action list. */
+preference* execute_action(agent* thisAgent, action* a, rhs_program* prog, uint32_t action_index, wme** wmes, action* rule_action)
 {
     Symbol* lId, *lAttr, *lValue, *lReferent;
     char first_letter;
     preference* newPref;
 
     bool_quadruple was_unbound_vars;
+    uint32_t field = 4 * action_index;
 
     if (a->type == FUNCALL_ACTION)
     {
-        lValue = instantiate_rhs_value(thisAgent, a->value, -1, 'v', tok, w, was_unbound_vars.id);
+        lValue = run_rhs_program_field(thisAgent, prog, field + 2, -1, 'v', wmes, was_unbound_vars.id);
         if (lValue)
         {
             thisAgent->symbolManager->symbol_remove_ref(&lValue);
@@ -389,7 +498,7 @@ preference* execute_action(agent* thisAgent, action* a, struct token_struct* tok
     uint64_t oid_id = 0, oid_attr = 0, oid_value = 0, oid_referent = 0;
     rhs_value f_id = 0, f_attr = 0, f_value = 0, f_referent = 0;
 
-    lId = instantiate_rhs_value(thisAgent, a->id, -1, 's', tok, w, was_unbound_vars.id);
+    lId = run_rhs_program_field(thisAgent, prog, field, -1, 's', wmes, was_unbound_vars.id);
     if (!lId)
     {
         goto abort_execute_action;
@@ -400,7 +509,7 @@ preference* execute_action(agent* thisAgent, action* a, struct token_struct* tok
         goto abort_execute_action;
     }
 
-    lAttr = instantiate_rhs_value(thisAgent, a->attr, lId->id->level, 'a', tok, w, was_unbound_vars.attr);
+    lAttr = run_rhs_program_field(thisAgent, prog, field + 1, lId->id->level, 'a', wmes, was_unbound_vars.attr);
     if (!lAttr)
     {
         goto abort_execute_action;
@@ -408,7 +517,7 @@ preference* execute_action(agent* thisAgent, action* a, struct token_struct* tok
 
     first_letter = first_letter_from_symbol(lAttr);
 
-    lValue = instantiate_rhs_value(thisAgent, a->value, lId->id->level, first_letter, tok, w, was_unbound_vars.value);
+    lValue = run_rhs_program_field(thisAgent, prog, field + 2, lId->id->level, first_letter, wmes, was_unbound_vars.value);
     if (!lValue)
     {
         goto abort_execute_action;
@@ -416,7 +525,7 @@ preference* execute_action(agent* thisAgent, action* a, struct token_struct* tok
 
     if (preference_is_binary(a->preference_type))
     {
-        lReferent = instantiate_rhs_value(thisAgent, a->referent, lId->id->level, first_letter, tok, w, was_unbound_vars.referent);
+        lReferent = run_rhs_program_field(thisAgent, prog, field + 3, lId->id->level, first_letter, wmes, was_unbound_vars.referent);
         if (!lReferent)
         {
             goto abort_execute_action;
@@ -779,12 +888,13 @@ void finalize_instantiation(agent* thisAgent, instantiation* inst, bool need_to_
                 }
             }
             /* Check for local singletons */
-            if (cond->bt.wme_->local_singleton_value_identity_set && lDoIdentities && (cond->bt.wme_->id == inst->match_goal))
+            const wme_rare_fields& lRare = peek_rare_fields(thisAgent, cond->bt.wme_);
+            if (lRare.local_singleton_value_identity_set && lDoIdentities && (cond->bt.wme_->id == inst->match_goal))
             {
-                thisAgent->explanationBasedChunker->force_id_to_identity_mapping(cond->data.tests.id_test->eq_test->inst_identity, cond->bt.wme_->local_singleton_id_identity_set);
-                thisAgent->explanationBasedChunker->force_id_to_identity_mapping(cond->data.tests.value_test->eq_test->inst_identity, cond->bt.wme_->local_singleton_value_identity_set);
-                set_test_identity(thisAgent, cond->data.tests.id_test->eq_test, cond->bt.wme_->local_singleton_id_identity_set);
-                set_test_identity(thisAgent, cond->data.tests.value_test->eq_test, cond->bt.wme_->local_singleton_value_identity_set);
+                thisAgent->explanationBasedChunker->force_id_to_identity_mapping(cond->data.tests.id_test->eq_test->inst_identity, lRare.local_singleton_id_identity_set);
+                thisAgent->explanationBasedChunker->force_id_to_identity_mapping(cond->data.tests.value_test->eq_test->inst_identity, lRare.local_singleton_value_identity_set);
+                set_test_identity(thisAgent, cond->data.tests.id_test->eq_test, lRare.local_singleton_id_identity_set);
+                set_test_identity(thisAgent, cond->data.tests.value_test->eq_test, lRare.local_singleton_value_identity_set);
                 thisAgent->explanationMemory->increment_stat_identity_propagations();
             }
             if (lDoIdentities)
@@ -1042,6 +1152,14 @@ void create_instantiation(agent* thisAgent, production* prod, struct token_struc
     bool trace_it;
     int64_t index;
     Symbol** cell;
+    rhs_program* prog;
+    uint32_t action_index;
+    wme* local_wmes[RHS_PROGRAM_LOCAL_SIZE];
+    std::vector<wme*> big_wmes;
+    wme** wmes;
+    token* t;
+
+    thisAgent->explanationBasedChunker->ebc_timers->instantiation_creation->start();
 
     init_instantiation(thisAgent, inst, thisAgent->symbolManager->soarSymbols.architecture_inst_symbol, prod, tok, w);
     inst->next = thisAgent->newly_created_instantiations;
@@ -1120,18 +1238,36 @@ void create_instantiation(agent* thisAgent, production* prod, struct token_struc
         xml_object(thisAgent, kTagActionSideMarker);
     }
 
+    /* look up the wmes the RHS can refer to, walking up the token just once */
+    prog = prod->compiled_rhs;
+    assert(prog);
+    wmes = local_wmes;
+    if (prog->max_levels_up >= RHS_PROGRAM_LOCAL_SIZE)
+    {
+        big_wmes.resize(prog->max_levels_up + 1);
+        wmes = &big_wmes[0];
+    }
+    wmes[0] = w;
+    t = tok;
+    for (index = 1; index <= prog->max_levels_up; index++)
+    {
+        wmes[index] = t->w;
+        t = t->parent;
+    }
+
     /* execute the RHS actions, collect the results */
     a2 = rhs_vars;
+    action_index = 0;
 
-    for (a = prod->action_list; a != NIL; a = a->next)
+    for (a = prod->action_list; a != NIL; a = a->next, action_index++)
     {
         if (prod->type != TEMPLATE_PRODUCTION_TYPE)
         {
             if (a2 && isSubGoalMatch)
             {
-                pref = execute_action(thisAgent, a, tok, w, a2);
+                pref = execute_action(thisAgent, a, prog, action_index, wmes, a2);
             } else {
-                pref = execute_action(thisAgent, a, tok, w, NULL);
+                pref = execute_action(thisAgent, a, prog, action_index, wmes, NULL);
             }
         }
         else
@@ -1185,6 +1321,8 @@ void create_instantiation(agent* thisAgent, production* prod, struct token_struc
 
     if (isSubGoalMatch) thisAgent->explanationBasedChunker->clear_symbol_identity_map();
 
+    thisAgent->explanationBasedChunker->ebc_timers->instantiation_creation->stop();
+
     if (isSubGoalMatch)
     {
         /* Copy any operator selection knowledge preferences for conditions of this instantiation */
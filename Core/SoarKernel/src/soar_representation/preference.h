@@ -114,22 +114,15 @@ typedef struct preference_struct
     bool                            o_supported;        /* is the preference o-supported? */
     bool                            in_tm;              /* is this currently in TM? */
     bool                            on_goal_list;       /* is this pref on the list for its match goal */
+    bool                            rl_contribution;
     goal_stack_level                level;
+    unsigned int                    total_preferences_for_candidate;
     uint64_t                        reference_count;
     Symbol*                         id;
     Symbol*                         attr;
     Symbol*                         value;
     Symbol*                         referent;
 
-    identity_set_quadruple          identities;                             /* identity sets for all four elements */
-    identity_quadruple              inst_identities;                        /* identities for a preferences in relation to instantiation that created*/
-    identity_quadruple              chunk_inst_identities;                  /* identities for a result preference in relation to chunk formed*/
-    rhs_quadruple                   rhs_func_inst_identities;               /* identities of syms in rhs functions*/
-    rhs_quadruple                   rhs_func_chunk_inst_identities;         /* identities of syms in chunk instantiation's rhs functions */
-
-    bool_quadruple                  was_unbound_vars;                       /* Whether a RHS variable is a newly created unbound RHS var.  Used by re-orderer */
-    action*                         parent_action;                          /* Action that created pref.  Used by the explainer */
-
     struct slot_struct*             slot;
     struct preference_struct*       next, *prev;                            /* dll of pref's of same type in same slot */
     struct preference_struct*       all_of_slot_next, *all_of_slot_prev;    /* dll of all pref's in same slot */
@@ -141,12 +134,20 @@ typedef struct preference_struct
     struct preference_struct*       next_candidate;
     struct preference_struct*       next_result;
 
-    unsigned int                    total_preferences_for_candidate;
     double                          numeric_value;
-    bool                            rl_contribution;
     double                          rl_rho;                                 /* ratio of target policy to behavior policy */
 
     wme_set*                        wma_o_set;
+
+    /* EBC and explainer bookkeeping */
+    identity_set_quadruple          identities;                             /* identity sets for all four elements */
+    identity_quadruple              inst_identities;                        /* identities for a preferences in relation to instantiation that created*/
+    identity_quadruple              chunk_inst_identities;                  /* identities for a result preference in relation to chunk formed*/
+    rhs_quadruple                   rhs_func_inst_identities;               /* identities of syms in rhs functions*/
+    rhs_quadruple                   rhs_func_chunk_inst_identities;         /* identities of syms in chunk instantiation's rhs functions */
+
+    bool_quadruple                  was_unbound_vars;                       /* Whether a RHS variable is a newly created unbound RHS var.  Used by re-orderer */
+    action*                         parent_action;                          /* Action that created pref.  Used by the explainer */
 } preference;
 
 preference* make_preference(agent* thisAgent, PreferenceType type, Symbol* id, Symbol* attr, Symbol* value, Symbol* referent = NULL,
@@ -31,6 +31,8 @@
 
 #include <ctype.h>
 #include <stdlib.h>
+#include <string>
+#include <vector>
 
 void init_production_utilities(agent* thisAgent)
 {
@@ -429,6 +431,7 @@ production* make_production(agent*          thisAgent,
     p->trace_firings = false;
     p->p_node = NIL;               /* it's not in the Rete yet */
     p->action_list = *rhs_top;
+    p->compiled_rhs = NIL;          /* the Rete fills this in */
     p->rhs_unbound_variables = NIL; /* the Rete fills this in */
     p->instantiations = NIL;
     p->interrupt = false;
@@ -478,6 +481,7 @@ void deallocate_production(agent* thisAgent, production* prod)
     }
 
     deallocate_action_list(thisAgent, prod->action_list);
+    deallocate_rhs_program(thisAgent, prod->compiled_rhs);
     thisAgent->symbolManager->deallocate_symbol_list_removing_references(prod->rhs_unbound_variables);
     thisAgent->symbolManager->symbol_remove_ref(&prod->name);
 
@@ -549,6 +553,110 @@ void excise_all_productions(agent* thisAgent, bool print_sharp_sign,  bool cache
     }
 }
 
+/* ----------------------------------------------------------------
+   Reorders the conditions of a rule already in the rete using the
+   match statistics the alpha memories have gathered, and rebuilds
+   the rule if that gives a different order.  The rebuilt rule is
+   just like one re-sourced with the same name:  its instantiations
+   are retracted and it matches again from scratch.  Its firing
+   count, watches and RL values carry over.  Returns true if the
+   rule was rebuilt.
+------------------------------------------------------------------*/
+
+bool reorder_production_with_match_statistics(agent* thisAgent, production* prod)
+{
+    condition *lhs_top, *lhs_bottom, *c;
+    action* rhs;
+    std::vector<condition*> old_order;
+    bool reordered;
+
+    if ((prod->type == JUSTIFICATION_PRODUCTION_TYPE) || (prod->type == TEMPLATE_PRODUCTION_TYPE) || !prod->p_node)
+    {
+        return false;
+    }
+
+    p_node_to_conditions_and_rhs(thisAgent, prod->p_node, NIL, NIL, &lhs_top, &lhs_bottom, &rhs);
+    for (c = lhs_top; c != NIL; c = c->next)
+    {
+        old_order.push_back(c);
+    }
+
+    thisAgent->name_of_production_being_reordered = prod->name->sc->name;
+    thisAgent->reorder_with_match_statistics = true;
+    ProdReorderFailureType result = reorder_and_validate_lhs_and_rhs(thisAgent, &lhs_top, &rhs, true);
+    thisAgent->reorder_with_match_statistics = false;
+
+    reordered = false;
+    if (result == reorder_success)
+    {
+        size_t i = 0;
+        for (c = lhs_top; (c != NIL) && !reordered; c = c->next, i++)
+        {
+            reordered = (i >= old_order.size()) || (old_order[i] != c);
+        }
+    }
+    if (!reordered)
+    {
+        deallocate_condition_list(thisAgent, lhs_top);
+        deallocate_action_list(thisAgent, rhs);
+        return false;
+    }
+
+    /* --- save what the new production should inherit before the old one goes --- */
+    ProductionType type = prod->type;
+    Symbol* name = prod->name;
+    std::string original_rule_name(prod->original_rule_name);
+    char* documentation = prod->documentation;
+    char* filename = prod->filename;
+    SupportType declared_support = prod->declared_support;
+    byte interrupt = prod->interrupt;
+    bool interrupt_break = prod->interrupt_break;
+    bool trace_firings = prod->trace_firings;
+    uint64_t firing_count = prod->firing_count;
+    bool explain_its_chunks = prod->explain_its_chunks;
+    double rl_update_count = prod->rl_update_count;
+    double rl_delta_bar_delta_beta = prod->rl_delta_bar_delta_beta;
+    double rl_delta_bar_delta_h = prod->rl_delta_bar_delta_h;
+    double rl_ecr = prod->rl_ecr;
+    double rl_efr = prod->rl_efr;
+    double rl_gql = prod->rl_gql;
+
+    prod->documentation = NIL;
+    prod->filename = NIL;
+    thisAgent->symbolManager->symbol_add_ref(name);
+    excise_production(thisAgent, prod, false, true);
+
+    production* p = make_production(thisAgent, type, name, const_cast<char*>(original_rule_name.c_str()), &lhs_top, &rhs, true, NULL);
+    p->documentation = documentation;
+    p->filename = filename;
+    p->declared_support = declared_support;
+    p->interrupt = interrupt;
+    p->interrupt_break = interrupt_break;
+    p->firing_count = firing_count;
+    p->explain_its_chunks = explain_its_chunks;
+    p->rl_update_count = rl_update_count;
+    p->rl_delta_bar_delta_beta = rl_delta_bar_delta_beta;
+    p->rl_delta_bar_delta_h = rl_delta_bar_delta_h;
+    p->rl_ecr = rl_ecr;
+    p->rl_efr = rl_efr;
+    p->rl_gql = rl_gql;
+
+    production* duplicate_rule = NULL;
+    if (add_production_to_rete(thisAgent, p, lhs_top, NIL, false, duplicate_rule) == DUPLICATE_PRODUCTION)
+    {
+        thisAgent->outputManager->printa_sf(thisAgent, "Reordered rule %y duplicates rule %y, so it was excised.\n", name, duplicate_rule->name);
+        excise_production(thisAgent, p, false);
+    }
+    else if (trace_firings)
+    {
+        add_pwatch(thisAgent, p);
+    }
+    deallocate_condition_list(thisAgent, lhs_top);
+    thisAgent->name_of_production_being_reordered = NULL;
+
+    return true;
+}
+
 /****************************/
 /* ----------------------------------------------------------------
  This returns a boolean that indicates that one condition is
@@ -17,6 +17,7 @@ typedef struct production_struct
     char*                           filename;                   /* name of source file, or NIL. */
     SupportType                     declared_support;
     action*                         action_list;                /* RHS actions */
+    rhs_program*                    compiled_rhs;               /* action_list compiled for firing */
     cons*                           rhs_unbound_variables;      /* RHS vars not bound on LHS */
     int                             OPERAND_which_assert_list;
     bool                            trace_firings;              /* used by pwatch */
@@ -173,6 +174,7 @@ production* make_production(agent* thisAgent, ProductionType type,
 void deallocate_production(agent* thisAgent, production* prod);
 void excise_production(agent* thisAgent, production* prod, bool print_sharp_sign = true, bool cacheProdForExplainer = false);
 void excise_all_productions_of_type(agent* thisAgent, byte type, bool print_sharp_sign, bool cacheProdForExplainer = false);
+bool reorder_production_with_match_statistics(agent* thisAgent, production* prod);
 void excise_all_productions(agent* thisAgent, bool print_sharp_sign, bool cacheProdForExplainer = false);
 
 inline void production_add_ref(production* p)
@@ -221,6 +223,10 @@ inline void production_remove_ref(agent* thisAgent, production* p)
 
       action_list:  singly-linked list of the RHS actions of the production.
 
+      compiled_rhs:  the action list compiled into a flat program (see rhs.h)
+        when the production is added to the Rete, and used to fire it.  NIL
+        until then.
+
       rhs_unbound_variables:  A (consed) list of variables used on the RHS
         that aren't bound on the LHS, in the order of their indices (for
         rhs_values).  For chunks, this is NIL, since we discard chunk
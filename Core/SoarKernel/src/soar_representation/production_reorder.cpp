@@ -25,6 +25,7 @@
 #include "preference.h"
 #include "print.h"
 #include "production.h"
+#include "rete.h"
 #include "rhs.h"
 #include "run_soar.h"
 #include "soar_TraceNames.h"
@@ -904,6 +905,30 @@ int64_t get_cost_of_possible_multi_attribute(agent* thisAgent, Symbol* sym)
     return 1;
 }
 
+/* -------------------------------------------------------------
+   Returns the branching factor for an unbound value under the
+   given attribute.  While a chunk is being reordered with match
+   statistics, a constant attribute uses the average number of
+   values per id that the rete has actually seen for it, instead
+   of the fixed estimate.
+------------------------------------------------------------- */
+
+#define MAX_OBSERVED_BF 100000      /* keeps observed costs under MAX_COST */
+
+int64_t get_branching_factor_for_values(agent* thisAgent, Symbol* attr, bool acceptable)
+{
+    uint64_t observed;
+
+    if (thisAgent->reorder_with_match_statistics && attr && !attr->is_variable() &&
+            get_values_per_id_for_attribute(thisAgent, attr, acceptable, &observed))
+    {
+        if (observed < 1) return 1;
+        if (observed > MAX_OBSERVED_BF) return MAX_OBSERVED_BF;
+        return static_cast<int64_t>(observed);
+    }
+    return acceptable ? BF_FOR_ACCEPTABLE_PREFS : BF_FOR_VALUES;
+}
+
 /* -------------------------------------------------------------
    Return an estimate of the "cost" of the given condition.
    The current TC should be the set of previously bound variables;
@@ -941,14 +966,8 @@ int64_t cost_of_adding_condition(agent* thisAgent, condition* cond, tc_number tc
 
         if (!(cond->data.tests.value_test->data.referent->is_constant_or_marked_variable(tc)))
         {
-            if (cond->test_for_acceptable_preference)
-            {
-                result = result * BF_FOR_ACCEPTABLE_PREFS;
-            }
-            else
-            {
-                result = result * BF_FOR_VALUES;
-            }
+            result = result * get_branching_factor_for_values(thisAgent,
+                     cond->data.tests.attr_test->data.referent, cond->test_for_acceptable_preference);
         }
         return result;
     } /* --- end of common simple case --- */
@@ -973,14 +992,9 @@ int64_t cost_of_adding_condition(agent* thisAgent, condition* cond, tc_number tc
         if (! test_covered_by_bound_vars(cond->data.tests.value_test, tc,
                                          root_vars_not_bound_yet))
         {
-            if (cond->test_for_acceptable_preference)
-            {
-                result = result * BF_FOR_ACCEPTABLE_PREFS;
-            }
-            else
-            {
-                result = result * BF_FOR_VALUES;
-            }
+            result = result * get_branching_factor_for_values(thisAgent,
+                     cond->data.tests.attr_test->eq_test ? cond->data.tests.attr_test->eq_test->data.referent : NIL,
+                     cond->test_for_acceptable_preference);
         }
         return result;
     }
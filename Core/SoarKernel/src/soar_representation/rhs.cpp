@@ -11,6 +11,7 @@
 #include "symbol.h"
 #include "test.h"
 
+#include <cassert>
 #include <stdlib.h>
 
 test var_test_bound_in_reconstructed_conds(
@@ -142,6 +143,172 @@ void deallocate_action_list(agent* thisAgent, action* actions)
     }
 }
 
+/*--------------------------------------------------------------
+   Compiling action lists into rhs_programs (see rhs.h).
+
+   Only the fields that execute_action() evaluates are compiled:
+   the value of a funcall action, and the id, attr, value and (for
+   binary preferences) referent of a make action.
+--------------------------------------------------------------*/
+
+static void get_compiled_action_fields(action* a, rhs_value* fields)
+{
+    fields[0] = fields[1] = fields[2] = fields[3] = NIL;
+    if (a->type == FUNCALL_ACTION)
+    {
+        fields[2] = a->value;
+        return;
+    }
+    fields[0] = a->id;
+    fields[1] = a->attr;
+    fields[2] = a->value;
+    if (preference_is_binary(a->preference_type))
+    {
+        fields[3] = a->referent;
+    }
+}
+
+static uint32_t count_rhs_ops(rhs_value rv)
+{
+    cons* c;
+    uint32_t count;
+
+    if (!rhs_value_is_funcall(rv))
+    {
+        return 1;
+    }
+    count = 1;
+    for (c = rhs_value_to_funcall_list(rv)->rest; c != NIL; c = c->rest)
+    {
+        count += count_rhs_ops(static_cast<char*>(c->first));
+    }
+    return count;
+}
+
+/* Emits the ops for rv at prog->ops[next_op] and returns the most values
+ * they have on the stack at once */
+static uint32_t emit_rhs_ops(rhs_program* prog, rhs_value rv, uint32_t& next_op)
+{
+    rhs_op* op;
+    cons* fl;
+    cons* c;
+    uint32_t num_args, depth, max_depth;
+
+    if (rhs_value_is_funcall(rv))
+    {
+        fl = rhs_value_to_funcall_list(rv);
+        num_args = 0;
+        max_depth = 1;
+        for (c = fl->rest; c != NIL; c = c->rest)
+        {
+            depth = num_args + emit_rhs_ops(prog, static_cast<char*>(c->first), next_op);
+            if (depth > max_depth)
+            {
+                max_depth = depth;
+            }
+            num_args++;
+        }
+        op = &prog->ops[next_op++];
+        op->type = RHS_OP_FUNCALL;
+        op->num_args = num_args;
+        op->function = static_cast<rhs_function*>(fl->first);
+        return max_depth;
+    }
+
+    op = &prog->ops[next_op++];
+    op->num_args = 0;
+    if (rhs_value_is_symbol(rv))
+    {
+        op->type = RHS_OP_SYMBOL;
+        op->sym = rhs_value_to_symbol(rv);
+    }
+    else if (rhs_value_is_reteloc(rv))
+    {
+        op->type = RHS_OP_RETELOC;
+        op->reteloc.levels_up = rhs_value_to_reteloc_levels_up(rv);
+        op->reteloc.field_num = rhs_value_to_reteloc_field_num(rv);
+        if (op->reteloc.levels_up > prog->max_levels_up)
+        {
+            prog->max_levels_up = op->reteloc.levels_up;
+        }
+    }
+    else
+    {
+        op->type = RHS_OP_UNBOUNDVAR;
+        op->unboundvar_index = rhs_value_to_unboundvar(rv);
+    }
+    return 1;
+}
+
+rhs_program* compile_rhs_program(agent* thisAgent, action* actions)
+{
+    rhs_program* prog;
+    action* a;
+    rhs_value fields[4];
+    uint32_t num_ops, next_op, next_field, depth;
+    int f;
+
+    prog = static_cast<rhs_program*>(thisAgent->memoryManager->allocate_memory(sizeof(rhs_program), MISCELLANEOUS_MEM_USAGE));
+    prog->num_actions = 0;
+    prog->max_stack_depth = 0;
+    prog->max_levels_up = 0;
+
+    num_ops = 0;
+    for (a = actions; a != NIL; a = a->next)
+    {
+        get_compiled_action_fields(a, fields);
+        for (f = 0; f < 4; f++)
+        {
+            if (fields[f])
+            {
+                num_ops += count_rhs_ops(fields[f]);
+            }
+        }
+        prog->num_actions++;
+    }
+
+    prog->ops = NIL;
+    if (num_ops)
+    {
+        prog->ops = static_cast<rhs_op*>(thisAgent->memoryManager->allocate_memory(num_ops * sizeof(rhs_op), MISCELLANEOUS_MEM_USAGE));
+    }
+    prog->field_starts = static_cast<uint32_t*>(thisAgent->memoryManager->allocate_memory((4 * prog->num_actions + 1) * sizeof(uint32_t), MISCELLANEOUS_MEM_USAGE));
+
+    next_op = 0;
+    next_field = 0;
+    for (a = actions; a != NIL; a = a->next)
+    {
+        get_compiled_action_fields(a, fields);
+        for (f = 0; f < 4; f++)
+        {
+            prog->field_starts[next_field++] = next_op;
+            if (fields[f])
+            {
+                depth = emit_rhs_ops(prog, fields[f], next_op);
+                if (depth > prog->max_stack_depth)
+                {
+                    prog->max_stack_depth = depth;
+                }
+            }
+        }
+    }
+    prog->field_starts[next_field] = next_op;
+    assert(next_op == num_ops);
+
+    return prog;
+}
+
+void deallocate_rhs_program(agent* thisAgent, rhs_program* prog)
+{
+    if (!prog) return;
+    if (prog->ops)
+    {
+        thisAgent->memoryManager->free_memory(prog->ops, MISCELLANEOUS_MEM_USAGE);
+    }
+    thisAgent->memoryManager->free_memory(prog->field_starts, MISCELLANEOUS_MEM_USAGE);
+    thisAgent->memoryManager->free_memory(prog, MISCELLANEOUS_MEM_USAGE);
+}
+
 /*---------------------------------------------------------------
    Find first letter of rhs_value, or '*' if nothing appropriate.
    (See comments on first_letter_from_symbol for more explanation.)
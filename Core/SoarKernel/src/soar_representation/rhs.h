@@ -84,6 +84,61 @@ typedef struct action_struct
     struct action_struct*   next;
 } action;
 
+/* -------------------------------------------------------------------
+                          Compiled RHS Programs
+
+   When a production is added to the Rete, its action list is compiled
+   into a flat array of rhs_op's so that firing it doesn't have to walk
+   the tagged rhs_value trees and cons lists of every action.
+
+   Each field of each action (id, attr, value, referent) becomes a run of
+   ops in postfix order:  symbols, Rete locations and unbound variables
+   each push one value, and a funcall pops its num_args arguments and
+   pushes its result.  The ops for field f of action i are
+
+      ops[field_starts[4*i+f] .. field_starts[4*i+f+1])
+
+   and an empty run means the field is NIL.  Rete locations keep their
+   levels_up, so the firer can look up every wme the rule's actions need
+   with a single walk up the token (max_levels_up is the deepest one).
+   max_stack_depth is the most values any one field pushes at once.
+
+   The program borrows the symbols of the action list without adding
+   references, so it must be recompiled whenever any rhs_value in the
+   action list is replaced.  The one exception is swapping one symbol for
+   another, which can just update the sym of that field's single
+   RHS_OP_SYMBOL op (RL does this for the numeric-indifferent value).
+------------------------------------------------------------------- */
+
+typedef struct rhs_op_struct
+{
+    RHSOpType               type;
+    uint32_t                num_args;       /* for RHS_OP_FUNCALL */
+    union
+    {
+        Symbol*             sym;
+        rhs_function*       function;
+        uint64_t            unboundvar_index;
+        struct
+        {
+            uint16_t        levels_up;
+            byte            field_num;
+        } reteloc;
+    };
+} rhs_op;
+
+typedef struct rhs_program_struct
+{
+    rhs_op*                 ops;
+    uint32_t*               field_starts;
+    uint32_t                num_actions;
+    uint32_t                max_stack_depth;
+    uint16_t                max_levels_up;
+} rhs_program;
+
+rhs_program*    compile_rhs_program(agent* thisAgent, action* actions);
+void            deallocate_rhs_program(agent* thisAgent, rhs_program* prog);
+
 /* -- Used by cli_productionfind.cpp and related functions -- */
 typedef struct binding_structure
 {
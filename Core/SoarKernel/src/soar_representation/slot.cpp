@@ -26,6 +26,89 @@
    decider.
 ====================================================================== */
 
+/* -----------------------------------------------------------------
+                          Slot Index
+
+   Keyed on the attribute's hash_id, which is unique per symbol.  Deletion
+   shifts later entries of a probe run back instead of leaving tombstones,
+   so a lookup always stops at the first empty entry.
+----------------------------------------------------------------- */
+
+inline uint32_t slot_index_home(slot_index* idx, Symbol* attr)
+{
+    return (attr->hash_id * 2654435761u) & (idx->size - 1);
+}
+
+static void slot_index_insert(slot_index* idx, slot* s)
+{
+    uint32_t i = slot_index_home(idx, s->attr);
+    while (idx->entries[i])
+    {
+        i = (i + 1) & (idx->size - 1);
+    }
+    idx->entries[i] = s;
+    idx->count++;
+}
+
+static void slot_index_remove(slot_index* idx, slot* s)
+{
+    uint32_t mask = idx->size - 1;
+    uint32_t i = slot_index_home(idx, s->attr);
+    while (idx->entries[i] != s)
+    {
+        if (!idx->entries[i])
+        {
+            return;
+        }
+        i = (i + 1) & mask;
+    }
+    idx->entries[i] = NIL;
+    idx->count--;
+
+    /* --- move back any later entry of the run that can't be found past the hole now --- */
+    uint32_t hole = i;
+    for (i = (i + 1) & mask; idx->entries[i]; i = (i + 1) & mask)
+    {
+        uint32_t home = slot_index_home(idx, idx->entries[i]->attr);
+        if (((i - home) & mask) >= ((i - hole) & mask))
+        {
+            idx->entries[hole] = idx->entries[i];
+            idx->entries[i] = NIL;
+            hole = i;
+        }
+    }
+}
+
+static void free_slot_index(agent* thisAgent, Symbol* id)
+{
+    thisAgent->memoryManager->free_memory(id->id->slot_index, MISCELLANEOUS_MEM_USAGE);
+    id->id->slot_index = NIL;
+}
+
+/* Builds the index from the slot list, sized to stay under 3/4 full until num_slots doubles */
+static void build_slot_index(agent* thisAgent, Symbol* id)
+{
+    uint32_t size = SLOT_INDEX_THRESHOLD * 2;
+    while (size < id->id->num_slots * 4)
+    {
+        size *= 2;
+    }
+
+    if (id->id->slot_index)
+    {
+        free_slot_index(thisAgent, id);
+    }
+    slot_index* idx = static_cast<slot_index*>(thisAgent->memoryManager->allocate_memory_and_zerofill(sizeof(slot_index) + size * sizeof(slot*), MISCELLANEOUS_MEM_USAGE));
+    idx->size = size;
+    idx->count = 0;
+    idx->entries = reinterpret_cast<slot**>(idx + 1);
+    for (slot* s = id->id->slots; s != NIL; s = s->next)
+    {
+        slot_index_insert(idx, s);
+    }
+    id->id->slot_index = idx;
+}
+
 slot* find_slot(Symbol* id, Symbol* attr)
 {
     slot* s;
@@ -34,6 +117,18 @@ slot* find_slot(Symbol* id, Symbol* attr)
     {
         return NIL;    /* fixes bug #135 kjh */
     }
+    slot_index* idx = id->id->slot_index;
+    if (idx)
+    {
+        for (uint32_t i = slot_index_home(idx, attr); (s = idx->entries[i]) != NIL; i = (i + 1) & (idx->size - 1))
+        {
+            if (s->attr == attr)
+            {
+                return s;
+            }
+        }
+        return NIL;
+    }
     for (s = id->id->slots; s != NIL; s = s->next)
         if (s->attr == attr)
         {
@@ -49,12 +144,10 @@ slot* make_slot(agent* thisAgent, Symbol* id, Symbol* attr)
 
     /* Search for a slot first.  If it exists
     *  for the given symbol, then just return it */
-    for (s = id->id->slots; s != NIL; s = s->next)
+    s = find_slot(id, attr);
+    if (s)
     {
-        if (s->attr == attr)
-        {
-            return s;
-        }
+        return s;
     }
 
     /* Need to create a new slot */
@@ -97,6 +190,16 @@ slot* make_slot(agent* thisAgent, Symbol* id, Symbol* attr)
 
     s->wma_val_references = NIL;
 
+    id->id->num_slots++;
+    if (id->id->slot_index && (id->id->slot_index->count + 1) * 4 <= id->id->slot_index->size * 3)
+    {
+        slot_index_insert(id->id->slot_index, s);
+    }
+    else if (id->id->num_slots >= SLOT_INDEX_THRESHOLD)
+    {
+        build_slot_index(thisAgent, id);
+    }
+
     return s;
 }
 
@@ -194,6 +297,18 @@ void remove_garbage_slots(agent* thisAgent)
             thisAgent->memoryManager->free_with_pool(MP_dl_cons, s->changed);
         }
         remove_from_dll(s->id->id->slots, s, next, prev);
+        s->id->id->num_slots--;
+        if (s->id->id->slot_index)
+        {
+            if (s->id->id->num_slots < SLOT_INDEX_THRESHOLD / 2)
+            {
+                free_slot_index(thisAgent, s->id);
+            }
+            else
+            {
+                slot_index_remove(s->id->id->slot_index, s);
+            }
+        }
         thisAgent->symbolManager->symbol_remove_ref(&s->id);
         thisAgent->symbolManager->symbol_remove_ref(&s->attr);
         if (s->wma_val_references != NIL)
@@ -24,6 +24,13 @@
    of the same production firing, for example).  At the end of the phase,
    we call remove_garbage_slots(), which scans through each marked slot
    and garbage collects it if it has no wmes or preferences.
+
+   Identifiers with many slots (input-link and world-model objects often
+   have hundreds of attributes) also keep a slot_index, a small
+   open-addressing hash table from attribute to slot, so that finding a
+   slot doesn't mean walking all of them.  The index is built when an
+   identifier reaches SLOT_INDEX_THRESHOLD slots and dropped again when it
+   falls below half that.
 --------------------------------------------------------------------- */
 
 #ifndef TEMPMEM_H
@@ -58,6 +65,15 @@ typedef struct slot_struct
 
 } slot;
 
+#define SLOT_INDEX_THRESHOLD 16
+
+typedef struct slot_index_struct
+{
+    uint32_t size;      /* number of entries, always a power of two */
+    uint32_t count;     /* number of non-NIL entries */
+    slot** entries;     /* linear probing, no tombstones */
+} slot_index;
+
 extern slot* find_slot(Symbol* id, Symbol* attr);
 extern slot* make_slot(agent* thisAgent, Symbol* id, Symbol* attr);
 extern void mark_slot_as_changed(agent* thisAgent, slot* s);
@@ -130,6 +130,7 @@ struct intSymbol   : public Symbol
 struct strSymbol   : public Symbol
 {
     char* name;
+    uint32_t name_hash;                     /* hash_string(name), see symbol_manager.cpp */
     struct production_struct* production;
     agent* thisAgent;
     char* cached_rereadable_print_str;
@@ -177,6 +178,8 @@ struct idSymbol    : public Symbol
     dl_cons* unknown_level;
 
     struct slot_struct* slots;  /* dll of slots for this identifier */
+    struct slot_index_struct* slot_index;  /* NIL unless it has many slots */
+    uint32_t num_slots;
 
     /* --- fields used only on goals and impasse identifiers --- */
     struct wme_struct* impasse_wmes;
@@ -333,6 +336,8 @@ double get_number_from_symbol(Symbol* sym);
  *                             figure out whether a given object is an operator.
  * name_number, name_letter    Name and letter of the identifier
  * slots                       DLL of all slots this symbol is used in
+ * slot_index, num_slots       Hash index over slots, kept once there are many of
+ *                             them, and how many there are (see slot.h)
  * tc_num                      Unique numbers put in here to mark ID for things like
  *                             transitive closures
  * variablization              When variablizing chunks, this points to the variable to
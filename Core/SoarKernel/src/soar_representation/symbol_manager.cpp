@@ -20,6 +20,7 @@
 #include "symbol.h"
 
 #include <cinttypes>
+#include <cstring>
 
 Symbol_Manager::Symbol_Manager(agent* pAgent)
 {
@@ -27,6 +28,9 @@ Symbol_Manager::Symbol_Manager(agent* pAgent)
     thisAgent->symbolManager = this;
     current_symbol_hash_id             = 0;
     current_variable_gensym_number     = 0;
+    #ifdef DEBUG_SYMBOL_REFCOUNTS
+        net_symbol_refs                = 0;
+    #endif
     init_symbol_tables();
     create_predefined_symbols();
     create_common_variables_and_numbers();
@@ -48,7 +52,11 @@ Symbol_Manager::~Symbol_Manager()
    bits, xor-ing pieces of the 32-bit value to avoid throwing away bits
    that might be important for the hash function to be effective.
 
-   Hash_string() produces a hash value for a string of characters.
+   Hash_string() produces a hash value for a string of characters.  It
+   mixes the string eight bytes at a time rather than a byte at a time.
+   String constants keep the full 32-bit hash of their name, so tables
+   resize without rehashing them and lookups skip strcmp() on most
+   mismatches.
 
    Hash_xxx_raw_info() are the hash functions for the five kinds of
    symbols.  These functions operate on the basic info about the symbol
@@ -79,17 +87,35 @@ uint32_t compress(uint32_t h, short num_bits)
     return result;
 }
 
-uint32_t hash_string(const char* s)      /* AGR 600 */
+uint32_t hash_string(const char* s, size_t len)
 {
-    uint32_t h;
+    uint64_t h = 0x9E3779B97F4A7C15ULL ^ len;
+    uint64_t w;
 
-    h = 0;
-    while (*s != 0)
+    while (len >= 8)
     {
-        h = ((h << 8) | (h >> 24)) ^ (*s);
-        s++;
+        memcpy(&w, s, 8);
+        h = (h ^ w) * 0xFF51AFD7ED558CCDULL;
+        h ^= h >> 32;
+        s += 8;
+        len -= 8;
     }
-    return h;
+    if (len)
+    {
+        w = 0;
+        memcpy(&w, s, len);
+        h = (h ^ w) * 0xC4CEB9FE1A85EC53ULL;
+        h ^= h >> 29;
+    }
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDULL;
+    h ^= h >> 33;
+    return static_cast<uint32_t>(h) ^ static_cast<uint32_t>(h >> 32);
+}
+
+uint32_t hash_string(const char* s)
+{
+    return hash_string(s, strlen(s));
 }
 
 /* -----------------------------------------
@@ -145,7 +171,7 @@ uint32_t hash_str_constant(void* item, short num_bits)
 {
     strSymbol* sc;
     sc = static_cast<strSymbol*>(item);
-    return compress(hash_string(sc->name), num_bits);
+    return compress(sc->name_hash, num_bits);
 }
 
 uint32_t hash_int_constant(void* item, short num_bits)
@@ -296,16 +322,20 @@ Symbol* Symbol_Manager::find_identifier(char name_letter, uint64_t name_number)
 }
 
 Symbol* Symbol_Manager::find_str_constant(const char* name)
+{
+    return find_str_constant(name, hash_string(name));
+}
+
+Symbol* Symbol_Manager::find_str_constant(const char* name, uint32_t name_hash)
 {
     uint32_t hash_value;
     strSymbol* sym;
 
-    hash_value = hash_str_constant_raw_info(name,
-                                            str_constant_hash_table->log2size);
+    hash_value = compress(name_hash, str_constant_hash_table->log2size);
     sym = reinterpret_cast<strSymbol*>(*(str_constant_hash_table->buckets + hash_value));
     for (; sym != NIL; sym = static_cast<strSymbol*>(sym->next_in_hash_table))
     {
-        if (!strcmp(sym->name, name))
+        if ((sym->name_hash == name_hash) && !strcmp(sym->name, name))
         {
             return sym;
         }
@@ -428,6 +458,8 @@ Symbol* Symbol_Manager::make_new_identifier(char name_letter, goal_stack_level l
     sym->level = level;
     sym->promotion_level = level;
     sym->slots = NULL;
+    sym->slot_index = NULL;
+    sym->num_slots = 0;
     sym->isa_goal = false;
     sym->isa_impasse = false;
     sym->isa_operator = 0;
@@ -476,6 +508,11 @@ Symbol* Symbol_Manager::make_new_identifier(char name_letter, goal_stack_level l
  * Avoids calling find
  */
 Symbol* Symbol_Manager::make_str_constant_no_find(char const* name)
+{
+    return make_str_constant_no_find(name, hash_string(name));
+}
+
+Symbol* Symbol_Manager::make_str_constant_no_find(char const* name, uint32_t name_hash)
 {
     strSymbol* sym;
 
@@ -490,6 +527,7 @@ Symbol* Symbol_Manager::make_str_constant_no_find(char const* name)
     sym->smem_hash = 0;
     sym->smem_valid = 0;
     sym->name = make_memory_block_for_string(thisAgent, name);
+    sym->name_hash = name_hash;
     sym->thisAgent = thisAgent;
     sym->cached_rereadable_print_str = NULL;
     sym->production = NULL;
@@ -507,13 +545,14 @@ Symbol* Symbol_Manager::make_str_constant_no_find(char const* name)
 Symbol* Symbol_Manager::make_str_constant(char const* name)
 {
     strSymbol* sym;
-    sym = static_cast<strSymbol*>(find_str_constant(name));
+    uint32_t name_hash = hash_string(name);
+    sym = static_cast<strSymbol*>(find_str_constant(name, name_hash));
     if (sym)
     {
         symbol_add_ref(sym);
         return sym;
     }
-    return make_str_constant_no_find(name);
+    return make_str_constant_no_find(name, name_hash);
 }
 
 Symbol* Symbol_Manager::make_int_constant(int64_t value)
@@ -945,6 +984,44 @@ void Symbol_Manager::deallocate_symbol(Symbol*& sym)
     sym = NULL;
 }
 
+#ifdef DEBUG_SYMBOL_REFCOUNTS
+typedef struct refcount_tally_struct
+{
+    uint64_t total_refs;
+    uint64_t unreferenced;
+} refcount_tally;
+
+bool tally_symbol_refcount(agent* /*thisAgent*/, void* item, void* userdata)
+{
+    Symbol* sym = static_cast<symbol_struct*>(item);
+    refcount_tally* tally = static_cast<refcount_tally*>(userdata);
+
+    tally->total_refs += sym->reference_count;
+    if (sym->reference_count == 0) tally->unreferenced++;
+    return false;
+}
+
+bool Symbol_Manager::check_symbol_refcounts()
+{
+    refcount_tally tally = { 0, 0 };
+
+    do_for_all_items_in_hash_table(thisAgent, variable_hash_table, tally_symbol_refcount, &tally);
+    do_for_all_items_in_hash_table(thisAgent, identifier_hash_table, tally_symbol_refcount, &tally);
+    do_for_all_items_in_hash_table(thisAgent, str_constant_hash_table, tally_symbol_refcount, &tally);
+    do_for_all_items_in_hash_table(thisAgent, int_constant_hash_table, tally_symbol_refcount, &tally);
+    do_for_all_items_in_hash_table(thisAgent, float_constant_hash_table, tally_symbol_refcount, &tally);
+
+    if ((tally.total_refs != static_cast<uint64_t>(net_symbol_refs)) || tally.unreferenced)
+    {
+        thisAgent->outputManager->printa_sf(thisAgent, "Symbol refcounts out of balance:  symbols hold %u references, %d were taken and not released, %u symbols are unreferenced.\n",
+            tally.total_refs, net_symbol_refs, tally.unreferenced);
+        return false;
+    }
+    thisAgent->outputManager->printa_sf(thisAgent, "Symbol refcounts balance:  symbols hold %u references.\n", tally.total_refs);
+    return true;
+}
+#endif
+
 /* -------------------------------------------------------------------
                        Other Symbol Utilities
 
@@ -1070,6 +1147,12 @@ void Symbol_Manager::reset_hash_table(MemoryPoolType lHashTable)
                 do_for_all_items_in_hash_table(thisAgent, identifier_hash_table, print_sym, 0);
                 #endif
             }
+            #ifdef DEBUG_SYMBOL_REFCOUNTS
+                /* The leaked references go away with the identifiers */
+                refcount_tally leaked = { 0, 0 };
+                do_for_all_items_in_hash_table(thisAgent, identifier_hash_table, tally_symbol_refcount, &leaked);
+                net_symbol_refs -= leaked.total_refs;
+            #endif
             free_hash_table(thisAgent, identifier_hash_table);
             thisAgent->memoryManager->free_memory_pool(MP_identifier);
             identifier_hash_table = make_hash_table(thisAgent, 0, hash_identifier);
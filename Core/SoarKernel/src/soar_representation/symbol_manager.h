@@ -13,8 +13,10 @@
 #include "symbol.h"
 #include "symbols_predefined.h"
 
+#include <cassert>
 #include <iostream>
 #include <string>
+#include <vector>
 bool is_DT_mode_enabled(TraceMode mode);
 
 class EXPORT Symbol_Manager {
@@ -44,6 +46,7 @@ class EXPORT Symbol_Manager {
         Symbol* make_float_constant(double value);
         Symbol* make_new_identifier(char name_letter, goal_stack_level level, uint64_t name_number = NIL, bool prohibit_S = true);
         Symbol* make_str_constant_no_find(char const* name);
+        Symbol* make_str_constant_no_find(char const* name, uint32_t name_hash);
         Symbol* generate_new_str_constant(const char* prefix, uint64_t* counter);
 
         void deallocate_symbol_list_removing_references(cons*& sym_list);
@@ -52,6 +55,7 @@ class EXPORT Symbol_Manager {
         Symbol* find_variable(const char* name);
         Symbol* find_identifier(char name_letter, uint64_t name_number);
         Symbol* find_str_constant(const char* name);
+        Symbol* find_str_constant(const char* name, uint32_t name_hash);
         Symbol* find_int_constant(int64_t value);
         Symbol* find_float_constant(double value);
 
@@ -87,12 +91,19 @@ class EXPORT Symbol_Manager {
         inline void symbol_add_ref(Symbol* x)
         {
             (x)->reference_count++;
+            #ifdef DEBUG_SYMBOL_REFCOUNTS
+                net_symbol_refs++;
+            #endif
         }
 
         //-- symbol_remove_ref -----------------
 
         inline void symbol_remove_ref(Symbol** x)
         {
+            #ifdef DEBUG_SYMBOL_REFCOUNTS
+                assert((*x)->reference_count > 0);
+                net_symbol_refs--;
+            #endif
             (*x)->reference_count--;
             if ((*x)->reference_count == 0)
             {
@@ -101,6 +112,20 @@ class EXPORT Symbol_Manager {
             }
         }
 
+        /* --------------------------------------------------------------------
+                              Refcount Checking
+
+           Check_symbol_refcounts() is only available with DEBUG_SYMBOL_REFCOUNTS
+           and is run by 'debug symbol-refcounts'.  It checks that the reference
+           counts of all symbols add up to the references taken and not
+           released, and that no unreferenced symbols are left.  It walks every
+           symbol table, so nothing calls it on its own.
+        -------------------------------------------------------------------- */
+
+        #ifdef DEBUG_SYMBOL_REFCOUNTS
+            bool check_symbol_refcounts();
+        #endif
+
     private:
 
         agent*      thisAgent;
@@ -119,6 +144,10 @@ class EXPORT Symbol_Manager {
 
         void deallocate_symbol(Symbol*& sym);
 
+        #ifdef DEBUG_SYMBOL_REFCOUNTS
+            int64_t net_symbol_refs;
+        #endif
+
         uint32_t get_next_symbol_hash_id(agent* thisAgent) { return (current_symbol_hash_id += 137); }
 
 };
@@ -90,6 +90,7 @@ void reset_wme_timetags(agent* thisAgent)
         return;
     }
     thisAgent->current_wme_timetag = 1;
+    thisAgent->WM->wmes_by_timetag.clear();
 }
 
 wme* make_wme(agent* thisAgent, Symbol* id, Symbol* attr, Symbol* value, bool acceptable)
@@ -108,27 +109,25 @@ wme* make_wme(agent* thisAgent, Symbol* id, Symbol* attr, Symbol* value, bool ac
     w->timetag = thisAgent->current_wme_timetag++;
     w->reference_count = 0;
     w->preference = NIL;
-    w->output_link = NIL;
     w->tc = 0;
-    w->chunker_bt_last_ground_cond = NULL;
     w->is_singleton = false;
     w->singleton_status_checked = false;
-    w->local_singleton_id_identity_set = NULL_IDENTITY_SET;
-    w->local_singleton_value_identity_set = NULL_IDENTITY_SET;
     w->next = NIL;
     w->prev = NIL;
     w->rete_next = NIL;
     w->rete_prev = NIL;
+    w->right_mems = NIL;
+    w->tokens = NIL;
 
     w->gds = NIL;
     w->gds_prev = NIL;
     w->gds_next = NIL;
 
-    w->wma_decay_el = NIL;
-    w->wma_tc_value = 0;
-
-    w->epmem_id = EPMEM_NODEID_BAD;
-    w->epmem_valid = NIL;
+#ifdef COMPACT_WMES
+    w->has_rare_fields = false;
+#else
+    w->rare = wme_rare_fields();
+#endif
 
     return w;
 }
@@ -138,6 +137,7 @@ wme* make_wme(agent* thisAgent, Symbol* id, Symbol* attr, Symbol* value, bool ac
 void add_wme_to_wm(agent* thisAgent, wme* w)
 {
     push(thisAgent, w, thisAgent->wmes_to_add);
+    thisAgent->WM->wmes_by_timetag[w->timetag] = w;
 
     if (w->value->symbol_type == IDENTIFIER_SYMBOL_TYPE)
     {
@@ -154,6 +154,12 @@ void remove_wme_from_wm(agent* thisAgent, wme* w)
 
     push(thisAgent, w, thisAgent->wmes_to_remove);
 
+    timetag_to_wme_map::iterator it = thisAgent->WM->wmes_by_timetag.find(w->timetag);
+    if ((it != thisAgent->WM->wmes_by_timetag.end()) && (it->second == w))
+    {
+        thisAgent->WM->wmes_by_timetag.erase(it);
+    }
+
     if (w->value->is_sti())
     {
         post_link_removal(thisAgent, w->id, w->value);
@@ -197,8 +203,9 @@ void remove_wme_list_from_wm(agent* thisAgent, wme* w, bool updateWmeMap)
 
 void do_buffered_wm_changes(agent* thisAgent)
 {
-    cons* c, *next_c, *cr;
+    cons* c, *next_c;
     wme* w;
+    tc_number removed_tc, cancelled_tc;
 
     #ifndef NO_TIMING_STUFF
     #ifdef DETAILED_TIMING_STATS
@@ -217,15 +224,42 @@ void do_buffered_wm_changes(agent* thisAgent)
     /* --- be fetched from the agent structure.                           --- */
     soar_invoke_callbacks(thisAgent, WM_CHANGES_CALLBACK, 0);
 
+    /* --- a wme added and removed in the same phase would only match and
+       unmatch again, so it never goes through the rete at all.  Such wmes
+       are marked with cancelled_tc. --- */
+    cancelled_tc = 0;
+    if (thisAgent->wmes_to_add && thisAgent->wmes_to_remove)
+    {
+        removed_tc = get_new_tc_number(thisAgent);
+        cancelled_tc = get_new_tc_number(thisAgent);
+        for (c = thisAgent->wmes_to_remove; c != NIL; c = c->rest)
+        {
+            static_cast<wme_struct*>(c->first)->tc = removed_tc;
+        }
+        for (c = thisAgent->wmes_to_add; c != NIL; c = c->rest)
+        {
+            w = static_cast<wme_struct*>(c->first);
+            if (w->tc == removed_tc)
+            {
+                w->tc = cancelled_tc;
+            }
+        }
+    }
+
     /* --- stuff wme changes through the rete net --- */
     #ifndef NO_TIMING_STUFF
     #ifdef DETAILED_TIMING_STATS
     local_timer.start();
     #endif
     #endif
+    std::vector<wme*>& wmes_for_rete = thisAgent->WM->wmes_for_rete;
     for (c = thisAgent->wmes_to_add; c != NIL; c = c->rest)
     {
         w = (wme_struct*)(c->first);
+        if (cancelled_tc && (w->tc == cancelled_tc))
+        {
+            continue;
+        }
         #ifdef SPREADING_ACTIVATION_ENABLED
         if (w->id->symbol_type == IDENTIFIER_SYMBOL_TYPE && w->id->id->LTI_ID)
         {//We attempt to keep track of ltis currently in wmem.
@@ -249,11 +283,20 @@ void do_buffered_wm_changes(agent* thisAgent)
         {
             thisAgent->explanationBasedChunker->add_new_singleton(ebc_any, w->attr, ebc_any);
         }
-        add_wme_to_rete(thisAgent, static_cast<wme_struct*>(c->first));
+        wmes_for_rete.push_back(w);
+    }
+    if (!wmes_for_rete.empty())
+    {
+        add_wmes_to_rete(thisAgent, &wmes_for_rete[0], wmes_for_rete.size());
+        wmes_for_rete.clear();
     }
     for (c = thisAgent->wmes_to_remove; c != NIL; c = c->rest)
     {
         w = (wme_struct*)(c->first);
+        if (cancelled_tc && (w->tc == cancelled_tc))
+        {
+            continue;
+        }
         #ifdef SPREADING_ACTIVATION_ENABLED
         if (w->id->symbol_type == IDENTIFIER_SYMBOL_TYPE && w->id->id->LTI_ID)
         {
@@ -287,24 +330,19 @@ void do_buffered_wm_changes(agent* thisAgent)
     #endif
     #endif
     /* --- warn if watching wmes and same wme was added and removed -- */
-    if (thisAgent->trace_settings[TRACE_WM_CHANGES_SYSPARAM])
+    if (cancelled_tc && thisAgent->trace_settings[TRACE_WM_CHANGES_SYSPARAM])
     {
-        for (c = thisAgent->wmes_to_add; c != NIL; c = next_c)
+        for (c = thisAgent->wmes_to_add; c != NIL; c = c->rest)
         {
-            next_c = c->rest;
             w = static_cast<wme_struct*>(c->first);
-            for (cr = thisAgent->wmes_to_remove; cr != NIL; cr = next_c)
+            if (w->tc == cancelled_tc)
             {
-                next_c = cr->rest;
-                if (w == cr->first)
-                {
-                    const char* const kWarningMessage = "WARNING: WME added and removed in same phase : ";
-                    thisAgent->outputManager->printa(thisAgent,  const_cast< char* >(kWarningMessage));
-                    xml_begin_tag(thisAgent, kTagWarning);
-                    xml_att_val(thisAgent, kTypeString, kWarningMessage);
-                    print_wme(thisAgent, w);
-                    xml_end_tag(thisAgent, kTagWarning);
-                }
+                const char* const kWarningMessage = "WARNING: WME added and removed in same phase : ";
+                thisAgent->outputManager->printa(thisAgent,  const_cast< char* >(kWarningMessage));
+                xml_begin_tag(thisAgent, kTagWarning);
+                xml_att_val(thisAgent, kTypeString, kWarningMessage);
+                print_wme(thisAgent, w);
+                xml_end_tag(thisAgent, kTagWarning);
             }
         }
     }
@@ -344,11 +382,15 @@ void deallocate_wme(agent* thisAgent, wme* w)
 {
     if (wma_enabled(thisAgent)) wma_remove_decay_element(thisAgent, w);
 
-    if (w->local_singleton_value_identity_set)
+    if (peek_rare_fields(thisAgent, w).local_singleton_value_identity_set)
     {
-        IdentitySet_remove_ref(thisAgent, w->local_singleton_id_identity_set);
-        IdentitySet_remove_ref(thisAgent, w->local_singleton_value_identity_set);
+        wme_rare_fields& rare = get_rare_fields(thisAgent, w);
+        IdentitySet_remove_ref(thisAgent, rare.local_singleton_id_identity_set);
+        IdentitySet_remove_ref(thisAgent, rare.local_singleton_value_identity_set);
     }
+#ifdef COMPACT_WMES
+    if (w->has_rare_fields) thisAgent->WM->wme_rare_fields_table.erase(w);
+#endif
     thisAgent->symbolManager->symbol_remove_ref(&w->id);
     thisAgent->symbolManager->symbol_remove_ref(&w->attr);
     thisAgent->symbolManager->symbol_remove_ref(&w->value);
@@ -356,6 +398,30 @@ void deallocate_wme(agent* thisAgent, wme* w)
     thisAgent->num_existing_wmes--;
 }
 
+#ifdef COMPACT_WMES
+const wme_rare_fields default_rare_fields;
+
+wme_rare_fields& get_rare_fields(agent* thisAgent, wme* w)
+{
+    w->has_rare_fields = true;
+    return thisAgent->WM->wme_rare_fields_table[w];
+}
+
+const wme_rare_fields& lookup_rare_fields(agent* thisAgent, wme* w)
+{
+    std::unordered_map<wme*, wme_rare_fields>::const_iterator it = thisAgent->WM->wme_rare_fields_table.find(w);
+    if (it == thisAgent->WM->wme_rare_fields_table.end()) return default_rare_fields;
+    return it->second;
+}
+#endif
+
+wme* find_wme_by_timetag(agent* thisAgent, uint64_t timetag)
+{
+    timetag_to_wme_map::iterator it = thisAgent->WM->wmes_by_timetag.find(timetag);
+    if (it == thisAgent->WM->wmes_by_timetag.end()) return NIL;
+    return it->second;
+}
+
 Symbol* find_name_of_object(agent* thisAgent, Symbol* object)
 {
     if (object->symbol_type != IDENTIFIER_SYMBOL_TYPE) return NIL;
@@ -14,11 +14,18 @@
    the caller is responsible for manipulating the appropriate dll.  WM
    changes don't actually get stuffed down the rete until the end of the
    phase, when do_buffered_wm_and_ownership_changes() gets be called.
+   A wme that is added and removed within the same phase never reaches
+   the rete.
 
    Remove_wme_list_from_wm() is a utility routine that scans through a
    list of wmes, linked by their "next" fields, and calls remove_wme_from_wm()
    on each one.
 
+   Find_wme_by_timetag() returns the wme with the given timetag, or NIL if
+   no such wme is in WM.  Add_wme_to_wm() and remove_wme_from_wm() keep the
+   index it uses, so a wme can be found as soon as it is added, before it
+   reaches the rete, and not after it is removed.
+
    Wme_add_ref() and wme_remove_ref() are macros for incrementing and
    decrementing the reference count on a wme.  Deallocate_wme() deallocates
    a wme; this should only be invoked via the wme_remove_ref() macro.
@@ -37,6 +44,37 @@
 #include "semantic_memory.h"
 #include "symbol.h"
 
+#include <vector>
+
+/* Fields most wmes never use.  Normally they sit at the end of the wme; with
+   COMPACT_WMES they are kept in a per-agent side table instead, and only for
+   the wmes that use them.  Read them with peek_rare_fields() and write them
+   with get_rare_fields(). */
+typedef struct wme_rare_fields_struct
+{
+    struct output_link_struct*  output_link;            /* for top-state output commands */
+    struct condition_struct*    chunker_bt_last_ground_cond;
+    Identity*                   local_singleton_id_identity_set;
+    Identity*                   local_singleton_value_identity_set;
+
+    epmem_node_id               epmem_id;
+    uint64_t                    epmem_valid;
+
+    wma_decay_element*          wma_decay_el;
+    tc_number                   wma_tc_value;
+
+    wme_rare_fields_struct()
+    {
+        output_link = NIL;
+        chunker_bt_last_ground_cond = NULL;
+        local_singleton_id_identity_set = NULL_IDENTITY_SET;
+        local_singleton_value_identity_set = NULL_IDENTITY_SET;
+        epmem_id = EPMEM_NODEID_BAD;
+        epmem_valid = NIL;
+        wma_decay_el = NIL;
+        wma_tc_value = 0;
+    }
+} wme_rare_fields;
 
 void reset_wme_timetags(agent* thisAgent);
 wme* make_wme(agent* thisAgent, Symbol* id, Symbol* attr, Symbol* value, bool acceptable);
@@ -44,6 +82,7 @@ void add_wme_to_wm(agent* thisAgent, wme* w);
 void remove_wme_from_wm(agent* thisAgent, wme* w);
 void remove_wme_list_from_wm(agent* thisAgent, wme* w, bool updateWmeMap = false);
 void do_buffered_wm_changes(agent* thisAgent);
+wme* find_wme_by_timetag(agent* thisAgent, uint64_t timetag);
 
 void deallocate_wme(agent* thisAgent, wme* w);
 Symbol* find_name_of_object(agent* thisAgent, Symbol* id);
@@ -74,6 +113,12 @@ class WM_Manager
 
         deep_copy_wme_list      glbDeepCopyWMEs;
 
+        timetag_to_wme_map      wmes_by_timetag;
+#ifdef COMPACT_WMES
+        std::unordered_map<wme*, wme_rare_fields> wme_rare_fields_table;
+#endif
+        std::vector<wme*>       wmes_for_rete;          /* scratch for do_buffered_wm_changes() */
+
     private:
 
         agent*                  thisAgent;
@@ -87,8 +132,15 @@ typedef struct wme_struct
     Symbol*                     attr;
     Symbol*                     value;
     bool                        acceptable;
-    uint64_t                    timetag;
+    bool                        is_singleton;
+    bool                        singleton_status_checked;
+#ifdef COMPACT_WMES
+    bool                        has_rare_fields;        /* has an entry in wme_rare_fields_table */
+    uint32_t                    reference_count;
+#else
     uint64_t                    reference_count;
+#endif
+    uint64_t                    timetag;
 
     struct wme_struct           *rete_next, *rete_prev;
     struct right_mem_struct*    right_mems;
@@ -96,25 +148,39 @@ typedef struct wme_struct
     struct wme_struct           *next, *prev;
 
     struct preference_struct*   preference;             /* pref. supporting it, or NIL */
-    struct output_link_struct*  output_link;            /* for top-state output commands */
-
     tc_number                   tc;
-    struct condition_struct*    chunker_bt_last_ground_cond;
-    bool                        is_singleton;
-    bool                        singleton_status_checked;
-    Identity*                   local_singleton_id_identity_set;
-    Identity*                   local_singleton_value_identity_set;
 
     struct gds_struct*          gds;
     struct wme_struct*          gds_next, *gds_prev;   /* wmes in gds */
 
-    epmem_node_id               epmem_id;
-    uint64_t                    epmem_valid;
-
-    wma_decay_element*          wma_decay_el;
-    tc_number                   wma_tc_value;
+#ifndef COMPACT_WMES
+    wme_rare_fields             rare;
+#endif
 } wme;
 
+#ifdef COMPACT_WMES
+extern const wme_rare_fields default_rare_fields;
+wme_rare_fields& get_rare_fields(agent* thisAgent, wme* w);
+const wme_rare_fields& lookup_rare_fields(agent* thisAgent, wme* w);
+
+/* Most wmes never get a table entry, so check the flag before hashing */
+inline const wme_rare_fields& peek_rare_fields(agent* thisAgent, wme* w)
+{
+    if (!w->has_rare_fields) return default_rare_fields;
+    return lookup_rare_fields(thisAgent, w);
+}
+#else
+inline wme_rare_fields& get_rare_fields(agent* thisAgent, wme* w)
+{
+    return w->rare;
+}
+
+inline const wme_rare_fields& peek_rare_fields(agent* thisAgent, wme* w)
+{
+    return w->rare;
+}
+#endif
+
 inline void wme_add_ref(wme* w, bool always_add = false)
 {
     (w)->reference_count++;
@@ -191,6 +257,11 @@ inline Symbol* get_wme_element(wme* w, WME_Field f)
      dependent for more than one goal, then it will point to the GDS
      of the highest goal.
 
+      rare:  output_link, chunker_bt_last_ground_cond, the local singleton
+         identity sets and the epmem and wma bookkeeping, which most wmes
+         never use.  Building with COMPACT_WMES moves them to a side table
+         and narrows reference_count, so a wme fits in two cache lines.
+
    Reference counts on wmes:
       +1 if the wme is currently in WM
       +1 for each instantiation condition that points to it (bt.wme)
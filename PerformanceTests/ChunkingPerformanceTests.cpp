@@ -0,0 +1,240 @@
+/*
+ * ChunkingPerformanceTests.cpp
+ *
+ *  Measures the cost of explanation-based chunking on one of the learning
+ *  test agents:  rules learned per second, time spent in each phase of rule
+ *  formation (as reported by the EBC timers) and memory allocated per learned
+ *  rule.  Each run appends one line to ChunkingPerformanceResults.csv so that
+ *  results can be compared across commits.
+ */
+
+#include "PerformanceTests.h"
+
+#include "sml_Client.h"
+#include "sml_Connection.h"
+
+#include <map>
+
+#define CHUNKING_RESULTS_FILE "ChunkingPerformanceResults.csv"
+#define DEFAULT_LEARNING_AGENT "arithmetic_learning"
+
+using namespace sml;
+
+/* EBC timers in the order they are reported.  Names must match the ones in ebc_timers.cpp */
+static const char* ebc_phase_timers[] =
+{
+    "instantiation_creation",
+    "dependency_analysis",
+    "identity_unification",
+    "identity_update",
+    "variablization_lhs",
+    "merging",
+    "variablization_rhs",
+    "reorder",
+    "repair",
+    "reinstantiate",
+    "chunk_instantiation_creation",
+    "add_to_rete",
+    "clean_up"
+};
+static const int num_ebc_phase_timers = sizeof(ebc_phase_timers) / sizeof(ebc_phase_timers[0]);
+
+class ChunkingStatsTracker
+{
+    public:
+        std::vector<double> kerneltimes;
+        std::vector<double> ebctimes;
+        std::vector<double> rules;
+        std::vector<double> justifications;
+        std::vector<double> rule_memory;
+        std::map< std::string, std::vector<double> > phasetimes;
+
+        double GetAverage(const std::vector<double>& numbers)
+        {
+            if (numbers.empty()) return 0.0;
+
+            double total = 0.0;
+            for (unsigned int i = 0; i < numbers.size(); i++)
+            {
+                total += numbers[i];
+            }
+            return total / static_cast<double>(numbers.size());
+        }
+
+        void PrintResults(const char* testName, int numTrials, int numDCs, const char* label)
+        {
+            double lKernel = GetAverage(kerneltimes);
+            double lEBC = GetAverage(ebctimes);
+            double lLearned = GetAverage(rules) + GetAverage(justifications);
+            double lRulesPerSec = lEBC ? (lLearned / lEBC) : 0.0;
+            double lBytesPerRule = lLearned ? (GetAverage(rule_memory) / lLearned) : 0.0;
+
+            std::cout << std::setiosflags(std::ios::fixed) << std::setprecision(4);
+            std::cout << "\033[1;34m" << testName << "\033[0;37m: ";
+            std::cout << "\033[0;93m" << std::setprecision(0) << lLearned << "\033[0;37m rules learned, ";
+            std::cout << std::setprecision(4);
+            std::cout << "\033[0;93m" << lEBC << "\033[0;37m sec in EBC (" << lKernel << " kernel), ";
+            std::cout << "\033[0;93m" << std::setprecision(1) << lRulesPerSec << "\033[0;37m rules/sec, ";
+            std::cout << "\033[0;93m" << std::setprecision(0) << lBytesPerRule << "\033[0;37m bytes/rule\n";
+            std::cout << std::setprecision(4);
+            for (int i = 0; i < num_ebc_phase_timers; i++)
+            {
+                std::cout << "    " << std::resetiosflags(std::ios::right) << std::setiosflags(std::ios::left) << std::setw(32) << ebc_phase_timers[i];
+                std::cout << std::resetiosflags(std::ios::left) << std::setiosflags(std::ios::right) << std::setw(10) << GetAverage(phasetimes[ebc_phase_timers[i]]) << std::endl;
+            }
+            std::cout << "---------------------------------------------------------------------------------\n";
+
+            std::ifstream lExisting(CHUNKING_RESULTS_FILE);
+            bool lNeedsHeader = !lExisting.good();
+            lExisting.close();
+
+            time_t t = time(0);
+            char now_string[32];
+            strftime(now_string, sizeof(now_string), "%Y-%m-%d %H:%M:%S", localtime(&t));
+
+            std::ofstream resultFile(CHUNKING_RESULTS_FILE, std::ofstream::out | std::ofstream::app);
+            if (lNeedsHeader)
+            {
+                resultFile << "date,label,agent,trials,decisions,kernel_sec,ebc_sec,rules_learned,justifications_learned,rules_per_sec,bytes_per_rule";
+                for (int i = 0; i < num_ebc_phase_timers; i++)
+                {
+                    resultFile << "," << ebc_phase_timers[i] << "_sec";
+                }
+                resultFile << "\n";
+            }
+            resultFile << std::setiosflags(std::ios::fixed) << std::setprecision(6);
+            resultFile << now_string << "," << label << "," << testName << "," << numTrials << "," << numDCs << ",";
+            resultFile << lKernel << "," << lEBC << "," << GetAverage(rules) << "," << GetAverage(justifications) << ",";
+            resultFile << lRulesPerSec << "," << lBytesPerRule;
+            for (int i = 0; i < num_ebc_phase_timers; i++)
+            {
+                resultFile << "," << GetAverage(phasetimes[ebc_phase_timers[i]]);
+            }
+            resultFile << "\n";
+            resultFile.close();
+        }
+};
+
+/* Returns the number at the end of the first line of pOutput that starts with pLabel */
+double GetTrailingNumber(const std::string& pOutput, const std::string& pLabel)
+{
+    std::istringstream lLines(pOutput);
+    std::string lLine;
+    while (std::getline(lLines, lLine))
+    {
+        if (lLine.compare(0, pLabel.size(), pLabel) == 0)
+        {
+            size_t lPos = lLine.find_last_of(" \t:");
+            double lValue = 0.0;
+            std::istringstream((lPos == std::string::npos) ? lLine : lLine.substr(lPos + 1)) >> lValue;
+            return lValue;
+        }
+    }
+    return 0.0;
+}
+
+void Run_ChunkingPerformanceTest(int numTrials, int numDecisions, ChunkingStatsTracker* pSt, const std::vector<std::string>& commands)
+{
+    for (int i = 0; i < numTrials; i++)
+    {
+        Kernel* kernel = Kernel::CreateKernelInNewThread();
+        Agent* agent = kernel->CreateAgent("Soar1");
+        std::string runCmd = "run ";
+        if (numDecisions > 0) runCmd += std::to_string(numDecisions);
+        std::cout << (i+1) << " ";
+        std::cout.flush();
+
+        agent->SetOutputLinkChangeTracking(false);
+
+        for (int j = 0; j < commands.size(); ++j)
+        {
+            agent->ExecuteCommandLine(commands[j].c_str());
+        }
+        agent->ExecuteCommandLine(runCmd.c_str());
+
+        {
+            ClientAnalyzedXML response;
+            agent->ExecuteCommandLineXML("stats", &response);
+            pSt->kerneltimes.push_back(response.GetArgFloat(sml_Names::kParamStatsKernelCPUTime, 0.0));
+        }
+
+        /* Timer and statistics output is parsed from the command results */
+        agent->ExecuteCommandLine("output enable on");
+        agent->ExecuteCommandLine("output callbacks on");
+        std::string lTimers = agent->ExecuteCommandLine("chunk timers");
+        std::string lStats = agent->ExecuteCommandLine("chunk stats");
+
+        pSt->ebctimes.push_back(GetTrailingNumber(lTimers, "_total:"));
+        for (int j = 0; j < num_ebc_phase_timers; j++)
+        {
+            pSt->phasetimes[ebc_phase_timers[j]].push_back(GetTrailingNumber(lTimers, std::string(ebc_phase_timers[j]) + ":"));
+        }
+        pSt->rules.push_back(GetTrailingNumber(lStats, "Rules learned"));
+        pSt->justifications.push_back(GetTrailingNumber(lStats, "Justifications learned"));
+        pSt->rule_memory.push_back(GetTrailingNumber(lStats, "Memory allocated while forming learned rules"));
+
+        kernel->Shutdown();
+        delete kernel;
+
+        std::cout << "✅  ";
+        std::cout.flush();
+    }
+
+    std::cout << std::endl;
+    std::cout.flush();
+}
+
+int main(int argc, char* argv[])
+{
+    set_working_directory_to_executable_path();
+
+    const char* agentname = DEFAULT_LEARNING_AGENT;
+    const char* label = "";
+    int numTrials = DEFAULT_TRIALS;
+    int numDCs = DEFAULT_DCS;
+
+    if (argc > 5)
+    {
+        std::cout << "Usage: " << argv[0] << " [default | <agent name>] [<numtrials>] [<num_decisions>] [<label>]" << std::endl;
+        return 1;
+    }
+    if (argc > 1) agentname = argv[1];
+    if (argc > 2) std::stringstream(argv[2]) >> numTrials;
+    if (argc > 3) std::stringstream(argv[3]) >> numDCs;
+    if (argc > 4) label = argv[4];
+
+    if (!strcmp(agentname, "default"))
+    {
+        agentname = DEFAULT_LEARNING_AGENT;
+    }
+    if (!numDCs) numDCs = DEFAULT_DCS;
+
+    std::cout << "\033[1;31m" << agentname << "\033[0;37m" << " (chunking): ";
+    if (numTrials > 1) std::cout << numTrials << " trials"; else std::cout << "single run";
+    if (numDCs > 0) std::cout << ", " << numDCs << " DCs\n"; else std::cout << ", run forever\n";
+    std::cout.flush();
+
+    {
+        ChunkingStatsTracker l_testStats;
+        std::vector<std::string> commands;
+
+        commands.push_back("pushd SoarPerformanceTests");
+        std::string srccmd = "source ";
+        srccmd += agentname;
+        srccmd += ".soar";
+        commands.push_back(srccmd.c_str());
+        commands.push_back("output console off");
+        commands.push_back("output callbacks off");
+        commands.push_back("output agent-writes off");
+        commands.push_back("output enable off");
+        commands.push_back("watch 0");
+        commands.push_back("srand 3");
+        commands.push_back("chunk timers on");
+
+        Run_ChunkingPerformanceTest(numTrials, numDCs, &l_testStats, commands);
+
+        l_testStats.PrintResults(agentname, numTrials, numDCs, label);
+    }
+
+    return 0;
+}
@@ -0,0 +1,307 @@
+/*
+ * SvsPerformanceTests.cpp
+ *
+ *  Measures how SVS scales with scene size.  For each requested node count it
+ *  builds a synthetic scene of boxes and balls around an eye node, gives the
+ *  agent a fixed set of extract commands over the whole scene, and then
+ *  replays a number of frames in which a share of the nodes move and a few
+ *  tags change.  Each size is run twice.  In the top-state scenario the agent
+ *  has no task knowledge beyond one operator that keeps it from impassing.  In
+ *  the substate scenario every frame selects an operator that impasses, the
+ *  substate moves one node with set_transform and then returns, so every
+ *  frame also pays for creating a substate scene and copying it on its first
+ *  write.  Either way the time spent is SVS's:  the per-stage and per-filter
+ *  times reported by "svs timers".  Each stage of each run appends one line to
+ *  SvsPerformanceResults.csv so that results can be compared across commits.
+ */
+
+#include "PerformanceTests.h"
+
+#include "sml_Client.h"
+#include "sml_Connection.h"
+
+#include <chrono>
+#include <cmath>
+
+#define SVS_RESULTS_FILE "SvsPerformanceResults.csv"
+#define DEFAULT_SVS_SIZES "100,1000"
+#define DEFAULT_SVS_FRAMES 50
+#define DEFAULT_SVS_MOVING 10
+
+/* descend, the impasse and return */
+#define SUBSTATE_DECISIONS 3
+
+using namespace sml;
+
+/* Vertices of a unit cube, for the box nodes */
+static const char* cube_verts = "v -0.5 -0.5 -0.5 -0.5 -0.5 0.5 -0.5 0.5 -0.5 -0.5 0.5 0.5 0.5 -0.5 -0.5 0.5 -0.5 0.5 0.5 0.5 -0.5 0.5 0.5 0.5";
+
+/* Keeps the top state busy without impassing, for the top-state scenario */
+static const char* svs_tick_productions[] =
+{
+    "sp {svs*elaborate*tick (state <s> ^superstate nil -^tick) --> (<s> ^tick 0)}",
+    "sp {svs*propose*tick (state <s> ^superstate nil ^tick <t>) --> (<s> ^operator <o> +) (<o> ^name tick)}",
+    "sp {svs*apply*tick (state <s> ^operator.name tick ^tick <t>) --> (<s> ^tick <t> - (+ <t> 1))}"
+};
+static const int num_svs_tick_productions = sizeof(svs_tick_productions) / sizeof(svs_tick_productions[0]);
+
+/* For the substate scenario:  descend impasses, the substate moves n0 to a new
+ * place so that its scene is copied, and return ends the impasse once the move
+ * has been made.  One round takes SUBSTATE_DECISIONS decisions. */
+static const char* svs_substate_productions[] =
+{
+    "sp {svs*propose*init (state <s> ^superstate nil -^tick) --> (<s> ^operator <o> + >) (<o> ^name init)}",
+    "sp {svs*apply*init (state <s> ^operator.name init) --> (<s> ^tick 0)}",
+    "sp {svs*propose*descend (state <s> ^superstate nil ^tick <t>) --> (<s> ^operator <o> +) (<o> ^name descend)}",
+    "sp {svs*substate*move (state <s> ^superstate <ss> ^svs.command <c>) (<ss> ^operator.name descend ^tick <t>) --> (<c> ^set_transform <x>) (<x> ^id |n0| ^position <p>) (<p> ^x <t> ^y 0 ^z 0)}",
+    "sp {svs*propose*return (state <s> ^superstate.operator.name descend ^svs.command.set_transform.status success) --> (<s> ^operator <o> +) (<o> ^name return)}",
+    "sp {svs*apply*return (state <s> ^operator.name return ^superstate <ss>) (<ss> ^tick <t>) --> (<ss> ^tick <t> - (+ <t> 1))}"
+};
+static const int num_svs_substate_productions = sizeof(svs_substate_productions) / sizeof(svs_substate_productions[0]);
+
+/* The extract commands run every frame, one per filter type being measured */
+static const char* svs_productions[] =
+{
+    "sp {svs*extract*distance (state <s> ^superstate nil ^svs.command <c>) --> (<c> ^extract <e>) (<e> ^type distance ^a <a> ^b <b>) (<a> ^type node ^id |n0|) (<b> ^type all_nodes)}",
+    "sp {svs*extract*intersect (state <s> ^superstate nil ^svs.command <c>) --> (<c> ^extract <e>) (<e> ^type intersect_select ^intersect_type hull ^a <a> ^b <b>) (<a> ^type node ^id |n0|) (<b> ^type all_nodes)}",
+    "sp {svs*extract*closest (state <s> ^superstate nil ^svs.command <c>) --> (<c> ^extract <e>) (<e> ^type closest ^a <a> ^b <b>) (<a> ^type node ^id |n1|) (<b> ^type all_nodes)}",
+    "sp {svs*extract*sight (state <s> ^superstate nil ^svs.command <c>) --> (<c> ^extract <e>) (<e> ^type line_of_sight ^a <a> ^b <b>) (<a> ^type node ^id eye) (<b> ^type all_nodes)}",
+    "sp {svs*extract*occlusion (state <s> ^superstate nil ^svs.command <c>) --> (<c> ^extract <e>) (<e> ^type occlusion ^a <a> ^b <b>) (<a> ^type node ^id |n0|) (<b> ^type all_nodes)}"
+};
+static const int num_svs_productions = sizeof(svs_productions) / sizeof(svs_productions[0]);
+
+/* Small deterministic generator, so every run and platform builds the same scenes */
+class SceneRandom
+{
+    public:
+        SceneRandom(unsigned int seed) : state(seed) {}
+
+        /* Uniform in [lo, hi) */
+        double Uniform(double lo, double hi)
+        {
+            state = state * 1664525u + 1013904223u;
+            return lo + (hi - lo) * ((state >> 8) / 16777216.0);
+        }
+
+    private:
+        unsigned int state;
+};
+
+class SvsSceneGenerator
+{
+    public:
+        SvsSceneGenerator(int numNodes, int movingPercent)
+            : m_Random(3), m_NumNodes(numNodes), m_NumMoving(numNodes * movingPercent / 100), m_NextMover(0)
+        {
+            /* Keep the density about the same at every size */
+            m_Extent = 3.0 * std::cbrt(static_cast<double>(numNodes));
+            if (m_NumMoving < 1) m_NumMoving = 1;
+        }
+
+        /* SGEL adding the eye and every node */
+        std::string MakeScene()
+        {
+            std::ostringstream lSgel;
+            lSgel << "add eye world b 0.1 p 0 0 0\n";
+            for (int i = 0; i < m_NumNodes; i++)
+            {
+                lSgel << "add n" << i << " world ";
+                if (i % 2) lSgel << "b 0.5"; else lSgel << cube_verts;
+                lSgel << " p " << m_Random.Uniform(-m_Extent, m_Extent) << " " << m_Random.Uniform(-m_Extent, m_Extent) << " " << m_Random.Uniform(-m_Extent, m_Extent) << "\n";
+                lSgel << "tag add n" << i << " color " << ((i % 3) ? "red" : "blue") << "\n";
+            }
+            return lSgel.str();
+        }
+
+        /* SGEL moving the next share of the nodes a little and changing a few of their tags */
+        std::string MakeFrame(int frame)
+        {
+            std::ostringstream lSgel;
+            for (int i = 0; i < m_NumMoving; i++)
+            {
+                int lNode = (m_NextMover + i) % m_NumNodes;
+                lSgel << "change n" << lNode << " p " << m_Random.Uniform(-m_Extent, m_Extent) << " " << m_Random.Uniform(-m_Extent, m_Extent) << " " << m_Random.Uniform(-m_Extent, m_Extent) << "\n";
+                if (i % 10 == 0)
+                {
+                    lSgel << "tag change n" << lNode << " color " << ((frame % 2) ? "green" : "red") << "\n";
+                }
+            }
+            m_NextMover = (m_NextMover + m_NumMoving) % m_NumNodes;
+            return lSgel.str();
+        }
+
+    private:
+        SceneRandom m_Random;
+        int m_NumNodes;
+        int m_NumMoving;
+        int m_NextMover;
+        double m_Extent;
+};
+
+/* One line of "svs timers" output */
+struct SvsStage
+{
+    std::string name;
+    long calls;
+    double seconds;
+};
+
+/* The stage name can contain spaces, so the numbers are read from the end of each line */
+void ParseSvsTimers(const std::string& pOutput, std::vector<SvsStage>& pStages)
+{
+    std::istringstream lLines(pOutput);
+    std::string lLine;
+    while (std::getline(lLines, lLine))
+    {
+        std::vector<std::string> lWords;
+        std::istringstream lWordStream(lLine);
+        std::string lWord;
+        while (lWordStream >> lWord) lWords.push_back(lWord);
+        if (lWords.size() < 4 || lWords[0] == "stage" || lWords[0] == "timers") continue;
+
+        SvsStage lStage;
+        std::istringstream(lWords[lWords.size() - 3]) >> lStage.calls;
+        std::istringstream(lWords[lWords.size() - 2]) >> lStage.seconds;
+        lStage.name = lWords[0];
+        for (size_t i = 1; i + 3 < lWords.size(); i++)
+        {
+            lStage.name += " " + lWords[i];
+        }
+        pStages.push_back(lStage);
+    }
+}
+
+void Run_SvsPerformanceTest(int numNodes, int numFrames, int movingPercent, int numThreads, bool substates, const char* label)
+{
+    Kernel* kernel = Kernel::CreateKernelInNewThread();
+    Agent* agent = kernel->CreateAgent("Soar1");
+    SvsSceneGenerator lGenerator(numNodes, movingPercent);
+
+    agent->SetOutputLinkChangeTracking(false);
+    agent->ExecuteCommandLine("watch 0");
+    agent->ExecuteCommandLine("svs --enable");
+    if (numThreads > 0)
+    {
+        agent->ExecuteCommandLine(("svs filter_threads " + std::to_string(numThreads)).c_str());
+    }
+    for (int i = 0; i < num_svs_productions; i++)
+    {
+        agent->ExecuteCommandLine(svs_productions[i]);
+    }
+    if (substates)
+    {
+        for (int i = 0; i < num_svs_substate_productions; i++)
+        {
+            agent->ExecuteCommandLine(svs_substate_productions[i]);
+        }
+    }
+    else
+    {
+        for (int i = 0; i < num_svs_tick_productions; i++)
+        {
+            agent->ExecuteCommandLine(svs_tick_productions[i]);
+        }
+    }
+    /* Setup ends after init and one whole round, so that each frame starts by selecting descend */
+    int lSetupDecisions = substates ? 1 + SUBSTATE_DECISIONS : 2;
+    int lFrameDecisions = substates ? SUBSTATE_DECISIONS : 1;
+    const char* lScenario = substates ? "substates" : "top_state";
+
+    /* Building the scene and the first round of results are timed apart from the frames */
+    agent->ExecuteCommandLine("svs timers on");
+    std::chrono::steady_clock::time_point lStart = std::chrono::steady_clock::now();
+    agent->SendSVSInput(lGenerator.MakeScene());
+    agent->RunSelf(lSetupDecisions);
+    double lSetupSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - lStart).count();
+    agent->ExecuteCommandLine("svs timers reset");
+
+    lStart = std::chrono::steady_clock::now();
+    for (int i = 0; i < numFrames; i++)
+    {
+        agent->SendSVSInput(lGenerator.MakeFrame(i));
+        agent->RunSelf(lFrameDecisions);
+    }
+    double lFramesSec = std::chrono::duration<double>(std::chrono::steady_clock::now() - lStart).count();
+
+    std::vector<SvsStage> lStages;
+    ParseSvsTimers(agent->ExecuteCommandLine("svs timers"), lStages);
+
+    kernel->Shutdown();
+    delete kernel;
+
+    std::cout << std::setiosflags(std::ios::fixed) << std::setprecision(4);
+    std::cout << "\033[1;34m" << numNodes << " nodes, " << lScenario << "\033[0;37m: ";
+    std::cout << "setup \033[0;93m" << lSetupSec << "\033[0;37m sec, ";
+    std::cout << "\033[0;93m" << std::setprecision(3) << (1000.0 * lFramesSec / numFrames) << "\033[0;37m msec/frame\n";
+    for (size_t i = 0; i < lStages.size(); i++)
+    {
+        std::cout << "    " << std::resetiosflags(std::ios::right) << std::setiosflags(std::ios::left) << std::setw(32) << lStages[i].name;
+        std::cout << std::resetiosflags(std::ios::left) << std::setiosflags(std::ios::right) << std::setw(10) << (1000.0 * lStages[i].seconds / numFrames) << " msec/frame" << std::endl;
+    }
+    std::cout << "---------------------------------------------------------------------------------\n";
+
+    std::ifstream lExisting(SVS_RESULTS_FILE);
+    bool lNeedsHeader = !lExisting.good();
+    lExisting.close();
+
+    time_t t = time(0);
+    char now_string[32];
+    strftime(now_string, sizeof(now_string), "%Y-%m-%d %H:%M:%S", localtime(&t));
+
+    std::ofstream resultFile(SVS_RESULTS_FILE, std::ofstream::out | std::ofstream::app);
+    if (lNeedsHeader)
+    {
+        resultFile << "date,label,scenario,nodes,frames,moving_percent,filter_threads,stage,calls,total_sec,msec_per_frame\n";
+    }
+    resultFile << std::setiosflags(std::ios::fixed) << std::setprecision(6);
+    std::string lPrefix = std::string(now_string) + "," + label + "," + lScenario + "," + std::to_string(numNodes) + "," + std::to_string(numFrames) + "," + std::to_string(movingPercent) + "," + std::to_string(numThreads) + ",";
+    resultFile << lPrefix << "setup,1," << lSetupSec << "," << (1000.0 * lSetupSec) << "\n";
+    resultFile << lPrefix << "frame," << numFrames << "," << lFramesSec << "," << (1000.0 * lFramesSec / numFrames) << "\n";
+    for (size_t i = 0; i < lStages.size(); i++)
+    {
+        resultFile << lPrefix << lStages[i].name << "," << lStages[i].calls << "," << lStages[i].seconds << "," << (1000.0 * lStages[i].seconds / numFrames) << "\n";
+    }
+    resultFile.close();
+}
+
+int main(int argc, char* argv[])
+{
+    set_working_directory_to_executable_path();
+
+    std::string sizes = DEFAULT_SVS_SIZES;
+    int numFrames = DEFAULT_SVS_FRAMES;
+    int movingPercent = DEFAULT_SVS_MOVING;
+    int numThreads = 0;
+    const char* label = "";
+
+    if (argc > 6)
+    {
+        std::cout << "Usage: " << argv[0] << " [default | <node counts, e.g. 100,1000>] [<frames>] [<percent of nodes moving per frame>] [<filter threads>] [<label>]" << std::endl;
+        return 1;
+    }
+    if (argc > 1 && strcmp(argv[1], "default")) sizes = argv[1];
+    if (argc > 2) std::stringstream(argv[2]) >> numFrames;
+    if (argc > 3) std::stringstream(argv[3]) >> movingPercent;
+    if (argc > 4) std::stringstream(argv[4]) >> numThreads;
+    if (argc > 5) label = argv[5];
+    if (numFrames <= 0) numFrames = DEFAULT_SVS_FRAMES;
+
+    std::cout << "\033[1;31m" << "SVS" << "\033[0;37m" << ": " << numFrames << " frames, " << movingPercent << "% of nodes moving";
+    if (numThreads > 0) std::cout << ", " << numThreads << " filter threads\n"; else std::cout << "\n";
+    std::cout.flush();
+
+    std::istringstream lSizes(sizes);
+    std::string lSize;
+    while (std::getline(lSizes, lSize, ','))
+    {
+        int numNodes = 0;
+        std::stringstream(lSize) >> numNodes;
+        if (numNodes > 0)
+        {
+            Run_SvsPerformanceTest(numNodes, numFrames, movingPercent, numThreads, false, label);
+            Run_SvsPerformanceTest(numNodes, numFrames, movingPercent, numThreads, true, label);
+        }
+    }
+
+    return 0;
+}
@@ -7,13 +7,22 @@ if [[ "${TRACE-0}" == "1" ]]; then
     set -o xtrace
 fi
 
-usage="Usage: $0 [-s [full | fast]] "
+usage="Usage: $0 [-s [full | fast | chunking | svs]] [-l <label>]"
 
 if [[ "${1-}" =~ ^-*h(elp)?$ ]]; then
     echo "$usage
 
 Score Soar's performance on a variety of tasks.
 
+The chunking suite measures rule learning on its own and appends its results,
+tagged with the optional label (e.g. a commit hash), to
+ChunkingPerformanceResults.csv.
+
+The svs suite measures SVS stage and filter times on synthetic scenes of
+increasing size, once on the top state and once with a substate created and
+its scene copied every frame, and appends its results, tagged the same way, to
+SvsPerformanceResults.csv.
+
 "
     exit
 fi
@@ -21,12 +30,14 @@ fi
 lVersion="9.6"
 lTestSuite="full"
 lUnitTests=off
+lLabel=""
 
-while getopts u:s: opt
+while getopts u:s:l: opt
 do
     case "$opt" in
       u)  lUnitTests=on;;
       s)  lTestSuite="$OPTARG";;
+      l)  lLabel="$OPTARG";;
       \?)		# unknown flag
       	  echo >&2 "$usage"
 	  exit 1;;
@@ -70,6 +81,13 @@ elif [ "$lTestSuite" == "fast" ] ; then
     nice -n -10 ./PerformanceTests mac-planning_learning 2 165 32
     nice -n -10 ./PerformanceTests water-jug-lookahead 3 10000
     nice -n -10 ./PerformanceTests water-jug-lookahead_learning 2 102 100
+elif [ "$lTestSuite" == "chunking" ] ; then
+    nice -n -10 ./ChunkingPerformanceTests arithmetic_learning 3 0 "$lLabel"
+    nice -n -10 ./ChunkingPerformanceTests FactorizationStressTest_learning 2 0 "$lLabel"
+    nice -n -10 ./ChunkingPerformanceTests water-jug-lookahead_learning 5 0 "$lLabel"
+elif [ "$lTestSuite" == "svs" ] ; then
+    nice -n -10 ./SvsPerformanceTests 100,500,1000,2000 50 10 0 "$lLabel"
+    nice -n -10 ./SvsPerformanceTests 1000 50 10 4 "$lLabel"
 fi
 
 if [ $lUnitTests != off ] ; then
@@ -18,6 +18,7 @@
 
 #include <string>
 #include <iostream>
+#include <fstream>
 
 #include "SoarHelper.hpp"
 #include "handlers.hpp"
@@ -391,6 +392,426 @@ void MiscTests::testLocationPredictionRhs()
     no_agent_assertTrue_msg("compute-closest-intercept failed: " + result, result.find("^predicted-destination southeast-location") != std::string::npos);
 }
 
+void MiscTests::testDuplicateProductionDetection()
+{
+    agent->ExecuteCommandLine("sp {dup*original (state <s> ^superstate nil ^io <io>) (<io> ^input-link <il>) -{(<il> ^block <b>) (<b> ^color red)} --> (<s> ^copy <il> + ^value (+ 1 2))}");
+    no_agent_assertTrue(agent->GetLastCommandLineResult());
+
+    // Same rule with different variable names is a duplicate
+    std::string result = agent->ExecuteCommandLine("sp {dup*renamed (state <x> ^superstate nil ^io <i>) (<i> ^input-link <in>) -{(<in> ^block <y>) (<y> ^color red)} --> (<x> ^copy <in> + ^value (+ 1 2))}");
+    no_agent_assertTrue_msg("Renamed rule not detected as duplicate: " + result, result.find("duplicate of dup*original") != std::string::npos);
+
+    // Rules that differ in a constant or an RHS function argument are not
+    result = agent->ExecuteCommandLine("sp {dup*other-color (state <s> ^superstate nil ^io <io>) (<io> ^input-link <il>) -{(<il> ^block <b>) (<b> ^color blue)} --> (<s> ^copy <il> + ^value (+ 1 2))}");
+    no_agent_assertTrue_msg("Different rule detected as duplicate: " + result, result.find("duplicate") == std::string::npos);
+    result = agent->ExecuteCommandLine("sp {dup*other-value (state <s> ^superstate nil ^io <io>) (<io> ^input-link <il>) -{(<il> ^block <b>) (<b> ^color red)} --> (<s> ^copy <il> + ^value (+ 1 3))}");
+    no_agent_assertTrue_msg("Different rule detected as duplicate: " + result, result.find("duplicate") == std::string::npos);
+
+    // Once the original is excised, an identical rule can be added again
+    agent->ExecuteCommandLine("production excise dup*original");
+    result = agent->ExecuteCommandLine("sp {dup*renamed (state <x> ^superstate nil ^io <i>) (<i> ^input-link <in>) -{(<in> ^block <y>) (<y> ^color red)} --> (<x> ^copy <in> + ^value (+ 1 2))}");
+    no_agent_assertTrue_msg("Rule still detected as duplicate after excise: " + result, result.find("duplicate") == std::string::npos);
+}
+
+void MiscTests::testDuplicateDetectionAfterRlUpdate()
+{
+    // chunk-stop treats RL rules that differ only in value as duplicates, so leave it off
+    agent->ExecuteCommandLine("rl --set learning on");
+    agent->ExecuteCommandLine("rl --set chunk-stop off");
+    agent->ExecuteCommandLine("sp {propose*init (state <s> ^superstate nil -^count) --> (<s> ^operator <o> +) (<o> ^name init)}");
+    agent->ExecuteCommandLine("sp {apply*init (state <s> ^operator.name init) --> (<s> ^count 0)}");
+    agent->ExecuteCommandLine("sp {propose*count (state <s> ^superstate nil ^count < 10) --> (<s> ^operator <o> +) (<o> ^name count)}");
+    agent->ExecuteCommandLine("sp {rl*count (state <s> ^operator <o> +) (<o> ^name count) --> (<s> ^operator <o> = 0.5)}");
+    agent->ExecuteCommandLine("sp {apply*count (state <s> ^operator <o> ^count <c> ^reward-link <r>) (<o> ^name count) --> (<s> ^count <c> - (+ <c> 1)) (<r> ^reward.value 1)}");
+    agent->RunSelf(5, sml::sml_DECIDE);
+    agent->ExecuteCommandLine("init-soar");
+
+    // The RL rule no longer has its original value, so a rule with that value is new
+    std::string result = agent->ExecuteCommandLine("sp {rl*count*original (state <s> ^operator <o> +) (<o> ^name count) --> (<s> ^operator <o> = 0.5)}");
+    no_agent_assertTrue_msg("Rule with the pre-update value detected as duplicate: " + result, result.find("duplicate") == std::string::npos);
+    result = agent->ExecuteCommandLine("print rl*count*original");
+    no_agent_assertTrue_msg("Rule with the pre-update value wasn't added: " + result, result.find("= 0.5") != std::string::npos);
+}
+
+void MiscTests::testDuplicateDetectionTestTypes()
+{
+    // Rules that differ only in a not-equal versus a conjunctive test are both added
+    std::string result = agent->ExecuteCommandLine("sp {dup*not-equal (state <s> ^superstate nil ^count <c>) (<s> ^limit <> <c>) --> (<s> ^ok yes)}");
+    no_agent_assertTrue(agent->GetLastCommandLineResult());
+    result = agent->ExecuteCommandLine("sp {dup*conjunctive (state <s> ^superstate nil ^count <c>) (<s> ^limit { <> <c> < 10 }) --> (<s> ^ok yes)}");
+    no_agent_assertTrue_msg("Conjunctive test detected as duplicate: " + result, result.find("duplicate") == std::string::npos);
+    result = agent->ExecuteCommandLine("sp {dup*constant-not-equal (state <s> ^superstate nil ^count <c>) (<s> ^limit <> 5) --> (<s> ^ok yes)}");
+    no_agent_assertTrue_msg("Not-equal test detected as duplicate: " + result, result.find("duplicate") == std::string::npos);
+    result = agent->ExecuteCommandLine("sp {dup*constant-conjunctive (state <s> ^superstate nil ^count <c>) (<s> ^limit { <> 5 <> 6 }) --> (<s> ^ok yes)}");
+    no_agent_assertTrue_msg("Conjunctive test detected as duplicate: " + result, result.find("duplicate") == std::string::npos);
+
+    const char* lRules[] = { "dup*not-equal", "dup*conjunctive", "dup*constant-not-equal", "dup*constant-conjunctive" };
+    for (int i = 0; i < 4; ++i)
+    {
+        result = agent->ExecuteCommandLine((std::string("print ") + lRules[i]).c_str());
+        no_agent_assertTrue_msg(std::string("Rule was not added: ") + result, result.find(std::string("sp {") + lRules[i]) != std::string::npos);
+    }
+}
+
+void MiscTests::testExplainerRecordLimit()
+{
+    // Deep_Copy_Identity_Expansion learns four chunks; only one explanation may stay in memory
+    no_agent_assertTrue(SoarHelper::source(agent, "ChunkingTests", "Deep_Copy_Identity_Expansion"));
+    agent->ExecuteCommandLine("explain all on");
+    agent->ExecuteCommandLine("explain record-limit 1");
+    agent->RunSelf(3, sml::sml_DECIDE);
+
+    std::string result = agent->ExecuteCommandLine("explain list-chunks");
+    no_agent_assertTrue_msg("No explanations were archived: " + result, result.find("archived") != std::string::npos);
+
+    // Older explanations are paged back in from the log
+    result = agent->ExecuteCommandLine("explain chunk 1");
+    no_agent_assertTrue_msg("Explanation was not paged in: " + result, result.find("Paged in") != std::string::npos);
+    result = agent->ExecuteCommandLine("explain formation");
+    no_agent_assertTrue_msg("Archived formation missing: " + result, result.find("The formation of chunk") != std::string::npos);
+    result = agent->ExecuteCommandLine("explain stats");
+    no_agent_assertTrue_msg("Archived stats missing: " + result, result.find("Number of conditions") != std::string::npos);
+    result = agent->ExecuteCommandLine("explain chunk 1");
+    no_agent_assertTrue_msg("Archived chunk missing its conditions: " + result, result.find("Working memory trace of instantiation") != std::string::npos);
+    result = agent->ExecuteCommandLine("explain constraints");
+    no_agent_assertTrue_msg("Constraint analysis should not be archived: " + result, result.find("does not keep") != std::string::npos);
+}
+
+void MiscTests::testExplainerLogKeepsExistingFile()
+{
+    {
+        std::ofstream existing("explain-log-test.txt");
+        existing << "keep me";
+    }
+    no_agent_assertTrue(SoarHelper::source(agent, "ChunkingTests", "Deep_Copy_Identity_Expansion"));
+    agent->ExecuteCommandLine("explain all on");
+    agent->ExecuteCommandLine("explain record-limit 1");
+    agent->ExecuteCommandLine("explain log-file explain-log-test.txt");
+    agent->RunSelf(3, sml::sml_DECIDE);
+
+    std::string contents;
+    {
+        std::ifstream existing("explain-log-test.txt");
+        std::getline(existing, contents);
+    }
+    remove("explain-log-test.txt");
+    no_agent_assertTrue_msg("Explanation log overwrote an existing file: " + contents, contents == "keep me");
+}
+
+void MiscTests::testChunkTimers()
+{
+    no_agent_assertTrue(SoarHelper::source(agent, "ChunkingTests", "Deep_Copy_Identity_Expansion"));
+    agent->ExecuteCommandLine("chunk timers on");
+    agent->RunSelf(3, sml::sml_DECIDE);
+
+    std::string result = agent->ExecuteCommandLine("chunk timers");
+    no_agent_assertTrue_msg("Timer missing: " + result, result.find("dependency_analysis:") != std::string::npos);
+    no_agent_assertTrue_msg("Timer missing: " + result, result.find("add_to_rete:") != std::string::npos);
+
+    result = agent->ExecuteCommandLine("chunk stats");
+    size_t lPos = result.find("Memory allocated while forming learned rules (bytes)");
+    no_agent_assertTrue_msg("Rule memory missing: " + result, lPos != std::string::npos);
+    lPos = result.find_first_of("0123456789", lPos + strlen("Memory allocated while forming learned rules (bytes)"));
+    no_agent_assertTrue_msg("Rule memory not counted: " + result, (lPos != std::string::npos) && (atol(result.c_str() + lPos) > 0));
+}
+
+void MiscTests::testManySlotsOnOneIdentifier()
+{
+    // Enough attributes that the input-link and state slots get indexed, then few enough that they don't
+    agent->ExecuteCommandLine("sp {copy*input (state <s> ^superstate nil ^io.input-link.<a> <v>) --> (<s> ^<a> <v>)}");
+    sml::Identifier* il = agent->GetInputLink();
+    std::vector<sml::StringElement*> wmes;
+    for (int i = 0; i < 100; i++)
+    {
+        wmes.push_back(agent->CreateStringWME(il, ("attr" + std::to_string(i)).c_str(), ("val" + std::to_string(i)).c_str()));
+    }
+    agent->RunSelf(1, sml::sml_DECIDE);
+    std::string result = agent->ExecuteCommandLine("print S1");
+    no_agent_assertTrue_msg("Missing copied attribute: " + result, result.find("^attr0 val0") != std::string::npos);
+    no_agent_assertTrue_msg("Missing copied attribute: " + result, result.find("^attr99 val99") != std::string::npos);
+
+    // Remove every attribute but a few, from all over the index
+    for (int i = 0; i < 100; i++)
+    {
+        if (i % 20 != 7)
+        {
+            agent->DestroyWME(wmes[i]);
+        }
+    }
+    agent->RunSelf(1, sml::sml_DECIDE);
+    result = agent->ExecuteCommandLine("print S1");
+    no_agent_assertTrue_msg("Removed attribute still copied: " + result, result.find("^attr0 ") == std::string::npos);
+    no_agent_assertTrue_msg("Remaining attribute missing: " + result, result.find("^attr47 val47") != std::string::npos);
+
+    // Growing again rebuilds the index around the slots that are left
+    for (int i = 100; i < 150; i++)
+    {
+        agent->CreateStringWME(il, ("attr" + std::to_string(i)).c_str(), ("val" + std::to_string(i)).c_str());
+    }
+    agent->CreateStringWME(il, "attr47", "other47");
+    agent->RunSelf(1, sml::sml_DECIDE);
+    result = agent->ExecuteCommandLine("print S1");
+    no_agent_assertTrue_msg("Missing copied attribute: " + result, result.find("^attr149 val149") != std::string::npos);
+    no_agent_assertTrue_msg("Second value in an existing slot missing: " + result, result.find("^attr47 other47") != std::string::npos);
+    no_agent_assertTrue_msg("First value in an existing slot missing: " + result, result.find("^attr47 val47") != std::string::npos);
+}
+
+void MiscTests::testLongConstituentStrings()
+{
+    // Strings longer than the lexer's 16 character blocks, ending at every kind of boundary
+    agent->ExecuteCommandLine("sp {long*names*with-every-constituent$%&*+-/:<=>?_@char (state <s> ^superstate nil) --> (<s> ^attribute-longer-than-sixteen-chars value_with:all<the>$%&*+-/?@extras ^another-really-long-attribute|name| 1.5e3 ^x.y-is-a-dotted-path-longer-than-sixteen last-string-at-the-very-end)}");
+    no_agent_assertTrue(agent->GetLastCommandLineResult());
+    agent->RunSelf(1, sml::sml_DECIDE);
+
+    std::string result = agent->ExecuteCommandLine("print S1");
+    no_agent_assertTrue_msg("Long value misread: " + result, result.find("^attribute-longer-than-sixteen-chars value_with:all<the>$%&*+-/?@extras") != std::string::npos);
+    no_agent_assertTrue_msg("Vbar string after a long string misread: " + result, result.find("^another-really-long-attribute name") != std::string::npos);
+    no_agent_assertTrue_msg("Float after a vbar string misread: " + result, result.find("^another-really-long-attribute 1500.") != std::string::npos);
+    result = agent->ExecuteCommandLine("print --depth 2 S1");
+    no_agent_assertTrue_msg("Last string misread: " + result, result.find("^y-is-a-dotted-path-longer-than-sixteen last-string-at-the-very-end") != std::string::npos);
+}
+
+void MiscTests::testManyRulesSharingConditions()
+{
+    // Hundreds of joins and negations below the same nodes, so sharing goes through the join index
+    for (int i = 0; i < 300; i++)
+    {
+        std::string n = std::to_string(i);
+        agent->ExecuteCommandLine(("sp {sense*" + n + " (state <s> ^superstate nil ^io.input-link <il>) (<il> ^sensor" + n + " <x>) --> (<s> ^out" + n + " <x>)}").c_str());
+        no_agent_assertTrue(agent->GetLastCommandLineResult());
+        agent->ExecuteCommandLine(("sp {free*" + n + " (state <s> ^superstate nil ^io.input-link <il>) -(<il> ^block" + n + ") --> (<s> ^free" + n + " yes)}").c_str());
+        no_agent_assertTrue(agent->GetLastCommandLineResult());
+    }
+    // Same conditions as sense*5, so it shares sense*5's join node
+    agent->ExecuteCommandLine("sp {sense*again (state <s> ^superstate nil ^io.input-link <il>) (<il> ^sensor5 <x>) --> (<s> ^again <x>)}");
+
+    sml::Identifier* il = agent->GetInputLink();
+    for (int i = 0; i < 300; i += 3)
+    {
+        agent->CreateStringWME(il, ("sensor" + std::to_string(i)).c_str(), ("val" + std::to_string(i)).c_str());
+    }
+    agent->CreateStringWME(il, "block4", "yes");
+    agent->RunSelf(1, sml::sml_DECIDE);
+    std::string result = agent->ExecuteCommandLine("print S1");
+    no_agent_assertTrue_msg("Missing sensor copy: " + result, result.find("^out3 val3") != std::string::npos);
+    no_agent_assertTrue_msg("Missing sensor copy: " + result, result.find("^out297 val297") != std::string::npos);
+    no_agent_assertTrue_msg("Copy of an absent sensor: " + result, result.find("^out4 ") == std::string::npos);
+    no_agent_assertTrue_msg("Missing negation match: " + result, result.find("^free299 yes") != std::string::npos);
+    no_agent_assertTrue_msg("Blocked negation matched: " + result, result.find("^free4 ") == std::string::npos);
+
+    // Excise every other rule, then add them back against the current working memory
+    for (int i = 0; i < 300; i += 2)
+    {
+        std::string n = std::to_string(i);
+        agent->ExecuteCommandLine(("excise sense*" + n + " free*" + n).c_str());
+    }
+    agent->ExecuteCommandLine("excise sense*again");
+    for (int i = 0; i < 300; i += 2)
+    {
+        std::string n = std::to_string(i);
+        agent->ExecuteCommandLine(("sp {sense*" + n + " (state <s> ^superstate nil ^io.input-link <il>) (<il> ^sensor" + n + " <x>) --> (<s> ^copy" + n + " <x>)}").c_str());
+        no_agent_assertTrue(agent->GetLastCommandLineResult());
+        agent->ExecuteCommandLine(("sp {free*" + n + " (state <s> ^superstate nil ^io.input-link <il>) -(<il> ^block" + n + ") --> (<s> ^open" + n + " yes)}").c_str());
+        no_agent_assertTrue(agent->GetLastCommandLineResult());
+    }
+    agent->RunSelf(1, sml::sml_DECIDE);
+    result = agent->ExecuteCommandLine("print S1");
+    no_agent_assertTrue_msg("Re-added rule didn't match: " + result, result.find("^copy6 val6") != std::string::npos);
+    no_agent_assertTrue_msg("Kept rule lost its match: " + result, result.find("^out9 val9") != std::string::npos);
+    no_agent_assertTrue_msg("Re-added negation didn't match: " + result, result.find("^open298 yes") != std::string::npos);
+    no_agent_assertTrue_msg("Re-added negation ignored its block: " + result, result.find("^open4 ") == std::string::npos);
+    no_agent_assertTrue_msg("Excised rule's result still there: " + result, result.find("^out6 ") == std::string::npos);
+}
+
+void MiscTests::testBatchLoadIntoPopulatedMemory()
+{
+    sml::Identifier* il = agent->GetInputLink();
+    for (int i = 0; i < 100; i += 2)
+    {
+        agent->CreateStringWME(il, ("sensor" + std::to_string(i)).c_str(), ("val" + std::to_string(i)).c_str());
+    }
+    sml::Identifier* block = agent->CreateIdWME(il, "block7");
+    agent->CreateStringWME(block, "color", "red");
+    agent->RunSelf(1, sml::sml_DECIDE);
+
+    // Joins, negations and conjunctive negations that share nodes with each other, plus a rule
+    // that is excised and replaced while the batch is still open
+    {
+        std::ofstream rules("batch-test.soar");
+        for (int i = 0; i < 100; i++)
+        {
+            std::string n = std::to_string(i);
+            rules << "sp {sense*" << n << " (state <s> ^superstate nil ^io.input-link <il>) (<il> ^sensor" << n << " <x>) --> (<s> ^out" << n << " <x>)}\n";
+            rules << "sp {free*" << n << " (state <s> ^superstate nil ^io.input-link <il>) -(<il> ^sensor" << n << ") --> (<s> ^free" << n << " yes)}\n";
+            rules << "sp {clear*" << n << " (state <s> ^superstate nil ^io.input-link <il>) -{(<il> ^block" << n << " <b>) (<b> ^color red)} --> (<s> ^clear" << n << " yes)}\n";
+        }
+        rules << "excise sense*10\n";
+        rules << "sp {sense*10 (state <s> ^superstate nil ^io.input-link <il>) (<il> ^sensor10 <x>) --> (<s> ^again10 <x>)}\n";
+    }
+    agent->ExecuteCommandLine("load file --batch batch-test.soar");
+    no_agent_assertTrue_msg("load file --batch", agent->GetLastCommandLineResult());
+    remove("batch-test.soar");
+
+    std::string matches = agent->ExecuteCommandLine("production matches --count sense*4");
+    no_agent_assertTrue_msg("Batch rule has no match: " + matches, matches.find("1") != std::string::npos);
+
+    agent->RunSelf(1, sml::sml_DECIDE);
+    std::string result = agent->ExecuteCommandLine("print S1");
+    no_agent_assertTrue_msg("Missing sensor copy: " + result, result.find("^out4 val4") != std::string::npos);
+    no_agent_assertTrue_msg("Missing sensor copy: " + result, result.find("^out98 val98") != std::string::npos);
+    no_agent_assertTrue_msg("Copy of an absent sensor: " + result, result.find("^out5 ") == std::string::npos);
+    no_agent_assertTrue_msg("Missing negation match: " + result, result.find("^free99 yes") != std::string::npos);
+    no_agent_assertTrue_msg("Negation matched a present sensor: " + result, result.find("^free98 ") == std::string::npos);
+    no_agent_assertTrue_msg("Missing conjunctive negation match: " + result, result.find("^clear6 yes") != std::string::npos);
+    no_agent_assertTrue_msg("Conjunctive negation ignored its block: " + result, result.find("^clear7 ") == std::string::npos);
+    no_agent_assertTrue_msg("Replaced rule didn't match: " + result, result.find("^again10 val10") != std::string::npos);
+    no_agent_assertTrue_msg("Excised rule fired: " + result, result.find("^out10 ") == std::string::npos);
+
+    // Working memory changes after the batch reach the new rules as usual
+    agent->DestroyWME(block);
+    agent->CreateStringWME(il, "sensor5", "val5");
+    agent->RunSelf(1, sml::sml_DECIDE);
+    result = agent->ExecuteCommandLine("print S1");
+    no_agent_assertTrue_msg("New sensor not copied: " + result, result.find("^out5 val5") != std::string::npos);
+    no_agent_assertTrue_msg("Removed block still blocks: " + result, result.find("^clear7 yes") != std::string::npos);
+    no_agent_assertTrue_msg("Negation didn't retract: " + result, result.find("^free5 ") == std::string::npos);
+}
+
+void MiscTests::testReorderWithMatchStatistics()
+{
+    // The reorderer guesses that ^target has many values and ^item few, so it joins ^item first
+    agent->ExecuteCommandLine("production optimize-attribute target 20");
+    agent->ExecuteCommandLine("sp {pick (state <s> ^superstate nil ^io.input-link <il>) (<il> ^item <i>) (<i> ^name <n>) (<il> ^target <n>) --> (<s> ^picked <n>)}");
+    no_agent_assertTrue(agent->GetLastCommandLineResult());
+    std::string result = agent->ExecuteCommandLine("print pick");
+    no_agent_assertTrue_msg("Unexpected initial order: " + result, result.find("^item") < result.find("^target"));
+
+    agent->ExecuteCommandLine("chunk reorder-statistics on");
+    no_agent_assertTrue(agent->GetLastCommandLineResult());
+    sml::Identifier* il = agent->GetInputLink();
+    std::vector<sml::Identifier*> items;
+    for (int i = 0; i < 60; i++)
+    {
+        items.push_back(agent->CreateIdWME(il, "item"));
+        agent->CreateStringWME(items.back(), "name", ("thing-" + std::to_string(i)).c_str());
+    }
+    agent->CreateStringWME(il, "target", "thing-7");
+    agent->RunSelf(1, sml::sml_DECIDE);
+    for (int i = 50; i < 60; i++)
+    {
+        agent->DestroyWME(items[i]);
+    }
+    agent->RunSelf(1, sml::sml_DECIDE);
+
+    // In working memory there is one target and many items, so the target should go first
+    agent->ExecuteCommandLine("production reorder pick");
+    no_agent_assertTrue(agent->GetLastCommandLineResult());
+    result = agent->ExecuteCommandLine("print pick");
+    no_agent_assertTrue_msg("Rule was not reordered: " + result, result.find("^target") < result.find("^item"));
+    result = agent->ExecuteCommandLine("production reorder --all");
+    no_agent_assertTrue_msg("Already reordered rule was rebuilt: " + result, result.find("0 productions reordered") != std::string::npos);
+
+    agent->RunSelf(1, sml::sml_DECIDE);
+    result = agent->ExecuteCommandLine("print S1");
+    no_agent_assertTrue_msg("Reordered rule didn't match: " + result, result.find("^picked thing-7") != std::string::npos);
+    agent->ExecuteCommandLine("chunk reorder-statistics off");
+    no_agent_assertTrue(agent->GetLastCommandLineResult());
+}
+
+void MiscTests::testFindWmeByTimetag()
+{
+    sml::Identifier* il = agent->GetInputLink();
+    agent->CreateStringWME(il, "probe", "value");
+    agent->RunSelf(1, sml::sml_DECIDE);
+
+    std::string result = agent->ExecuteCommandLine("print --internal I2");
+    size_t end = result.find(": I2 ^probe value");
+    no_agent_assertTrue_msg("Input wme not found: " + result, end != std::string::npos);
+    size_t start = result.rfind('(', end);
+    std::string timetag = result.substr(start + 1, end - start - 1);
+
+    result = agent->ExecuteCommandLine(("print " + timetag).c_str());
+    no_agent_assertTrue_msg("Lookup by timetag failed: " + result, result.find("^probe value") != std::string::npos);
+
+    agent->ExecuteCommandLine(("wm remove " + timetag).c_str());
+    no_agent_assertTrue(agent->GetLastCommandLineResult());
+    result = agent->ExecuteCommandLine(("print " + timetag).c_str());
+    no_agent_assertTrue_msg("Removed wme still found: " + result, result.find("^probe value") == std::string::npos);
+    agent->RunSelf(1, sml::sml_DECIDE);
+    result = agent->ExecuteCommandLine("print --internal I2");
+    no_agent_assertTrue_msg("Removed wme still in working memory: " + result, result.find("^probe value") == std::string::npos);
+}
+
+void MiscTests::testWmeAddedAndRemovedInOnePhase()
+{
+    agent->ExecuteCommandLine("sp {see*blip (state <s> ^superstate nil ^io.input-link <il>) (<il> ^blip <x>) --> (<s> ^saw-blip <x>)}");
+    agent->ExecuteCommandLine("sp {no*blip (state <s> ^superstate nil ^io.input-link <il>) -(<il> ^blip) (<il> ^steady <x>) --> (<s> ^no-blip <x>)}");
+    sml::Identifier* il = agent->GetInputLink();
+    agent->CreateStringWME(il, "steady", "here");
+    sml::StringElement* blip = agent->CreateStringWME(il, "blip", "gone");
+    agent->DestroyWME(blip);
+    agent->RunSelf(1, sml::sml_DECIDE);
+
+    std::string result = agent->ExecuteCommandLine("print S1");
+    no_agent_assertTrue_msg("Rule matched a wme that was removed: " + result, result.find("^saw-blip") == std::string::npos);
+    no_agent_assertTrue_msg("Negation saw a wme that was removed: " + result, result.find("^no-blip here") != std::string::npos);
+    result = agent->ExecuteCommandLine("print --internal I2");
+    no_agent_assertTrue_msg("Removed wme still in working memory: " + result, result.find("^blip") == std::string::npos);
+
+    blip = agent->CreateStringWME(il, "blip", "stays");
+    agent->RunSelf(1, sml::sml_DECIDE);
+    result = agent->ExecuteCommandLine("print S1");
+    no_agent_assertTrue_msg("Rule didn't match a later wme: " + result, result.find("^saw-blip stays") != std::string::npos);
+    no_agent_assertTrue_msg("Negation didn't retract: " + result, result.find("^no-blip") == std::string::npos);
+}
+
+void MiscTests::testCompiledRhsActions()
+{
+    agent->ExecuteCommandLine("sp {setup (state <s> ^superstate nil) --> (<s> ^a 3 ^b 4 ^c <c>) (<c> ^d 5)}");
+    agent->ExecuteCommandLine("sp {use (state <s> ^a <a> ^b <b> ^c <c>) (<c> ^d <d>) --> (<s> ^sum (+ (* <a> 2) <b> <d>) ^made <n>) (<n> ^from <d> ^name (concat |x| <a> (- <d> <b>)))}");
+    agent->RunSelf(1, sml::sml_DECIDE);
+
+    std::string result = agent->ExecuteCommandLine("print --depth 2 S1");
+    no_agent_assertTrue_msg("Nested RHS functions evaluated wrong: " + result, result.find("^sum 15") != std::string::npos);
+    no_agent_assertTrue_msg("Unbound variable wasn't made: " + result, result.find("^made N") != std::string::npos);
+    no_agent_assertTrue_msg("Rete location from an earlier condition was wrong: " + result, result.find("^from 5") != std::string::npos);
+    no_agent_assertTrue_msg("RHS function on a new identifier was wrong: " + result, result.find("^name |x31|") != std::string::npos);
+}
+
+void MiscTests::testRlUpdateReachesCompiledRhs()
+{
+    agent->ExecuteCommandLine("rl --set learning on");
+    agent->ExecuteCommandLine("sp {propose*init (state <s> ^superstate nil -^count) --> (<s> ^operator <o> +) (<o> ^name init)}");
+    agent->ExecuteCommandLine("sp {apply*init (state <s> ^operator.name init) --> (<s> ^count 0)}");
+    agent->ExecuteCommandLine("sp {propose*count (state <s> ^superstate nil ^count < 10) --> (<s> ^operator <o> +) (<o> ^name count)}");
+    agent->ExecuteCommandLine("sp {rl*count (state <s> ^operator <o> +) (<o> ^name count) --> (<s> ^operator <o> = 0)}");
+    agent->ExecuteCommandLine("sp {apply*count (state <s> ^operator <o> ^count <c> ^reward-link <r>) (<o> ^name count) --> (<s> ^count <c> - (+ <c> 1)) (<r> ^reward.value 1)}");
+    agent->RunSelf(5, sml::sml_DECIDE);
+
+    std::string rule = agent->ExecuteCommandLine("print rl*count");
+    size_t start = rule.find("= ");
+    no_agent_assertTrue_msg("RL rule has no value: " + rule, start != std::string::npos);
+    std::string value = rule.substr(start + 2, rule.find(')', start) - start - 2);
+    no_agent_assertTrue_msg("RL rule wasn't updated: " + rule, value != "0");
+
+    std::string result = agent->ExecuteCommandLine("preferences S1 operator");
+    no_agent_assertTrue_msg("New preference doesn't use the updated value " + value + ": " + result, result.find("(count) = " + value) != std::string::npos);
+}
+
+void MiscTests::testSymbolRefcountsBalance()
+{
+    agent->ExecuteCommandLine("sp {propose*init (state <s> ^superstate nil -^count) --> (<s> ^operator <o> +) (<o> ^name init)}");
+    agent->ExecuteCommandLine("sp {apply*init (state <s> ^operator.name init) --> (<s> ^count 0)}");
+    agent->ExecuteCommandLine("sp {propose*count (state <s> ^superstate nil ^count < 10) --> (<s> ^operator <o> +) (<o> ^name count)}");
+    agent->ExecuteCommandLine("sp {apply*count (state <s> ^operator.name count ^count <c>) --> (<s> ^count <c> - (+ <c> 1) ^label (concat |n| <c>))}");
+    agent->RunSelf(20, sml::sml_DECIDE);
+
+    std::string result = agent->ExecuteCommandLine("print S1");
+    no_agent_assertTrue_msg("Agent didn't count up: " + result, result.find("^count 10") != std::string::npos);
+    result = agent->ExecuteCommandLine("debug symbol-refcounts");
+    no_agent_assertTrue_msg("Symbol refcounts don't balance: " + result, agent->GetLastCommandLineResult());
+}
+
 //void MiscTests::testSoarDebugger()
 //{
 //	bool result = agent->SpawnDebugger();
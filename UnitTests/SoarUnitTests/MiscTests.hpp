@@ -69,6 +69,41 @@ public:
     TEST(testLocationPredictionRhs, -1)
     void testLocationPredictionRhs();
 
+    TEST(testDuplicateProductionDetection, -1)
+    void testDuplicateProductionDetection();
+    TEST(testDuplicateDetectionTestTypes, -1)
+    void testDuplicateDetectionTestTypes();
+    TEST(testDuplicateDetectionAfterRlUpdate, -1)
+    void testDuplicateDetectionAfterRlUpdate();
+
+    TEST(testExplainerRecordLimit, -1)
+    void testExplainerRecordLimit();
+
+    TEST(testExplainerLogKeepsExistingFile, -1)
+    void testExplainerLogKeepsExistingFile();
+    TEST(testChunkTimers, -1)
+    void testChunkTimers();
+    TEST(testManySlotsOnOneIdentifier, -1)
+    void testManySlotsOnOneIdentifier();
+    TEST(testLongConstituentStrings, -1)
+    void testLongConstituentStrings();
+    TEST(testManyRulesSharingConditions, -1)
+    void testManyRulesSharingConditions();
+    TEST(testBatchLoadIntoPopulatedMemory, -1)
+    void testBatchLoadIntoPopulatedMemory();
+    TEST(testReorderWithMatchStatistics, -1)
+    void testReorderWithMatchStatistics();
+    TEST(testFindWmeByTimetag, -1)
+    void testFindWmeByTimetag();
+    TEST(testWmeAddedAndRemovedInOnePhase, -1)
+    void testWmeAddedAndRemovedInOnePhase();
+    TEST(testCompiledRhsActions, -1)
+    void testCompiledRhsActions();
+    TEST(testRlUpdateReachesCompiledRhs, -1)
+    void testRlUpdateReachesCompiledRhs();
+    TEST(testSymbolRefcountsBalance, -1)
+    void testSymbolRefcountsBalance();
+
 	// If you would like to test the Soar Debugger Spawning, uncomment below.
 	// It may or may not work but should unless you're running without a GUI.
 //	TEST(testSoarDebugger, -1)
@@ -176,3 +176,505 @@ void SvsTests::testSvsSceneCaseInsensitivity()
     result = agent->ExecuteCommandLine("svs D34.scene.world");
     no_agent_assertTrue_msg("D34 scene name found: " + result, result == "path not found\n");
 }
+
+void SvsTests::testNearestAndWithinDistanceFilters()
+{
+    agent->ExecuteCommandLine("svs --enable");
+    no_agent_assertTrue_msg("failed to enable SVS", agent->GetLastCommandLineResult());
+
+    agent->ExecuteCommandLine("svs S1.scene.sgel add a world b 0.5 p 0 0 0");
+    agent->ExecuteCommandLine("svs S1.scene.sgel add b world b 0.5 p 2 0 0");
+    agent->ExecuteCommandLine("svs S1.scene.sgel add c world b 0.5 p 5 0 0");
+    agent->ExecuteCommandLine("svs S1.scene.sgel add d world b 0.5 p 10 0 0");
+
+    agent->ExecuteCommandLine("sp {extract*nearest (state <s> ^superstate nil ^svs.command <c>) --> (<c> ^extract <e>) (<e> ^type nearest ^a <a>) (<a> ^type node ^id a)}");
+    agent->ExecuteCommandLine("sp {extract*within (state <s> ^superstate nil ^svs.command <c>) --> (<c> ^extract <e>) (<e> ^type within_distance ^a <a> ^max 3.5) (<a> ^type node ^id a)}");
+    agent->ExecuteCommandLine("sp {elaborate*nearest (state <s> ^svs.command.extract <e>) (<e> ^type nearest ^result.record.value <v>) --> (<s> ^nearest <v>)}");
+    agent->ExecuteCommandLine("sp {elaborate*within (state <s> ^svs.command.extract <e>) (<e> ^type within_distance ^result.record.value <v>) --> (<s> ^within <v>)}");
+
+    agent->ExecuteCommandLine("run 2");
+    std::string result = agent->ExecuteCommandLine("print S1");
+    no_agent_assertTrue_msg("expected b to be nearest to a: " + result, result.find("^nearest b") != std::string::npos);
+    no_agent_assertTrue_msg("expected b within range of a: " + result, result.find("^within b") != std::string::npos);
+    no_agent_assertTrue_msg("expected c out of range of a: " + result, result.find("^within c") == std::string::npos);
+
+    /* Moving b away should change the answers without any change to the filter inputs */
+    agent->SendSVSInput("change b p 20 0 0\nchange c p 3 0 0");
+    agent->ExecuteCommandLine("run 2");
+    result = agent->ExecuteCommandLine("print S1");
+    no_agent_assertTrue_msg("expected c to be nearest to a: " + result, result.find("^nearest c") != std::string::npos);
+    no_agent_assertTrue_msg("expected b out of range of a: " + result, result.find("^within b") == std::string::npos);
+    no_agent_assertTrue_msg("expected c within range of a: " + result, result.find("^within c") != std::string::npos);
+}
+
+void SvsTests::testSubstateScenesShareParentNodes()
+{
+    agent->ExecuteCommandLine("svs --enable");
+    no_agent_assertTrue_msg("failed to enable SVS", agent->GetLastCommandLineResult());
+    agent->ExecuteCommandLine("svs substate_scenes live");
+
+    agent->SendSVSInput("add a world b 0.5 p 0 0 0");
+    agent->ExecuteCommandLine("run 2");
+    std::string result = agent->ExecuteCommandLine("svs S2.scene.properties");
+    no_agent_assertTrue_msg("expected S2 to start with a: " + result, result.find("a:px") != std::string::npos);
+
+    /* Until it writes, a substate sees changes to its parent's scene */
+    agent->SendSVSInput("add b world b 0.5 p 2 0 0");
+    agent->ExecuteCommandLine("run 1");
+    result = agent->ExecuteCommandLine("svs S2.scene.properties");
+    no_agent_assertTrue_msg("expected S2 to see b: " + result, result.find("b:px") != std::string::npos);
+
+    /* Writing to the substate scene must not leak into the parent */
+    agent->ExecuteCommandLine("svs S2.scene.sgel add c world b 0.5 p 5 0 0");
+    result = agent->ExecuteCommandLine("svs S1.scene.properties");
+    no_agent_assertTrue_msg("expected c to stay out of S1: " + result, result.find("c:px") == std::string::npos);
+    result = agent->ExecuteCommandLine("svs S2.scene.properties");
+    no_agent_assertTrue_msg("expected S2 to have c: " + result, result.find("c:px") != std::string::npos);
+    result = agent->ExecuteCommandLine("svs S3.scene.properties");
+    no_agent_assertTrue_msg("expected S3 to see its parent's c: " + result, result.find("c:px") != std::string::npos);
+
+    /* and after writing, the substate no longer follows the parent */
+    agent->SendSVSInput("add d world b 0.5 p 8 0 0");
+    agent->ExecuteCommandLine("run 1");
+    result = agent->ExecuteCommandLine("svs S1.scene.properties");
+    no_agent_assertTrue_msg("expected S1 to have d: " + result, result.find("\nd:px") != std::string::npos);
+    result = agent->ExecuteCommandLine("svs S2.scene.properties");
+    no_agent_assertTrue_msg("expected S2 not to see d: " + result, result.find("\nd:px") == std::string::npos);
+
+    result = agent->ExecuteCommandLine("print -d 4 S3");
+    no_agent_assertTrue_msg("expected S3 working memory to mirror c: " + result, result.find("^id c") != std::string::npos);
+}
+
+/*
+ The word following name in the output of an svs command, such as a property
+ in "svs <scene>.properties", or "" if name isn't there
+*/
+static std::string svs_output_value(const std::string& output, const std::string& name)
+{
+    size_t i = output.find(name + " ");
+    if (i == std::string::npos)
+    {
+        return "";
+    }
+    std::istringstream in(output.substr(i + name.size()));
+    std::string value;
+    in >> value;
+    return value;
+}
+
+void SvsTests::testSubstateScenesKeepSnapshot()
+{
+    agent->ExecuteCommandLine("svs --enable");
+    no_agent_assertTrue_msg("failed to enable SVS", agent->GetLastCommandLineResult());
+    std::string result = agent->ExecuteCommandLine("svs substate_scenes");
+    no_agent_assertTrue_msg("expected snapshot substate scenes by default: " + result, result.find("snapshot") != std::string::npos);
+
+    agent->SendSVSInput("add a world b 0.5 p 0 0 0");
+    agent->ExecuteCommandLine("run 2");
+    result = agent->ExecuteCommandLine("svs S2.scene.properties");
+    no_agent_assertTrue_msg("expected S2 to start with a: " + result, result.find("a:px") != std::string::npos);
+
+    /* Changes to the parent's scene after the substate was made don't show up in it */
+    agent->SendSVSInput("add b world b 0.5 p 2 0 0\nchange a p 7 0 0");
+    agent->ExecuteCommandLine("run 1");
+    result = agent->ExecuteCommandLine("svs S1.scene.properties");
+    no_agent_assertTrue_msg("expected S1 to have b: " + result, result.find("b:px") != std::string::npos);
+    no_agent_assertTrue_msg("expected a to move in S1: " + result, svs_output_value(result, "a:px") == "7");
+    result = agent->ExecuteCommandLine("svs S2.scene.properties");
+    no_agent_assertTrue_msg("expected S2 not to see b: " + result, result.find("b:px") == std::string::npos);
+    no_agent_assertTrue_msg("expected a to stay put in S2: " + result, svs_output_value(result, "a:px") == "0");
+    result = agent->ExecuteCommandLine("print -d 4 S2");
+    no_agent_assertTrue_msg("expected S2 working memory not to mirror b: " + result, result.find("^id b") == std::string::npos);
+
+    /* A substate made from a snapshot sees the snapshot, and keeps it when the snapshot's state writes */
+    result = agent->ExecuteCommandLine("svs S3.scene.properties");
+    no_agent_assertTrue_msg("expected S3 to start from S2's view: " + result, svs_output_value(result, "a:px") == "0" && result.find("b:px") == std::string::npos);
+    agent->ExecuteCommandLine("svs S2.scene.sgel add c world b 0.5 p 5 0 0");
+    result = agent->ExecuteCommandLine("svs S3.scene.properties");
+    no_agent_assertTrue_msg("expected S3 not to see S2's c: " + result, result.find("c:px") == std::string::npos);
+    result = agent->ExecuteCommandLine("svs S1.scene.properties");
+    no_agent_assertTrue_msg("expected c to stay out of S1: " + result, result.find("c:px") == std::string::npos);
+}
+
+void SvsTests::testStandingWriteCommandKeepsSnapshotShared()
+{
+    agent->ExecuteCommandLine("svs --enable");
+    no_agent_assertTrue_msg("failed to enable SVS", agent->GetLastCommandLineResult());
+    agent->ExecuteCommandLine("svs timers on");
+
+    /* The top state moves a once, then impasses, and the command stays on its command link */
+    agent->SendSVSInput("add a world b 0.5 p 0 0 0");
+    agent->ExecuteCommandLine("sp {svs*move (state <s> ^superstate nil ^svs.command <c>) --> (<c> ^set_transform <t>) (<t> ^id a ^position <p>) (<p> ^x 3 ^y 0 ^z 0)}");
+    agent->ExecuteCommandLine("sp {propose*wait (state <s> ^superstate nil -^waited) --> (<s> ^operator <o> +) (<o> ^name wait)}");
+    agent->ExecuteCommandLine("sp {apply*wait (state <s> ^operator.name wait) --> (<s> ^waited true)}");
+    agent->ExecuteCommandLine("run 5");
+
+    std::string result = agent->ExecuteCommandLine("svs S2.scene.properties");
+    no_agent_assertTrue_msg("expected S2 to see a where S1 moved it: " + result, svs_output_value(result, "a:px") == "3");
+
+    /* The command has nothing left to write, so S2 keeps sharing S1's nodes */
+    result = agent->ExecuteCommandLine("svs timers");
+    no_agent_assertTrue_msg("expected the substate scene not to be copied: " + result, result.find("scene_copy") == std::string::npos);
+}
+
+void SvsTests::testFilterResultsFollowGeometryChanges()
+{
+    agent->ExecuteCommandLine("svs --enable");
+    no_agent_assertTrue_msg("failed to enable SVS", agent->GetLastCommandLineResult());
+
+    agent->SendSVSInput("add g world p 0 0 0\nadd a g b 0.5 p 0 0 0\nadd b world b 0.5 p 4 0 0");
+    agent->ExecuteCommandLine("sp {extract*distance (state <s> ^superstate nil ^svs.command <c>) --> (<c> ^extract <e>) (<e> ^type distance ^distance_type hull ^a <a> ^b <b>) (<a> ^type node ^id a) (<b> ^type node ^id b)}");
+    agent->ExecuteCommandLine("sp {elaborate*distance (state <s> ^svs.command.extract.result.record.value <v>) --> (<s> ^dist <v>)}");
+
+    agent->ExecuteCommandLine("run 2");
+    std::string result = agent->ExecuteCommandLine("print S1");
+    no_agent_assertTrue_msg("expected a distance of 3: " + result, result.find("^dist 3") != std::string::npos);
+
+    agent->SendSVSInput("change b p 6 0 0");
+    agent->ExecuteCommandLine("run 1");
+    result = agent->ExecuteCommandLine("print S1");
+    no_agent_assertTrue_msg("expected a distance of 5 after moving b: " + result, result.find("^dist 5") != std::string::npos);
+
+    /* A tag change doesn't move anything, so the cached distance stays */
+    agent->SendSVSInput("tag add b color red");
+    agent->ExecuteCommandLine("run 1");
+    result = agent->ExecuteCommandLine("print S1");
+    no_agent_assertTrue_msg("expected a distance of 5 after tagging b: " + result, result.find("^dist 5") != std::string::npos);
+
+    /* Moving a's parent moves a too */
+    agent->SendSVSInput("change g p 1 0 0");
+    agent->ExecuteCommandLine("run 1");
+    result = agent->ExecuteCommandLine("print S1");
+    no_agent_assertTrue_msg("expected a distance of 4 after moving g: " + result, result.find("^dist 4") != std::string::npos);
+}
+
+void SvsTests::testNodeFilterCacheSkipsUnmovedNodes()
+{
+    agent->ExecuteCommandLine("svs --enable");
+    no_agent_assertTrue_msg("failed to enable SVS", agent->GetLastCommandLineResult());
+
+    agent->SendSVSInput("add a world b 0.5 p 0 0 0\nadd b world b 0.5 p 4 0 0");
+    agent->ExecuteCommandLine("sp {extract*distance (state <s> ^superstate nil ^svs.command <c>) --> (<c> ^extract <e>) (<e> ^type distance ^distance_type hull ^a <a> ^b <b>) (<a> ^type node ^id a) (<b> ^type all_nodes)}");
+    agent->ExecuteCommandLine("sp {elaborate*distance (state <s> ^svs.command.extract.result.record.value <v>) --> (<s> ^dist <v>)}");
+    agent->ExecuteCommandLine("run 2");
+
+    /* all_nodes reports b as changed when it is tagged, but its geometry is the same */
+    agent->ExecuteCommandLine("svs filter_cache reset");
+    agent->SendSVSInput("tag add b color red");
+    agent->ExecuteCommandLine("run 1");
+    std::string result = agent->ExecuteCommandLine("svs filter_cache");
+    no_agent_assertTrue_msg("expected the tagged pair to be found in the cache: " + result, svs_output_value(result, "hits:") != "0" && svs_output_value(result, "hits:") != "");
+    no_agent_assertTrue_msg("expected nothing to be computed after a tag change: " + result, svs_output_value(result, "computed:") == "0");
+    result = agent->ExecuteCommandLine("print S1");
+    no_agent_assertTrue_msg("expected a distance of 3 after tagging b: " + result, result.find("^dist 3") != std::string::npos);
+
+    agent->ExecuteCommandLine("svs filter_cache reset");
+    agent->SendSVSInput("change b p 6 0 0");
+    agent->ExecuteCommandLine("run 1");
+    result = agent->ExecuteCommandLine("svs filter_cache");
+    no_agent_assertTrue_msg("expected the moved pair to be computed again: " + result, svs_output_value(result, "computed:") != "0" && svs_output_value(result, "computed:") != "");
+    result = agent->ExecuteCommandLine("print S1");
+    no_agent_assertTrue_msg("expected a distance of 5 after moving b: " + result, result.find("^dist 5") != std::string::npos);
+}
+
+void SvsTests::testHullIntersectOverManyPairs()
+{
+    agent->ExecuteCommandLine("svs --enable");
+    no_agent_assertTrue_msg("failed to enable SVS", agent->GetLastCommandLineResult());
+
+    /* e's bounding box overlaps a's, but the balls themselves don't touch */
+    agent->SendSVSInput("add a world b 1 p 0 0 0\nadd b world b 1 p 1.5 0 0\nadd c world v 0 0 0 1 0 0 0 1 0 0 0 1 p 0 -1.5 0\nadd d world b 1 p 5 0 0\nadd e world b 1 p 1.6 1.6 0");
+    agent->ExecuteCommandLine("sp {extract*intersect (state <s> ^superstate nil ^svs.command <c>) --> (<c> ^extract <e>) (<e> ^type intersect_select ^intersect_type hull ^a <a> ^b <b>) (<a> ^type node ^id a) (<b> ^type all_nodes)}");
+    agent->ExecuteCommandLine("sp {elaborate*intersect (state <s> ^svs.command.extract.result.record.value <v>) --> (<s> ^hit <v>)}");
+
+    agent->ExecuteCommandLine("run 2");
+    std::string result = agent->ExecuteCommandLine("print S1");
+    no_agent_assertTrue_msg("expected a to intersect b: " + result, result.find("^hit b") != std::string::npos);
+    no_agent_assertTrue_msg("expected a to intersect c: " + result, result.find("^hit c") != std::string::npos);
+    no_agent_assertTrue_msg("expected a to miss d: " + result, result.find("^hit d") == std::string::npos);
+    no_agent_assertTrue_msg("expected a to miss e: " + result, result.find("^hit e") == std::string::npos);
+
+    agent->SendSVSInput("change d p 1.9 0 0\nchange b p 3 0 0");
+    agent->ExecuteCommandLine("run 1");
+    result = agent->ExecuteCommandLine("print S1");
+    no_agent_assertTrue_msg("expected a to miss b after it moved: " + result, result.find("^hit b") == std::string::npos);
+    no_agent_assertTrue_msg("expected a to intersect d after it moved: " + result, result.find("^hit d") != std::string::npos);
+}
+
+void SvsTests::testPairwiseSelectFollowsIndex()
+{
+    agent->ExecuteCommandLine("svs --enable");
+    no_agent_assertTrue_msg("failed to enable SVS", agent->GetLastCommandLineResult());
+
+    agent->SendSVSInput("add a world b 0.5 p 0 0 0\nadd b world b 0.5 p 2 0 0\nadd c world b 0.5 p 5 0 0\nadd d world b 0.5 p 10 0 0");
+    agent->ExecuteCommandLine("sp {extract*near (state <s> ^superstate nil ^svs.command <c>) --> (<c> ^extract <e>) (<e> ^type distance_select ^distance_type hull ^max 2.5 ^a <a> ^b <b>) (<a> ^type node ^id a) (<b> ^type all_nodes)}");
+    agent->ExecuteCommandLine("sp {extract*touch (state <s> ^superstate nil ^svs.command <c>) --> (<c> ^extract <e>) (<e> ^type intersect_select ^a <a> ^b <b>) (<a> ^type node ^id c) (<b> ^type all_nodes)}");
+    agent->ExecuteCommandLine("sp {elaborate*near (state <s> ^svs.command.extract <e>) (<e> ^type distance_select ^result.record.value <v>) --> (<s> ^near <v>)}");
+    agent->ExecuteCommandLine("sp {elaborate*touch (state <s> ^svs.command.extract <e>) (<e> ^type intersect_select ^result.record.value <v>) --> (<s> ^touch <v>)}");
+
+    agent->ExecuteCommandLine("run 2");
+    std::string result = agent->ExecuteCommandLine("print S1");
+    no_agent_assertTrue_msg("expected b near a: " + result, result.find("^near b") != std::string::npos);
+    no_agent_assertTrue_msg("expected c out of range of a: " + result, result.find("^near c") == std::string::npos);
+    no_agent_assertTrue_msg("expected c to touch only itself: " + result, result.find("^touch c") != std::string::npos && result.find("^touch b") == std::string::npos);
+
+    /* Moving the b side: only the pairs of the nodes that moved are looked at again */
+    agent->SendSVSInput("change b p 20 0 0\nchange d p 5.8 0 0");
+    agent->ExecuteCommandLine("run 1");
+    result = agent->ExecuteCommandLine("print S1");
+    no_agent_assertTrue_msg("expected b out of range of a after it moved: " + result, result.find("^near b") == std::string::npos);
+    no_agent_assertTrue_msg("expected d to touch c after it moved: " + result, result.find("^touch d") != std::string::npos);
+    no_agent_assertTrue_msg("expected c to still touch itself: " + result, result.find("^touch c") != std::string::npos);
+
+    /* Moving the a side */
+    agent->SendSVSInput("change a p 18 0 0");
+    agent->ExecuteCommandLine("run 1");
+    result = agent->ExecuteCommandLine("print S1");
+    no_agent_assertTrue_msg("expected b near a after a moved: " + result, result.find("^near b") != std::string::npos);
+
+    /* Nodes added later are found through the index as well, and deleted ones drop out */
+    agent->SendSVSInput("add e world b 0.5 p 4.6 0 0\ndelete d");
+    agent->ExecuteCommandLine("run 1");
+    result = agent->ExecuteCommandLine("print S1");
+    no_agent_assertTrue_msg("expected e to touch c after it was added: " + result, result.find("^touch e") != std::string::npos);
+    no_agent_assertTrue_msg("expected d to be gone after it was deleted: " + result, result.find("^touch d") == std::string::npos);
+}
+
+/* Little-endian writers for the binary scene batch layout in sgel_batch.h */
+static void put_batch_uint(std::string& out, uint64_t v, int bytes)
+{
+    for (int i = 0; i < bytes; ++i)
+    {
+        out += static_cast<char>((v >> (8 * i)) & 0xff);
+    }
+}
+
+static void put_batch_str(std::string& out, const std::string& s)
+{
+    put_batch_uint(out, s.size(), 4);
+    out += s;
+}
+
+static void put_batch_double(std::string& out, double d)
+{
+    uint64_t bits;
+    memcpy(&bits, &d, sizeof(bits));
+    put_batch_uint(out, bits, 8);
+}
+
+static void put_batch_vec(std::string& out, double x, double y, double z)
+{
+    put_batch_double(out, x);
+    put_batch_double(out, y);
+    put_batch_double(out, z);
+}
+
+static std::string batch_header(int count)
+{
+    std::string out("SVSB");
+    put_batch_uint(out, count, 4);
+    return out;
+}
+
+void SvsTests::testBinarySceneBatches()
+{
+    agent->ExecuteCommandLine("svs --enable");
+    no_agent_assertTrue_msg("failed to enable SVS", agent->GetLastCommandLineResult());
+
+    /* add g world p 1 2 3; add b g b 0.5 p 0 0 1; tag add b color red */
+    std::string batch = batch_header(3);
+    batch += 'a';
+    put_batch_str(batch, "g");
+    put_batch_str(batch, "world");
+    put_batch_uint(batch, 1, 1);
+    put_batch_vec(batch, 1, 2, 3);
+    batch += 'a';
+    put_batch_str(batch, "b");
+    put_batch_str(batch, "g");
+    put_batch_uint(batch, 1 | 16, 1);
+    put_batch_vec(batch, 0, 0, 1);
+    put_batch_double(batch, 0.5);
+    batch += 't';
+    batch += 'a';
+    put_batch_str(batch, "b");
+    put_batch_str(batch, "color");
+    put_batch_str(batch, "red");
+    agent->SendSVSBinaryInput(batch);
+    agent->ExecuteCommandLine("run 1");
+
+    std::string result = agent->SVSQuery("obj-info g");
+    no_agent_assertTrue_msg("expected g to be added: " + result, result.find("o g p 1 2 3") != std::string::npos);
+    result = agent->SVSQuery("obj-info b");
+    no_agent_assertTrue_msg("expected b to be added under g: " + result, result.find("o b p 0 0 1") != std::string::npos);
+    no_agent_assertTrue_msg("expected b to be tagged: " + result, result.find("color red") != std::string::npos);
+
+    /* change g p 5 5 5; delete g; change b p 9 9 9 -- b went away with g, so nothing applies */
+    batch = batch_header(3);
+    batch += 'c';
+    put_batch_str(batch, "g");
+    put_batch_uint(batch, 1, 1);
+    put_batch_vec(batch, 5, 5, 5);
+    batch += 'd';
+    put_batch_str(batch, "g");
+    batch += 'c';
+    put_batch_str(batch, "b");
+    put_batch_uint(batch, 1, 1);
+    put_batch_vec(batch, 9, 9, 9);
+    agent->SendSVSBinaryInput(batch);
+    agent->ExecuteCommandLine("run 1");
+
+    result = agent->SVSQuery("obj-info g");
+    no_agent_assertTrue_msg("expected rejected batch to leave g alone: " + result, result.find("o g p 1 2 3") != std::string::npos);
+    result = agent->SVSQuery("obj-info b");
+    no_agent_assertTrue_msg("expected rejected batch to leave b alone: " + result, result.find("o b p 0 0 1") != std::string::npos);
+
+    /* delete g; add g world -- the new g does not bring b back */
+    batch = batch_header(2);
+    batch += 'd';
+    put_batch_str(batch, "g");
+    batch += 'a';
+    put_batch_str(batch, "g");
+    put_batch_str(batch, "world");
+    put_batch_uint(batch, 0, 1);
+    agent->SendSVSBinaryInput(batch);
+    agent->SendSVSInput("change g p 4 4 4");
+    agent->ExecuteCommandLine("run 1");
+
+    result = agent->SVSQuery("obj-info g");
+    no_agent_assertTrue_msg("expected g to be re-added and then moved by SGEL: " + result, result.find("o g p 4 4 4") != std::string::npos);
+    result = agent->SVSQuery("obj-info b");
+    no_agent_assertTrue_msg("expected b to be deleted with g: " + result, result.find("Node not found") != std::string::npos);
+}
+
+void SvsTests::testParallelFilterUpdatesMatchSerial()
+{
+    /* The same agent, updating filters serially and on four workers, should build identical working memory */
+    sml::Agent* parallel = kernel->CreateAgent("soar2");
+    sml::Agent* agents[2] = { agent, parallel };
+
+    for (int i = 0; i < 2; ++i)
+    {
+        agents[i]->ExecuteCommandLine("svs --enable");
+        no_agent_assertTrue_msg("failed to enable SVS", agents[i]->GetLastCommandLineResult());
+        agents[i]->SendSVSInput("add a world b 1 p 0 0 0\nadd b world b 1 p 1.5 0 0\nadd c world v 0 0 0 1 0 0 0 1 0 0 0 1 p 0 -1.5 0\nadd d world b 1 p 5 0 0\nadd e world b 0.5 p 3 3 0");
+        agents[i]->ExecuteCommandLine("sp {extract*distance (state <s> ^superstate nil ^svs.command <c>) --> (<c> ^extract <e>) (<e> ^type distance ^a <a> ^b <b>) (<a> ^type all_nodes) (<b> ^type all_nodes)}");
+        agents[i]->ExecuteCommandLine("sp {extract*intersect (state <s> ^superstate nil ^svs.command <c>) --> (<c> ^extract <e>) (<e> ^type intersect_select ^intersect_type hull ^a <a> ^b <b>) (<a> ^type node ^id a) (<b> ^type all_nodes)}");
+        agents[i]->ExecuteCommandLine("sp {extract*closest (state <s> ^superstate nil ^svs.command <c>) --> (<c> ^extract <e>) (<e> ^type closest ^a <a> ^b <b>) (<a> ^type node ^id d) (<b> ^type all_nodes)}");
+        agents[i]->ExecuteCommandLine("sp {extract*broken (state <s> ^superstate nil ^svs.command <c>) --> (<c> ^extract <e>) (<e> ^type distance ^a <a> ^b <b>) (<a> ^type node ^id nowhere) (<b> ^type all_nodes)}");
+    }
+    std::string result = parallel->ExecuteCommandLine("svs filter_threads 4");
+    result = parallel->ExecuteCommandLine("svs filter_threads");
+    no_agent_assertTrue_msg("expected 4 filter threads: " + result, result.find("4") != std::string::npos);
+
+    const char* moves[] = { "change d p 1.9 0 0\nchange b p 3 0 0", "delete c\nadd f world b 2 p -2 0 0", "change e p 0 0 0" };
+    for (int step = 0; step <= 3; ++step)
+    {
+        for (int i = 0; i < 2; ++i)
+        {
+            if (step > 0)
+            {
+                agents[i]->SendSVSInput(moves[step - 1]);
+            }
+            // --self, or each run would step both agents
+            agents[i]->ExecuteCommandLine("run 1 --self");
+        }
+        std::string serial_wm = agent->ExecuteCommandLine("print --depth 8 S1");
+        std::string parallel_wm = parallel->ExecuteCommandLine("print --depth 8 S1");
+        no_agent_assertTrue_msg("expected distance results: " + serial_wm, serial_wm.find("^result") != std::string::npos);
+        no_agent_assertTrue_msg("parallel working memory differs at step " + std::to_string(step) + ":\n" + serial_wm + "\n" + parallel_wm, serial_wm == parallel_wm);
+    }
+
+    kernel->DestroyAgent(parallel);
+}
+
+void SvsTests::testLineOfSightAndOcclusion()
+{
+    agent->ExecuteCommandLine("svs --enable");
+    no_agent_assertTrue_msg("failed to enable SVS", agent->GetLastCommandLineResult());
+
+    /* A thin wall w stands between the eye and the cube t; nothing is between the eye and the cube u */
+    const char* cube = "v -0.5 -0.5 -0.5 -0.5 -0.5 0.5 -0.5 0.5 -0.5 -0.5 0.5 0.5 0.5 -0.5 -0.5 0.5 -0.5 0.5 0.5 0.5 -0.5 0.5 0.5 0.5";
+    agent->SendSVSInput(std::string("add eye world b 0.1 p 0 0 0\n") +
+                        "add t world " + cube + " p 5 0 0\n" +
+                        "add u world " + cube + " p 0 5 0\n" +
+                        "add w world " + cube + " p 2.5 0 0 s 0.2 6 6");
+    agent->ExecuteCommandLine("sp {extract*sight (state <s> ^superstate nil ^svs.command <c>) --> (<c> ^extract <e>) (<e> ^type line_of_sight ^a <a> ^b <b>) (<a> ^type node ^id eye) (<b> ^type all_nodes)}");
+    agent->ExecuteCommandLine("sp {extract*occlusion (state <s> ^superstate nil ^svs.command <c>) --> (<c> ^extract <e>) (<e> ^type occlusion ^a <a> ^b <b>) (<a> ^type node ^id t) (<b> ^type node ^id w)}");
+    agent->ExecuteCommandLine("sp {elaborate*visible (state <s> ^svs.command.extract <e>) (<e> ^type line_of_sight ^result.record <r>) (<r> ^value true ^params.b <b>) --> (<s> ^visible <b>)}");
+    agent->ExecuteCommandLine("sp {elaborate*occluded (state <s> ^svs.command.extract <e>) (<e> ^type occlusion ^result.record.value <v>) --> (<s> ^occluded <v>)}");
+
+    agent->ExecuteCommandLine("run 2");
+    std::string result = agent->ExecuteCommandLine("print S1");
+    no_agent_assertTrue_msg("expected u to be visible: " + result, result.find("^visible u") != std::string::npos);
+    no_agent_assertTrue_msg("expected the wall to be visible: " + result, result.find("^visible w") != std::string::npos);
+    no_agent_assertTrue_msg("expected t to be hidden: " + result, result.find("^visible t") == std::string::npos);
+    no_agent_assertTrue_msg("expected t to be fully occluded: " + result, result.find("^occluded 1.") != std::string::npos);
+
+    agent->SendSVSInput("change w p 2.5 20 0");
+    agent->ExecuteCommandLine("run 1");
+    result = agent->ExecuteCommandLine("print S1");
+    no_agent_assertTrue_msg("expected t to be visible once the wall moved: " + result, result.find("^visible t") != std::string::npos);
+    no_agent_assertTrue_msg("expected t to be unoccluded once the wall moved: " + result, result.find("^occluded 0.") != std::string::npos);
+}
+
+void SvsTests::testSparseSceneMirroring()
+{
+    agent->ExecuteCommandLine("svs --enable");
+    no_agent_assertTrue_msg("failed to enable SVS", agent->GetLastCommandLineResult());
+    agent->ExecuteCommandLine("svs mirror sparse");
+
+    agent->SendSVSInput("add a world b 1 p 5 0 0\nadd g world\nadd n5 g b 1 p 0 5 0");
+    agent->ExecuteCommandLine("sp {elaborate*seen (state <s> ^superstate nil ^svs.spatial-scene.child <c>) (<c> ^id <id>) --> (<s> ^seen <id>)}");
+    agent->ExecuteCommandLine("sp {elaborate*seen*child (state <s> ^superstate nil ^svs.spatial-scene.child.child <c>) (<c> ^id <id>) --> (<s> ^seen <id>)}");
+    agent->ExecuteCommandLine("sp {elaborate*color (state <s> ^superstate nil ^svs.spatial-scene.child.child <c>) (<c> ^id |n5| ^color <v>) --> (<s> ^n5-color <v>)}");
+    agent->ExecuteCommandLine("run 1");
+    std::string result = agent->ExecuteCommandLine("print S1");
+    no_agent_assertTrue_msg("expected no nodes mirrored before subscribing: " + result, result.find("^seen") == std::string::npos);
+
+    agent->ExecuteCommandLine("sp {subscribe*n5 (state <s> ^superstate nil ^svs.command <c>) --> (<c> ^subscribe.id |n5|)}");
+    agent->ExecuteCommandLine("run 2");
+    result = agent->ExecuteCommandLine("print S1");
+    no_agent_assertTrue_msg("expected n5 to be mirrored: " + result, result.find("^seen |n5|") != std::string::npos);
+    no_agent_assertTrue_msg("expected the path to n5 to be mirrored: " + result, result.find("^seen g") != std::string::npos);
+    no_agent_assertTrue_msg("expected a to stay unmirrored: " + result, result.find("^seen a") == std::string::npos);
+
+    /* only the last of several changes in a cycle reaches working memory */
+    agent->SendSVSInput("tag add n5 color red\ntag change n5 color blue");
+    agent->ExecuteCommandLine("run 1");
+    result = agent->ExecuteCommandLine("print S1");
+    no_agent_assertTrue_msg("expected n5's latest color: " + result, result.find("^n5-color blue") != std::string::npos);
+    no_agent_assertTrue_msg("expected n5's earlier color to be skipped: " + result, result.find("^n5-color red") == std::string::npos);
+
+    agent->ExecuteCommandLine("svs mirror full");
+    agent->ExecuteCommandLine("run 1");
+    result = agent->ExecuteCommandLine("print S1");
+    no_agent_assertTrue_msg("expected every node mirrored in full mode: " + result, result.find("^seen a") != std::string::npos);
+}
+
+void SvsTests::testIdenticalShapesShareVertices()
+{
+    agent->ExecuteCommandLine("svs --enable");
+    no_agent_assertTrue_msg("failed to enable SVS", agent->GetLastCommandLineResult());
+
+    const char* tetra = " v 0 0 0 1 0 0 0 1 0 0 0 1.5";
+    agent->ExecuteCommandLine((std::string("svs S1.scene.sgel add a world") + tetra + " p 0 0 0").c_str());
+    agent->ExecuteCommandLine((std::string("svs S1.scene.sgel add b world") + tetra + " p 3 0 0").c_str());
+    agent->ExecuteCommandLine((std::string("svs S1.scene.sgel add c world") + tetra + " p 6 0 0").c_str());
+    agent->ExecuteCommandLine("svs S1.scene.sgel add d world v 0 0 0 2 0 0 0 2 0 0 0 2.5 p 9 0 0");
+
+    std::string result = agent->ExecuteCommandLine("svs S1.scene.world.a");
+    no_agent_assertTrue_msg("expected a to share its vertices with b and c: " + result, result.find("shared with 2 other nodes") != std::string::npos);
+    result = agent->ExecuteCommandLine("svs S1.scene.world.d");
+    no_agent_assertTrue_msg("expected d to have its own vertices: " + result, result.find("shared with") == std::string::npos);
+
+    agent->ExecuteCommandLine("svs S1.scene.sgel change b v 0 0 0 2 0 0 0 2 0 0 0 2.5");
+    result = agent->ExecuteCommandLine("svs S1.scene.world.a");
+    no_agent_assertTrue_msg("expected a to share with c only: " + result, result.find("shared with 1 other nodes") != std::string::npos);
+    result = agent->ExecuteCommandLine("svs S1.scene.world.d");
+    no_agent_assertTrue_msg("expected b to pick up d's vertices: " + result, result.find("shared with 1 other nodes") != std::string::npos);
+
+    /* moving a node only changes its world vertices */
+    agent->ExecuteCommandLine("svs S1.scene.sgel change a p 0 20 0");
+    result = agent->ExecuteCommandLine("svs S1.scene.world.c");
+    no_agent_assertTrue_msg("expected c to still share with a: " + result, result.find("shared with 1 other nodes") != std::string::npos);
+}
@@ -57,6 +57,44 @@ public:
 
     TEST(testSvsSceneCaseInsensitivity, -1);
     void testSvsSceneCaseInsensitivity();
+
+    TEST(testNearestAndWithinDistanceFilters, -1);
+    void testNearestAndWithinDistanceFilters();
+
+    TEST(testSubstateScenesShareParentNodes, -1);
+    void testSubstateScenesShareParentNodes();
+
+    TEST(testSubstateScenesKeepSnapshot, -1);
+    void testSubstateScenesKeepSnapshot();
+    TEST(testStandingWriteCommandKeepsSnapshotShared, -1);
+    void testStandingWriteCommandKeepsSnapshotShared();
+
+    TEST(testFilterResultsFollowGeometryChanges, -1);
+    void testFilterResultsFollowGeometryChanges();
+
+    TEST(testNodeFilterCacheSkipsUnmovedNodes, -1);
+    void testNodeFilterCacheSkipsUnmovedNodes();
+
+    TEST(testHullIntersectOverManyPairs, -1);
+    void testHullIntersectOverManyPairs();
+
+    TEST(testPairwiseSelectFollowsIndex, -1);
+    void testPairwiseSelectFollowsIndex();
+
+    TEST(testBinarySceneBatches, -1);
+    void testBinarySceneBatches();
+
+    TEST(testParallelFilterUpdatesMatchSerial, -1);
+    void testParallelFilterUpdatesMatchSerial();
+
+    TEST(testLineOfSightAndOcclusion, -1);
+    void testLineOfSightAndOcclusion();
+
+    TEST(testSparseSceneMirroring, -1);
+    void testSparseSceneMirroring();
+
+    TEST(testIdenticalShapesShareVertices, -1);
+    void testIdenticalShapesShareVertices();
 };
 
 #endif /* SvsTests_cpp */